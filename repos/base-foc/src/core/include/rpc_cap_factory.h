@@ -30,12 +30,17 @@ class Genode::Rpc_cap_factory
 {
 	private:
 
-		struct Entry : Object_pool<Entry>::Entry
+		struct Entry;
+
+		/* each PD session has its own factory, keep the pool small */
+		typedef Object_pool<Entry, 4> Pool;
+
+		struct Entry : Pool::Entry
 		{
-			Entry(Native_capability cap) : Object_pool<Entry>::Entry(cap) {}
+			Entry(Native_capability cap) : Pool::Entry(cap) {}
 		};
 
-		Object_pool<Entry> _pool { };
+		Pool _pool { };
 
 		/*
 		 * Dimension '_entry_slab' such that slab blocks (including the
@@ -27,6 +27,18 @@ namespace Genode {
 	 */
 	inline size_t memcpy_cpu(void *, const void *, size_t size) {
 		return size; }
+
+
+	/**
+	 * Fill memory block with zeros
+	 *
+	 * \param dst   destination memory block
+	 * \param size  number of bytes to clear
+	 *
+	 * \return      number of bytes not cleared
+	 */
+	inline size_t memclear_cpu(void *, size_t size) {
+		return size; }
 }
 
 #endif /* _INCLUDE__RISCV__CPU__STRING_H_ */
@@ -37,18 +37,19 @@ void Ram_dataspace_factory::_clear_ds (Dataspace_component * ds)
 	if (!platform()->region_alloc()->alloc(page_rounded_size, &virt_addr)) {
 		error("could not allocate virtual address range in core of size ",
 		      page_rounded_size);
-		return;
+		throw Core_virtual_memory_exhausted();
 	}
 
 	/* map the dataspace's physical pages to corresponding virtual addresses */
 	size_t num_pages = page_rounded_size >> get_page_size_log2();
 	if (!map_local(ds->phys_addr(), (addr_t)virt_addr, num_pages)) {
 		error("core-local memory mapping failed");
-		return;
+		platform()->region_alloc()->free(virt_addr, page_rounded_size);
+		throw Core_virtual_memory_exhausted();
 	}
 
 	/* clear dataspace */
-	memset(virt_addr, 0, page_rounded_size);
+	_clear_mem(virt_addr, page_rounded_size);
 
 	/* uncached dataspaces need to be flushed from the data cache */
 	if (ds->cacheability() != CACHED)
@@ -27,15 +27,16 @@ namespace Genode {
 	class Signal_context_component;
 	class Signal_source_component;
 
-	typedef Object_pool<Signal_context_component> Signal_context_pool;
-	typedef Object_pool<Signal_source_component>  Signal_source_pool;
+	/* both pools exist once per PD session, see 'Signal_broker' */
+	typedef Object_pool<Signal_context_component, 4> Signal_context_pool;
+	typedef Object_pool<Signal_source_component,  2> Signal_source_pool;
 }
 
 
 struct Genode::Signal_context_component : private Kernel_object<Kernel::Signal_context>,
                                           public Signal_context_pool::Entry
 {
-	friend class Object_pool<Signal_context_component>;
+	friend class Object_pool<Signal_context_component, 4>;
 
 	using Signal_context_pool::Entry::cap;
 
@@ -49,7 +50,7 @@ struct Genode::Signal_context_component : private Kernel_object<Kernel::Signal_c
 struct Genode::Signal_source_component : private Kernel_object<Kernel::Signal_receiver>,
                                          public Signal_source_pool::Entry
 {
-	friend class Object_pool<Signal_source_component>;
+	friend class Object_pool<Signal_source_component, 2>;
 	friend class Signal_context_component;
 
 	using Signal_source_pool::Entry::cap;
@@ -33,13 +33,13 @@ class Genode::Signal_broker
 {
 	private:
 
-		Allocator                            &_md_alloc;
-		Rpc_entrypoint                       &_source_ep;
-		Object_pool<Signal_context_component> _obj_pool { };
-		Rpc_entrypoint                       &_context_ep;
-		Signal_source_component               _source;
-		Signal_source_capability              _source_cap;
-		Signal_context_slab                   _context_slab { _md_alloc };
+		Allocator                &_md_alloc;
+		Rpc_entrypoint           &_source_ep;
+		Signal_context_pool       _obj_pool { };
+		Rpc_entrypoint           &_context_ep;
+		Signal_source_component   _source;
+		Signal_source_capability  _source_cap;
+		Signal_context_slab       _context_slab { _md_alloc };
 
 	public:
 
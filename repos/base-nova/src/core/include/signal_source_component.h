@@ -22,13 +22,16 @@ namespace Genode {
 
 	class Signal_context_component;
 	class Signal_source_component;
+
+	/* the pool exists once per PD session, see 'Signal_broker' */
+	typedef Object_pool<Signal_context_component, 4> Signal_context_pool;
 }
 
 
-struct Genode::Signal_context_component : Object_pool<Signal_context_component>::Entry
+struct Genode::Signal_context_component : Signal_context_pool::Entry
 {
 	Signal_context_component(Signal_context_capability cap)
-	: Object_pool<Signal_context_component>::Entry(cap) { }
+	: Signal_context_pool::Entry(cap) { }
 
 	Signal_source_component *source() { ASSERT_NEVER_CALLED; }
 };
@@ -26,6 +26,9 @@
 using namespace Genode;
 
 
+void Ram_dataspace_factory::_export_ram_ds(Dataspace_component *) { }
+
+
 void Ram_dataspace_factory::_revoke_ram_ds(Dataspace_component *) { }
 
 
@@ -53,37 +56,12 @@ void Ram_dataspace_factory::_clear_ds(Dataspace_component *ds)
 {
 	size_t page_rounded_size = align_addr(ds->size(), get_page_size_log2());
 
-	size_t memset_count = page_rounded_size / 4;
-	addr_t memset_ptr   = ds->core_local_addr();
-
-	if ((memset_count * 4 == page_rounded_size) && !(memset_ptr & 0x3))
-		asm volatile ("rep stosl" : "+D" (memset_ptr), "+c" (memset_count)
-		                          : "a" (0)  : "memory");
-	else
-		memset(reinterpret_cast<void *>(memset_ptr), 0, page_rounded_size);
-
-	/* we don't keep any core-local mapping */
-	unmap_local(reinterpret_cast<Nova::Utcb *>(Thread::myself()->utcb()),
-	            ds->core_local_addr(),
-	            page_rounded_size >> get_page_size_log2());
-
-	platform()->region_alloc()->free((void*)ds->core_local_addr(),
-	                                 page_rounded_size);
-
-	ds->assign_core_local_addr(nullptr);
-}
-
-
-void Ram_dataspace_factory::_export_ram_ds(Dataspace_component *ds) {
-
-	size_t page_rounded_size = align_addr(ds->size(), get_page_size_log2());
-
 	/* allocate the virtual region contiguous for the dataspace */
 	void * virt_ptr = alloc_region(ds, page_rounded_size);
 	if (!virt_ptr)
 		throw Core_virtual_memory_exhausted();
 
-	/* map it writeable for _clear_ds */
+	/* map it writeable to core */
 	Nova::Utcb * const utcb = reinterpret_cast<Nova::Utcb *>(Thread::myself()->utcb());
 	const Nova::Rights rights_rw(true, true, false);
 
@@ -94,6 +72,11 @@ void Ram_dataspace_factory::_export_ram_ds(Dataspace_component *ds) {
 		throw Core_virtual_memory_exhausted();
 	}
 
-	/* assign virtual address to the dataspace to be used by clear_ds */
-	ds->assign_core_local_addr(virt_ptr);
+	_clear_mem(virt_ptr, page_rounded_size);
+
+	/* we don't keep any core-local mapping */
+	unmap_local(utcb, reinterpret_cast<addr_t>(virt_ptr),
+	            page_rounded_size >> get_page_size_log2());
+
+	platform()->region_alloc()->free(virt_ptr, page_rounded_size);
 }
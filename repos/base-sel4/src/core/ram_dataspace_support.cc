@@ -62,9 +62,7 @@ void Ram_dataspace_factory::_clear_ds (Dataspace_component *ds)
 		}
 
 		/* clear one page */
-		size_t num_longwords = get_page_size()/sizeof(long);
-		for (long *dst = reinterpret_cast<long *>(virt_addr); num_longwords--;)
-			*dst++ = 0;
+		_clear_mem(reinterpret_cast<void *>(virt_addr), get_page_size());
 
 		/* unmap cleared page from core */
 		unmap_local(virt_addr, ONE_PAGE, nullptr, ds->cacheability() != CACHED);
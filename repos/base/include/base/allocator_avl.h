@@ -67,6 +67,10 @@ class Genode::Allocator_avl_base : public Range_allocator
 				short  _id        { 0 };     /* for debugging   */
 				size_t _max_avail { 0 };     /* biggest free block size of
 				                                sub tree */
+				Block *_free_next { nullptr }; /* size-class free list */
+				Block *_free_prev { nullptr };
+
+				friend class Allocator_avl_base;
 
 				/**
 				 * Request max_avail value of subtree
@@ -166,9 +170,48 @@ class Genode::Allocator_avl_base : public Range_allocator
 
 	private:
 
+		/*
+		 * Free blocks are additionally kept in one list per power-of-two
+		 * size class. Small requests without alignment or range constraints
+		 * are served from these lists in constant time. All other requests
+		 * take the best-fit search through the AVL tree.
+		 */
+		enum {
+			NUM_SIZE_CLASSES   = 8*sizeof(addr_t),
+			FAST_FIT_MAX_ALIGN = sizeof(addr_t) == 8 ? 3 : 2,
+			FAST_FIT_MAX_SIZE  = 64*1024,
+		};
+
 		Avl_tree<Block> _addr_tree        { };  /* blocks sorted by base address */
 		Allocator      *_md_alloc { nullptr };  /* meta-data allocator           */
 		size_t          _md_entry_size  { 0 };  /* size of block meta-data entry */
+		Block          *_free_list[NUM_SIZE_CLASSES] { };
+		addr_t          _free_classes   { 0 };  /* bit n set if list n non-empty */
+
+		/**
+		 * Return size class of block, which is the index of its MSB
+		 */
+		static unsigned _size_class(size_t size) {
+			return 8*sizeof(size) - 1 - __builtin_clzl(size); }
+
+		/**
+		 * Enqueue free block into the list of its size class
+		 */
+		void _insert_free(Block *b);
+
+		/**
+		 * Dequeue free block from the list of its size class
+		 */
+		void _remove_free(Block *b);
+
+		/**
+		 * Find free block starting at an address with the given alignment
+		 * and holding at least 'size' bytes by looking at the heads of the
+		 * size-class lists only
+		 *
+		 * \return  matching block or nullptr if the fast path failed
+		 */
+		Block *_find_fast_fit(size_t size, unsigned align);
 
 		/**
 		 * Alloc meta-data block
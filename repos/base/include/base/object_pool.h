@@ -16,34 +16,40 @@
 #ifndef _INCLUDE__BASE__OBJECT_POOL_H_
 #define _INCLUDE__BASE__OBJECT_POOL_H_
 
-#include <util/avl_tree.h>
 #include <util/noncopyable.h>
 #include <base/capability.h>
 #include <base/weak_ptr.h>
 
-namespace Genode { template <typename> class Object_pool; }
+namespace Genode { template <typename, unsigned = 8> class Object_pool; }
 
 
 /**
  * Map capabilities to local objects
  *
- * \param OBJ_TYPE  object type (must be inherited from Object_pool::Entry)
+ * \param OBJ_TYPE     object type (must be inherited from Object_pool::Entry)
+ * \param BUCKET_BITS  log2 of the number of hash buckets
  *
  * The local names of a capabilities are used to differentiate multiple server
  * objects managed by one and the same object pool.
+ *
+ * The entries are kept in a hash table with chained buckets. Each bucket is
+ * protected by one of a few locks. Hence, the costs of a lookup are
+ * independent from the number of entries, and concurrent lookups contend
+ * only if their buckets share the same lock.
+ *
+ * The bucket table is part of the pool object. Pools that exist once per
+ * session, e.g., within core, should use a small number of buckets.
  */
-template <typename OBJ_TYPE>
+template <typename OBJ_TYPE, unsigned BUCKET_BITS>
 class Genode::Object_pool : Interface, Noncopyable
 {
 	public:
 
-		class Entry : Avl_node<Entry>
+		class Entry
 		{
 			private:
 
 				friend class Object_pool;
-				friend class Avl_tree<Entry>;
-				friend class Avl_node<Entry>;
 
 				struct Entry_lock : Weak_object<Entry_lock>, Noncopyable
 				{
@@ -57,8 +63,16 @@ class Genode::Object_pool : Interface, Noncopyable
 				Untyped_capability _cap  { };
 				Entry_lock         _lock { *this };
 
+				Entry *_next { nullptr };  /* next entry of the same bucket */
+
 				inline unsigned long _obj_id() { return _cap.local_name(); }
 
+				/*
+				 * Noncopyable
+				 */
+				Entry(Entry const &);
+				Entry &operator = (Entry const &);
+
 			public:
 
 				Entry() { }
@@ -66,24 +80,6 @@ class Genode::Object_pool : Interface, Noncopyable
 
 				virtual ~Entry() { }
 
-				/**
-				 * Avl_node interface
-				 */
-				bool higher(Entry *e) { return e->_obj_id() > _obj_id(); }
-				void recompute() { }  /* for gcc-3.4 compatibility */
-
-				/**
-				 * Support for object pool
-				 */
-				Entry *find_by_obj_id(unsigned long obj_id)
-				{
-					if (obj_id == _obj_id()) return this;
-
-					Entry *obj = this->child(obj_id > _obj_id());
-
-					return obj ? obj->find_by_obj_id(obj_id) : 0;
-				}
-
 				/**
 				 * Assign capability to object pool entry
 				 */
@@ -94,29 +90,80 @@ class Genode::Object_pool : Interface, Noncopyable
 
 	private:
 
-		Avl_tree<Entry> _tree { };
-		Lock            _lock { };
+		static_assert(BUCKET_BITS > 0 && BUCKET_BITS <= 12,
+		              "invalid number of object-pool buckets");
+
+		/* one lock per 16 buckets, but at most 16 locks */
+		enum { NUM_BUCKETS = 1 << BUCKET_BITS,
+		       NUM_LOCKS   = NUM_BUCKETS >= 256 ? 16
+		                   : NUM_BUCKETS >= 16  ? NUM_BUCKETS / 16 : 1 };
+
+		Entry *_buckets[NUM_BUCKETS] { };
+		Lock   _locks[NUM_LOCKS];
+
+		/**
+		 * Return bucket index of object ID
+		 *
+		 * Multiplicative hashing spreads consecutive as well as aligned IDs
+		 * evenly over the buckets.
+		 */
+		static unsigned _bucket(unsigned long obj_id)
+		{
+			unsigned long const factor = sizeof(unsigned long) == 8
+			                           ? (unsigned long)0x9e3779b97f4a7c15ULL
+			                           : (unsigned long)0x9e3779b9UL;
+
+			return (unsigned)((obj_id*factor) >> (8*sizeof(unsigned long) - BUCKET_BITS));
+		}
+
+		Lock &_bucket_lock(unsigned bucket) { return _locks[bucket % NUM_LOCKS]; }
+
+		/**
+		 * Unlink entry from its bucket, called with the bucket lock held
+		 */
+		void _unlink(unsigned bucket, Entry &entry)
+		{
+			for (Entry **e = &_buckets[bucket]; *e; e = &(*e)->_next)
+				if (*e == &entry) {
+					*e = entry._next;
+					entry._next = nullptr;
+					return;
+				}
+		}
 
 	protected:
 
 		bool empty()
 		{
-			Lock::Guard lock_guard(_lock);
-			return _tree.first() == nullptr;
+			for (unsigned i = 0; i < NUM_BUCKETS; i++) {
+				Lock::Guard lock_guard(_bucket_lock(i));
+				if (_buckets[i])
+					return false;
+			}
+			return true;
 		}
 
 	public:
 
 		void insert(OBJ_TYPE *obj)
 		{
-			Lock::Guard lock_guard(_lock);
-			_tree.insert(obj);
+			Entry &entry = *obj;
+
+			unsigned const bucket = _bucket(entry._obj_id());
+
+			Lock::Guard lock_guard(_bucket_lock(bucket));
+			entry._next      = _buckets[bucket];
+			_buckets[bucket] = &entry;
 		}
 
 		void remove(OBJ_TYPE *obj)
 		{
-			Lock::Guard lock_guard(_lock);
-			_tree.remove(obj);
+			Entry &entry = *obj;
+
+			unsigned const bucket = _bucket(entry._obj_id());
+
+			Lock::Guard lock_guard(_bucket_lock(bucket));
+			_unlink(bucket, entry);
 		}
 
 		template <typename FUNC>
@@ -131,10 +178,13 @@ class Genode::Object_pool : Interface, Noncopyable
 			Weak_ptr ptr;
 
 			{
-				Lock::Guard lock_guard(_lock);
+				unsigned const bucket = _bucket(capid);
+
+				Lock::Guard lock_guard(_bucket_lock(bucket));
 
-				Entry * entry = _tree.first() ?
-					_tree.first()->find_by_obj_id(capid) : nullptr;
+				Entry *entry = _buckets[bucket];
+				while (entry && entry->_obj_id() != capid)
+					entry = entry->_next;
 
 				if (entry) ptr = entry->_lock.weak_ptr();
 			}
@@ -160,20 +210,25 @@ class Genode::Object_pool : Interface, Noncopyable
 			using Weak_ptr   = Weak_ptr<typename Entry::Entry_lock>;
 			using Locked_ptr = Locked_ptr<typename Entry::Entry_lock>;
 
-			for (;;) {
+			for (unsigned bucket = 0; bucket < NUM_BUCKETS; ) {
 				OBJ_TYPE * obj;
 
 				{
-					Lock::Guard lock_guard(_lock);
+					Lock::Guard lock_guard(_bucket_lock(bucket));
+
+					if (!_buckets[bucket]) {
+						bucket++;
+						continue;
+					}
 
-					if (!((obj = (OBJ_TYPE*) _tree.first()))) return;
+					obj = (OBJ_TYPE *)_buckets[bucket];
 
 					Weak_ptr ptr = obj->_lock.weak_ptr();
 					{
 						Locked_ptr lock_ptr(ptr);
 						if (!lock_ptr.valid()) return;
 
-						_tree.remove(obj);
+						_unlink(bucket, *obj);
 					}
 				}
 
@@ -17,37 +17,67 @@
 #include <base/stdint.h>
 #include <cpu_session/cpu_session.h>
 
-namespace Genode { namespace Trace { class Buffer; } }
+namespace Genode { namespace Trace {
+
+	class Buffer;
+	class Buffer_reader;
+} }
 
 
 /**
  * Buffer shared between CPU client thread and TRACE client
+ *
+ * The buffer is written by a single thread, the traced thread, and read by
+ * the TRACE client without any synchronization between both. Each entry
+ * carries a sequence number, which enables the reader to detect entries
+ * that were overwritten before the reader got hold of them.
  */
 class Genode::Trace::Buffer
 {
 	private:
 
+		friend class Buffer_reader;
+
 		unsigned volatile _head_offset;  /* in bytes, relative to 'entries' */
 		unsigned volatile _size;         /* in bytes */
 		unsigned volatile _wrapped;      /* count of buffer wraps */
+		unsigned          _sequence;     /* sequence number of next entry */
 
 		struct _Entry
 		{
-			size_t len;
-			char   data[0];
+			unsigned len;
+			unsigned seq;
+			char     data[0];
 		};
 
 		_Entry _entries[0];
 
+		/**
+		 * Return space occupied by the data of an entry
+		 *
+		 * Entries are kept aligned so that the length can be updated
+		 * atomically.
+		 */
+		static size_t _padded(size_t len) {
+			return (len + sizeof(unsigned) - 1) & ~(sizeof(unsigned) - 1); }
+
 		_Entry *_head_entry() { return (_Entry *)((addr_t)_entries + _head_offset); }
 
+		_Entry const *_entry_at(size_t offset) const
+		{
+			if (offset + sizeof(_Entry) > _size)
+				return nullptr;
+
+			return (_Entry const *)((addr_t)_entries + offset);
+		}
+
 		void _buffer_wrapped()
 		{
 			_head_offset = 0;
 			_wrapped++;
 
 			/* mark first entry with len 0 */
-			_head_entry()->len = 0;
+			__atomic_store_n(&_head_entry()->len, 0, __ATOMIC_RELEASE);
 		}
 
 		/*
@@ -68,9 +98,12 @@ class Genode::Trace::Buffer
 			/* compute number of bytes available for tracing data */
 			size_t const header_size = (addr_t)&_entries - (addr_t)this;
 
-			_size = size - header_size;
+			_size = (size - header_size) & ~(sizeof(unsigned) - 1);
+
+			_wrapped  = 0;
+			_sequence = 0;
 
-			_wrapped = 0;
+			_head_entry()->len = 0;
 		}
 
 		char *reserve(size_t len)
@@ -80,7 +113,7 @@ class Genode::Trace::Buffer
 
 			/* mark last entry with len 0 and wrap */
 			if (_head_offset + sizeof(_Entry) <= _size)
-				_head_entry()->len = 0;
+				__atomic_store_n(&_head_entry()->len, 0, __ATOMIC_RELEASE);
 
 			_buffer_wrapped();
 
@@ -93,16 +126,24 @@ class Genode::Trace::Buffer
 			if (len == 0)
 				return;
 
-			_head_entry()->len = len;
+			_Entry &entry = *_head_entry();
+			entry.seq = _sequence;
 
 			/* advance head offset, wrap when reaching buffer boundary */
-			_head_offset += sizeof(_Entry) + len;
+			_head_offset += sizeof(_Entry) + _padded(len);
+
+			/*
+			 * Mark the entry next to the new entry with len 0 before the
+			 * new entry becomes visible to the reader
+			 */
+			if (_head_offset + sizeof(_Entry) <= _size)
+				__atomic_store_n(&_head_entry()->len, 0, __ATOMIC_RELEASE);
+
+			__atomic_store_n(&entry.len, (unsigned)len, __ATOMIC_RELEASE);
+			__atomic_store_n(&_sequence, _sequence + 1, __ATOMIC_RELEASE);
+
 			if (_head_offset == _size)
 				_buffer_wrapped();
-
-			/* mark entry next to new entry with len 0 */
-			else if (_head_offset + sizeof(_Entry) <= _size)
-				_head_entry()->len = 0;
 		}
 
 		unsigned wrapped() const { return _wrapped; }
@@ -119,6 +160,7 @@ class Genode::Trace::Buffer
 				_Entry const *_entry;
 
 				friend class Buffer;
+				friend class Buffer_reader;
 
 				Entry(_Entry const *entry) : _entry(entry) { }
 
@@ -127,6 +169,14 @@ class Genode::Trace::Buffer
 				size_t      length() const { return _entry->len; }
 				char const *data()   const { return _entry->data; }
 
+				/**
+				 * Return sequence number of the entry
+				 *
+				 * The entries of a buffer are numbered consecutively in
+				 * the order of their commit, starting with 0.
+				 */
+				unsigned sequence() const { return _entry->seq; }
+
 				/*
 				 * XXX The meaning of this method is irritating.
 				 *
@@ -175,12 +225,121 @@ class Genode::Trace::Buffer
 			if (entry.length() == 0)
 				return Entry(0);
 
-			addr_t const offset = (addr_t)entry._entry - (addr_t)_entries;
-			if (offset + entry.length() + sizeof(_Entry) > _size)
-				return Entry(0);
+			addr_t const offset = (addr_t)entry._entry - (addr_t)_entries
+			                    + sizeof(_Entry) + _padded(entry.length());
+
+			_Entry const * const next = _entry_at(offset);
+
+			return Entry(next && next->len ? next : 0);
+		}
+
+		/**
+		 * Return number of entries committed so far
+		 *
+		 * The value wraps at the range of 'unsigned'.
+		 */
+		unsigned sequence() const {
+			return __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE); }
+};
+
 
-			return Entry((_Entry const *)((addr_t)entry.data() + entry.length()));
+/**
+ * Reader that consumes the entries of a buffer in commit order
+ *
+ * In contrast to the iteration via 'Buffer::first' and 'Buffer::next', the
+ * reader keeps track of the entries consumed so far. Entries that were
+ * overwritten by the traced thread before being consumed are not silently
+ * skipped but accounted as lost.
+ */
+class Genode::Trace::Buffer_reader
+{
+	private:
+
+		typedef Buffer::_Entry _Entry;
+
+		Buffer const &_buffer;
+
+		size_t             _offset   = 0;  /* offset of next entry */
+		unsigned           _expected = 0;  /* sequence number of next entry */
+		unsigned           _lost     = 0;  /* lost entries not yet reported */
+		unsigned long long _lost_total = 0;
+
+		/*
+		 * Noncopyable
+		 */
+		Buffer_reader(Buffer_reader const &);
+		Buffer_reader &operator = (Buffer_reader const &);
+
+	public:
+
+		Buffer_reader(Buffer const &buffer) : _buffer(buffer) { }
+
+		/**
+		 * Call functor for each entry that was not consumed yet
+		 *
+		 * \param fn           functor called with the 'Buffer::Entry' and
+		 *                     the number of entries lost right before the
+		 *                     entry
+		 * \param max_entries  maximum number of entries to consume
+		 *
+		 * \return number of consumed entries
+		 *
+		 * The functor accesses the entry data directly within the buffer.
+		 * Hence, the data may get overwritten by the traced thread while
+		 * being processed if the reader falls behind by a whole buffer.
+		 */
+		template <typename FN>
+		unsigned for_each_new_entry(FN const &fn, unsigned max_entries = ~0U)
+		{
+			unsigned count = 0;
+
+			while (count < max_entries && _buffer.sequence() != _expected) {
+
+				_Entry const *e = _buffer._entry_at(_offset);
+				unsigned len = e ? __atomic_load_n(&e->len, __ATOMIC_ACQUIRE) : 0;
+
+				/* end of entries in memory order, continue at the buffer start */
+				if (!len && _offset) {
+					_offset = 0;
+					continue;
+				}
+
+				/* traced thread is about to overwrite the buffer start */
+				if (!len)
+					break;
+
+				unsigned const seq = e->seq;
+				if (seq != _expected) {
+
+					/* entry was overwritten, the buffer start holds the oldest entries */
+					if (_offset) {
+						_offset = 0;
+						continue;
+					}
+
+					/* not an entry of the current sequence */
+					if ((int)(seq - _expected) < 0)
+						break;
+
+					_lost     += seq - _expected;
+					_expected  = seq;
+				}
+
+				fn(Buffer::Entry(e), _lost);
+
+				_lost_total += _lost;
+				_lost        = 0;
+				_offset     += sizeof(_Entry) + Buffer::_padded(len);
+				_expected++;
+				count++;
+			}
+			return count;
 		}
+
+		/**
+		 * Return total number of lost entries reported so far
+		 */
+		unsigned long long lost() const { return _lost_total; }
 };
 
 #endif /* _INCLUDE__BASE__TRACE__BUFFER_H_ */
@@ -64,6 +64,42 @@ namespace Genode {
 			              :: "r3");
 		return size;
 	}
+
+	/**
+	 * Fill memory block with zeros
+	 *
+	 * \param dst   destination memory block
+	 * \param size  number of bytes to clear
+	 *
+	 * \return      number of bytes not cleared
+	 *
+	 * Word-aligned blocks are cleared in chunks of 32 bytes via
+	 * store-multiple instructions.
+	 */
+	inline size_t memclear_cpu(void *dst, size_t size)
+	{
+		unsigned char *d = (unsigned char *)dst;
+
+		if (size < 32 || ((unsigned long)d & 0x3))
+			return size;
+
+		size_t chunks = size / 32;
+		asm volatile ("mov  r3, #0            \n\t"
+		              "mov  r4, #0            \n\t"
+		              "mov  r5, #0            \n\t"
+		              "mov  r6, #0            \n\t"
+		              "mov  r7, #0            \n\t"
+		              "mov  r8, #0            \n\t"
+		              "mov  r9, #0            \n\t"
+		              "mov  r10, #0           \n\t"
+		              "1:                     \n\t"
+		              "stmia %0!, {r3 - r10}  \n\t"
+		              "subs  %1, %1, #1       \n\t"
+		              "bne   1b               \n\t"
+		              : "+r" (d), "+r" (chunks)
+		              :: "r3","r4","r5","r6","r7","r8","r9","r10", "cc", "memory");
+		return size % 32;
+	}
 }
 
 #endif /* _INCLUDE__SPEC__ARM__VFP__CPU__STRING_H_ */
@@ -26,6 +26,50 @@ namespace Genode {
 	 * \return      number of bytes not copied
 	 */
 	inline size_t memcpy_cpu(void *, const void *, size_t size) { return size; }
+
+
+	/**
+	 * Fill memory block with zeros
+	 *
+	 * \param dst   destination memory block
+	 * \param size  number of bytes to clear
+	 *
+	 * \return      number of bytes not cleared
+	 *
+	 * On x86_64, blocks of at least 64 bytes are cleared via non-temporal
+	 * stores, which bypass the cache. Hence, clearing large blocks does not
+	 * evict the working set from the cache. On x86_32, where the
+	 * non-temporal store instruction (SSE2) cannot be assumed, the words are
+	 * cleared via the string-store instruction. The remaining bytes are left
+	 * to the generic 'memset'.
+	 */
+	inline size_t memclear_cpu(void *dst, size_t size)
+	{
+		enum { MIN_SIZE = 64 };
+
+		if (size < MIN_SIZE || ((unsigned long)dst & (sizeof(long) - 1)))
+			return size;
+
+#ifdef __x86_64__
+		size_t chunks = size / 32;
+		asm volatile ("1:                \n\t"
+		              "movnti %2,  0(%0) \n\t"
+		              "movnti %2,  8(%0) \n\t"
+		              "movnti %2, 16(%0) \n\t"
+		              "movnti %2, 24(%0) \n\t"
+		              "add    $32, %0    \n\t"
+		              "dec    %1         \n\t"
+		              "jnz    1b         \n\t"
+		              "sfence            \n\t"
+		              : "+r" (dst), "+r" (chunks) : "r" (0UL) : "cc", "memory");
+		return size % 32;
+#else
+		size_t words = size / sizeof(long);
+		asm volatile ("rep stosl"
+		              : "+D" (dst), "+c" (words) : "a" (0) : "memory");
+		return size % sizeof(long);
+#endif
+	}
 }
 
 #endif /* _INCLUDE__SPEC__X86__CPU__STRING_H_ */
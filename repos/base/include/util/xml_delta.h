@@ -0,0 +1,297 @@
+/*
+ * \brief  Incremental updates of generated XML data
+ * \author Genode Labs
+ * \date   2018-12-09
+ *
+ * Reports are usually regenerated as a whole whenever any part of them
+ * changes. An XML delta describes a new version of a node relative to its
+ * previous version, carrying only the sub nodes that changed. Unchanged
+ * sub nodes are referred to by their position within the previous version.
+ *
+ * A delta has the same type as the described node and carries its
+ * attributes. It is marked by the 'xml_delta_base' attribute, which holds
+ * the checksum of the previous version. Its sub nodes are either new or
+ * changed sub nodes, or 'xml_delta_copy' nodes that refer to a range of
+ * sub nodes of the previous version:
+ *
+ * ! <state xml_delta_base="4026411921" version="3">
+ * !   <xml_delta_copy from="0" count="12"/>
+ * !   <child name="nic_drv" state="incomplete"/>
+ * !   <xml_delta_copy from="13" count="20"/>
+ * ! </state>
+ *
+ * The application of a delta reproduces the new version byte by byte.
+ * This is the case if the new version is formatted like the output of
+ * the 'Xml_generator' and consists of sub nodes only, which is checked
+ * by 'Xml_delta::representable'.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__UTIL__XML_DELTA_H_
+#define _INCLUDE__UTIL__XML_DELTA_H_
+
+#include <util/xml_node.h>
+#include <util/xml_generator.h>
+
+namespace Genode { struct Xml_delta; }
+
+
+struct Genode::Xml_delta
+{
+	/**
+	 * Exception type
+	 *
+	 * Thrown if a delta does not refer to the given previous version.
+	 */
+	class Invalid_delta : public Exception { };
+
+	typedef unsigned Checksum;
+
+	static char const *base_attr() { return "xml_delta_base"; }
+	static char const *copy_type() { return "xml_delta_copy"; }
+
+	/**
+	 * Return checksum of the data of 'node'
+	 */
+	static Checksum checksum(Xml_node const &node)
+	{
+		Checksum result = 2166136261U;
+		node.with_raw_node([&] (char const *start, size_t len) {
+			for (size_t i = 0; i < len; i++)
+				result = (result ^ (unsigned char)start[i])*16777619U; });
+		return result;
+	}
+
+	/**
+	 * Return true if the data at 'src' is an XML delta
+	 *
+	 * Only the start tag is inspected. Because attribute values never
+	 * contain unescaped quotes or angle brackets, the first '>' ends the
+	 * start tag.
+	 */
+	static bool delta(char const *src, size_t len)
+	{
+		char const * const attr = base_attr();
+		size_t       const attr_len = strlen(attr);
+
+		size_t i = 0;
+		for (; i < len && is_whitespace(src[i]); i++);
+
+		if (i == len || src[i] != '<')
+			return false;
+
+		for (; i < len && src[i] != '>'; i++)
+			if (src[i] == ' ' && len - i > attr_len + 2
+			 && !strcmp(src + i + 1, attr, attr_len) && src[i + 1 + attr_len] == '=')
+				return true;
+
+		return false;
+	}
+
+	/**
+	 * Return true if 'node' can be reproduced from a delta
+	 */
+	static bool representable(Xml_node const &node)
+	{
+		char const *start = nullptr;
+		size_t      len   = 0;
+		node.with_raw_node([&] (char const *s, size_t l) { start = s; len = l; });
+
+		/* start tag as generated with the attributes of the node */
+		size_t tag_len = 1 + strlen(node.type().string());
+		try {
+			for (Xml_attribute a = node.attribute(0U); ; a = a.next())
+				tag_len += 1 + strlen(a.name().string()) + 2 + a.value_size() + 1;
+		} catch (Xml_attribute::Nonexistent_attribute) { }
+
+		if (node.num_sub_nodes() == 0)
+			return node.content_size() == 0 && len == tag_len + 2
+			    && !strcmp(start + tag_len, "/>", 2);
+
+		if (node.content_base() != start + tag_len + 1)
+			return false;
+
+		/* sub nodes, each at a fresh line, indented by one level more */
+		char const *expected = node.content_base();
+		unsigned    indent   = 0;
+		for (char const *s = start; s > node.addr() && s[-1] == '\t'; s--)
+			indent++;
+
+		bool result = true;
+		node.for_each_sub_node([&] (Xml_node const &sub_node) {
+			sub_node.with_raw_node([&] (char const *s, size_t l) {
+
+				size_t const gap = 1 + indent + 1;
+
+				if (s != expected + gap || expected[0] != '\n')
+					result = false;
+
+				for (size_t i = 1; i < gap; i++)
+					if (expected[i] != '\t')
+						result = false;
+
+				expected = s + l; }); });
+
+		/* end tag at a fresh line */
+		return result && expected[0] == '\n'
+		    && expected + 1 + indent == node.content_base() + node.content_size();
+	}
+
+	/**
+	 * Generate delta of 'curr' relative to 'prev'
+	 *
+	 * \param xml            generator positioned at a node of the type of
+	 *                       'curr'
+	 * \param prev_checksum  checksum of 'prev'
+	 *
+	 * The attributes and content of the generated node form the delta.
+	 * Sub nodes of 'curr' are matched against the sub nodes of 'prev' in
+	 * order. Sub nodes of the same type and the same 'name' attribute are
+	 * considered as the same sub node, which lets a changed sub node
+	 * replace its previous version and a removed sub node be skipped.
+	 */
+	static void generate(Xml_generator &xml, Xml_node const &prev,
+	                     Xml_node const &curr, Checksum prev_checksum)
+	{
+		xml.attribute(base_attr(), prev_checksum);
+
+		try {
+			for (Xml_attribute a = curr.attribute(0U); ; a = a.next())
+				xml.attribute(a.name().string(), a.value_base(), a.value_size());
+		} catch (Xml_attribute::Nonexistent_attribute) { }
+
+		unsigned const num_prev = prev.num_sub_nodes();
+
+		/* cursor at the next not yet consumed sub node of 'prev' */
+		Xml_node p   = num_prev ? prev.sub_node(0U) : prev;
+		unsigned idx = 0;
+
+		auto advance = [&] () { if (++idx < num_prev) p = p.next(); };
+
+		/* range of sub nodes of 'prev' to copy */
+		unsigned copy_from = 0, copy_count = 0;
+
+		auto flush = [&] ()
+		{
+			if (!copy_count)
+				return;
+
+			xml.node(copy_type(), [&] () {
+				xml.attribute("from",  copy_from);
+				xml.attribute("count", copy_count); });
+
+			copy_count = 0;
+		};
+
+		curr.for_each_sub_node([&] (Xml_node const &c) {
+
+			/* skip previous sub node if it was removed */
+			if (idx + 1 < num_prev && !_same_node(p, c) && _same_node(p.next(), c))
+				advance();
+
+			if (idx < num_prev && _equal(p, c)) {
+
+				if (copy_count && copy_from + copy_count != idx)
+					flush();
+
+				if (!copy_count)
+					copy_from = idx;
+
+				copy_count++;
+				advance();
+				return;
+			}
+
+			flush();
+
+			c.with_raw_node([&] (char const *start, size_t len) {
+				xml.append_node(start, len); });
+
+			/* changed sub node replaces its previous version */
+			if (idx < num_prev && _same_node(p, c))
+				advance();
+		});
+
+		flush();
+	}
+
+	/**
+	 * Reproduce the node described by 'delta' from its previous version
+	 *
+	 * \param xml  generator positioned at a node of the type of 'delta'
+	 *
+	 * \throw Invalid_delta
+	 */
+	static void apply(Xml_generator &xml, Xml_node const &prev,
+	                  Xml_node const &delta)
+	{
+		if (delta.attribute_value(base_attr(), 0U) != checksum(prev))
+			throw Invalid_delta();
+
+		try {
+			for (Xml_attribute a = delta.attribute(0U); ; a = a.next())
+				if (!a.has_type(base_attr()))
+					xml.attribute(a.name().string(), a.value_base(), a.value_size());
+		} catch (Xml_attribute::Nonexistent_attribute) { }
+
+		unsigned const num_prev = prev.num_sub_nodes();
+
+		Xml_node p   = num_prev ? prev.sub_node(0U) : prev;
+		unsigned idx = 0;
+
+		delta.for_each_sub_node([&] (Xml_node const &d) {
+
+			auto append = [&] (Xml_node const &node) {
+				node.with_raw_node([&] (char const *start, size_t len) {
+					xml.append_node(start, len); }); };
+
+			if (!d.has_type(copy_type())) {
+				append(d);
+				return;
+			}
+
+			unsigned const from  = d.attribute_value("from",  0U);
+			unsigned const count = d.attribute_value("count", 0U);
+
+			if (!count || from < idx || from + count > num_prev || from + count < from)
+				throw Invalid_delta();
+
+			for (; idx < from; idx++)
+				p = p.next();
+
+			for (unsigned i = 0; i < count; i++, idx++) {
+				append(p);
+				if (idx + 1 < num_prev)
+					p = p.next();
+			}
+		});
+	}
+
+	private:
+
+		static bool _equal(Xml_node const &a, Xml_node const &b)
+		{
+			bool result = false;
+			a.with_raw_node([&] (char const *a_start, size_t a_len) {
+				b.with_raw_node([&] (char const *b_start, size_t b_len) {
+					result = (a_len == b_len)
+					      && !memcmp(a_start, b_start, a_len); }); });
+			return result;
+		}
+
+		static bool _same_node(Xml_node const &a, Xml_node const &b)
+		{
+			typedef String<128> Name;
+
+			return a.type() == b.type()
+			    && a.attribute_value("name", Name()) == b.attribute_value("name", Name());
+		}
+};
+
+#endif /* _INCLUDE__UTIL__XML_DELTA_H_ */
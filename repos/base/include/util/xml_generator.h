@@ -226,21 +226,27 @@ class Genode::Xml_generator
 
 			public:
 
-				void insert_attribute(char const *name, char const *value)
+				void insert_attribute(char const *name, char const *value,
+				                      size_t const value_len)
 				{
 					/* ' ' + name + '=' + '"' + value + '"' */
-					size_t const gap = 1 + strlen(name) + 1 + 1 + strlen(value) + 1;
+					size_t const gap = 1 + strlen(name) + 1 + 1 + value_len + 1;
 
 					Out_buffer dst = _out_buffer.insert_gap(_attr_offset, gap);
 					dst.append(' ');
 					dst.append(name);
 					dst.append("=\"");
-					dst.append(value, strlen(value));
+					dst.append(value, value_len);
 					dst.append("\"");
 
 					_attr_offset += gap;
 				}
 
+				void insert_attribute(char const *name, char const *value)
+				{
+					insert_attribute(name, value, strlen(value));
+				}
+
 				void append(char const *src, size_t src_len)
 				{
 					Out_buffer content_buffer = _content_buffer(false);
@@ -255,6 +261,20 @@ class Genode::Xml_generator
 					_commit_content(content_buffer);
 				}
 
+				/**
+				 * Append sub node given as XML data
+				 *
+				 * \param indent  indentation level of the sub node
+				 */
+				void append_node(char const *src, size_t src_len,
+				                 unsigned const indent)
+				{
+					Out_buffer content_buffer = _content_buffer(true);
+					content_buffer.append('\t', indent);
+					content_buffer.append(src, src_len);
+					_commit_content(content_buffer);
+				}
+
 				template <typename FUNC>
 				Node(Xml_generator &xml, char const *name, FUNC const &func)
 				:
@@ -397,6 +417,18 @@ class Genode::Xml_generator
 			_curr_node->insert_attribute(name, buf.string());
 		}
 
+		/**
+		 * Add attribute with a value that is not null-terminated
+		 *
+		 * The value is inserted as is. Hence, it must not contain any
+		 * characters that need sanitizing, which is the case for
+		 * attribute values taken from existing XML data.
+		 */
+		void attribute(char const *name, char const *str, size_t str_len)
+		{
+			_curr_node->insert_attribute(name, str, str_len);
+		}
+
 		/**
 		 * Append content to XML node
 		 *
@@ -417,6 +449,22 @@ class Genode::Xml_generator
 			_curr_node->append_sanitized(str, str_len == ~0UL ? strlen(str) : str_len);
 		}
 
+		/**
+		 * Append sub node given as XML data
+		 *
+		 * The data is copied verbatim and indented like a sub node
+		 * generated via 'node'. It is expected to contain a single XML
+		 * node as generated by an 'Xml_generator' at the same depth,
+		 * which is the case for sub nodes of an 'Xml_node' obtained via
+		 * 'Xml_node::with_raw_node'.
+		 *
+		 * This method must not be followed by calls of 'attribute'.
+		 */
+		void append_node(char const *src, size_t src_len)
+		{
+			_curr_node->append_node(src, src_len, _curr_indent);
+		}
+
 		size_t used() const { return _out_buffer.used(); }
 };
 
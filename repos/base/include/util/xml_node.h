@@ -20,6 +20,7 @@
 namespace Genode {
 	class Xml_attribute;
 	class Xml_node;
+	class Xml_node_index;
 }
 
 
@@ -443,12 +444,44 @@ class Genode::Xml_node
 			}
 		};
 
+		friend class Xml_node_index;
+
+		/**
+		 * Pre-parsed structure of an XML node, see 'util/xml_node_index.h'
+		 *
+		 * The entries are stored in document order, the first entry refers
+		 * to the indexed node itself. The sub nodes of each entry are
+		 * listed consecutively in the 'sub_nodes' table.
+		 */
+		struct Index_table
+		{
+			struct Entry
+			{
+				size_t   addr;           /* offset of node, see 'addr()'   */
+				size_t   start;          /* offset of start tag            */
+				size_t   end;            /* offset of end tag, equals
+				                            'start' for empty-element tags */
+				unsigned parent;         /* entry of parent node           */
+				unsigned position;       /* position within parent node    */
+				unsigned num_sub_nodes;
+				unsigned sub_nodes;      /* first sub node in 'sub_nodes'  */
+			};
+
+			char     const *base;
+			size_t          max_len;
+			Entry          *entries;
+			unsigned       *sub_nodes;
+		};
+
 		const char *_addr;          /* first character of XML data      */
 		size_t      _max_len;       /* length of XML data in characters */
 		int         _num_sub_nodes; /* number of immediate sub nodes    */
 		Tag         _start_tag;
 		Tag         _end_tag;
 
+		Index_table const *_index    { nullptr }; /* optional index     */
+		unsigned           _index_id { 0 };       /* entry of this node */
+
 		/**
 		 * Search for end tag of XML node and initialize '_num_sub_nodes'
 		 *
@@ -565,6 +598,38 @@ class Genode::Xml_node
 			return Xml_node(at, _max_len - (at - addr()));
 		}
 
+		/**
+		 * Create node from index entry, without scanning the node content
+		 */
+		Xml_node(Index_table const &index, unsigned id)
+		:
+			_addr(index.base + index.entries[id].addr),
+			_max_len(index.max_len - index.entries[id].addr),
+			_num_sub_nodes(index.entries[id].num_sub_nodes),
+			_start_tag(Token(index.base + index.entries[id].start,
+			                 index.max_len - index.entries[id].start)),
+			_end_tag(index.entries[id].end == index.entries[id].start
+			         ? _start_tag
+			         : Tag(Token(index.base + index.entries[id].end,
+			                     index.max_len - index.entries[id].end))),
+			_index(&index), _index_id(id)
+		{ }
+
+		/**
+		 * Return sub node at position 'idx' of the indexed node 'id'
+		 *
+		 * \throw Nonexistent_sub_node
+		 */
+		Xml_node _indexed_sub_node(unsigned id, unsigned idx) const
+		{
+			Index_table::Entry const &entry = _index->entries[id];
+
+			if (idx >= entry.num_sub_nodes)
+				throw Nonexistent_sub_node();
+
+			return Xml_node(*_index, _index->sub_nodes[entry.sub_nodes + idx]);
+		}
+
 	public:
 
 		/**
@@ -638,6 +703,22 @@ class Genode::Xml_node
 		 */
 		size_t size() const { return _end_tag.next_token().start() - addr(); }
 
+		/**
+		 * Call functor 'fn' with the location of the node data
+		 *
+		 * In contrast to 'addr', the node data starts at the start tag,
+		 * excluding any text or comments preceding the node. The functor
+		 * is called with the pointer to the start tag and the length of
+		 * the data up to the end of the end tag.
+		 */
+		template <typename FN>
+		void with_raw_node(FN const &fn) const
+		{
+			char const * const start = _start_tag.token().start();
+
+			fn(start, (size_t)(_end_tag.next_token().start() - start));
+		}
+
 		/**
 		 * Return begin of node content as an opaque string
 		 *
@@ -720,6 +801,15 @@ class Genode::Xml_node
 		 */
 		Xml_node next() const
 		{
+			/*
+			 * The index covers the sub tree of the indexed node only. Hence,
+			 * the siblings of the indexed node itself are found by scanning.
+			 */
+			if (_index && _index_id) {
+				Index_table::Entry const &entry = _index->entries[_index_id];
+				return _indexed_sub_node(entry.parent, entry.position + 1);
+			}
+
 			Token after_node = _end_tag.next_token();
 			after_node = skip_non_tag_characters(after_node);
 			try { return _sub_node(after_node.start()); }
@@ -757,6 +847,9 @@ class Genode::Xml_node
 		 */
 		Xml_node sub_node(unsigned idx = 0U) const
 		{
+			if (_index)
+				return _indexed_sub_node(_index_id, idx);
+
 			if (_num_sub_nodes > 0) {
 
 				/* look up node at specified index */
@@ -778,6 +871,15 @@ class Genode::Xml_node
 		 */
 		Xml_node sub_node(const char *type) const
 		{
+			if (_index) {
+				for (unsigned i = 0; i < (unsigned)_num_sub_nodes; i++) {
+					Xml_node const node = _indexed_sub_node(_index_id, i);
+					if (node.has_type(type))
+						return node;
+				}
+				throw Nonexistent_sub_node();
+			}
+
 			if (_num_sub_nodes > 0) {
 
 				/* search for sub node of specified type */
@@ -0,0 +1,237 @@
+/*
+ * \brief  Pre-parsed index of the structure of an XML node
+ * \author Genode Labs
+ * \date   2018-12-08
+ *
+ * Each 'Xml_node' locates its end tag by scanning its content, which is
+ * repeated for each node created while traversing the XML data. The index
+ * records the location of all nodes of a sub tree in a single pass. Nodes
+ * obtained from the index refer to the index when accessing their sub
+ * nodes or siblings, which thereby takes constant time.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__UTIL__XML_NODE_INDEX_H_
+#define _INCLUDE__UTIL__XML_NODE_INDEX_H_
+
+#include <util/xml_node.h>
+#include <util/noncopyable.h>
+#include <base/allocator.h>
+
+namespace Genode { class Xml_node_index; }
+
+
+class Genode::Xml_node_index : Noncopyable
+{
+	private:
+
+		typedef Xml_node::Index_table Index_table;
+		typedef Index_table::Entry    Entry;
+		typedef Xml_node::Token       Token;
+		typedef Xml_node::Tag         Tag;
+		typedef Xml_node::Comment     Comment;
+
+		enum { INITIAL_CAPACITY = 64 };
+
+		Allocator &_alloc;
+
+		Index_table _table { nullptr, 0, nullptr, nullptr };
+
+		unsigned _num_entries { 0 };
+		unsigned _capacity    { 0 };
+
+		size_t _offset(Token t) const { return t.start() - _table.base; }
+
+		/**
+		 * Append entry for node at 'addr' with the start tag at 'start'
+		 *
+		 * \throw Out_of_ram
+		 */
+		unsigned _append(size_t addr, size_t start, unsigned parent)
+		{
+			if (_num_entries == _capacity) {
+
+				unsigned const capacity = _capacity ? 2*_capacity
+				                                    : (unsigned)INITIAL_CAPACITY;
+
+				Entry *entries = (Entry *)_alloc.alloc(capacity*sizeof(Entry));
+
+				if (_table.entries) {
+					memcpy(entries, _table.entries, _num_entries*sizeof(Entry));
+					_alloc.free(_table.entries, _capacity*sizeof(Entry));
+				}
+				_table.entries = entries;
+				_capacity      = capacity;
+			}
+
+			unsigned const id = _num_entries++;
+
+			unsigned const position = id ? _table.entries[parent].num_sub_nodes++ : 0;
+
+			_table.entries[id] = Entry { addr, start, start, parent, position, 0, 0 };
+			return id;
+		}
+
+		/**
+		 * Record all nodes of the sub tree in document order
+		 *
+		 * \throw Xml_node::Invalid_syntax
+		 */
+		void _scan(Xml_node const &node)
+		{
+			unsigned curr = _append(0, _offset(node._start_tag.token()), 0);
+
+			if (node._start_tag.type() != Tag::START)
+				return;
+
+			/*
+			 * Like with 'Xml_node::sub_node', the address of the first sub
+			 * node is the begin of the content of its parent. As with
+			 * 'Xml_node::next', any other node starts with its start tag.
+			 */
+			size_t content = _offset(node._start_tag.next_token());
+
+			for (Token t = node._start_tag.next_token(); t.type() != Token::END; ) {
+
+				/* eat XML comment */
+				Comment const comment(t);
+				if (comment.valid()) {
+					t = comment.next_token();
+					continue;
+				}
+
+				/* skip all tokens that are no tags */
+				Tag const tag(t);
+				if (tag.type() == Tag::INVALID) {
+					t = t.next();
+					continue;
+				}
+
+				if (tag.node()) {
+					size_t const start = _offset(tag.token());
+					size_t const addr  = _table.entries[curr].num_sub_nodes
+					                   ? start : content;
+
+					unsigned const id = _append(addr, start, curr);
+					if (tag.type() == Tag::START) {
+						curr    = id;
+						content = _offset(tag.next_token());
+					}
+				}
+
+				if (tag.type() == Tag::END) {
+
+					/* end tag must match the start tag of the current node */
+					Token const start_name =
+						Tag(Token(_table.base + _table.entries[curr].start,
+						          _table.max_len - _table.entries[curr].start)).name();
+
+					if (start_name.len() != tag.name().len()
+					 || strcmp(start_name.start(), tag.name().start(), start_name.len()))
+						throw Xml_node::Invalid_syntax();
+
+					_table.entries[curr].end = _offset(tag.token());
+
+					/* end of indexed node */
+					if (curr == 0)
+						return;
+
+					curr = _table.entries[curr].parent;
+				}
+
+				t = tag.next_token();
+			}
+
+			throw Xml_node::Invalid_syntax();
+		}
+
+		/**
+		 * Lay out the sub nodes of each entry consecutively
+		 *
+		 * \throw Out_of_ram
+		 */
+		void _init_sub_nodes()
+		{
+			/* the indexed node is no sub node */
+			unsigned const num = _num_entries - 1;
+			if (num == 0)
+				return;
+
+			_table.sub_nodes = (unsigned *)_alloc.alloc(num*sizeof(unsigned));
+
+			unsigned first = 0;
+			for (unsigned i = 0; i < _num_entries; i++) {
+				_table.entries[i].sub_nodes = first;
+				first += _table.entries[i].num_sub_nodes;
+			}
+
+			for (unsigned i = 1; i < _num_entries; i++) {
+				Entry const &entry = _table.entries[i];
+				_table.sub_nodes[_table.entries[entry.parent].sub_nodes
+				                 + entry.position] = i;
+			}
+		}
+
+		void _free()
+		{
+			if (_table.entries)
+				_alloc.free(_table.entries, _capacity*sizeof(Entry));
+
+			if (_table.sub_nodes)
+				_alloc.free(_table.sub_nodes, (_num_entries - 1)*sizeof(unsigned));
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param alloc  allocator used for the index tables
+		 * \param node   XML node to index
+		 *
+		 * \throw Out_of_ram
+		 * \throw Out_of_caps
+		 * \throw Xml_node::Invalid_syntax  the sub tree is malformed
+		 *
+		 * The index refers to the XML data of 'node', which must remain
+		 * unchanged during the lifetime of the index.
+		 */
+		Xml_node_index(Allocator &alloc, Xml_node const &node)
+		:
+			_alloc(alloc)
+		{
+			_table.base    = node.addr();
+			_table.max_len = node._max_len;
+
+			try {
+				_scan(node);
+				_init_sub_nodes();
+			} catch (...) {
+				_free();
+				throw;
+			}
+		}
+
+		~Xml_node_index() { _free(); }
+
+		/**
+		 * Return indexed XML node
+		 *
+		 * The returned node and all nodes obtained from it must not be
+		 * used after the index is destructed.
+		 */
+		Xml_node xml() const { return Xml_node(_table, 0); }
+
+		/**
+		 * Return number of nodes of the indexed sub tree
+		 */
+		unsigned num_nodes() const { return _num_entries; }
+};
+
+#endif /* _INCLUDE__UTIL__XML_NODE_INDEX_H_ */
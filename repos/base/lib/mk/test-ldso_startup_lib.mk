@@ -0,0 +1,4 @@
+SRC_CC     = lib.cc
+SHARED_LIB = yes
+
+vpath lib.cc $(REP_DIR)/src/test/ldso_startup
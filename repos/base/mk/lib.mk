@@ -234,6 +234,10 @@ STATIC_LIBS_BRIEF := $(subst $(LIB_CACHE_DIR),$$libs,$(STATIC_LIBS))
 # constructing static objects must be specified as object file to prevent the
 # linker from garbage-collecting it.
 #
+# Besides the SysV hash table, the GNU-style hash table is generated, which
+# the dynamic linker prefers because its Bloom filter rules out most of the
+# objects that lack a looked-up symbol.
+#
 
 #
 # Default entry point of shared libraries
@@ -245,6 +249,7 @@ $(LIB_SO) $(ABI_SO): $(SHARED_LIBS)
 $(LIB_SO): $(STATIC_LIBS) $(OBJECTS) $(wildcard $(LD_SCRIPT_SO)) $(LIB_SO_DEPS)
 	$(MSG_MERGE)$(LIB_SO)
 	$(VERBOSE)libs=$(LIB_CACHE_DIR); $(LD) -o $(LIB_SO) -shared --eh-frame-hdr \
+	                --hash-style=both \
 	                $(LD_OPT) -T $(LD_SCRIPT_SO) --entry=$(ENTRY_POINT) \
 	                --whole-archive --start-group \
 	                $(SHARED_LIBS) $(STATIC_LIBS_BRIEF) $(OBJECTS) \
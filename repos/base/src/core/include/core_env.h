@@ -85,6 +85,8 @@ class Genode::Core_env : public Env_deprecated
 
 		Rpc_entrypoint &signal_ep();
 
+		void fill_zeroed_ram_pool() { _pd_session.fill_zeroed_ram_pool(); }
+
 		/******************************
 		 ** Env_deprecated interface **
 		 ******************************/
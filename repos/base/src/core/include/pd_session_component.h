@@ -161,6 +161,11 @@ class Genode::Pd_session_component : public Session_object<Pd_session>
 			_ram_account.construct(_ram_quota_guard(), _label);
 		}
 
+		/**
+		 * Fill core's pool of zeroed RAM up to its low watermark
+		 */
+		void fill_zeroed_ram_pool() { _ram_ds_factory.fill_zeroed_pool(); }
+
 		/**
 		 * Associate thread with PD
 		 *
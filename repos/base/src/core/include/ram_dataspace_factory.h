@@ -17,12 +17,14 @@
 /* Genode includes */
 #include <base/heap.h>
 #include <base/tslab.h>
+#include <util/string.h>
 
 /* base-internal includes */
 #include <base/internal/page_size.h>
 
 /* core includes */
 #include <dataspace_component.h>
+#include <zeroed_ram_pool.h>
 
 namespace Genode { class Ram_dataspace_factory; }
 
@@ -57,6 +59,40 @@ class Genode::Ram_dataspace_factory : public Ram_allocator,
 
 		Tslab<Dataspace_component, SLAB_BLOCK_SIZE> _ds_slab;
 
+		/*
+		 * Pool of zeroed memory shared by all RAM dataspace factories
+		 */
+		static Zeroed_ram_pool &_zeroed_pool(Range_allocator &phys_alloc)
+		{
+			static Zeroed_ram_pool pool(phys_alloc);
+			return pool;
+		}
+
+		Zeroed_ram_pool &_pool = _zeroed_pool(_phys_alloc);
+
+		/**
+		 * Allocate physical backing store for a dataspace
+		 */
+		bool _alloc_phys(size_t size, void *&out_addr);
+
+		/**
+		 * Zero-out physical memory not used by any dataspace
+		 */
+		bool _clear_phys(void *addr, size_t size);
+
+		/**
+		 * Fill memory with zeros
+		 *
+		 * This function is used by the platform-specific '_clear_ds'
+		 * implementations. It uses CPU-specific stores, which bypass the
+		 * cache where available.
+		 */
+		static void _clear_mem(void *dst, size_t size)
+		{
+			size_t const left = memclear_cpu(dst, size);
+			memset((char *)dst + size - left, 0, left);
+		}
+
 
 		/********************************************
 		 ** Platform-implemented support functions **
@@ -78,6 +114,11 @@ class Genode::Ram_dataspace_factory : public Ram_allocator,
 
 		/**
 		 * Zero-out content of dataspace
+		 *
+		 * The function may be called at any time while the dataspace is
+		 * exported.
+		 *
+		 * \throw Core_virtual_memory_exhausted
 		 */
 		void _clear_ds(Dataspace_component *ds);
 
@@ -101,6 +142,14 @@ class Genode::Ram_dataspace_factory : public Ram_allocator,
 		}
 
 
+		/**
+		 * Fill pool of zeroed memory up to its low watermark
+		 *
+		 * This function is called once at the startup of core.
+		 */
+		void fill_zeroed_pool();
+
+
 		/*****************************
 		 ** Ram_allocator interface **
 		 *****************************/
@@ -0,0 +1,304 @@
+/*
+ * \brief  Pool of zeroed physical memory
+ * \author Genode Labs
+ * \date   2018-12-18
+ *
+ * New RAM dataspaces must be filled with zeros. For large dataspaces, the
+ * clearing stalls the requesting component considerably. The pool keeps
+ * blocks of physical memory that are known to be zeroed such that core can
+ * hand them out without clearing them. Each block of the pool is a block
+ * allocated from the physical-memory allocator. Hence, the pool is
+ * transparent to all other users of the physical-memory allocator.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CORE__INCLUDE__ZEROED_RAM_POOL_H_
+#define _CORE__INCLUDE__ZEROED_RAM_POOL_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <base/lock.h>
+#include <base/log.h>
+#include <util/misc_math.h>
+
+namespace Genode { class Zeroed_ram_pool; }
+
+
+class Genode::Zeroed_ram_pool
+{
+	public:
+
+		/*
+		 * Smaller blocks are not worth keeping because the clearing of small
+		 * dataspaces is cheap.
+		 */
+		enum { MIN_BLOCK_SIZE = 64*1024 };
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Zeroed_ram_pool(Zeroed_ram_pool const &);
+		Zeroed_ram_pool &operator = (Zeroed_ram_pool const &);
+
+		enum { MAX_BLOCKS      = 64,
+		       MAX_WATERMARK   = 128*1024*1024,
+		       REPORT_INTERVAL = 64*1024*1024 };
+
+		struct Block { addr_t addr; size_t size; };
+
+		Range_allocator &_phys_alloc;
+
+		/*
+		 * The pool is filled up to the low watermark at startup. Freed
+		 * dataspaces are added to the pool until the high watermark is
+		 * reached.
+		 */
+		size_t const _high_watermark;
+		size_t const _low_watermark { _high_watermark / 2 };
+
+		Lock _lock { };
+
+		Block  _blocks[MAX_BLOCKS] { };
+		size_t _level = 0;
+
+		/* number of bytes allocated from the pool and cleared on demand */
+		uint64_t _from_pool = 0, _on_demand = 0, _reported = 0;
+
+		static size_t _watermark(size_t avail)
+		{
+			return min(avail / 16, (size_t)MAX_WATERMARK) & ~(size_t)(MIN_BLOCK_SIZE - 1);
+		}
+
+		Block *_unused_block()
+		{
+			for (Block &b : _blocks)
+				if (!b.size)
+					return &b;
+			return nullptr;
+		}
+
+		/**
+		 * Find naturally aligned-as-possible location for 'size' bytes
+		 * within block 'b' and the range 'from'-'to'
+		 */
+		static bool _fit(Block const &b, size_t size, addr_t from, addr_t to,
+		                 addr_t &out_addr)
+		{
+			addr_t const start = max(b.addr, from);
+			addr_t const end   = min(b.addr + b.size - 1, to);
+
+			for (int align_log2 = log2(size); align_log2 >= 12; align_log2--) {
+				addr_t const addr = align_addr(start, align_log2);
+				if (addr >= start && addr <= end && end - addr >= size - 1) {
+					out_addr = addr;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Keep free range of the physical-memory allocator as block
+		 *
+		 * The range must be zeroed. If the range cannot be kept, it is
+		 * left to the physical-memory allocator.
+		 */
+		void _keep(addr_t addr, size_t size)
+		{
+			if (size < MIN_BLOCK_SIZE)
+				return;
+
+			Block * const b = _unused_block();
+			if (!b || !_phys_alloc.alloc_addr(size, addr).ok())
+				return;
+
+			*b = Block { addr, size };
+			_level += size;
+		}
+
+		/*
+		 * The pool holds no more memory than remains free at the
+		 * physical-memory allocator. This way, the pool never starves
+		 * allocations that cannot be served by the pool, e.g., the
+		 * allocations of core's own meta data.
+		 */
+		bool _wants(size_t size)
+		{
+			return size >= MIN_BLOCK_SIZE
+			    && _level + size <= _high_watermark
+			    && _phys_alloc.avail() >= _level + size
+			    && _unused_block();
+		}
+
+		void _release()
+		{
+			for (Block &b : _blocks) {
+				if (!b.size)
+					continue;
+
+				_phys_alloc.free((void *)b.addr, b.size);
+				b = Block { 0, 0 };
+			}
+			_level = 0;
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * The watermarks are derived from the amount of memory available
+		 * at construction time.
+		 */
+		Zeroed_ram_pool(Range_allocator &phys_alloc)
+		:
+			_phys_alloc(phys_alloc),
+			_high_watermark(_watermark(phys_alloc.avail()))
+		{ }
+
+		/**
+		 * Return number of bytes missing up to the low watermark
+		 */
+		size_t deficit()
+		{
+			Lock::Guard guard(_lock);
+			return _level < _low_watermark ? _low_watermark - _level : 0;
+		}
+
+		/**
+		 * Return true if the pool would keep a zeroed block of 'size' bytes
+		 */
+		bool wants(size_t size)
+		{
+			Lock::Guard guard(_lock);
+			return _wants(size);
+		}
+
+		/**
+		 * Add zeroed block allocated from the physical-memory allocator
+		 *
+		 * \return false if the pool refuses the block, in which case the
+		 *         block remains owned by the caller
+		 */
+		bool add(void *addr, size_t size)
+		{
+			Lock::Guard guard(_lock);
+
+			if (!_wants(size))
+				return false;
+
+			Block * const b = _unused_block();
+
+			*b = Block { (addr_t)addr, size };
+			_level += size;
+			return true;
+		}
+
+		/**
+		 * Allocate zeroed memory within the physical range 'from'-'to'
+		 *
+		 * \return true if 'out_addr' refers to a block of 'size' bytes
+		 *         allocated from the physical-memory allocator
+		 */
+		bool alloc(size_t size, addr_t from, addr_t to, void *&out_addr)
+		{
+			if (size < MIN_BLOCK_SIZE)
+				return false;
+
+			Lock::Guard guard(_lock);
+
+			/* select the smallest block that can hold the allocation */
+			Block *best = nullptr;
+			addr_t addr = 0;
+			for (Block &b : _blocks) {
+				addr_t fit_addr = 0;
+				if (b.size >= size && (!best || b.size < best->size)
+				 && _fit(b, size, from, to, fit_addr)) {
+					best = &b;
+					addr = fit_addr;
+				}
+			}
+
+			if (!best)
+				return false;
+
+			Block const b = *best;
+			*best  = Block { 0, 0 };
+			_level -= b.size;
+
+			/*
+			 * Split the block into the allocation and the remainders at
+			 * both sides, each becoming a distinct block of the
+			 * physical-memory allocator.
+			 */
+			_phys_alloc.free((void *)b.addr, b.size);
+
+			if (!_phys_alloc.alloc_addr(size, addr).ok())
+				return false;
+
+			_keep(b.addr, addr - b.addr);
+			_keep(addr + size, b.addr + b.size - addr - size);
+
+			out_addr = (void *)addr;
+			return true;
+		}
+
+		/**
+		 * Return all blocks to the physical-memory allocator
+		 *
+		 * \return true if the pool held any memory
+		 */
+		bool release()
+		{
+			Lock::Guard guard(_lock);
+
+			bool const any = _level > 0;
+			_release();
+			return any;
+		}
+
+		/**
+		 * Release the pool if it holds more memory than is free otherwise
+		 */
+		void trim()
+		{
+			Lock::Guard guard(_lock);
+
+			if (_level && _phys_alloc.avail() < _level)
+				_release();
+		}
+
+		/**
+		 * Account allocation of a RAM dataspace
+		 *
+		 * \param zeroed  true if the dataspace was allocated from the pool,
+		 *                false if it was cleared on demand
+		 */
+		void account(size_t size, bool zeroed)
+		{
+			Lock::Guard guard(_lock);
+
+			(zeroed ? _from_pool : _on_demand) += size;
+
+			uint64_t const total = _from_pool + _on_demand;
+			if (total - _reported < REPORT_INTERVAL)
+				return;
+
+			_reported = total;
+
+			enum { MB = 1024*1024 };
+			log("RAM dataspaces: ", _from_pool / MB, " MiB from zeroed pool, ",
+			    _on_demand / MB, " MiB cleared on demand, ",
+			    _level / MB, " MiB pooled");
+		}
+};
+
+#endif /* _CORE__INCLUDE__ZEROED_RAM_POOL_H_ */
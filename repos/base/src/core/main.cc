@@ -304,6 +304,9 @@ int main()
 		         "label=\"core\"", Affinity(), Cpu_session::QUOTA_LIMIT);
 	Cpu_session_capability core_cpu_cap = ep.manage(&core_cpu);
 
+	/* clear memory in advance while no component is running yet */
+	core_env()->fill_zeroed_ram_pool();
+
 	log("", init_ram_quota.value / (1024*1024), " MiB RAM and ", init_cap_quota, " caps "
 	    "assigned to init");
 
@@ -20,25 +20,14 @@
 using namespace Genode;
 
 
-Ram_dataspace_capability
-Ram_dataspace_factory::alloc(size_t ds_size, Cache_attribute cached)
+bool Ram_dataspace_factory::_alloc_phys(size_t ds_size, void *&ds_addr)
 {
-	/* zero-sized dataspaces are not allowed */
-	if (!ds_size) return Ram_dataspace_capability();
-
-	/* dataspace allocation granularity is page size */
-	ds_size = align_addr(ds_size, 12);
-
 	/*
-	 * Allocate physical backing store
-	 *
 	 * As an optimization for the use of large mapping sizes, we try to
 	 * align the dataspace in physical memory naturally (size-aligned).
 	 * If this does not work, we subsequently weaken the alignment constraint
 	 * until the allocation succeeds.
 	 */
-	void *ds_addr = 0;
-	bool alloc_succeeded = false;
 
 	/*
 	 * If no physical constraint exists, try to allocate physical memory at
@@ -50,23 +39,85 @@ Ram_dataspace_factory::alloc(size_t ds_size, Cache_attribute cached)
 		addr_t const high_start = (sizeof(void *) == 4 ? 3UL : 4UL) << 30;
 		for (size_t align_log2 = log2(ds_size); align_log2 >= 12; align_log2--) {
 			if (_phys_alloc.alloc_aligned(ds_size, &ds_addr, align_log2,
-			                              high_start, _phys_range.end).ok()) {
-				alloc_succeeded = true;
-				break;
-			}
+			                              high_start, _phys_range.end).ok())
+				return true;
 		}
 	}
 
 	/* apply constraints or re-try because higher memory allocation failed */
-	if (!alloc_succeeded) {
-		for (size_t align_log2 = log2(ds_size); align_log2 >= 12; align_log2--) {
-			if (_phys_alloc.alloc_aligned(ds_size, &ds_addr, align_log2,
-			                              _phys_range.start, _phys_range.end).ok()) {
-				alloc_succeeded = true;
+	for (size_t align_log2 = log2(ds_size); align_log2 >= 12; align_log2--) {
+		if (_phys_alloc.alloc_aligned(ds_size, &ds_addr, align_log2,
+		                              _phys_range.start, _phys_range.end).ok())
+			return true;
+	}
+
+	return false;
+}
+
+
+bool Ram_dataspace_factory::_clear_phys(void *addr, size_t size)
+{
+	Dataspace_component ds(size, (addr_t)addr, CACHED, true, this);
+
+	try { _export_ram_ds(&ds); }
+	catch (Core_virtual_memory_exhausted) { return false; }
+
+	bool cleared = true;
+	try { _clear_ds(&ds); }
+	catch (Core_virtual_memory_exhausted) { cleared = false; }
+
+	_revoke_ram_ds(&ds);
+	return cleared;
+}
+
+
+void Ram_dataspace_factory::fill_zeroed_pool()
+{
+	for (size_t size; (size = _pool.deficit()) >= Zeroed_ram_pool::MIN_BLOCK_SIZE; ) {
+
+		/* weaken the size of the block until the allocation succeeds */
+		void *addr = nullptr;
+		for (; size >= Zeroed_ram_pool::MIN_BLOCK_SIZE; size = (size / 2) & ~0xfffUL)
+			if (_alloc_phys(size, addr))
 				break;
-			}
+
+		if (size < Zeroed_ram_pool::MIN_BLOCK_SIZE)
+			return;
+
+		if (!_clear_phys(addr, size) || !_pool.add(addr, size)) {
+			_phys_alloc.free(addr, size);
+			return;
 		}
 	}
+}
+
+
+Ram_dataspace_capability
+Ram_dataspace_factory::alloc(size_t ds_size, Cache_attribute cached)
+{
+	/* zero-sized dataspaces are not allowed */
+	if (!ds_size) return Ram_dataspace_capability();
+
+	/* dataspace allocation granularity is page size */
+	ds_size = align_addr(ds_size, 12);
+
+	void *ds_addr = 0;
+
+	/*
+	 * Cached dataspaces are preferably backed by memory of the pool of
+	 * zeroed memory, which spares the clearing of the dataspace. Uncached
+	 * dataspaces are always cleared on demand because the clearing must
+	 * flush the cache lines of the dataspace.
+	 */
+	bool const zeroed = (cached == CACHED)
+	                 && _pool.alloc(ds_size, _phys_range.start, _phys_range.end, ds_addr);
+
+	/* allocate physical backing store */
+	bool alloc_succeeded = zeroed || _alloc_phys(ds_size, ds_addr);
+
+	/* memory held by the pool is available to all allocations */
+	if (!alloc_succeeded && _pool.release())
+		alloc_succeeded = _alloc_phys(ds_size, ds_addr);
 
 	/*
 	 * Helper to release the allocated physical memory whenever we leave the
@@ -133,7 +184,22 @@ Ram_dataspace_factory::alloc(size_t ds_size, Cache_attribute cached)
 	 * function must also make sure to flush all cache lines related to the
 	 * address range used by the dataspace.
 	 */
-	_clear_ds(ds);
+	if (!zeroed) {
+		try { _clear_ds(ds); }
+		catch (Core_virtual_memory_exhausted) {
+			warning("could not clear RAM dataspace of size ", ds->size());
+
+			/* cleanup unneeded resources */
+			_revoke_ram_ds(ds);
+			destroy(_ds_slab, ds);
+			throw Out_of_ram();
+		}
+
+		/* keep the pool from starving other allocations */
+		_pool.trim();
+	}
+
+	_pool.account(ds_size, zeroed);
 
 	Dataspace_capability result = _ep.manage(ds);
 
@@ -161,11 +227,23 @@ void Ram_dataspace_factory::free(Ram_dataspace_capability ds_cap)
 		/* remove dataspace from all RM sessions */
 		ds->detach_from_rm_sessions();
 
+		/*
+		 * Keep the memory in the pool of zeroed memory if the pool lacks
+		 * memory. The clearing must happen before the revocation of the
+		 * native shared memory representation.
+		 */
+		bool zeroed = _pool.wants(ds_size);
+		if (zeroed) {
+			try { _clear_ds(ds); }
+			catch (Core_virtual_memory_exhausted) { zeroed = false; }
+		}
+
 		/* destroy native shared memory representation */
 		_revoke_ram_ds(ds);
 
 		/* free physical memory that was backing the dataspace */
-		_phys_alloc.free((void *)ds->phys_addr(), ds_size);
+		if (!zeroed || !_pool.add((void *)ds->phys_addr(), ds_size))
+			_phys_alloc.free((void *)ds->phys_addr(), ds_size);
 	});
 
 	/* call dataspace destructor and free memory */
@@ -129,6 +129,9 @@ int Allocator_avl_base::_add_block(Block *block_metadata,
 	/* insert block into avl tree */
 	_addr_tree.insert(block_metadata);
 
+	if (!used)
+		_insert_free(block_metadata);
+
 	return 0;
 }
 
@@ -137,12 +140,71 @@ void Allocator_avl_base::_destroy_block(Block *b)
 {
 	if (!b) return;
 
-	/* remove block from both avl trees */
+	/* remove block from avl tree and free list */
 	_addr_tree.remove(b);
+	if (!b->used())
+		_remove_free(b);
+
 	_md_alloc->free(b, _md_entry_size);
 }
 
 
+void Allocator_avl_base::_insert_free(Block *b)
+{
+	unsigned const c = _size_class(b->size());
+
+	b->_free_prev = nullptr;
+	b->_free_next = _free_list[c];
+	if (b->_free_next)
+		b->_free_next->_free_prev = b;
+
+	_free_list[c]  = b;
+	_free_classes |= 1UL << c;
+}
+
+
+void Allocator_avl_base::_remove_free(Block *b)
+{
+	unsigned const c = _size_class(b->size());
+
+	if (b->_free_prev)
+		b->_free_prev->_free_next = b->_free_next;
+	else
+		_free_list[c] = b->_free_next;
+
+	if (b->_free_next)
+		b->_free_next->_free_prev = b->_free_prev;
+
+	b->_free_next = b->_free_prev = nullptr;
+
+	if (!_free_list[c])
+		_free_classes &= ~(1UL << c);
+}
+
+
+Allocator_avl_base::Block *
+Allocator_avl_base::_find_fast_fit(size_t size, unsigned align)
+{
+	auto fits = [&] (Block *b) {
+		return b && b->size() >= size && b->addr() == align_addr(b->addr(), align); };
+
+	/* a block of the size class of 'size' may be large enough */
+	unsigned const c = _size_class(size);
+	if (fits(_free_list[c]))
+		return _free_list[c];
+
+	/* any block of a higher size class is large enough */
+	for (addr_t classes = _free_classes & ~((2UL << c) - 1); classes;
+	     classes &= classes - 1) {
+
+		Block * const b = _free_list[__builtin_ctzl(classes)];
+		if (fits(b))
+			return b;
+	}
+	return nullptr;
+}
+
+
 void Allocator_avl_base::_cut_from_block(Block *b, addr_t addr, size_t size,
                                          Block *dst1, Block *dst2)
 {
@@ -267,6 +329,39 @@ Range_allocator::Alloc_return
 Allocator_avl_base::alloc_aligned(size_t size, void **out_addr, int align,
                                   addr_t from, addr_t to)
 {
+	if (size && size <= FAST_FIT_MAX_SIZE && align <= FAST_FIT_MAX_ALIGN
+	 && from == 0 && to == ~0UL) {
+
+		/*
+		 * The meta data for the remainder of the block must be allocated
+		 * before looking up the block because the meta-data allocator may
+		 * allocate from this allocator.
+		 */
+		Block *remainder = _alloc_block_metadata();
+		if (!remainder)
+			return Alloc_return(Alloc_return::OUT_OF_METADATA);
+
+		if (Block *b = _find_fast_fit(size, align)) {
+
+			addr_t const addr = b->addr();
+			size_t const rest = b->size() - size;
+
+			/* reuse the meta data of the free block for the allocation */
+			_addr_tree.remove(b);
+			_remove_free(b);
+			_add_block(b, addr, size, Block::USED);
+
+			if (rest)
+				_add_block(remainder, addr + size, rest, Block::FREE);
+			else
+				_md_alloc->free(remainder, sizeof(Block));
+
+			*out_addr = reinterpret_cast<void *>(addr);
+			return Alloc_return(Alloc_return::OK);
+		}
+		_md_alloc->free(remainder, sizeof(Block));
+	}
+
 	Block *dst1, *dst2;
 	if (!_alloc_two_blocks_metadata(&dst1, &dst2))
 		return Alloc_return(Alloc_return::OUT_OF_METADATA);
@@ -20,6 +20,8 @@
 
 namespace Linker {
 	struct Hash_table;
+	struct Gnu_hash_table;
+	struct Symbol_hash;
 	struct Dynamic;
 }
 
@@ -53,6 +55,94 @@ struct Linker::Hash_table
 };
 
 
+/**
+ * GNU-style hash table (DT_GNU_HASH)
+ *
+ * The header is followed by a Bloom filter of address-sized words, the
+ * buckets, and the hash values of the symbols starting at 'symoffset'.
+ * The symbols of a bucket are adjacent in the symbol table. The lowest bit
+ * of a hash value marks the last symbol of its bucket. The Bloom filter
+ * rules out most lookups of symbols that are not defined by the object
+ * without touching the buckets or the symbol table.
+ */
+struct Linker::Gnu_hash_table
+{
+	Elf::Hashelt nbuckets;
+	Elf::Hashelt symoffset;
+	Elf::Hashelt bloom_size;
+	Elf::Hashelt bloom_shift;
+
+	enum { BLOOM_WORD_BITS = 8*sizeof(Elf::Addr) };
+
+	Elf::Addr    const *bloom()   const { return (Elf::Addr const *)(this + 1); }
+	Elf::Hashelt const *buckets() const { return (Elf::Hashelt const *)(bloom() + bloom_size); }
+	Elf::Hashelt const *hashes()  const { return buckets() + nbuckets; }
+
+	/**
+	 * Hash function of the GNU toolchain (Bernstein)
+	 */
+	static Elf::Hashelt hash(char const *name)
+	{
+		Elf::Hashelt h = 5381;
+
+		for (unsigned char const *p = (unsigned char const *)name; *p; p++)
+			h = h*33 + *p;
+
+		return h;
+	}
+
+	/**
+	 * Return false if the object does not define a symbol with hash 'h'
+	 */
+	bool may_contain(Elf::Hashelt h) const
+	{
+		if (!bloom_size || !nbuckets)
+			return false;
+
+		Elf::Addr const word = bloom()[(h / BLOOM_WORD_BITS) % bloom_size];
+		Elf::Addr const mask = ((Elf::Addr)1 << (h % BLOOM_WORD_BITS))
+		                     | ((Elf::Addr)1 << ((h >> bloom_shift) % BLOOM_WORD_BITS));
+
+		return (word & mask) == mask;
+	}
+
+	/**
+	 * Return number of symbols
+	 *
+	 * The number is not stated by the table. It follows from the last
+	 * symbol of the bucket with the highest symbol index.
+	 */
+	unsigned long num_symbols() const SELF_RELOC
+	{
+		unsigned long last = 0;
+		for (unsigned long i = 0; i < nbuckets; i++)
+			if (buckets()[i] > last)
+				last = buckets()[i];
+
+		if (last < symoffset)
+			return symoffset;
+
+		while (!(hashes()[last - symoffset] & 1))
+			last++;
+
+		return last + 1;
+	}
+};
+
+
+/**
+ * Hash values of a symbol name for both kinds of hash tables
+ */
+struct Linker::Symbol_hash
+{
+	unsigned long const sysv;
+	Elf::Hashelt  const gnu;
+
+	Symbol_hash(char const *name)
+	: sysv(Hash_table::hash(name)), gnu(Gnu_hash_table::hash(name)) { }
+};
+
+
 /**
  * .dynamic section entries
  */
@@ -94,6 +184,8 @@ class Linker::Dynamic
 		Allocator           *_md_alloc      = nullptr;
 
 		Hash_table          *_hash_table    = nullptr;
+		Gnu_hash_table      *_gnu_hash      = nullptr;
+		unsigned long        _num_symbols   = 0;
 
 		Elf::Rela           *_reloca        = nullptr;
 		unsigned long        _reloca_size   = 0;
@@ -158,6 +250,7 @@ class Linker::Dynamic
 				case DT_PLTRELSZ: _pltrel_size = d->un.val;                             break;
 				case DT_PLTGOT  : _section<typeof(_pltgot)>(&_pltgot, d);               break;
 				case DT_HASH    : _section<typeof(_hash_table)>(&_hash_table, d);       break;
+				case DT_GNU_HASH: _section<typeof(_gnu_hash)>(&_gnu_hash, d);           break;
 				case DT_RELA    : _section<typeof(_reloca)>(&_reloca, d);               break;
 				case DT_RELASZ  : _reloca_size = d->un.val;                             break;
 				case DT_SYMTAB  : _section<typeof(_symtab)>(&_symtab, d);               break;
@@ -173,6 +266,83 @@ class Linker::Dynamic
 					break;
 				}
 			}
+
+			_num_symbols = _hash_table ? _hash_table->nchains()
+			             : _gnu_hash   ? _gnu_hash->num_symbols() : 0;
+		}
+
+		/**
+		 * Return symbol if it is a defined symbol named 'name'
+		 */
+		Elf::Sym const *_matching_symbol(unsigned long sym_index, char const *name) const
+		{
+			Elf::Sym const *sym = symbol(sym_index);
+			if (!sym)
+				return nullptr;
+
+			/* this omitts everything but 'NOTYPE', 'OBJECT', and 'FUNC' */
+			if (sym->type() > STT_FUNC)
+				return nullptr;
+
+			if (sym->st_value == 0)
+				return nullptr;
+
+			/* check for symbol name */
+			char const *sym_name = symbol_name(*sym);
+			if (name[0] != sym_name[0] || strcmp(name, sym_name))
+				return nullptr;
+
+			return sym;
+		}
+
+		Elf::Sym const *_lookup_sysv(char const *name, unsigned long hash) const
+		{
+			Hash_table *h = _hash_table;
+
+			if (!h->buckets())
+				return nullptr;
+
+			unsigned long sym_index = h->buckets()[hash % h->nbuckets()];
+
+			/* traverse hash chain */
+			for (; sym_index != STN_UNDEF; sym_index = h->chains()[sym_index])
+			{
+				/* bad object */
+				if (sym_index > h->nchains())
+					return nullptr;
+
+				if (Elf::Sym const *sym = _matching_symbol(sym_index, name))
+					return sym;
+			}
+
+			return nullptr;
+		}
+
+		Elf::Sym const *_lookup_gnu(char const *name, Elf::Hashelt hash) const
+		{
+			Gnu_hash_table const &h = *_gnu_hash;
+
+			if (!h.may_contain(hash))
+				return nullptr;
+
+			unsigned long sym_index = h.buckets()[hash % h.nbuckets];
+			if (sym_index < h.symoffset)
+				return nullptr;
+
+			/* traverse the symbols of the bucket */
+			for (; sym_index < _num_symbols; sym_index++) {
+
+				Elf::Hashelt const sym_hash = h.hashes()[sym_index - h.symoffset];
+
+				if ((sym_hash | 1) == (hash | 1))
+					if (Elf::Sym const *sym = _matching_symbol(sym_index, name))
+						return sym;
+
+				if (sym_hash & 1)
+					break;
+			}
+
+			return nullptr;
 		}
 
 	public:
@@ -214,9 +384,9 @@ class Linker::Dynamic
 			_init_function();
 		}
 
-		Elf::Sym const *symbol(unsigned sym_index) const
+		Elf::Sym const *symbol(unsigned long sym_index) const
 		{
-			if (sym_index > _hash_table->nchains())
+			if (sym_index >= _num_symbols)
 				return nullptr;
 
 			return _symtab + sym_index;
@@ -234,46 +404,27 @@ class Linker::Dynamic
 		Dependency const &dep() const { return *_dep; }
 
 		/*
-		 * Use DT_HASH table address for linker, assuming that it will always be at
-		 * the beginning of the file
+		 * Use hash table address for linker, assuming that it will always be
+		 * at the beginning of the file
 		 */
-		Elf::Addr link_map_addr() const { return trunc_page((Elf::Addr)_hash_table); }
+		Elf::Addr link_map_addr() const
+		{
+			return trunc_page(_hash_table ? (Elf::Addr)_hash_table
+			                              : (Elf::Addr)_gnu_hash);
+		}
 
 		/**
 		 * Lookup symbol name in this ELF
+		 *
+		 * The GNU-style hash table is preferred if present.
 		 */
-		Elf::Sym const *lookup_symbol(char const *name, unsigned long hash) const
+		Elf::Sym const *lookup_symbol(char const *name, Symbol_hash const &hash) const
 		{
-			Hash_table *h = _hash_table;
+			if (_gnu_hash)
+				return _lookup_gnu(name, hash.gnu);
 
-			if (!h->buckets())
-				return nullptr;
-
-			unsigned long sym_index = h->buckets()[hash % h->nbuckets()];
-
-			/* traverse hash chain */
-			for (; sym_index != STN_UNDEF; sym_index = h->chains()[sym_index])
-			{
-				/* bad object */
-				if (sym_index > h->nchains())
-					return nullptr;
-
-				Elf::Sym const *sym      = symbol(sym_index);
-				char const     *sym_name = symbol_name(*sym);
-
-				/* this omitts everything but 'NOTYPE', 'OBJECT', and 'FUNC' */
-				if (sym->type() > STT_FUNC)
-					continue;
-
-				if (sym->st_value == 0)
-					continue;
-
-				/* check for symbol name */
-				if (name[0] != sym_name[0] || strcmp(name, sym_name))
-					continue;
-
-				return sym;
-			}
+			if (_hash_table)
+				return _lookup_sysv(name, hash.sysv);
 
 			return nullptr;
 		}
@@ -285,7 +436,7 @@ class Linker::Dynamic
 		{
 			addr_t const reloc_base = _obj.reloc_base();
 
-			for (unsigned long i = 0; i < _hash_table->nchains(); i++)
+			for (unsigned long i = 0; i < _num_symbols; i++)
 			{
 				Elf::Sym const *sym = symbol(i);
 				if (!sym)
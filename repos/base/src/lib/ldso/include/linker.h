@@ -110,6 +110,13 @@ namespace Linker {
 	 * Global ELF access lock
 	 */
 	Lock &lock();
+
+	/**
+	 * Invalidate cached symbol lookups
+	 *
+	 * Called whenever a dependency is added or removed.
+	 */
+	void flush_symbol_cache();
 }
 
 
@@ -0,0 +1,130 @@
+/*
+ * \brief  Cache of symbol lookups
+ * \author Genode Labs
+ * \date   2018-12-17
+ *
+ * Many relocations of the objects of a program refer to the same symbols,
+ * e.g., functions of the C library. Each lookup searches the objects of the
+ * dependency list in turn. The cache remembers the result of a lookup by
+ * the symbol name and the dependency list. The names are stored by
+ * reference to the string table of the object that requested the lookup.
+ * Hence, the cache must be flushed whenever an object is unloaded.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__SYMBOL_CACHE_H_
+#define _INCLUDE__SYMBOL_CACHE_H_
+
+/* local includes */
+#include <linker.h>
+
+namespace Linker { class Symbol_cache; }
+
+
+class Linker::Symbol_cache
+{
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Symbol_cache(Symbol_cache const &);
+		Symbol_cache &operator = (Symbol_cache const &);
+
+		struct Entry
+		{
+			char       const *name;
+			Dependency const *deps;
+			Elf::Sym   const *sym;
+			Elf::Addr         base;
+			unsigned          generation;
+			bool              undef;
+		};
+
+		Allocator     &_alloc;
+		unsigned const _num_entries;
+		size_t   const _size { _num_entries*sizeof(Entry) };
+		Entry  * const _entries { (Entry *)_alloc.alloc(_size) };
+
+		Lock _lock { };
+
+		/* entries of other generations are invalid */
+		unsigned _generation = 1;
+
+		Entry &_entry(Elf::Hashelt hash, Dependency const &deps)
+		{
+			unsigned long const key = hash ^ ((addr_t)&deps >> 4);
+			return _entries[key % _num_entries];
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param num_entries  number of cached lookups, must not be zero
+		 */
+		Symbol_cache(Allocator &alloc, unsigned num_entries)
+		:
+			_alloc(alloc), _num_entries(num_entries)
+		{
+			memset(_entries, 0, _size);
+		}
+
+		~Symbol_cache() { _alloc.free(_entries, _size); }
+
+		/**
+		 * Invalidate all entries
+		 */
+		void flush()
+		{
+			Lock::Guard guard(_lock);
+			_generation++;
+		}
+
+		/**
+		 * Return cached result of lookup, or nullptr if not cached
+		 *
+		 * \param deps  first element of the dependency list searched
+		 */
+		Elf::Sym const *lookup(char const *name, Elf::Hashelt hash,
+		                       Dependency const &deps, bool undef, Elf::Addr *base)
+		{
+			Lock::Guard guard(_lock);
+
+			Entry const &e = _entry(hash, deps);
+
+			if (e.generation != _generation || e.deps != &deps
+			 || e.undef != undef || strcmp(e.name, name))
+				return nullptr;
+
+			*base = e.base;
+			return e.sym;
+		}
+
+		/**
+		 * Remember result of lookup, replacing a colliding entry
+		 */
+		void insert(char const *name, Elf::Hashelt hash, Dependency const &deps,
+		            bool undef, Elf::Sym const *sym, Elf::Addr base)
+		{
+			Lock::Guard guard(_lock);
+
+			Entry &e = _entry(hash, deps);
+
+			e.name       = name;
+			e.deps       = &deps;
+			e.sym        = sym;
+			e.base       = base;
+			e.generation = _generation;
+			e.undef      = undef;
+		}
+};
+
+#endif /* _INCLUDE__SYMBOL_CACHE_H_ */
@@ -29,6 +29,7 @@
 #include <dynamic.h>
 #include <init.h>
 #include <region_map.h>
+#include <symbol_cache.h>
 
 using namespace Linker;
 
@@ -174,7 +175,7 @@ class Linker::Elf_object : public Object, private Fifo<Elf_object>::Element
 			return _dyn.symbol_name(sym);
 		}
 
-		Elf::Sym const *lookup_symbol(char const *name, unsigned long hash) const
+		Elf::Sym const *lookup_symbol(char const *name, Symbol_hash const &hash) const
 		{
 			return _dyn.lookup_symbol(name, hash);
 		}
@@ -480,8 +481,7 @@ struct Linker::Binary : private Root_object, public Elf_object
 
 Elf::Addr Linker::Object::_symbol_address(char const *name)
 {
-	unsigned long   hash = Hash_table::hash(name);
-	Elf::Sym const *sym  = dynamic().lookup_symbol(name, hash);
+	Elf::Sym const *sym = dynamic().lookup_symbol(name, Symbol_hash(name));
 
 	if (sym)
 		return reloc_base() + sym->st_value;
@@ -524,31 +524,28 @@ Object *Linker::obj_list_head()
 }
 
 
-Elf::Sym const *Linker::lookup_symbol(unsigned sym_index, Dependency const &dep,
-                                      Elf::Addr *base, bool undef, bool other)
-{
-	Elf_object const &elf    = static_cast<Elf_object const &>(dep.obj());
-	Elf::Sym   const *symbol = elf.symbol(sym_index);
-
-	if (!symbol) {
-		warning("LD: unknown symbol index ", Hex(sym_index));
-		return 0;
-	}
+/*
+ * The cache is created once the linker is relocated. Until then, the plain
+ * pointer is accessed without relocation.
+ */
+static Symbol_cache *symbol_cache_ptr = nullptr;
 
-	if (symbol->bind() == STB_LOCAL) {
-		*base = dep.obj().reloc_base();
-		return symbol;
-	}
 
-	return lookup_symbol(elf.symbol_name(*symbol), dep, base, undef, other);
+void Linker::flush_symbol_cache()
+{
+	if (symbol_cache_ptr)
+		symbol_cache_ptr->flush();
 }
 
 
-Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const &dep,
-                                      Elf::Addr *base, bool undef, bool other)
+/**
+ * Search dependency list for symbol
+ */
+static Elf::Sym const *search_symbol(char const *name, Symbol_hash const &hash,
+                                     Dependency const &dep, Elf::Addr *base,
+                                     bool undef, bool other)
 {
 	Dependency const *curr        = &dep.first();
-	unsigned long     hash        = Hash_table::hash(name);
 	Elf::Sym   const *weak_symbol = 0;
 	Elf::Addr        weak_base    = 0;
 	Elf::Sym   const *symbol      = 0;
@@ -586,7 +583,7 @@ Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const &dep,
 	/* try searching binary's dependencies */
 	if (!weak_symbol && dep.root()) {
 		if (binary_ptr && &dep != binary_ptr->first_dep()) {
-			return lookup_symbol(name, *binary_ptr->first_dep(), base, undef, other);
+			return search_symbol(name, hash, *binary_ptr->first_dep(), base, undef, other);
 		} else {
 			throw Not_found(name);
 		}
@@ -603,6 +600,53 @@ Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const &dep,
 }
 
 
+Elf::Sym const *Linker::lookup_symbol(unsigned sym_index, Dependency const &dep,
+                                      Elf::Addr *base, bool undef, bool other)
+{
+	Elf_object const &elf    = static_cast<Elf_object const &>(dep.obj());
+	Elf::Sym   const *symbol = elf.symbol(sym_index);
+
+	if (!symbol) {
+		warning("LD: unknown symbol index ", Hex(sym_index));
+		return 0;
+	}
+
+	if (symbol->bind() == STB_LOCAL) {
+		*base = dep.obj().reloc_base();
+		return symbol;
+	}
+
+	char const * const name = elf.symbol_name(*symbol);
+
+	/* lookups that skip the requesting object are rare (copy relocations) */
+	if (other || !symbol_cache_ptr)
+		return lookup_symbol(name, dep, base, undef, other);
+
+	/*
+	 * The name refers to the string table of the requesting object, which
+	 * belongs to the searched dependency list. Hence, it stays valid until
+	 * the cache is flushed on the destruction of a dependency.
+	 */
+	Symbol_hash const hash(name);
+	Dependency  const &deps = dep.first();
+
+	if (Elf::Sym const *cached = symbol_cache_ptr->lookup(name, hash.gnu, deps, undef, base))
+		return cached;
+
+	Elf::Sym const *result = search_symbol(name, hash, dep, base, undef, other);
+
+	symbol_cache_ptr->insert(name, hash.gnu, deps, undef, result, *base);
+	return result;
+}
+
+
+Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const &dep,
+                                      Elf::Addr *base, bool undef, bool other)
+{
+	return search_symbol(name, Symbol_hash(name), dep, base, undef, other);
+}
+
+
 /********************
  ** Initialization **
  ********************/
@@ -633,8 +677,12 @@ class Linker::Config
 {
 	private:
 
-		Bind _bind    = BIND_LAZY;
-		bool _verbose = false;
+		/* 10 KiB of the linker's heap on 64-bit platforms */
+		enum { DEFAULT_SYMBOL_CACHE_ENTRIES = 256 };
+
+		Bind     _bind                 = BIND_LAZY;
+		bool     _verbose              = false;
+		unsigned _symbol_cache_entries = DEFAULT_SYMBOL_CACHE_ENTRIES;
 
 	public:
 
@@ -647,11 +695,20 @@ class Linker::Config
 					_bind = BIND_NOW;
 
 				_verbose = config.xml().attribute_value("ld_verbose", false);
+
+				_symbol_cache_entries =
+					config.xml().attribute_value("ld_symbol_cache",
+					                             (unsigned)DEFAULT_SYMBOL_CACHE_ENTRIES);
 			} catch (Rom_connection::Rom_connection_failed) { }
 		}
 
 		Bind bind()    const { return _bind; }
 		bool verbose() const { return _verbose; }
+
+		/**
+		 * Number of cached symbol lookups, zero disables the cache
+		 */
+		unsigned symbol_cache_entries() const { return _symbol_cache_entries; }
 };
 
 
@@ -686,6 +743,10 @@ void Component::construct(Genode::Env &env)
 	static Config config(env);
 	verbose = config.verbose();
 
+	if (config.symbol_cache_entries())
+		symbol_cache_ptr = new (*heap())
+			Symbol_cache(*heap(), config.symbol_cache_entries());
+
 	/* load binary and all dependencies */
 	try {
 		binary_ptr = unmanaged_singleton<Binary>(env, *heap(), config.bind());
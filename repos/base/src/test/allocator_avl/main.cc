@@ -0,0 +1,156 @@
+/*
+ * \brief  Benchmark of the 'Allocator_avl' under fragmentation
+ * \author Genode Labs
+ * \date   2018-12-07
+ *
+ * The benchmark populates an allocator with blocks of random size, frees
+ * every other block to fragment the free space, and then replays a random
+ * sequence of allocations and deallocations. Each round is executed once
+ * via the size-class fast path and once via the best-fit search in the
+ * AVL tree. The latter is enforced by passing a range constraint to
+ * 'alloc_aligned' that excludes no practically used address. The run
+ * script measures the duration of each round by the time between the
+ * "start" and "finished" messages.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/allocator_avl.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <util/reconstructible.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	enum {
+		RANGE_BASE = 0x10000000UL,
+		RANGE_SIZE = 256*1024*1024UL,
+		NUM_SLOTS  = 8192,
+		NUM_OPS    = 1000*1000,
+		ALIGN      = sizeof(addr_t) == 8 ? 3 : 2,
+	};
+
+	struct Slot { addr_t addr; size_t size; };
+
+	Env  &_env;
+	Heap  _heap { _env.ram(), _env.rm() };
+	Slot  _slots[NUM_SLOTS] { };
+
+	Constructible<Allocator_avl> _allocator { };
+
+	unsigned long _seed { 0 };
+
+	unsigned long _random()
+	{
+		_seed = _seed*1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	size_t _random_size(size_t max) {
+		return align_addr(1 + _random() % max, ALIGN); }
+
+	bool _alloc(Allocator_avl &alloc, Slot &slot, size_t max, bool best_fit)
+	{
+		void *addr = nullptr;
+		size_t const size = _random_size(max);
+
+		bool const ok = best_fit
+		              ? alloc.alloc_aligned(size, &addr, ALIGN, 0, ~0UL - 1).ok()
+		              : alloc.alloc_aligned(size, &addr, ALIGN).ok();
+		if (!ok)
+			return false;
+
+		slot.addr = (addr_t)addr;
+		slot.size = size;
+		return true;
+	}
+
+	bool _round(char const *name, size_t max, bool best_fit)
+	{
+		_allocator.construct(&_heap);
+		Allocator_avl &alloc = *_allocator;
+		alloc.add_range(RANGE_BASE, RANGE_SIZE);
+
+		for (Slot &slot : _slots)
+			slot = Slot { 0, 0 };
+
+		_seed = 1;
+
+		/* fragment free space by releasing every other block */
+		for (Slot &slot : _slots)
+			if (!_alloc(alloc, slot, max, best_fit)) {
+				error(name, ": initial allocation failed");
+				return false;
+			}
+
+		for (unsigned i = 0; i < NUM_SLOTS; i += 2) {
+			alloc.free((void *)_slots[i].addr);
+			_slots[i] = Slot { 0, 0 };
+		}
+
+		log("start ", name);
+
+		for (unsigned i = 0; i < NUM_OPS; i++) {
+
+			Slot &slot = _slots[_random() % NUM_SLOTS];
+
+			if (slot.addr) {
+				alloc.free((void *)slot.addr);
+				slot = Slot { 0, 0 };
+				continue;
+			}
+
+			if (!_alloc(alloc, slot, max, best_fit)) {
+				error(name, ": allocation failed");
+				return false;
+			}
+		}
+
+		log("finished ", name);
+
+		/* validate the allocator state */
+		for (Slot &slot : _slots) {
+			if (!slot.addr)
+				continue;
+
+			if (alloc.size_at((void *)slot.addr) != slot.size) {
+				error(name, ": unexpected size of block at ", Hex(slot.addr));
+				return false;
+			}
+			alloc.free((void *)slot.addr);
+		}
+
+		if (alloc.avail() != RANGE_SIZE) {
+			error(name, ": free blocks not merged, avail=", alloc.avail());
+			return false;
+		}
+		_allocator.destruct();
+		return true;
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		log("Allocator_avl benchmark started");
+
+		bool const ok = _round("fast fit small", 256,  false)
+		             && _round("best fit small", 256,  true)
+		             && _round("fast fit mixed", 4096, false)
+		             && _round("best fit mixed", 4096, true);
+
+		log("--- Allocator_avl benchmark ", ok ? "finished" : "failed", " ---");
+		_env.parent().exit(ok ? 0 : -1);
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
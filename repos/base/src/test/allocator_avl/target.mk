@@ -0,0 +1,3 @@
+TARGET = test-allocator_avl
+SRC_CC = main.cc
+LIBS  += base
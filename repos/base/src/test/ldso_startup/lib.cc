@@ -0,0 +1,51 @@
+/*
+ * \brief  Shared library with many symbol relocations
+ * \author Genode Labs
+ * \date   2018-12-17
+ *
+ * The library defines 512 functions. Each function is referenced by two
+ * tables of function pointers and called by 'ldso_startup_sum'. Because
+ * the functions are exported, each reference is resolved by a symbol
+ * lookup of the dynamic linker, which resembles the relocation work at the
+ * startup of a large component.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#define FN(n)    extern "C" int ldso_startup_fn_##n() { return 0##n; }
+#define FN8(n)   FN(n##0)   FN(n##1)   FN(n##2)   FN(n##3) \
+                 FN(n##4)   FN(n##5)   FN(n##6)   FN(n##7)
+#define FN64(n)  FN8(n##0)  FN8(n##1)  FN8(n##2)  FN8(n##3) \
+                 FN8(n##4)  FN8(n##5)  FN8(n##6)  FN8(n##7)
+
+FN64(0) FN64(1) FN64(2) FN64(3) FN64(4) FN64(5) FN64(6) FN64(7)
+
+#define PTR(n)   ldso_startup_fn_##n,
+#define PTR8(n)  PTR(n##0)  PTR(n##1)  PTR(n##2)  PTR(n##3) \
+                 PTR(n##4)  PTR(n##5)  PTR(n##6)  PTR(n##7)
+#define PTR64(n) PTR8(n##0) PTR8(n##1) PTR8(n##2) PTR8(n##3) \
+                 PTR8(n##4) PTR8(n##5) PTR8(n##6) PTR8(n##7)
+#define PTRS     PTR64(0) PTR64(1) PTR64(2) PTR64(3) \
+                 PTR64(4) PTR64(5) PTR64(6) PTR64(7)
+
+typedef int (*Fn)();
+
+extern "C" Fn const ldso_startup_table_1[] = { PTRS };
+extern "C" Fn const ldso_startup_table_2[] = { PTRS };
+
+#define CALL(n)   + ldso_startup_fn_##n()
+#define CALL8(n)  CALL(n##0)  CALL(n##1)  CALL(n##2)  CALL(n##3) \
+                  CALL(n##4)  CALL(n##5)  CALL(n##6)  CALL(n##7)
+#define CALL64(n) CALL8(n##0) CALL8(n##1) CALL8(n##2) CALL8(n##3) \
+                  CALL8(n##4) CALL8(n##5) CALL8(n##6) CALL8(n##7)
+
+extern "C" int ldso_startup_sum()
+{
+	return 0 CALL64(0) CALL64(1) CALL64(2) CALL64(3)
+	         CALL64(4) CALL64(5) CALL64(6) CALL64(7);
+}
@@ -0,0 +1,2 @@
+TARGET = dummy-test-ldso_startup_lib
+LIBS   = test-ldso_startup_lib
@@ -0,0 +1,96 @@
+/*
+ * \brief  Benchmark of the relocation work of the dynamic linker
+ * \author Genode Labs
+ * \date   2018-12-17
+ *
+ * The benchmark repeatedly loads a shared library with many symbol
+ * relocations, which exercises the same symbol lookups as the startup of
+ * a dynamically linked component. The library is loaded with lazy binding
+ * and with immediate binding of the PLT. The run script measures the
+ * duration of each phase by the time between the "start" and "finished"
+ * messages.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/shared_object.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	enum {
+		NUM_LOADS    = 100,
+		NUM_FUNCS    = 512,
+		EXPECTED_SUM = NUM_FUNCS*(NUM_FUNCS - 1)/2,
+	};
+
+	Env &_env;
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	/**
+	 * Load and unload library 'NUM_LOADS' times
+	 *
+	 * \return true if the relocated library works as expected
+	 */
+	bool _load(Shared_object::Bind bind)
+	{
+		bool ok = true;
+
+		for (unsigned i = 0; i < NUM_LOADS; i++) {
+
+			Shared_object lib(_env, _heap, "test-ldso_startup_lib.lib.so",
+			                  bind, Shared_object::DONT_KEEP);
+
+			typedef int (*Fn)();
+
+			Fn const *table = lib.lookup<Fn const *>("ldso_startup_table_2");
+
+			ok &= (table[NUM_FUNCS - 1]() == NUM_FUNCS - 1);
+			ok &= (lib.lookup<Fn>("ldso_startup_sum")() == EXPECTED_SUM);
+		}
+		return ok;
+	}
+
+	template <typename FN>
+	static bool _phase(char const *name, FN const &fn)
+	{
+		log("start ", name);
+		bool const result = fn();
+		log("finished ", name);
+		return result;
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		log("ldso startup benchmark started");
+
+		bool ok = true;
+
+		ok &= _phase("lazy binding", [&] () {
+			return _load(Shared_object::BIND_LAZY); });
+
+		ok &= _phase("immediate binding", [&] () {
+			return _load(Shared_object::BIND_NOW); });
+
+		if (!ok)
+			error("library yields unexpected results");
+
+		log("--- ldso startup benchmark ", ok ? "finished" : "failed", " ---");
+		_env.parent().exit(ok ? 0 : -1);
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-ldso_startup
+SRC_CC = main.cc
+LIBS  += base
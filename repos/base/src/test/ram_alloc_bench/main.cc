@@ -0,0 +1,114 @@
+/*
+ * \brief  Benchmark of the allocation of RAM dataspaces
+ * \author Genode Labs
+ * \date   2018-12-18
+ *
+ * The benchmark allocates and frees RAM dataspaces of different sizes in
+ * two rounds. Between allocation and release, the content of each
+ * dataspace is checked to be zeroed and is overwritten afterwards. So the
+ * second round obtains memory that was used before. The run script
+ * measures the duration of each phase by the time between the "start" and
+ * "finished" messages.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+#include <util/string.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	enum { MAX_DATASPACES = 64 };
+
+	Env &_env;
+
+	Ram_dataspace_capability _ds[MAX_DATASPACES];
+
+	void _alloc(size_t size, unsigned count)
+	{
+		for (unsigned i = 0; i < count; i++)
+			_ds[i] = _env.ram().alloc(size);
+	}
+
+	void _free(unsigned count)
+	{
+		for (unsigned i = 0; i < count; i++)
+			_env.ram().free(_ds[i]);
+	}
+
+	/**
+	 * Check that the dataspaces are zeroed and fill them with a pattern
+	 */
+	bool _check_and_fill(size_t size, unsigned count)
+	{
+		bool zeroed = true;
+
+		for (unsigned i = 0; i < count; i++) {
+
+			unsigned long * const words = _env.rm().attach(_ds[i]);
+
+			for (size_t j = 0; j < size/sizeof(long); j++)
+				if (words[j]) {
+					error("dataspace ", i, " of size ", size, " not zeroed "
+					      "at offset ", Hex(j*sizeof(long)));
+					zeroed = false;
+					break;
+				}
+
+			memset(words, 0x55, size);
+
+			_env.rm().detach(words);
+		}
+		return zeroed;
+	}
+
+	template <typename FN>
+	static void _phase(char const *name, size_t size, unsigned round, FN const &fn)
+	{
+		log("start ", name, " ", size/1024, "K ", round);
+		fn();
+		log("finished ", name, " ", size/1024, "K ", round);
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		log("RAM allocation benchmark started");
+
+		struct { size_t size; unsigned count; } const tests[] = {
+			{   64*1024, 64 },
+			{ 1024*1024, 16 },
+			{ 8192*1024,  4 } };
+
+		bool ok = true;
+
+		for (auto const &test : tests) {
+			for (unsigned round = 1; round <= 2; round++) {
+
+				_phase("alloc", test.size, round, [&] () {
+					_alloc(test.size, test.count); });
+
+				if (!_check_and_fill(test.size, test.count))
+					ok = false;
+
+				_phase("free", test.size, round, [&] () {
+					_free(test.count); });
+			}
+		}
+
+		log("--- RAM allocation benchmark ", ok ? "finished" : "failed", " ---");
+		_env.parent().exit(ok ? 0 : -1);
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
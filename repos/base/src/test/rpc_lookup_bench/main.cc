@@ -0,0 +1,138 @@
+/*
+ * \brief  Benchmark of the lookup of RPC objects by capability
+ * \author Genode Labs
+ * \date   2018-12-17
+ *
+ * The benchmark manages a growing number of RPC objects at an entrypoint.
+ * For each number of objects, it looks up the objects via the object pool
+ * of the entrypoint and invokes them via RPC. The run script measures the
+ * duration of each phase by the time between the "start" and "finished"
+ * messages.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/rpc_server.h>
+#include <base/rpc_client.h>
+
+using namespace Genode;
+
+
+namespace Test {
+
+	struct Nop_interface : Interface
+	{
+		GENODE_RPC(Rpc_nop, void, nop);
+		GENODE_RPC_INTERFACE(Rpc_nop);
+	};
+
+	struct Nop_object : Rpc_object<Nop_interface, Nop_object>
+	{
+		void nop() { }
+	};
+}
+
+
+struct Main
+{
+	enum {
+		STACK_SIZE    = 4*1024*sizeof(long),
+		MAX_OBJECTS   = 4096,
+		NUM_LOOKUPS   = 1000000,
+		NUM_RPCS      = 100000,
+	};
+
+	Env &_env;
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	Rpc_entrypoint _ep { &_env.pd(), STACK_SIZE, "rpc_lookup_bench" };
+
+	Test::Nop_object                  *_objects[MAX_OBJECTS] { };
+	Capability<Test::Nop_interface>    _caps[MAX_OBJECTS];
+
+	unsigned _num_objects = 0;
+
+	void _grow(unsigned num_objects)
+	{
+		for (; _num_objects < num_objects; _num_objects++) {
+			_objects[_num_objects] = new (_heap) Test::Nop_object;
+			_caps[_num_objects]    = _ep.manage(_objects[_num_objects]);
+		}
+	}
+
+	/**
+	 * Index of the object accessed at step 'i', spread over all objects
+	 */
+	unsigned _index(unsigned i) const { return (i*7919) % _num_objects; }
+
+	unsigned long _lookup()
+	{
+		unsigned long found = 0;
+		for (unsigned i = 0; i < NUM_LOOKUPS; i++)
+			_ep.apply(_caps[_index(i)], [&] (Rpc_object_base *obj) {
+				if (obj) found++; });
+		return found;
+	}
+
+	unsigned long _rpc()
+	{
+		for (unsigned i = 0; i < NUM_RPCS; i++)
+			_caps[_index(i)].call<Test::Nop_interface::Rpc_nop>();
+		return NUM_RPCS;
+	}
+
+	template <typename FN>
+	static unsigned long _phase(char const *name, unsigned num_objects, FN const &fn)
+	{
+		log("start ", name, " ", num_objects);
+		unsigned long const result = fn();
+		log("finished ", name, " ", num_objects);
+		return result;
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		log("RPC lookup benchmark started");
+
+		bool ok = true;
+
+		for (unsigned n = 16; n <= MAX_OBJECTS; n *= 4) {
+
+			_grow(n);
+
+			if (_phase("lookup", n, [&] () { return _lookup(); }) != NUM_LOOKUPS) {
+				error("lookup failed with ", n, " objects");
+				ok = false;
+			}
+
+			_phase("rpc", n, [&] () { return _rpc(); });
+		}
+
+		for (unsigned i = 0; i < _num_objects; i++) {
+			_ep.dissolve(_objects[i]);
+			destroy(_heap, _objects[i]);
+		}
+
+		log("--- RPC lookup benchmark ", ok ? "finished" : "failed", " ---");
+		_env.parent().exit(ok ? 0 : -1);
+	}
+
+	/*
+	 * Noncopyable
+	 */
+	Main(Main const &);
+	Main &operator = (Main const &);
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
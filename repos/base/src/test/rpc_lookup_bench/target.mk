@@ -0,0 +1,3 @@
+TARGET = test-rpc_lookup_bench
+SRC_CC = main.cc
+LIBS  += base
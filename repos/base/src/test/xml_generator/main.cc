@@ -15,6 +15,7 @@
 #include <base/log.h>
 #include <util/xml_generator.h>
 #include <util/xml_node.h>
+#include <util/xml_delta.h>
 
 using Genode::size_t;
 
@@ -159,6 +160,29 @@ static size_t xml_with_exceptions(char *dst, size_t dst_len)
 	return xml.used();
 }
 
+static size_t xml_with_children(char *dst, size_t dst_len,
+                                char const *changed, char const *added)
+{
+	Genode::Xml_generator xml(dst, dst_len, "state", [&]
+	{
+		xml.attribute("version", "1");
+
+		auto child = [&] (char const *name, char const *state) {
+			xml.node("child", [&] () {
+				xml.attribute("name",  name);
+				xml.attribute("state", state); }); };
+
+		child("timer",    "ok");
+		child("nic_drv",  changed);
+		child("fs",       "ok");
+		child("platform", "ok");
+		if (added)
+			child(added, "incomplete");
+	});
+	return xml.used();
+}
+
+
 extern void gcov_init(Genode::Env &env);
 extern void genode_exit(int status);
 
@@ -226,6 +250,48 @@ void Component::construct(Genode::Env &env)
 		}
 	}
 
+	/*
+	 * Test the generation and application of XML deltas
+	 */
+	{
+		static char prev_buf[1000], curr_buf[1000], delta_buf[1000];
+
+		size_t const prev_len = xml_with_children(prev_buf, sizeof(prev_buf), "ok", nullptr);
+		size_t const curr_len = xml_with_children(curr_buf, sizeof(curr_buf), "incomplete", "log");
+
+		Xml_node const prev(prev_buf, prev_len), curr(curr_buf, curr_len);
+
+		if (!Xml_delta::representable(curr)) {
+			log("generated XML cannot be reproduced from a delta");
+			return;
+		}
+
+		Xml_generator delta_xml(delta_buf, sizeof(delta_buf), "state", [&] () {
+			Xml_delta::generate(delta_xml, prev, curr, Xml_delta::checksum(prev)); });
+
+		log("\nused ", delta_xml.used(), " bytes, delta:\n\n", Cstring(delta_buf));
+
+		memset(dst, 0, sizeof(dst));
+		Xml_node const delta(delta_buf, delta_xml.used());
+		Xml_generator xml(dst, sizeof(dst), "state", [&] () {
+			Xml_delta::apply(xml, prev, delta); });
+
+		if (xml.used() != curr_len || memcmp(dst, curr_buf, curr_len)) {
+			log("applied delta does not match the new version:\n", Cstring(dst));
+			return;
+		}
+
+		/* a delta must not be applied to another version */
+		try {
+			Xml_generator xml(dst, sizeof(dst), "state", [&] () {
+				Xml_delta::apply(xml, curr, delta); });
+			log("delta applied to wrong version");
+			return;
+		}
+		catch (Xml_delta::Invalid_delta) {
+			log("delta refers to other version (expected error)\n"); }
+	}
+
 	log("--- XML generator test finished ---");
 	genode_exit(0);
 }
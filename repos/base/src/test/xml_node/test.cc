@@ -14,8 +14,10 @@
 
 /* Genode includes */
 #include <util/xml_node.h>
+#include <util/xml_node_index.h>
 #include <base/attached_ram_dataspace.h>
 #include <base/component.h>
+#include <base/heap.h>
 #include <base/log.h>
 
 using namespace Genode;
@@ -317,6 +319,17 @@ static void log_xml_info(const char *xml_string)
 }
 
 
+static void log_indexed_xml_info(Allocator &alloc, const char *xml_string)
+{
+	try {
+		Xml_node_index const index(alloc, Xml_node(xml_string));
+		log(Formatted_xml_node(index.xml()));
+	} catch (Xml_node::Invalid_syntax) {
+		log("string has invalid XML syntax\n");
+	}
+}
+
+
 template <size_t max_content_sz>
 static void test_decoded_content(Env        &env,
                                  unsigned    step,
@@ -408,6 +421,14 @@ void Component::construct(Genode::Env &env)
 	log("-- Test parsing XML with comments --");
 	log_xml_info(xml_test_comments);
 
+	log("-- Test indexed XML structure --");
+	{
+		Heap heap(env.ram(), env.rm());
+		log_indexed_xml_info(heap, xml_test_valid);
+		log_indexed_xml_info(heap, xml_test_attributes);
+		log_indexed_xml_info(heap, xml_test_truncated);
+	}
+
 	log("-- Test exporting decoded content from XML node --");
 	test_decoded_content<~0UL>(env, 1, xml_test_comments, 8, 119);
 	test_decoded_content<119 >(env, 2, xml_test_comments, 8, 119);
@@ -0,0 +1,138 @@
+/*
+ * \brief  Benchmark of the traversal of large XML data
+ * \author Genode Labs
+ * \date   2018-12-08
+ *
+ * The benchmark generates a report with many sub nodes, resembling the
+ * state report of a large subsystem, and traverses it once via plain
+ * 'Xml_node' objects and once via an 'Xml_node_index'. The run script
+ * measures the duration of each phase by the time between the "start"
+ * and "finished" messages.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/attached_ram_dataspace.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <util/xml_generator.h>
+#include <util/xml_node_index.h>
+#include <util/reconstructible.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	enum {
+		BUFFER_SIZE  = 8*1024*1024,
+		NUM_CHILDREN = 20000,
+		NUM_SAMPLES  = 200,
+	};
+
+	Env &_env;
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	Attached_ram_dataspace _buffer { _env.ram(), _env.rm(), BUFFER_SIZE };
+
+	size_t _generate()
+	{
+		Xml_generator xml(_buffer.local_addr<char>(), BUFFER_SIZE, "state", [&] () {
+			for (unsigned i = 0; i < NUM_CHILDREN; i++) {
+				xml.node("child", [&] () {
+					xml.attribute("name", i);
+					xml.attribute("state", "incomplete");
+					xml.node("ram", [&] () {
+						xml.attribute("assigned", 1024*1024);
+						xml.attribute("quota",    1000*1024);
+						xml.attribute("used",     512*1024); });
+					xml.node("caps", [&] () {
+						xml.attribute("assigned", 100);
+						xml.attribute("quota",    96);
+						xml.attribute("used",     42); });
+				});
+			}
+		});
+		return xml.used();
+	}
+
+	/**
+	 * Visit all sub nodes and accumulate a value of each child
+	 */
+	static unsigned long _walk(Xml_node node)
+	{
+		unsigned long sum = 0;
+		node.for_each_sub_node("child", [&] (Xml_node child) {
+			sum += child.attribute_value("name", 0UL);
+			sum += child.sub_node("caps").attribute_value("used", 0UL); });
+		return sum;
+	}
+
+	/**
+	 * Access children by index, which is common for list-like reports
+	 */
+	static unsigned long _sample(Xml_node node)
+	{
+		unsigned long sum = 0;
+		for (unsigned i = 0; i < NUM_SAMPLES; i++)
+			sum += node.sub_node((i*7919) % NUM_CHILDREN)
+			           .attribute_value("name", 0UL);
+		return sum;
+	}
+
+	template <typename FN>
+	static unsigned long _phase(char const *name, FN const &fn)
+	{
+		log("start ", name);
+		unsigned long const result = fn();
+		log("finished ", name);
+		return result;
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		log("Xml_node benchmark started");
+
+		size_t const size = _generate();
+		log("generated report of ", size, " bytes");
+
+		Xml_node const xml(_buffer.local_addr<char>(), size);
+
+		unsigned long const plain_walk =
+			_phase("plain walk", [&] () { return _walk(xml); });
+
+		unsigned long const plain_sample =
+			_phase("plain sample", [&] () { return _sample(xml); });
+
+		Constructible<Xml_node_index> index { };
+		_phase("index construction", [&] () {
+			index.construct(_heap, xml);
+			return 0UL; });
+
+		unsigned long const indexed_walk =
+			_phase("indexed walk", [&] () { return _walk(index->xml()); });
+
+		unsigned long const indexed_sample =
+			_phase("indexed sample", [&] () { return _sample(index->xml()); });
+
+		bool const ok = (plain_walk   == indexed_walk)
+		             && (plain_sample == indexed_sample);
+
+		if (!ok)
+			error("indexed traversal yields different results");
+
+		log("--- Xml_node benchmark ", ok ? "finished" : "failed", " ---");
+		_env.parent().exit(ok ? 0 : -1);
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
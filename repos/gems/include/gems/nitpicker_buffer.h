@@ -23,6 +23,7 @@
 #include <os/pixel_rgb565.h>
 #include <os/pixel_alpha8.h>
 #include <os/pixel_rgb888.h>
+#include <blit/blit.h>
 
 /* gems includes */
 #include <gems/dither_painter.h>
@@ -155,6 +156,22 @@ struct Nitpicker_buffer
 		Dither_painter::paint(surface, texture, Point());
 	}
 
+	void _convert_back_to_front(Pixel_rgb565                        *front_base,
+	                            Genode::Texture<Pixel_rgb888> const &texture,
+	                            Rect                          const  clip_rect)
+	{
+		Rect const clipped = Rect::intersect(clip_rect, Rect(Point(0, 0), size()));
+
+		if (!clipped.valid()) return;
+
+		unsigned const line_len = size().w();
+		unsigned const offset   = line_len*clipped.y1() + clipped.x1();
+
+		dither_rgb888_to_rgb565(texture.pixel() + offset, line_len*sizeof(Pixel_rgb888),
+		                        front_base      + offset, line_len*sizeof(Pixel_rgb565),
+		                        clipped.w(), clipped.h(), clipped.x1(), clipped.y1());
+	}
+
 	void _update_input_mask()
 	{
 		unsigned const num_pixels = size().count();
@@ -38,6 +38,7 @@
 #include "libc_mem_alloc.h"
 #include "libc_mmap_registry.h"
 #include "libc_errno.h"
+#include "readiness.h"
 
 using namespace Libc;
 
@@ -227,9 +228,13 @@ extern "C" int _close(int libc_fd)
 {
 	Libc::File_descriptor *fd =
 		Libc::file_descriptor_allocator()->find_by_libc_fd(libc_fd);
-	return (!fd || !fd->plugin)
-		? Libc::Errno(EBADF)
-		: fd->plugin->close(fd);
+	if (!fd || !fd->plugin)
+		return Libc::Errno(EBADF);
+
+	/* like on FreeBSD, events registered for the descriptor vanish */
+	Libc::kqueue_close(libc_fd);
+
+	return fd->plugin->close(fd);
 }
 
 
@@ -447,7 +452,14 @@ extern "C" void *mmap(void *addr, ::size_t length, int prot, int flags,
 	}
 
 	void *start = fd->plugin->mmap(addr, length, prot, flags, fd, offset);
-	mmap_registry()->insert(start, length, fd->plugin);
+
+	/*
+	 * A plugin that maps a dataspace registers the mapping along with the
+	 * dataspace by itself.
+	 */
+	if (start != MAP_FAILED && !mmap_registry()->registered(start))
+		mmap_registry()->insert(start, length, fd->plugin);
+
 	return start;
 }
 
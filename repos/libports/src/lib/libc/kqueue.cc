@@ -0,0 +1,514 @@
+/*
+ * \brief  kqueue() and kevent() implementation
+ * \author Genode Labs
+ * \date   2018-12-16
+ *
+ * Each registered event is represented by a knote. Knotes are queued for
+ * examination when they are registered or when their file descriptor is
+ * notified via 'Libc::kqueue_notify()'. 'kevent()' examines the queued
+ * knotes only, so its costs depend on the number of notified and ready
+ * descriptors but not on the number of registered descriptors. Ready
+ * knotes stay queued unless they are edge-triggered (EV_CLEAR).
+ *
+ * Only the EVFILT_READ and EVFILT_WRITE filters are supported. Knotes of
+ * a file descriptor are removed when the descriptor gets closed.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/lock.h>
+#include <util/fifo.h>
+#include <util/list.h>
+
+/* libc plugin interface */
+#include <libc-plugin/fd_alloc.h>
+#include <libc-plugin/plugin.h>
+
+/* libc includes */
+#include <libc/allocator.h>
+#include <errno.h>
+#include <sys/event.h>
+#include <sys/select.h>
+#include <sys/time.h>
+
+/* libc-internal includes */
+#include "libc_errno.h"
+#include "readiness.h"
+#include "task.h"
+
+
+namespace Libc {
+	struct Knote;
+	struct Kqueue;
+	struct Kqueue_plugin;
+}
+
+
+static Libc::Allocator kqueue_allocator;
+
+
+/**
+ * Event registered at a kqueue
+ */
+struct Libc::Knote : Genode::Fifo<Knote>::Element
+{
+	Knote *fd_next = nullptr;   /* next knote of the same descriptor */
+	bool   enabled = true;
+
+	struct kevent kev;
+
+	Knote(struct kevent const &change) : kev(change)
+	{
+		kev.flags &= ~(EV_ADD | EV_DELETE | EV_ENABLE | EV_DISABLE);
+		kev.data   = 0;
+	}
+
+	/*
+	 * Noncopyable
+	 */
+	Knote(Knote const &);
+	Knote &operator = (Knote const &);
+};
+
+
+class Libc::Kqueue : public Plugin_context, public Genode::List<Kqueue>::Element
+{
+	private:
+
+		Genode::Allocator &_alloc;
+
+		/* protects the knotes of the descriptors and the queue */
+		Genode::Lock _lock { };
+
+		/* serializes the callers of 'kevent()' */
+		Genode::Lock _kevent_lock { };
+
+		Knote *_knotes[FD_SETSIZE] { };
+
+		Genode::Fifo<Knote> _queue     { };
+		unsigned            _num_queued { 0 };
+
+		Knote *_find(int fd, short filter)
+		{
+			for (Knote *k = _knotes[fd]; k; k = k->fd_next)
+				if (k->kev.filter == filter)
+					return k;
+			return nullptr;
+		}
+
+		/**
+		 * Queue knote for examination, called with '_lock' held
+		 *
+		 * \return true if the knote got queued
+		 */
+		bool _enqueue(Knote &k)
+		{
+			if (!k.enabled || k.enqueued())
+				return false;
+
+			_queue.enqueue(&k);
+			_num_queued++;
+			return true;
+		}
+
+		/**
+		 * Remove and destroy knote, called with '_lock' held
+		 */
+		void _destroy(Knote &k)
+		{
+			if (k.enqueued()) {
+				_queue.remove(&k);
+				_num_queued--;
+			}
+
+			int const fd = (int)k.kev.ident;
+			for (Knote **p = &_knotes[fd]; *p; p = &(*p)->fd_next)
+				if (*p == &k) {
+					*p = k.fd_next;
+					break;
+				}
+
+			Genode::destroy(_alloc, &k);
+		}
+
+		Knote *_dequeue()
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			Knote * const k = _queue.dequeue();
+			if (k)
+				_num_queued--;
+			return k;
+		}
+
+		/**
+		 * Examine dequeued knote
+		 *
+		 * \return true if the event is reported via 'out'
+		 */
+		bool _examine(Knote &k, struct kevent &out)
+		{
+			int const fd = (int)k.kev.ident;
+
+			if (!file_descriptor_allocator()->find_by_libc_fd(fd)) {
+				Genode::Lock::Guard guard(_lock);
+				_destroy(k);
+				return false;
+			}
+
+			bool readable = false, writeable = false;
+			fd_readiness(fd, readable, writeable);
+
+			bool const ready = (k.kev.filter == EVFILT_READ) ? readable : writeable;
+
+			Genode::Lock::Guard guard(_lock);
+
+			/* disabled knotes may still be queued */
+			if (!ready || !k.enabled)
+				return false;
+
+			out = k.kev;
+
+			if (k.kev.flags & EV_ONESHOT)
+				_destroy(k);
+			else if (k.kev.flags & EV_DISPATCH)
+				k.enabled = false;
+			else if (!(k.kev.flags & EV_CLEAR))
+				_enqueue(k);
+
+			return true;
+		}
+
+		/*
+		 * Noncopyable
+		 */
+		Kqueue(Kqueue const &);
+		Kqueue &operator = (Kqueue const &);
+
+	public:
+
+		Kqueue(Genode::Allocator &alloc) : _alloc(alloc) { }
+
+		~Kqueue()
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			for (unsigned fd = 0; fd < FD_SETSIZE; fd++)
+				while (_knotes[fd])
+					_destroy(*_knotes[fd]);
+		}
+
+		/**
+		 * Lock to be held while changing or collecting events
+		 */
+		Genode::Lock &kevent_lock() { return _kevent_lock; }
+
+		/**
+		 * Apply change to the registered events
+		 *
+		 * \return 0 on success, or the error number
+		 */
+		int apply(struct kevent const &change)
+		{
+			if (change.filter != EVFILT_READ && change.filter != EVFILT_WRITE)
+				return EINVAL;
+
+			if (change.ident >= FD_SETSIZE)
+				return EBADF;
+
+			int const fd = (int)change.ident;
+
+			if ((change.flags & EV_ADD)
+			 && !file_descriptor_allocator()->find_by_libc_fd(fd))
+				return EBADF;
+
+			Genode::Lock::Guard guard(_lock);
+
+			Knote *k = _find(fd, change.filter);
+
+			if (change.flags & EV_ADD) {
+
+				if (k) {
+					k->kev.flags  = change.flags & ~(EV_ADD | EV_ENABLE | EV_DISABLE);
+					k->kev.fflags = change.fflags;
+					k->kev.udata  = change.udata;
+				} else {
+					k = new (_alloc) Knote(change);
+					k->fd_next  = _knotes[fd];
+					_knotes[fd] = k;
+				}
+
+				k->enabled = !(change.flags & EV_DISABLE);
+
+				/* report the current state with the next 'kevent()' */
+				_enqueue(*k);
+				return 0;
+			}
+
+			if (!k)
+				return ENOENT;
+
+			if (change.flags & EV_DELETE) {
+				_destroy(*k);
+				return 0;
+			}
+
+			if (change.flags & EV_ENABLE) {
+				k->enabled = true;
+				_enqueue(*k);
+			}
+
+			if (change.flags & EV_DISABLE)
+				k->enabled = false;
+
+			return 0;
+		}
+
+		/**
+		 * Queue the knotes of notified descriptor
+		 *
+		 * \param fd  file descriptor, or ANY_READY_FD for all descriptors
+		 *
+		 * \return true if any knote got queued
+		 */
+		bool notify(int fd)
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			bool queued = false;
+
+			if (fd >= 0 && fd < (int)FD_SETSIZE) {
+				for (Knote *k = _knotes[fd]; k; k = k->fd_next)
+					queued |= _enqueue(*k);
+				return queued;
+			}
+
+			for (unsigned i = 0; i < FD_SETSIZE; i++)
+				for (Knote *k = _knotes[i]; k; k = k->fd_next)
+					queued |= _enqueue(*k);
+
+			return queued;
+		}
+
+		/**
+		 * Remove the knotes of closed descriptor
+		 */
+		void drop(int fd)
+		{
+			if (fd < 0 || fd >= (int)FD_SETSIZE)
+				return;
+
+			Genode::Lock::Guard guard(_lock);
+
+			while (_knotes[fd])
+				_destroy(*_knotes[fd]);
+		}
+
+		bool queued()
+		{
+			Genode::Lock::Guard guard(_lock);
+			return _num_queued > 0;
+		}
+
+		/**
+		 * Collect ready events, called with 'kevent_lock()' held
+		 *
+		 * Each knote queued at the time of the call is examined at most
+		 * once. Ready level-triggered knotes are queued again behind.
+		 *
+		 * \return number of events stored in 'out'
+		 */
+		int collect(struct kevent *out, int max)
+		{
+			unsigned num_examine = 0;
+			{
+				Genode::Lock::Guard guard(_lock);
+				num_examine = _num_queued;
+			}
+
+			int n = 0;
+			for (; num_examine && n < max; num_examine--) {
+
+				Knote * const k = _dequeue();
+				if (!k)
+					break;
+
+				if (_examine(*k, out[n]))
+					n++;
+			}
+			return n;
+		}
+};
+
+
+/**
+ * Kqueues for which notifications are queued
+ */
+static Genode::Lock              kqueues_lock;
+static Genode::List<Libc::Kqueue> kqueues;
+
+
+bool Libc::kqueue_notify(int libc_fd)
+{
+	Genode::Lock::Guard guard(kqueues_lock);
+
+	bool queued = false;
+	for (Kqueue *kq = kqueues.first(); kq; kq = kq->next())
+		queued |= kq->notify(libc_fd);
+
+	return queued;
+}
+
+
+void Libc::kqueue_close(int libc_fd)
+{
+	Genode::Lock::Guard guard(kqueues_lock);
+
+	for (Kqueue *kq = kqueues.first(); kq; kq = kq->next())
+		kq->drop(libc_fd);
+}
+
+
+struct Libc::Kqueue_plugin : Plugin
+{
+	static Kqueue *kqueue(File_descriptor *fd)
+	{
+		return fd ? dynamic_cast<Kqueue *>(fd->context) : nullptr;
+	}
+
+	int close(File_descriptor *fd) override
+	{
+		Kqueue *kq = kqueue(fd);
+		if (!kq)
+			return Errno(EBADF);
+
+		{
+			Genode::Lock::Guard guard(kqueues_lock);
+			kqueues.remove(kq);
+		}
+
+		Genode::destroy(kqueue_allocator, kq);
+		file_descriptor_allocator()->free(fd);
+		return 0;
+	}
+};
+
+
+static Libc::Kqueue_plugin &kqueue_plugin()
+{
+	static Libc::Kqueue_plugin inst;
+	return inst;
+}
+
+
+extern "C" __attribute__((weak))
+int kqueue(void)
+{
+	Libc::init_select_notify();
+
+	Libc::Kqueue *kq = new (kqueue_allocator) Libc::Kqueue(kqueue_allocator);
+
+	Libc::File_descriptor *fd =
+		Libc::file_descriptor_allocator()->alloc(&kqueue_plugin(), kq);
+
+	if (!fd) {
+		Genode::destroy(kqueue_allocator, kq);
+		return Libc::Errno(EMFILE);
+	}
+
+	Genode::Lock::Guard guard(kqueues_lock);
+	kqueues.insert(kq);
+
+	return fd->libc_fd;
+}
+
+
+extern "C" __attribute__((weak))
+int kevent(int kq_fd, const struct kevent *changelist, int nchanges,
+           struct kevent *eventlist, int nevents, const struct timespec *timeout)
+{
+	Libc::Kqueue *kq = Libc::Kqueue_plugin::kqueue(
+		Libc::file_descriptor_allocator()->find_by_libc_fd(kq_fd));
+
+	if (!kq)
+		return Libc::Errno(EBADF);
+
+	if (nchanges < 0 || nevents < 0 || (nchanges && !changelist)
+	 || (nevents && !eventlist))
+		return Libc::Errno(EINVAL);
+
+	int n = 0;
+	{
+		Genode::Lock::Guard guard(kq->kevent_lock());
+
+		/* errors of changes are reported as EV_ERROR events if possible */
+		for (int i = 0; i < nchanges; i++) {
+
+			int const error = kq->apply(changelist[i]);
+
+			if (!error && !(changelist[i].flags & EV_RECEIPT))
+				continue;
+
+			if (n == nevents) {
+				if (error)
+					return Libc::Errno(error);
+				continue;
+			}
+
+			eventlist[n]       = changelist[i];
+			eventlist[n].flags = EV_ERROR;
+			eventlist[n].data  = error;
+			n++;
+		}
+
+		if (n)
+			return n;
+
+		n = kq->collect(eventlist, nevents);
+	}
+
+	if (n || !nevents || (timeout && !timeout->tv_sec && !timeout->tv_nsec))
+		return n;
+
+	struct Timeout
+	{
+		timespec const *_ts;
+		bool    const   valid    { _ts != nullptr };
+		unsigned long   duration {
+			valid ? (unsigned long)_ts->tv_sec*1000 + _ts->tv_nsec/1000000 : 0UL };
+
+		bool expired() const { return valid && duration == 0; };
+
+		Timeout(timespec const *ts) : _ts(ts) { }
+	} timeout_ms { timeout };
+
+	struct Check : Libc::Suspend_functor
+	{
+		Timeout      &timeout;
+		Libc::Kqueue &kq;
+
+		Check(Timeout &timeout, Libc::Kqueue &kq) : timeout(timeout), kq(kq) { }
+
+		bool suspend() override { return !timeout.expired() && !kq.queued(); }
+	} check { timeout_ms, *kq };
+
+	/* sub-millisecond timeouts are rounded up to avoid an infinite suspend */
+	if (timeout_ms.valid && !timeout_ms.duration)
+		timeout_ms.duration = 1;
+
+	while (!n && !timeout_ms.expired()) {
+
+		while (check.suspend())
+			timeout_ms.duration = Libc::suspend(check, timeout_ms.duration);
+
+		Genode::Lock::Guard guard(kq->kevent_lock());
+		n = kq->collect(eventlist, nevents);
+	}
+	return n;
+}
@@ -12,6 +12,8 @@
 #include <base/env.h>
 #include <base/log.h>
 #include <libc/allocator.h>
+#include <dataspace/capability.h>
+#include <vfs/types.h>
 
 /* libc-internal includes */
 #include <libc-plugin/plugin.h>
@@ -34,13 +36,30 @@ class Libc::Mmap_registry
 {
 	public:
 
+		/**
+		 * Dataspace attached as mapping of a file
+		 *
+		 * Anonymous mappings and mappings that hold a copy of the file
+		 * content have no backing dataspace.
+		 */
+		struct Backing
+		{
+			typedef Genode::String<Vfs::MAX_PATH_LEN> Path;
+
+			Genode::Dataspace_capability ds;
+
+			/* path of the file the dataspace was obtained for */
+			Path path;
+		};
+
 		struct Entry : Genode::List<Entry>::Element
 		{
-			void   * const start;
-			Plugin * const plugin;
+			void    * const start;
+			Plugin  * const plugin;
+			Backing   const backing;
 
-			Entry(void *start, Plugin *plugin)
-			: start(start), plugin(plugin) { }
+			Entry(void *start, Plugin *plugin, Backing const &backing)
+			: start(start), plugin(plugin), backing(backing) { }
 		};
 
 	private:
@@ -76,7 +95,8 @@ class Libc::Mmap_registry
 
 	public:
 
-		void insert(void *start, Genode::size_t len, Plugin *plugin)
+		void insert(void *start, Genode::size_t len, Plugin *plugin,
+		            Backing const &backing = Backing())
 		{
 			Genode::Lock::Guard guard(_lock);
 
@@ -86,7 +106,7 @@ class Libc::Mmap_registry
 				return;
 			}
 
-			_list.insert(new (&_md_alloc) Entry(start, plugin));
+			_list.insert(new (&_md_alloc) Entry(start, plugin, backing));
 		}
 
 		Plugin *lookup_plugin_by_addr(void *start) const
@@ -97,6 +117,23 @@ class Libc::Mmap_registry
 			return e ? e->plugin : 0;
 		}
 
+		/**
+		 * Obtain backing of the mapping at 'start'
+		 *
+		 * \return false if the mapping has no backing dataspace
+		 */
+		bool lookup_backing_by_addr(void *start, Backing &backing) const
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			Entry const * const e = _lookup_by_addr_unsynchronized(start);
+			if (!e || !e->backing.ds.valid())
+				return false;
+
+			backing = e->backing;
+			return true;
+		}
+
 		bool registered(void *start) const
 		{
 			Genode::Lock::Guard guard(_lock);
@@ -16,6 +16,7 @@
 #include <base/env.h>
 #include <base/log.h>
 #include <base/slab.h>
+#include <base/thread.h>
 #include <util/construct_at.h>
 #include <util/string.h>
 #include <util/misc_math.h>
@@ -66,6 +67,21 @@ namespace Genode {
 
 /**
  * Allocator that uses slabs for small objects sizes
+ *
+ * To relieve multi-threaded programs from contending for the allocator
+ * lock, each thread keeps a small cache of free slab blocks per slab size.
+ * Most allocations and deallocations of small objects are satisfied by the
+ * cache of the calling thread without locking. Only if a cache runs empty
+ * or full, a batch of blocks is moved between the cache and the shared slab
+ * allocator while holding the lock.
+ *
+ * Genode provides no thread-local storage. However, each thread (and each
+ * secondary stack of a thread) executes on a distinct stack of the stack
+ * area. Hence, the caches are looked up by the index of the stack that
+ * contains the current stack pointer. Code executed on a stack outside the
+ * stack area bypasses the caches. A cache is not released when its thread
+ * exits but gets reused by the next thread on the same stack, which keeps
+ * the footprint of all caches bounded by the size of the stack area.
  */
 class Malloc
 {
@@ -80,6 +96,12 @@ class Malloc
 			NUM_SLABS  = (SLAB_STOP - SLAB_START) + 1
 		};
 
+		enum {
+			MAX_THREAD_CACHES  = 256,      /* stacks within the stack area */
+			MAGAZINE_SIZE      = 32,       /* max. cached blocks per slab */
+			MAGAZINE_MAX_BYTES = 8 * 1024, /* max. cached bytes per slab */
+		};
+
 		struct Metadata
 		{
 			unsigned long long value; /* bits 63..5 size and 4..0 offset */
@@ -97,6 +119,20 @@ class Malloc
 			unsigned offset() const { return value & 0x1f; }
 		};
 
+		/**
+		 * Free slab blocks of one size cached by a thread
+		 */
+		struct Magazine
+		{
+			unsigned  count { 0 };
+			void     *blocks[MAGAZINE_SIZE];
+		};
+
+		struct Thread_cache
+		{
+			Magazine magazines[NUM_SLABS];
+		};
+
 		/**
 		 * Allocation overhead due to alignment and metadata storage
 		 *
@@ -112,10 +148,26 @@ class Malloc
 		 */
 		static constexpr size_t _room() { return sizeof(Metadata) + 15; }
 
+		/**
+		 * Number of blocks a magazine of slab 'slab' caches at most
+		 */
+		static constexpr unsigned _capacity(unsigned slab)
+		{
+			return (MAGAZINE_MAX_BYTES >> (slab + SLAB_START)) < MAGAZINE_SIZE
+			     ? (MAGAZINE_MAX_BYTES >> (slab + SLAB_START)) : MAGAZINE_SIZE;
+		}
+
 		Genode::Allocator  &_backing_store;        /* back-end allocator */
 		Genode::Slab_alloc *_allocator[NUM_SLABS]; /* slab allocators */
 		Genode::Lock        _lock;
 
+		addr_t const _stack_area_base { Genode::Thread::stack_area_virtual_base() };
+		size_t const _stack_area_size { Genode::Thread::stack_area_virtual_size() };
+		size_t const _stack_size      { Genode::Thread::stack_virtual_size() };
+
+		/* caches indexed by stack, accessed only by the thread on the stack */
+		Thread_cache *_thread_caches[MAX_THREAD_CACHES] { };
+
 		unsigned _slab_log2(size_t size) const
 		{
 			unsigned msb = Genode::log2(size);
@@ -131,6 +183,80 @@ class Malloc
 			return msb;
 		}
 
+		/**
+		 * Return cache of the calling thread or nullptr if not available
+		 */
+		Thread_cache *_thread_cache()
+		{
+			int dummy = 0; /* used for determining the stack pointer */
+
+			addr_t const sp = (addr_t)&dummy;
+			if (sp < _stack_area_base || sp - _stack_area_base >= _stack_area_size)
+				return nullptr;
+
+			size_t const idx = (sp - _stack_area_base) / _stack_size;
+			if (idx >= MAX_THREAD_CACHES)
+				return nullptr;
+
+			Thread_cache *&cache = _thread_caches[idx];
+			if (cache)
+				return cache;
+
+			Genode::Lock::Guard lock_guard(_lock);
+
+			void *cache_addr = nullptr;
+			if (_backing_store.alloc(sizeof(Thread_cache), &cache_addr))
+				cache = Genode::construct_at<Thread_cache>(cache_addr);
+
+			return cache;
+		}
+
+		void *_slab_alloc(unsigned slab)
+		{
+			Thread_cache *cache = _thread_cache();
+			if (!cache) {
+				Genode::Lock::Guard lock_guard(_lock);
+				return _allocator[slab]->alloc();
+			}
+
+			Magazine &magazine = cache->magazines[slab];
+			if (!magazine.count) {
+
+				/* refill half of the magazine from the shared slab */
+				Genode::Lock::Guard lock_guard(_lock);
+				while (magazine.count < _capacity(slab) / 2) {
+					void *block = _allocator[slab]->alloc();
+					if (!block)
+						break;
+
+					magazine.blocks[magazine.count++] = block;
+				}
+				if (!magazine.count)
+					return nullptr;
+			}
+			return magazine.blocks[--magazine.count];
+		}
+
+		void _slab_free(unsigned slab, void *block)
+		{
+			Thread_cache *cache = _thread_cache();
+			if (!cache) {
+				Genode::Lock::Guard lock_guard(_lock);
+				_allocator[slab]->free(block);
+				return;
+			}
+
+			Magazine &magazine = cache->magazines[slab];
+			if (magazine.count == _capacity(slab)) {
+
+				/* return half of the magazine to the shared slab */
+				Genode::Lock::Guard lock_guard(_lock);
+				while (magazine.count > _capacity(slab) / 2)
+					_allocator[slab]->free(magazine.blocks[--magazine.count]);
+			}
+			magazine.blocks[magazine.count++] = block;
+		}
+
 	public:
 
 		Malloc(Genode::Allocator &backing_store) : _backing_store(backing_store)
@@ -149,18 +275,18 @@ class Malloc
 
 		void * alloc(size_t size)
 		{
-			Genode::Lock::Guard lock_guard(_lock);
-
 			size_t   const real_size = size + _room();
 			unsigned const msb       = _slab_log2(real_size);
 
 			void *alloc_addr = nullptr;
 
 			/* use backing store if requested memory is larger than largest slab */
-			if (msb > SLAB_STOP)
+			if (msb > SLAB_STOP) {
+				Genode::Lock::Guard lock_guard(_lock);
 				_backing_store.alloc(real_size, &alloc_addr);
-			else
-				alloc_addr = _allocator[msb - SLAB_START]->alloc();
+			} else {
+				alloc_addr = _slab_alloc(msb - SLAB_START);
+			}
 
 			if (!alloc_addr) return nullptr;
 
@@ -200,8 +326,6 @@ class Malloc
 
 		void free(void *ptr)
 		{
-			Genode::Lock::Guard lock_guard(_lock);
-
 			Metadata *md = (Metadata *)ptr - 1;
 
 			size_t   const  real_size  = md->size();
@@ -210,9 +334,10 @@ class Malloc
 			void *alloc_addr = (void *)((addr_t)ptr - md->offset());
 
 			if (msb > SLAB_STOP) {
+				Genode::Lock::Guard lock_guard(_lock);
 				_backing_store.free(alloc_addr, real_size);
 			} else {
-				_allocator[msb - SLAB_START]->free(alloc_addr);
+				_slab_free(msb - SLAB_START, alloc_addr);
 			}
 		}
 };
@@ -0,0 +1,93 @@
+/*
+ * \brief  Libc-internal notification of ready file descriptors
+ * \author Genode Labs
+ * \date   2018-12-16
+ *
+ * VFS plugins report I/O events with the context of the affected VFS
+ * handle. The libc attaches a context to each handle that names the file
+ * descriptor whose readiness depends on the handle. Hence, waiters in
+ * 'select()', 'poll()', and 'kevent()' re-examine only the descriptors
+ * that were notified instead of all their descriptors. Events without
+ * such context make all descriptors subject to re-examination.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIBC__READINESS_H_
+#define _LIBC__READINESS_H_
+
+/* Genode includes */
+#include <vfs/vfs_handle.h>
+
+namespace Libc {
+
+	class File_descriptor;
+
+	/**
+	 * Context of the VFS handles opened by the libc
+	 */
+	struct Vfs_handle_context : Vfs::Vfs_handle::Context
+	{
+		int libc_fd;
+
+		Vfs_handle_context(int libc_fd) : libc_fd(libc_fd) { }
+	};
+
+	enum { ANY_READY_FD = -1 };
+
+	/**
+	 * Record that the readiness of a file descriptor may have changed
+	 *
+	 * \param libc_fd  file descriptor, or ANY_READY_FD if unknown
+	 *
+	 * The recorded descriptors are examined by the next 'select_notify()'.
+	 */
+	void notify_ready(int libc_fd);
+
+	/**
+	 * Record notification for the file descriptor named by a handle context
+	 */
+	void notify_ready(Vfs::Vfs_handle::Context *);
+
+	/**
+	 * Let the I/O events of the VFS handle of 'fd' notify 'libc_fd'
+	 *
+	 * This is used by plugins that implement a file descriptor on top of
+	 * other descriptors, e.g., the sockets of the socket file system.
+	 */
+	void redirect_ready_notification(File_descriptor *fd, int libc_fd);
+
+	/**
+	 * Make sure that notifications are examined by 'select_notify()'
+	 */
+	void init_select_notify();
+
+	/**
+	 * Determine whether a file descriptor is ready for reading or writing
+	 */
+	void fd_readiness(int libc_fd, bool &readable, bool &writeable);
+
+	/**
+	 * Queue the events registered at kqueues for the notified descriptor
+	 *
+	 * \param libc_fd  file descriptor, or ANY_READY_FD for all descriptors
+	 *
+	 * \return true if any event got queued for examination
+	 */
+	bool kqueue_notify(int libc_fd);
+
+	/**
+	 * Remove the events registered at kqueues for the closed descriptor
+	 *
+	 * This prevents a descriptor that reuses the number of 'libc_fd' from
+	 * inheriting the registered events.
+	 */
+	void kqueue_close(int libc_fd);
+}
+
+#endif /* _LIBC__READINESS_H_ */
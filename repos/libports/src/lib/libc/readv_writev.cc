@@ -14,6 +14,7 @@
 
 /* Genode includes */
 #include <base/lock.h>
+#include <libc-plugin/fd_alloc.h>
 
 /* libc includes */
 #include <sys/uio.h>
@@ -22,6 +23,9 @@
 #include <errno.h>
 #include <stdio.h>
 
+/* libc-internal includes */
+#include "vfs_plugin.h"
+
 
 static Genode::Lock rw_lock;
 
@@ -32,6 +36,12 @@ struct Read
      {
     	 return read(fd, buf, count);
      }
+
+     ssize_t operator()(Libc::Vfs_plugin &vfs, Libc::File_descriptor *fd,
+                        const struct iovec *iov, int iovcnt)
+     {
+    	 return vfs.readv(fd, iov, iovcnt);
+     }
 };
 
 
@@ -41,9 +51,29 @@ struct Write
      {
     	 return write(fd, buf, count);
      }
+
+     ssize_t operator()(Libc::Vfs_plugin &vfs, Libc::File_descriptor *fd,
+                        const struct iovec *iov, int iovcnt)
+     {
+    	 return vfs.writev(fd, iov, iovcnt);
+     }
 };
 
 
+/**
+ * Return VFS plugin if the file supports transferring all vectors at once
+ */
+static Libc::Vfs_plugin *vectored_io_plugin(Libc::File_descriptor *fdesc)
+{
+	if (!fdesc)
+		return nullptr;
+
+	Libc::Vfs_plugin *vfs = dynamic_cast<Libc::Vfs_plugin *>(fdesc->plugin);
+
+	return (vfs && vfs->vectored_io(fdesc)) ? vfs : nullptr;
+}
+
+
 template <typename Rw_func>
 static ssize_t readv_writev_impl(Rw_func rw_func, int fd, const struct iovec *iov, int iovcnt)
 {
@@ -60,13 +90,20 @@ static ssize_t readv_writev_impl(Rw_func rw_func, int fd, const struct iovec *io
 	}
 
 	for (i = 0; i < iovcnt; i++)
-		v_len += iov->iov_len;
+		v_len += iov[i].iov_len;
 
 	if (v_len > SSIZE_MAX) {
 		errno = EINVAL;
 		return -1;
 	}
 
+	/* issue a single file-system request for all vectors if possible */
+	Libc::File_descriptor *fdesc =
+		Libc::file_descriptor_allocator()->find_by_libc_fd(fd);
+
+	if (Libc::Vfs_plugin *vfs = vectored_io_plugin(fdesc))
+		return rw_func(*vfs, fdesc, iov, iovcnt);
+
 	while (iovcnt > 0) {
 		v = static_cast<char *>(iov->iov_base);
 		v_len = iov->iov_len;
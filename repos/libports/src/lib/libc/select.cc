@@ -33,11 +33,13 @@
 #include <signal.h>
 
 #include "task.h"
+#include "readiness.h"
 
 
 namespace Libc {
 	struct Select_cb;
 	struct Select_cb_list;
+	struct Notified_fds;
 }
 
 
@@ -113,6 +115,98 @@ Select_cb_list *l;
 static Libc::Select_cb_list select_cb_list;
 
 
+/**
+ * File descriptors notified since the last call of 'select_notify()'
+ */
+struct Libc::Notified_fds
+{
+	/*
+	 * The descriptors are kept as bit set to keep 'Fds' small enough to be
+	 * returned by value. 'select_notify()' is called concurrently by the
+	 * entrypoint and by the threads of libc plugins, each of which examines
+	 * its own copy.
+	 */
+	struct Fds
+	{
+		bool   all    = false;
+		int    max_fd = -1;
+		fd_set set    { };
+
+		/**
+		 * Return true if the select callback waits for any of the descriptors
+		 */
+		bool concerns(Select_cb const &scb) const
+		{
+			int const nfds = Genode::min(scb.nfds, max_fd + 1);
+			for (int fd = 0; fd < nfds; fd++) {
+				if (FD_ISSET(fd, &set) && (FD_ISSET(fd, &scb.readfds)
+				                        || FD_ISSET(fd, &scb.writefds)
+				                        || FD_ISSET(fd, &scb.exceptfds)))
+					return true;
+			}
+			return false;
+		}
+
+		template <typename FN>
+		void for_each(FN const &fn) const
+		{
+			for (int fd = 0; fd <= max_fd; fd++)
+				if (FD_ISSET(fd, &set))
+					fn(fd);
+		}
+	};
+
+	Genode::Lock _mutex { };
+
+	Fds _pending { };
+
+	void insert(int libc_fd)
+	{
+		Genode::Lock::Guard guard(_mutex);
+
+		if (libc_fd < 0 || libc_fd >= (int)FD_SETSIZE) {
+			_pending.all = true;
+			return;
+		}
+
+		FD_SET(libc_fd, &_pending.set);
+		_pending.max_fd = Genode::max(_pending.max_fd, libc_fd);
+	}
+
+	/**
+	 * Take the notified descriptors and reset the notifications
+	 *
+	 * All descriptors are affected if 'select_notify()' is called without
+	 * any prior notification, e.g., by a libc plugin.
+	 */
+	Fds take()
+	{
+		Genode::Lock::Guard guard(_mutex);
+
+		Fds taken = _pending;
+		taken.all = _pending.all || _pending.max_fd < 0;
+
+		_pending = Fds();
+		return taken;
+	}
+};
+
+
+static Libc::Notified_fds notified_fds;
+
+
+void Libc::notify_ready(int libc_fd) { notified_fds.insert(libc_fd); }
+
+
+void Libc::notify_ready(Vfs::Vfs_handle::Context *context)
+{
+	Vfs_handle_context const *handle_context =
+		static_cast<Vfs_handle_context *>(context);
+
+	notify_ready(handle_context ? handle_context->libc_fd : ANY_READY_FD);
+}
+
+
 /**
  * Poll plugin select() functions
  *
@@ -174,16 +268,49 @@ static int selscan(int nfds,
 }
 
 
+void Libc::fd_readiness(int libc_fd, bool &readable, bool &writeable)
+{
+	readable = writeable = false;
+
+	if (libc_fd < 0 || libc_fd >= (int)FD_SETSIZE)
+		return;
+
+	fd_set readfds, writefds, exceptfds;
+	FD_ZERO(&readfds);
+	FD_ZERO(&writefds);
+	FD_ZERO(&exceptfds);
+
+	FD_SET(libc_fd, &readfds);
+	FD_SET(libc_fd, &writefds);
+
+	fd_set in_readfds = readfds, in_writefds = writefds, in_exceptfds = exceptfds;
+
+	selscan(libc_fd + 1, &in_readfds, &in_writefds, &in_exceptfds,
+	        &readfds, &writefds, &exceptfds);
+
+	readable  = FD_ISSET(libc_fd, &readfds);
+	writeable = FD_ISSET(libc_fd, &writefds);
+}
+
+
 /* this function gets called by plugin backends when file descripors become ready */
 static void select_notify()
 {
 	bool resume_all = false;
 	fd_set tmp_readfds, tmp_writefds, tmp_exceptfds;
 
-	/* check for each waiting select() function if one of its fds is ready now
-	 * and if so, wake all up */
+	Libc::Notified_fds::Fds const notified = notified_fds.take();
 
+	/*
+	 * Check for each waiting select() function that waits for a notified fd
+	 * if one of its fds is ready now and if so, wake all up. Callbacks with
+	 * results that are not yet picked up are left alone.
+	 */
 	select_cb_list.for_each([&] (Libc::Select_cb &scb) {
+
+		if (scb.nready > 0 || (!notified.all && !notified.concerns(scb)))
+			return;
+
 		scb.nready = selscan(scb.nfds,
 		                     &scb.readfds, &scb.writefds, &scb.exceptfds,
 		                     &tmp_readfds,  &tmp_writefds,  &tmp_exceptfds);
@@ -196,11 +323,25 @@ static void select_notify()
 		}
 	});
 
+	/* wake up waiters in kevent() for which events got queued */
+	if (notified.all)
+		resume_all |= Libc::kqueue_notify(Libc::ANY_READY_FD);
+	else
+		notified.for_each([&] (int fd) {
+			resume_all |= Libc::kqueue_notify(fd); });
+
 	if (resume_all)
 		Libc::resume_all();
 }
 
 
+void Libc::init_select_notify()
+{
+	if (!libc_select_notify)
+		libc_select_notify = select_notify;
+}
+
+
 static void print(Genode::Output &output, timeval *tv)
 {
 	if (!tv) {
@@ -225,8 +366,7 @@ _select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
 	Genode::Constructible<Libc::Select_cb> select_cb;
 
 	/* initialize the select notification function pointer */
-	if (!libc_select_notify)
-		libc_select_notify = select_notify;
+	Libc::init_select_notify();
 
 	if (readfds)   in_readfds   = *readfds;   else FD_ZERO(&in_readfds);
 	if (writefds)  in_writefds  = *writefds;  else FD_ZERO(&in_writefds);
@@ -353,8 +493,7 @@ int Libc::Select_handler_base::select(int nfds, fd_set &readfds,
 	fd_set in_readfds, in_writefds, in_exceptfds;
 
 	/* initialize the select notification function pointer */
-	if (!libc_select_notify)
-		libc_select_notify = select_notify;
+	Libc::init_select_notify();
 
 	in_readfds   = readfds;
 	in_writefds  = writefds;
@@ -38,6 +38,7 @@
 #include "libc_file.h"
 #include "libc_errno.h"
 #include "task.h"
+#include "readiness.h"
 
 
 namespace Libc {
@@ -139,6 +140,9 @@ struct Socket_fs::Context : Libc::Plugin_context
 
 		int  _fd_flags    = 0;
 
+		/* socket descriptor notified on I/O events of the socket files */
+		int  _socket_fd   = Libc::ANY_READY_FD;
+
 		Proto const _proto;
 
 		bool _accept_only = false;
@@ -162,6 +166,8 @@ struct Socket_fs::Context : Libc::Plugin_context
 				}
 				_fd[type].num  = fd;
 				_fd[type].file = Libc::file_descriptor_allocator()->find_by_libc_fd(fd);
+
+				Libc::redirect_ready_notification(_fd[type].file, _socket_fd);
 			}
 
 			return _fd[type].num;
@@ -188,6 +194,16 @@ struct Socket_fs::Context : Libc::Plugin_context
 
 		Proto proto() const { return _proto; }
 
+		/**
+		 * Set socket descriptor to be notified on I/O events
+		 */
+		void socket_fd(int libc_fd)
+		{
+			_socket_fd = libc_fd;
+			for (unsigned i = 0; i < Fd::MAX; ++i)
+				Libc::redirect_ready_notification(_fd[i].file, libc_fd);
+		}
+
 		int fd_flags() const { return _fd_flags; }
 		void fd_flags(int flags)
 		{
@@ -502,6 +518,8 @@ extern "C" int socket_fs_accept(int libc_fd, sockaddr *addr, socklen_t *addrlen)
 	Libc::File_descriptor *accept_fd =
 		Libc::file_descriptor_allocator()->alloc(&plugin(), accept_context);
 
+	accept_context->socket_fd(accept_fd->libc_fd);
+
 	/* inherit the O_NONBLOCK flag if set */
 	accept_context->fd_flags(listen_context->fd_flags());
 
@@ -842,6 +860,8 @@ extern "C" int socket_fs_socket(int domain, int type, int protocol)
 	Libc::File_descriptor *fd =
 		Libc::file_descriptor_allocator()->alloc(&plugin(), context);
 
+	context->socket_fd(fd->libc_fd);
+
 	return fd->libc_fd;
 }
 
@@ -929,6 +949,9 @@ int Socket_fs::Plugin::select(int nfds,
 
 	for (int fd = 0; fd < nfds; ++fd) {
 
+		if (!FD_ISSET(fd, &in_readfds) && !FD_ISSET(fd, &in_writefds))
+			continue;
+
 		Libc::File_descriptor *fdo =
 			Libc::file_descriptor_allocator()->find_by_libc_fd(fd);
 
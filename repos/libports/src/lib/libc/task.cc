@@ -35,6 +35,7 @@
 #include "vfs_plugin.h"
 #include "libc_init.h"
 #include "task.h"
+#include "readiness.h"
 
 extern char **environ;
 
@@ -388,9 +389,10 @@ extern void (*libc_select_notify)();
 
 struct Libc::Io_response_handler : Vfs::Io_response_handler
 {
-	void handle_io_response(Vfs::Vfs_handle::Context *) override
+	void handle_io_response(Vfs::Vfs_handle::Context *context) override
 	{
 		/* some contexts may have been deblocked from select() */
+		Libc::notify_ready(context);
 		if (libc_select_notify)
 			libc_select_notify();
 
@@ -16,6 +16,7 @@
 /* Genode includes */
 #include <base/env.h>
 #include <base/log.h>
+#include <dataspace/client.h>
 #include <vfs/dir_file_system.h>
 
 /* libc includes */
@@ -38,8 +39,10 @@
 
 /* libc-internal includes */
 #include "libc_mem_alloc.h"
+#include "libc_mmap_registry.h"
 #include "libc_errno.h"
 #include "task.h"
+#include "readiness.h"
 
 static Genode::Lock &vfs_lock()
 {
@@ -66,6 +69,66 @@ static Libc::Plugin_context *vfs_context(Vfs::Vfs_handle *vfs_handle)
 }
 
 
+/**
+ * Position within an I/O vector
+ */
+struct Io_vector_cursor
+{
+	typedef Vfs::File_io_service::Io_extent Io_extent;
+
+	struct iovec const * const iov;
+	int                  const iovcnt;
+
+	int      index  = 0;
+	::size_t offset = 0;
+
+	Io_vector_cursor(struct iovec const *iov, int iovcnt)
+	: iov(iov), iovcnt(iovcnt) { }
+
+	bool done() const { return index == iovcnt; }
+
+	/**
+	 * Translate the remaining vectors into extents at consecutive file
+	 * positions starting at 'seek'
+	 *
+	 * \param count  resulting number of bytes covered by the extents
+	 * \return       number of extents
+	 */
+	unsigned extents(Io_extent *extents, unsigned max, Vfs::file_size seek,
+	                 Vfs::file_size &count) const
+	{
+		unsigned num = 0;
+		count = 0;
+
+		for (int i = index; i < iovcnt && num < max; i++) {
+
+			::size_t       const skip = (i == index) ? offset : 0;
+			Vfs::file_size const len  = iov[i].iov_len - skip;
+
+			extents[num++] = Io_extent { seek, (char *)iov[i].iov_base + skip, len };
+
+			seek  += len;
+			count += len;
+		}
+		return num;
+	}
+
+	void advance(Vfs::file_size n)
+	{
+		while (index < iovcnt) {
+			::size_t const avail = iov[index].iov_len - offset;
+			if (n < avail) {
+				offset += n;
+				return;
+			}
+			n -= avail;
+			index++;
+			offset = 0;
+		}
+	}
+};
+
+
 /**
  * Utility to convert VFS stat struct to the libc stat struct
  *
@@ -176,6 +239,16 @@ namespace Libc {
 		return VFS_THREAD_SAFE(handle->fs().read_ready(handle));
 	}
 
+	void redirect_ready_notification(Libc::File_descriptor *fd, int libc_fd)
+	{
+		if (!fd || !dynamic_cast<Vfs_plugin *>(fd->plugin))
+			return;
+
+		Vfs::Vfs_handle *handle = vfs_handle(fd);
+		if (handle && handle->context)
+			static_cast<Vfs_handle_context *>(handle->context)->libc_fd = libc_fd;
+	}
+
 }
 
 int Libc::Vfs_plugin::access(const char *path, int amode)
@@ -306,6 +379,9 @@ Libc::File_descriptor *Libc::Vfs_plugin::open(char const *path, int flags,
 		return nullptr;
 	}
 
+	/* let I/O events of the handle notify the file descriptor */
+	handle->context = new (_alloc) Libc::Vfs_handle_context(fd->libc_fd);
+
 	fd->flags = flags & (O_ACCMODE|O_NONBLOCK|O_APPEND);
 
 	if ((flags & O_TRUNC) && (ftruncate(fd, 0) == -1)) {
@@ -321,7 +397,13 @@ int Libc::Vfs_plugin::close(Libc::File_descriptor *fd)
 {
 	Vfs::Vfs_handle *handle = vfs_handle(fd);
 	_vfs_sync(handle);
+
+	Vfs::Vfs_handle::Context *context = handle->context;
 	VFS_THREAD_SAFE(handle->close());
+
+	if (context)
+		destroy(_alloc, static_cast<Libc::Vfs_handle_context *>(context));
+
 	Libc::file_descriptor_allocator()->free(fd);
 	return 0;
 }
@@ -331,6 +413,10 @@ int Libc::Vfs_plugin::dup2(Libc::File_descriptor *fd,
                            Libc::File_descriptor *new_fd)
 {
 	new_fd->context = fd->context;
+
+	/* the handle is shared by two descriptors, notify both of them */
+	Libc::redirect_ready_notification(fd, Libc::ANY_READY_FD);
+
 	return new_fd->libc_fd;
 }
 
@@ -576,6 +662,226 @@ ssize_t Libc::Vfs_plugin::read(Libc::File_descriptor *fd, void *buf,
 }
 
 
+bool Libc::Vfs_plugin::vectored_io(Libc::File_descriptor *fd)
+{
+	/* non-blocking reads depend on the read-ready state of the handle */
+	if (fd->flags & (O_NONBLOCK | O_DIRECTORY))
+		return false;
+
+	Vfs::Vfs_handle *handle = vfs_handle(fd);
+
+	return VFS_THREAD_SAFE(handle->fs().vectored_io(handle));
+}
+
+
+/*
+ * Number of extents passed to the VFS at once, bounds the stack usage
+ */
+enum { MAX_IO_EXTENTS = 64 };
+
+
+ssize_t Libc::Vfs_plugin::writev(Libc::File_descriptor *fd,
+                                 struct iovec const *iov, int iovcnt)
+{
+	typedef Vfs::File_io_service::Write_result Result;
+	typedef Vfs::File_io_service::Io_extent    Io_extent;
+
+	Vfs::Vfs_handle *handle = vfs_handle(fd);
+
+	Io_vector_cursor cursor(iov, iovcnt);
+	ssize_t          total = 0;
+
+	while (!cursor.done()) {
+
+		Io_extent      extents[MAX_IO_EXTENTS];
+		Vfs::file_size count = 0;
+		unsigned const num   = cursor.extents(extents, MAX_IO_EXTENTS,
+		                                      VFS_THREAD_SAFE(handle->seek()),
+		                                      count);
+
+		Vfs::file_size out_count  = 0;
+		Result         out_result = Result::WRITE_OK;
+
+		struct Check : Libc::Suspend_functor
+		{
+			bool             retry { false };
+
+			Vfs::Vfs_handle *handle;
+			Io_extent const *extents;
+			unsigned         num;
+			Vfs::file_size  &out_count;
+			Result          &out_result;
+
+			Check(Vfs::Vfs_handle *handle, Io_extent const *extents,
+			      unsigned num, Vfs::file_size &out_count, Result &out_result)
+			: handle(handle), extents(extents), num(num),
+			  out_count(out_count), out_result(out_result)
+			{ }
+
+			bool suspend() override
+			{
+				try {
+					out_result = VFS_THREAD_SAFE(handle->fs().writev(handle, extents,
+					                                                 num, out_count));
+					retry = false;
+				} catch (Vfs::File_io_service::Insufficient_buffer) {
+					retry = true;
+				}
+
+				return retry;
+			}
+		} check(handle, extents, num, out_count, out_result);
+
+		do {
+			Libc::suspend(check);
+		} while (check.retry);
+
+		/* wake up threads blocking for 'queue_*()' or 'write()' */
+		Libc::resume_all();
+
+		if (out_result != Result::WRITE_OK) {
+			if (total)
+				break;
+
+			switch (out_result) {
+			case Result::WRITE_ERR_AGAIN:       return Errno(EAGAIN);
+			case Result::WRITE_ERR_WOULD_BLOCK: return Errno(EWOULDBLOCK);
+			case Result::WRITE_ERR_INVALID:     return Errno(EINVAL);
+			case Result::WRITE_ERR_IO:          return Errno(EIO);
+			case Result::WRITE_ERR_INTERRUPT:   return Errno(EINTR);
+			case Result::WRITE_OK:              break;
+			}
+		}
+
+		VFS_THREAD_SAFE(handle->advance_seek(out_count));
+
+		cursor.advance(out_count);
+		total += out_count;
+
+		/* the VFS may clip the request, give up only if there is no progress */
+		if (out_count == 0 && count > 0)
+			break;
+	}
+
+	return total;
+}
+
+
+ssize_t Libc::Vfs_plugin::readv(Libc::File_descriptor *fd,
+                                struct iovec const *iov, int iovcnt)
+{
+	Libc::dispatch_pending_io_signals();
+
+	typedef Vfs::File_io_service::Read_result Result;
+	typedef Vfs::File_io_service::Io_extent   Io_extent;
+
+	Vfs::Vfs_handle *handle = vfs_handle(fd);
+
+	Io_vector_cursor cursor(iov, iovcnt);
+	ssize_t          total = 0;
+
+	while (!cursor.done()) {
+
+		Io_extent      extents[MAX_IO_EXTENTS];
+		Vfs::file_size count = 0;
+		unsigned const num   = cursor.extents(extents, MAX_IO_EXTENTS,
+		                                      VFS_THREAD_SAFE(handle->seek()),
+		                                      count);
+		{
+			struct Check : Libc::Suspend_functor
+			{
+				bool             retry { false };
+
+				Vfs::Vfs_handle *handle;
+				Io_extent const *extents;
+				unsigned         num;
+
+				Check(Vfs::Vfs_handle *handle, Io_extent const *extents,
+				      unsigned num)
+				: handle(handle), extents(extents), num(num) { }
+
+				bool suspend() override
+				{
+					retry = !VFS_THREAD_SAFE(handle->fs().queue_readv(handle, extents, num));
+					return retry;
+				}
+			} check(handle, extents, num);
+
+			do {
+				Libc::suspend(check);
+			} while (check.retry);
+		}
+
+		Vfs::file_size out_count = 0;
+		Result         out_result;
+
+		{
+			struct Check : Libc::Suspend_functor
+			{
+				bool             retry { false };
+
+				Vfs::Vfs_handle *handle;
+				Io_extent const *extents;
+				unsigned         num;
+				Vfs::file_size  &out_count;
+				Result          &out_result;
+
+				Check(Vfs::Vfs_handle *handle, Io_extent const *extents,
+				      unsigned num, Vfs::file_size &out_count, Result &out_result)
+				: handle(handle), extents(extents), num(num),
+				  out_count(out_count), out_result(out_result)
+				{ }
+
+				bool suspend() override
+				{
+					out_result = VFS_THREAD_SAFE(handle->fs().complete_readv(handle,
+					                             extents, num, out_count));
+					/* suspend me if read is still queued */
+
+					retry = (out_result == Result::READ_QUEUED);
+
+					return retry;
+				}
+			} check(handle, extents, num, out_count, out_result);
+
+			do {
+				Libc::suspend(check);
+			} while (check.retry);
+		}
+
+		/* wake up threads blocking for 'queue_*()' or 'write()' */
+		Libc::resume_all();
+
+		if (out_result != Result::READ_OK) {
+			if (total)
+				break;
+
+			switch (out_result) {
+			case Result::READ_ERR_AGAIN:       return Errno(EAGAIN);
+			case Result::READ_ERR_WOULD_BLOCK: return Errno(EWOULDBLOCK);
+			case Result::READ_ERR_INVALID:     return Errno(EINVAL);
+			case Result::READ_ERR_IO:          return Errno(EIO);
+			case Result::READ_ERR_INTERRUPT:   return Errno(EINTR);
+			case Result::READ_OK:              break;
+
+			case Result::READ_QUEUED: /* handled above, so never reached */ break;
+			}
+		}
+
+		VFS_THREAD_SAFE(handle->advance_seek(out_count));
+
+		cursor.advance(out_count);
+		total += out_count;
+
+		/* like 'read', a short read (e.g., at the end of file) is not retried */
+		if (out_count < count)
+			break;
+	}
+
+	return total;
+}
+
+
 ssize_t Libc::Vfs_plugin::getdirentries(Libc::File_descriptor *fd, char *buf,
                                         ::size_t nbytes, ::off_t *basep)
 {
@@ -1166,7 +1472,12 @@ int Libc::Vfs_plugin::rename(char const *from_path, char const *to_path)
 void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags,
                              Libc::File_descriptor *fd, ::off_t offset)
 {
-	if (prot != PROT_READ) {
+	/*
+	 * A writeable mapping is supported only as private copy of the file
+	 * content because changes are never written back to the file.
+	 */
+	bool const writeable = (prot == (PROT_READ | PROT_WRITE));
+	if ((prot != PROT_READ && !writeable) || (writeable && (flags & MAP_SHARED))) {
 		Genode::error("mmap for prot=", Genode::Hex(prot), " not supported");
 		errno = EACCES;
 		return (void *)-1;
@@ -1179,9 +1490,15 @@ void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags
 	}
 
 	/*
-	 * XXX attempt to obtain memory mapping via
-	 *     'Vfs::Directory_service::dataspace'.
+	 * Map the dataspace provided by the file system, which saves the copy
+	 * of the file content. The offset of the mapping within the dataspace
+	 * must be page-aligned. The dataspace may be shared with other readers
+	 * of the file, so it is mapped read-only and writeable mappings use
+	 * the copy.
 	 */
+	if (!writeable && fd->fd_path && !(offset & ((1 << PAGE_SHIFT) - 1)))
+		if (void *addr = _attach_dataspace(fd->fd_path, length, offset))
+			return addr;
 
 	void *addr = Libc::mem_alloc()->alloc(length, PAGE_SHIFT);
 	if (addr == (void *)-1) {
@@ -1212,9 +1529,46 @@ void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags
 }
 
 
+void *Libc::Vfs_plugin::_attach_dataspace(char const *path, ::size_t length,
+                                          ::off_t offset)
+{
+	Genode::Dataspace_capability const ds =
+		VFS_THREAD_SAFE(_root_dir.dataspace(path));
+
+	if (!ds.valid())
+		return nullptr;
+
+	::size_t const size = Genode::align_addr(length, PAGE_SHIFT);
+
+	void *addr = nullptr;
+	try {
+		/* the dataspace may end before the requested range */
+		if ((::size_t)offset + size <= Genode::Dataspace_client(ds).size())
+			addr = _rm.attach(ds, size, offset, false, (void *)0, false, false);
+	} catch (...) { }
+
+	if (!addr) {
+		VFS_THREAD_SAFE(_root_dir.release(path, ds));
+		return nullptr;
+	}
+
+	mmap_registry()->insert(addr, length, this,
+	                        Mmap_registry::Backing { ds, path });
+	return addr;
+}
+
+
 int Libc::Vfs_plugin::munmap(void *addr, ::size_t)
 {
-	Libc::mem_alloc()->free(addr);
+	Mmap_registry::Backing backing;
+
+	if (!mmap_registry()->lookup_backing_by_addr(addr, backing)) {
+		Libc::mem_alloc()->free(addr);
+		return 0;
+	}
+
+	_rm.detach(addr);
+	VFS_THREAD_SAFE(_root_dir.release(backing.path.string(), backing.ds));
 	return 0;
 }
 
@@ -1256,6 +1610,9 @@ int Libc::Vfs_plugin::select(int nfds,
 
 	for (int fd = 0; fd < nfds; ++fd) {
 
+		if (!FD_ISSET(fd, &in_readfds) && !FD_ISSET(fd, &in_writefds))
+			continue;
+
 		Libc::File_descriptor *fdo =
 			Libc::file_descriptor_allocator()->find_by_libc_fd(fd);
 
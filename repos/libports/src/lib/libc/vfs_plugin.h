@@ -22,6 +22,7 @@
 /* libc includes */
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/uio.h>
 
 /* libc plugin interface */
 #include <libc-plugin/plugin.h>
@@ -43,6 +44,16 @@ class Libc::Vfs_plugin : public Libc::Plugin
 
 		Vfs::File_system &_root_dir;
 
+		Genode::Region_map &_rm;
+
+		/**
+		 * Attach dataspace provided by the file system for the file at 'path'
+		 *
+		 * \return local address of the mapping, or nullptr if the file
+		 *         system provides no dataspace covering the requested range
+		 */
+		void *_attach_dataspace(char const *path, ::size_t length, ::off_t offset);
+
 		void _open_stdio(Genode::Xml_node const &node, char const *attr,
 		                 int libc_fd, unsigned flags)
 		{
@@ -154,7 +165,7 @@ class Libc::Vfs_plugin : public Libc::Plugin
 
 		Vfs_plugin(Libc::Env &env, Genode::Allocator &alloc)
 		:
-			_alloc(alloc), _root_dir(env.vfs())
+			_alloc(alloc), _root_dir(env.vfs()), _rm(env.rm())
 		{
 			using Genode::Xml_node;
 
@@ -223,6 +234,13 @@ class Libc::Vfs_plugin : public Libc::Plugin
 		void   *mmap(void *, ::size_t, int, int, Libc::File_descriptor *, ::off_t) override;
 		int     munmap(void *, ::size_t) override;
 		int     select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout) override;
+
+		/**
+		 * Return true if 'readv' and 'writev' can transfer all vectors at once
+		 */
+		bool    vectored_io(Libc::File_descriptor *);
+		ssize_t readv(Libc::File_descriptor *, struct iovec const *, int);
+		ssize_t writev(Libc::File_descriptor *, struct iovec const *, int);
 };
 
 #endif
@@ -105,7 +105,7 @@ extern "C" {
 		                               struct pbuf *p, err_t err);
 		static err_t tcp_delayed_recv_callback(void *arg, struct tcp_pcb *tpcb,
 		                                       struct pbuf *p, err_t err);
-		/* static err_t tcp_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t len); */
+		static err_t tcp_sent_callback(void *arg, struct tcp_pcb *tpcb, u16_t len);
 		static void  tcp_err_callback(void *arg, err_t err);
 	}
 
@@ -463,6 +463,9 @@ class Lwip::Protocol_dir_impl final : public Protocol_dir
 
 		Genode::List<SOCKET_DIR> _socket_dirs { };
 
+		/* minimum size of writes that are sent by reference, 0 if disabled */
+		Genode::size_t _zero_copy_tx = 0;
+
 	public:
 
 		friend class Genode::List<SOCKET_DIR>;
@@ -474,6 +477,10 @@ class Lwip::Protocol_dir_impl final : public Protocol_dir
 		Protocol_dir_impl(Vfs::Env &vfs_env)
 		: _alloc(vfs_env.alloc()), _io_handler(vfs_env.io_handler()), _ep(vfs_env.env().ep()) { }
 
+		Genode::size_t zero_copy_tx() const { return _zero_copy_tx; }
+
+		void zero_copy_tx(Genode::size_t min_size) { _zero_copy_tx = min_size; }
+
 		SOCKET_DIR *lookup(char const *name)
 		{
 			if (*name == '/') ++name;
@@ -1015,6 +1022,72 @@ class Lwip::Tcp_socket_dir final :
 			return Open_result::OPEN_OK;
 		}
 
+		/*
+		 * Stream positions of the data passed to lwIP and of the data
+		 * acknowledged by the remote
+		 */
+		Genode::uint64_t _written = 0;
+		Genode::uint64_t _acked   = 0;
+
+		/**
+		 * Write data that is referenced by lwIP until it is acknowledged
+		 *
+		 * The data is not copied into the send buffer of the PCB. Hence,
+		 * the write returns not before the remote acknowledged the
+		 * referenced data, after which the caller is free to reuse its
+		 * buffer. Copied data written before does not delay the return
+		 * beyond the acknowledgement of the referenced data.
+		 */
+		Write_result _write_by_reference(char const *src, file_size count,
+		                                 file_size &out_count)
+		{
+			file_size out = 0;
+
+			while (out < count) {
+
+				if (!_pcb)
+					return Write_result::WRITE_ERR_IO;
+
+				u16_t const n = min(min(count - out, tcp_sndbuf(_pcb)), 0xffffU);
+
+				u8_t const flags = (out + n < count) ? TCP_WRITE_FLAG_MORE : 0;
+
+				err_t const err = n ? tcp_write(_pcb, src + out, n, flags) : ERR_MEM;
+				if (err == ERR_OK) {
+					out      += n;
+					_written += n;
+					continue;
+				}
+
+				if (err != ERR_MEM) {
+					Genode::error("lwIP: tcp_write failed, error ", (int)-err);
+					return Write_result::WRITE_ERR_IO;
+				}
+
+				/* send buffer or segment queue exhausted, wait for ACKs */
+				tcp_output(_pcb);
+				_ep.wait_and_dispatch_one_io_signal();
+			}
+
+			/* the last segment must not be delayed by the Nagle algorithm */
+			bool const nagle = !tcp_nagle_disabled(_pcb);
+			tcp_nagle_disable(_pcb);
+			tcp_output(_pcb);
+
+			Genode::uint64_t const referenced_end = _written;
+			while (_pcb && _acked < referenced_end)
+				_ep.wait_and_dispatch_one_io_signal();
+
+			if (_pcb && nagle)
+				tcp_nagle_enable(_pcb);
+
+			if (!_pcb)
+				return Write_result::WRITE_ERR_IO;
+
+			out_count = out;
+			return Write_result::WRITE_OK;
+		}
+
 	public:
 
 		friend class Tcp_socket_dir_list;
@@ -1036,8 +1109,8 @@ class Lwip::Tcp_socket_dir final :
 
 			tcp_recv(_pcb, tcp_recv_callback);
 
-			/* Disabled, do not track acknowledgements */
-			/* tcp_sent(_pcb, tcp_sent_callback); */
+			/* track acknowledgements for writes by reference */
+			tcp_sent(_pcb, tcp_sent_callback);
 
 			tcp_err(_pcb, tcp_err_callback);
 		}
@@ -1087,6 +1160,11 @@ class Lwip::Tcp_socket_dir final :
 			}
 		}
 
+		/**
+		 * Account data acknowledged by the remote
+		 */
+		void sent(u16_t len) { _acked = min(_acked + len, _written); }
+
 		/**
 		 * Close the connection by error
 		 *
@@ -1192,23 +1270,31 @@ class Lwip::Tcp_socket_dir final :
 							: Read_result::READ_OK;
 					}
 
-					u16_t const ucount = count;
-					u16_t const n = pbuf_copy_partial(_recv_pbuf, dst, ucount, _recv_off);
-					_recv_off += n;
-					{
-						u16_t new_off;
-						pbuf *new_head = pbuf_skip(_recv_pbuf, _recv_off, &new_off);
-						if (new_head != NULL && new_head != _recv_pbuf) {
-							/* move down the buffer and deref the head */
-							pbuf_ref(new_head);
-							pbuf_realloc(new_head, _recv_pbuf->tot_len+_recv_off);
-							pbuf_free(_recv_pbuf);
-						}
+					/*
+					 * Copy the data directly from the received pbufs, which
+					 * refer to the packet buffer of the Nic session. Each
+					 * pbuf is released as soon as it is consumed, which
+					 * acknowledges its packet to the Nic driver.
+					 */
+					file_size n = 0;
+					while (_recv_pbuf && n < count) {
+						u16_t const len = min(count - n, (file_size)(_recv_pbuf->len - _recv_off));
 
-						if (!new_head)
-							pbuf_free(_recv_pbuf);
-						_recv_pbuf = new_head;
-						_recv_off = new_off;
+						Genode::memcpy(dst + n, (char const *)_recv_pbuf->payload + _recv_off, len);
+						n         += len;
+						_recv_off += len;
+
+						if (_recv_off < _recv_pbuf->len)
+							break;
+
+						/* keep the tail of the chain when releasing the head */
+						pbuf *next = _recv_pbuf->next;
+						if (next)
+							pbuf_ref(next);
+						pbuf_free(_recv_pbuf);
+
+						_recv_pbuf = next;
+						_recv_off  = 0;
 					}
 
 					/* ACK the remote */
@@ -1322,6 +1408,9 @@ class Lwip::Tcp_socket_dir final :
 			switch(handle.kind) {
 			case Lwip_file_handle::DATA:
 				if (state == READY) {
+					if (_proto_dir.zero_copy_tx() && count >= _proto_dir.zero_copy_tx())
+						return _write_by_reference(src, count, out_count);
+
 					Write_result res = Write_result::WRITE_ERR_WOULD_BLOCK;
 					file_size out = 0;
 					/*
@@ -1342,7 +1431,7 @@ class Lwip::Tcp_socket_dir final :
 						count -= n;
 						src += n;
 						out += n;
-						/* pending_ack += n; */
+						_written += n;
 						res = Write_result::WRITE_OK;
 					}
 
@@ -1527,23 +1616,20 @@ err_t tcp_delayed_recv_callback(void *arg, struct tcp_pcb *pcb, struct pbuf *buf
 
 
 /**
- * This would be the ACK callback, we could defer sync completion
- * until then, but performance is expected to be unacceptable.
+ * Acknowledgement callback
  *
+ * Writes by reference wait for the remote to acknowledge their data.
+ * Writes that copy the data do not depend on acknowledgements.
+ */
 static
 err_t tcp_sent_callback(void *arg, struct tcp_pcb*, u16_t len)
 {
-	if (!arg) {
-		tcp_abort(pcb);
-		return ERR_ABRT;
-	}
+	if (!arg) return ERR_OK;
 
 	Lwip::Tcp_socket_dir *socket_dir = static_cast<Lwip::Tcp_socket_dir *>(arg);
-	socket_dir->pending_ack -= len;
-	socket_dir->handle_io(Lwip_file_handle::DATA);
+	socket_dir->sent(len);
 	return ERR_OK;
 }
-*/
 
 
 static
@@ -1599,7 +1685,26 @@ class Lwip::File_system final : public Vfs::File_system
 			          Vfs::Io_response_handler &io)
 			: Lwip::Nic_netif(vfs_env.env(), vfs_env.alloc(), config),
 			  io_handler(io), tcp_dir(vfs_env), udp_dir(vfs_env)
-			{ }
+			{
+				configure_sockets(config);
+			}
+
+			/**
+			 * Apply socket-related configuration
+			 *
+			 * The 'zero_copy_tx' attribute denotes the minimum size of
+			 * TCP writes that are referenced by lwIP instead of being
+			 * copied into the send buffer. Each such write blocks until
+			 * the remote acknowledged all of its data. Hence, a sender
+			 * with a single socket transfers at most one write per
+			 * round trip, so the threshold should be well above the
+			 * typical write size of latency-sensitive applications.
+			 */
+			void configure_sockets(Genode::Xml_node const &config)
+			{
+				tcp_dir.zero_copy_tx(config.attribute_value("zero_copy_tx",
+				                                            Genode::Number_of_bytes(0)));
+			}
 		} _netif;
 
 		/**
@@ -1629,8 +1734,11 @@ class Lwip::File_system final : public Vfs::File_system
 		/**
 		 * Reconfigure the LwIP Nic interface with the VFS config hook
 		 */
-		void apply_config(Genode::Xml_node const &node) override {
-			_netif.configure(node); }
+		void apply_config(Genode::Xml_node const &node) override
+		{
+			_netif.configure(node);
+			_netif.configure_sockets(node);
+		}
 
 
 		/***********************
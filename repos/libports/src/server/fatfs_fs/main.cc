@@ -14,6 +14,7 @@
 /* Genode includes */
 #include <base/component.h>
 #include <file_system_session/rpc_object.h>
+#include <file_system/util.h>
 #include <root/component.h>
 #include <base/attached_rom_dataspace.h>
 #include <os/session_policy.h>
@@ -119,6 +120,37 @@ class Fatfs_fs::Session_component : public Session_rpc_object
 				}
 				break;
 
+			case Packet_descriptor::READV:
+				if (content) {
+					unsigned next = 0;
+					res_length = File_system::transfer_extents(packet,
+						(char *)content, next,
+						[&] (seek_off_t pos, char *dst, size_t len) {
+							return open_node.node().read(dst, len, pos); });
+
+					/* extents beyond EOF are reported as short or empty */
+					succeeded = true;
+				}
+				break;
+
+			case Packet_descriptor::WRITEV:
+				if (content) {
+					unsigned next = 0;
+					res_length = File_system::transfer_extents(packet,
+						(char *)content, next,
+						[&] (seek_off_t pos, char *src, size_t len) {
+							return open_node.node().write(src, len, pos); });
+
+					/* File system session can't handle partial writes */
+					if (next != packet.length()) {
+						Genode::error("partial vectored write detected");
+						/* don't acknowledge */
+						return;
+					}
+					succeeded = true;
+				}
+				break;
+
 			case Packet_descriptor::CONTENT_CHANGED:
 				open_node.register_notify(*tx_sink());
 				open_node.node().notify_listeners();
@@ -0,0 +1,355 @@
+/*
+ * \brief  Test kqueue() and kevent() in libc
+ * \author Genode Labs
+ * \date   2018-12-21
+ *
+ * The test registers events for pipe descriptors and checks the effects of
+ * the kevent flags and timeouts. If a port is specified, the test accepts
+ * one TCP connection at this port and receives data from the connection
+ * driven by socket events until the peer closes the connection.
+ *
+ * ! test-libc_kqueue [<port> <expected bytes>]
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* libc includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/event.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+
+static unsigned long long now_ms()
+{
+	timespec ts { };
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000ULL + ts.tv_nsec/1000000;
+}
+
+
+#define CHECK(cond) \
+	if (!(cond)) { \
+		fprintf(stderr, "Error: check '%s' failed in line %d\n", #cond, __LINE__); \
+		exit(1); \
+	}
+
+
+static timespec const no_wait { 0, 0 };
+
+
+/**
+ * Apply change and return its result as reported via EV_RECEIPT
+ */
+static int change(int kq, int fd, short filter, unsigned short flags)
+{
+	struct kevent kev, out;
+	EV_SET(&kev, fd, filter, flags | EV_RECEIPT, 0, 0, (void *)(long)fd);
+
+	CHECK(kevent(kq, &kev, 1, &out, 1, nullptr) == 1);
+	CHECK(out.flags & EV_ERROR);
+	CHECK((int)out.ident == fd && out.filter == filter);
+
+	return (int)out.data;
+}
+
+
+/**
+ * Collect events and return the number of reported events
+ */
+static int collect(int kq, struct kevent *out, int max,
+                   timespec const *timeout = &no_wait)
+{
+	int const n = kevent(kq, nullptr, 0, out, max, timeout);
+	CHECK(n >= 0);
+	return n;
+}
+
+
+static void write_byte(int fd)
+{
+	char const c = 'x';
+	CHECK(write(fd, &c, 1) == 1);
+}
+
+
+static void read_byte(int fd)
+{
+	char c = 0;
+	CHECK(read(fd, &c, 1) == 1);
+}
+
+
+static void test_add_delete(int kq)
+{
+	printf("start add/delete\n");
+
+	int p[2];
+	CHECK(pipe(p) == 0);
+
+	struct kevent out[4];
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ADD) == 0);
+	CHECK(collect(kq, out, 4) == 0);
+
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4) == 1);
+	CHECK((int)out[0].ident == p[0] && out[0].filter == EVFILT_READ);
+	CHECK(out[0].udata == (void *)(long)p[0]);
+
+	/* level-triggered events are reported as long as the condition holds */
+	CHECK(collect(kq, out, 4) == 1);
+	read_byte(p[0]);
+	CHECK(collect(kq, out, 4) == 0);
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_DELETE) == 0);
+	CHECK(change(kq, p[0], EVFILT_READ, EV_DELETE) == ENOENT);
+
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4) == 0);
+
+	/* errors are reported as EV_ERROR events without EV_RECEIPT, too */
+	struct kevent kev;
+	EV_SET(&kev, p[0], EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+	CHECK(kevent(kq, &kev, 1, out, 4, nullptr) == 1);
+	CHECK((out[0].flags & EV_ERROR) && out[0].data == ENOENT);
+
+	/* and via errno if there is no room in the event list */
+	CHECK(kevent(kq, &kev, 1, nullptr, 0, nullptr) == -1 && errno == ENOENT);
+
+	close(p[0]);
+	close(p[1]);
+
+	printf("finished add/delete\n");
+}
+
+
+static void test_enable_disable(int kq)
+{
+	printf("start enable/disable\n");
+
+	int p[2];
+	CHECK(pipe(p) == 0);
+
+	struct kevent out[4];
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ADD | EV_DISABLE) == 0);
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4) == 0);
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ENABLE) == 0);
+	CHECK(collect(kq, out, 4) == 1);
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_DISABLE) == 0);
+	CHECK(collect(kq, out, 4) == 0);
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ENABLE) == 0);
+	CHECK(collect(kq, out, 4) == 1);
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_DELETE) == 0);
+
+	close(p[0]);
+	close(p[1]);
+
+	printf("finished enable/disable\n");
+}
+
+
+static void test_clear_oneshot_dispatch(int kq)
+{
+	printf("start clear/oneshot/dispatch\n");
+
+	int p[2];
+	CHECK(pipe(p) == 0);
+
+	struct kevent out[4];
+
+	/* edge-triggered event is reported once per notification */
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ADD | EV_CLEAR) == 0);
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4) == 1);
+	CHECK(collect(kq, out, 4) == 0);
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4) == 1);
+	read_byte(p[0]);
+	read_byte(p[0]);
+	CHECK(change(kq, p[0], EVFILT_READ, EV_DELETE) == 0);
+
+	/* one-shot event is deleted after being reported */
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ADD | EV_ONESHOT) == 0);
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4) == 1);
+	CHECK(collect(kq, out, 4) == 0);
+	CHECK(change(kq, p[0], EVFILT_READ, EV_DELETE) == ENOENT);
+
+	/* dispatched event is disabled after being reported */
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ADD | EV_DISPATCH) == 0);
+	CHECK(collect(kq, out, 4) == 1);
+	CHECK(collect(kq, out, 4) == 0);
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ENABLE) == 0);
+	CHECK(collect(kq, out, 4) == 1);
+	CHECK(collect(kq, out, 4) == 0);
+	read_byte(p[0]);
+	CHECK(change(kq, p[0], EVFILT_READ, EV_DELETE) == 0);
+
+	close(p[0]);
+	close(p[1]);
+
+	printf("finished clear/oneshot/dispatch\n");
+}
+
+
+static void test_timeout(int kq)
+{
+	printf("start timeout\n");
+
+	int p[2];
+	CHECK(pipe(p) == 0);
+
+	struct kevent out[4];
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ADD) == 0);
+
+	timespec const timeout { 0, 200*1000*1000 };
+
+	unsigned long long const start = now_ms();
+	CHECK(collect(kq, out, 4, &timeout) == 0);
+	unsigned long long const elapsed = now_ms() - start;
+	printf("kevent returned after %llu ms\n", elapsed);
+	CHECK(elapsed >= 150);
+
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4, &timeout) == 1);
+
+	close(p[0]);
+	close(p[1]);
+
+	printf("finished timeout\n");
+}
+
+
+static void test_close(int kq)
+{
+	printf("start close\n");
+
+	int p[2];
+	CHECK(pipe(p) == 0);
+
+	struct kevent out[4];
+
+	CHECK(change(kq, p[0], EVFILT_READ, EV_ADD) == 0);
+	CHECK(change(kq, p[1], EVFILT_WRITE, EV_ADD) == 0);
+
+	int const old_fd[2] { p[0], p[1] };
+	close(p[0]);
+	close(p[1]);
+
+	/* the new descriptors must not inherit the events of the closed ones */
+	CHECK(pipe(p) == 0);
+	printf("closed %d/%d, got %d/%d\n", old_fd[0], old_fd[1], p[0], p[1]);
+
+	write_byte(p[1]);
+	CHECK(collect(kq, out, 4) == 0);
+	CHECK(change(kq, old_fd[0], EVFILT_READ,  EV_DELETE) == ENOENT);
+	CHECK(change(kq, old_fd[1], EVFILT_WRITE, EV_DELETE) == ENOENT);
+
+	close(p[0]);
+	close(p[1]);
+
+	printf("finished close\n");
+}
+
+
+static void test_socket(int kq, unsigned port, unsigned long expected)
+{
+	printf("start socket\n");
+
+	int const sd = socket(AF_INET, SOCK_STREAM, 0);
+	CHECK(sd != -1);
+
+	sockaddr_in addr { };
+	addr.sin_family      = AF_INET;
+	addr.sin_port        = htons(port);
+	addr.sin_addr.s_addr = INADDR_ANY;
+
+	CHECK(bind(sd, (sockaddr *)&addr, sizeof(addr)) == 0);
+	CHECK(listen(sd, 1) == 0);
+
+	struct kevent out[4];
+
+	/* pending connection makes the listening socket readable */
+	CHECK(change(kq, sd, EVFILT_READ, EV_ADD) == 0);
+
+	timespec const timeout { 30, 0 };
+	CHECK(collect(kq, out, 4, &timeout) == 1);
+	CHECK((int)out[0].ident == sd && out[0].filter == EVFILT_READ);
+
+	int const cd = accept(sd, nullptr, nullptr);
+	CHECK(cd != -1);
+	CHECK(fcntl(cd, F_SETFL, O_NONBLOCK) == 0);
+
+	CHECK(change(kq, cd, EVFILT_WRITE, EV_ADD | EV_ONESHOT) == 0);
+	CHECK(collect(kq, out, 4, &timeout) == 1);
+	CHECK((int)out[0].ident == cd && out[0].filter == EVFILT_WRITE);
+
+	/* receive until the peer closes the connection */
+	CHECK(change(kq, cd, EVFILT_READ, EV_ADD) == 0);
+
+	static char buf[16*1024];
+	unsigned long bytes = 0;
+	for (bool eof = false; !eof; ) {
+
+		CHECK(collect(kq, out, 4, &timeout) == 1);
+		CHECK((int)out[0].ident == cd && out[0].filter == EVFILT_READ);
+
+		for (;;) {
+			ssize_t const n = read(cd, buf, sizeof(buf));
+			if (n > 0) { bytes += n; continue; }
+
+			CHECK(n == 0 || errno == EAGAIN);
+			eof = (n == 0);
+			break;
+		}
+	}
+	printf("received %lu bytes\n", bytes);
+	CHECK(bytes == expected);
+
+	close(cd);
+	close(sd);
+
+	printf("finished socket\n");
+}
+
+
+int main(int argc, char **argv)
+{
+	printf("--- kqueue test started ---\n");
+
+	int const kq = kqueue();
+	CHECK(kq != -1);
+
+	test_add_delete(kq);
+	test_enable_disable(kq);
+	test_clear_oneshot_dispatch(kq);
+	test_timeout(kq);
+	test_close(kq);
+
+	if (argc >= 3)
+		test_socket(kq, atoi(argv[1]), atol(argv[2]));
+
+	close(kq);
+
+	printf("--- kqueue test finished ---\n");
+	return 0;
+}
@@ -0,0 +1,5 @@
+TARGET = test-libc_kqueue
+SRC_CC = main.cc
+LIBS   = posix libc_pipe
+
+CC_CXX_WARN_STRICT =
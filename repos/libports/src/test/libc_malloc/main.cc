@@ -0,0 +1,103 @@
+/*
+ * \brief  Stress test for malloc and free with an increasing number of threads
+ * \author Genode Labs
+ * \date   2018-12-06
+ *
+ * Each thread keeps a working set of blocks with pseudo-random sizes and
+ * repeatedly replaces a pseudo-randomly selected block by a new one. The
+ * duration of each round is measured by the run script.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* libc includes */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+enum {
+	MAX_THREADS      = 8,
+	WORKING_SET      = 64,
+	MAX_BLOCK_SIZE   = 1024,
+	OPS_PER_ROUND    = 8*1024*1024,
+};
+
+
+static void *stress(void *arg)
+{
+	unsigned long const ops    = (unsigned long)arg;
+	unsigned            seed   = (unsigned)(unsigned long)&seed;
+	void               *blocks[WORKING_SET];
+
+	memset(blocks, 0, sizeof(blocks));
+
+	for (unsigned long i = 0; i < ops; i++) {
+
+		seed = seed*1103515245 + 12345;
+		unsigned const idx  = (seed >> 8) % WORKING_SET;
+		size_t   const size = (seed >> 16) % MAX_BLOCK_SIZE + 1;
+
+		free(blocks[idx]);
+		blocks[idx] = malloc(size);
+		if (!blocks[idx]) {
+			printf("Error: malloc of %zu bytes failed\n", size);
+			return (void *)1;
+		}
+
+		/* touch the block as a real application would do */
+		*(char *)blocks[idx] = 0;
+	}
+	for (unsigned i = 0; i < WORKING_SET; i++)
+		free(blocks[i]);
+
+	return nullptr;
+}
+
+
+static bool stress_round(unsigned num_threads)
+{
+	pthread_t threads[MAX_THREADS];
+	bool      failed = false;
+
+	printf("start %u threads\n", num_threads);
+
+	/* the overall work stays the same, only its distribution changes */
+	unsigned long const ops = OPS_PER_ROUND / num_threads;
+	for (unsigned i = 0; i < num_threads; i++) {
+		if (pthread_create(&threads[i], 0, stress, (void *)ops)) {
+			printf("Error: could not create thread\n");
+			return false;
+		}
+	}
+	for (unsigned i = 0; i < num_threads; i++) {
+		void *result = nullptr;
+		pthread_join(threads[i], &result);
+		failed |= (result != nullptr);
+	}
+
+	printf("finished %u threads\n", num_threads);
+	return !failed;
+}
+
+
+int main(int, char **)
+{
+	printf("--- malloc stress test started ---\n");
+
+	for (unsigned num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+		if (!stress_round(num_threads)) {
+			printf("--- malloc stress test failed ---\n");
+			return -1;
+		}
+	}
+
+	printf("--- malloc stress test finished ---\n");
+	return 0;
+}
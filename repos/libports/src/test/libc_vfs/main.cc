@@ -92,6 +92,72 @@ static void test_write_read(Genode::Xml_node node)
 }
 
 
+/**
+ * Test 'readv()' and 'writev()' with many extents
+ *
+ * The extents have different sizes and the last extent of the read exceeds
+ * the end of the file, which results in a short read of this extent.
+ */
+static void test_readv_writev_extents(char const *file_name)
+{
+	enum { NUM_IOV = 8 };
+
+	int     ret, fd;
+	ssize_t count;
+
+	static size_t const sizes[NUM_IOV] = { 1, 4096, 17, 1000, 512, 3, 2048, 211 };
+
+	static char data[16*1024];
+	static char buf[16*1024];
+
+	size_t total = 0;
+	for (unsigned i = 0; i < NUM_IOV; i++)
+		total += sizes[i];
+
+	for (size_t i = 0; i < total; i++)
+		data[i] = (char)(i*7 + 3);
+
+	/* write all extents in one call */
+	struct iovec iov[NUM_IOV];
+	for (unsigned i = 0, off = 0; i < NUM_IOV; off += sizes[i], i++) {
+		iov[i].iov_base = &data[off];
+		iov[i].iov_len  = sizes[i];
+	}
+
+	CALL_AND_CHECK(fd, open(file_name, O_CREAT | O_WRONLY | O_TRUNC), fd >= 0, "file_name=%s", file_name);
+	CALL_AND_CHECK(count, writev(fd, iov, NUM_IOV), (size_t)count == total, "");
+	CALL_AND_CHECK(ret, close(fd), ret == 0, "");
+
+	/*
+	 * Read the file back starting at offset 5 into extents of the reversed
+	 * sizes, the last extent is 5 bytes short plus 100 bytes beyond the end
+	 * of the file.
+	 */
+	memset(buf, 0, sizeof(buf));
+	for (unsigned i = 0, off = 0; i < NUM_IOV; off += sizes[NUM_IOV - 1 - i], i++) {
+		iov[i].iov_base = &buf[off];
+		iov[i].iov_len  = sizes[NUM_IOV - 1 - i];
+	}
+	iov[NUM_IOV - 1].iov_len += 100;
+
+	size_t const expected = total - 5;
+
+	CALL_AND_CHECK(fd, open(file_name, O_RDONLY), fd >= 0, "file_name=%s", file_name);
+	CALL_AND_CHECK(ret, (int)lseek(fd, 5, SEEK_SET), ret == 5, "");
+	CALL_AND_CHECK(count, readv(fd, iov, NUM_IOV), (size_t)count == expected, "");
+
+	/* the file position follows the bytes read, further reads hit the end */
+	CALL_AND_CHECK(count, readv(fd, iov, NUM_IOV), count == 0, "");
+	CALL_AND_CHECK(ret, close(fd), ret == 0, "");
+
+	if (memcmp(buf, &data[5], expected) != 0 || buf[expected] != 0) {
+		printf("unexpected content of vectored read\n");
+		throw Test_failed();
+	}
+	printf("vectored read of %zu extents is correct\n", (size_t)NUM_IOV);
+}
+
+
 static void test(Genode::Xml_node node)
 {
 	int ret, fd;
@@ -104,6 +170,7 @@ static void test(Genode::Xml_node node)
 	char const *file_name3    = "test3.tst";
 	char const *file_name4    = "test4.tst";
 	char const *file_name5    = "test5.tst";
+	char const *file_name6    = "test6.tst";
 	char const *pattern       = "a single line of text";
 
 	size_t      pattern_size  = strlen(pattern) + 1;
@@ -218,6 +285,9 @@ static void test(Genode::Xml_node node)
 			printf("file content is correct\n");
 		}
 
+		/* test 'readv()' and 'writev()' with many extents */
+		test_readv_writev_extents(file_name6);
+
 		/* read directory entries */
 		DIR *dir;
 
@@ -0,0 +1,161 @@
+/*
+ * \brief  TCP throughput benchmark for libc sockets
+ * \author Genode Labs
+ * \date   2018-12-15
+ *
+ * The server receives data from TCP connections, one at a time. The client
+ * sends a configured amount of data over one connection per chunk size,
+ * using one 'write' call per chunk. Both sides report the throughput.
+ *
+ * ! test-lwip_tcp_throughput server <port> <connections>
+ * ! test-lwip_tcp_throughput client <ip> <port> <MiB> <chunk size>...
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* libc includes */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+
+static unsigned long long now_us()
+{
+	timespec ts { };
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000000ULL + ts.tv_nsec/1000;
+}
+
+
+static void report(char const *role, size_t chunk_size,
+                   unsigned long long bytes, unsigned long long us)
+{
+	unsigned long long const kib_per_s = us ? (bytes*1000000ULL/us)/1024 : 0;
+
+	printf("%s: chunk_size=%zu bytes=%llu time_ms=%llu throughput_kib_s=%llu\n",
+	       role, chunk_size, bytes, us/1000, kib_per_s);
+}
+
+
+static int server(unsigned port, unsigned connections)
+{
+	int const sd = socket(AF_INET, SOCK_STREAM, 0);
+	if (sd == -1) { perror("socket"); return 1; }
+
+	sockaddr_in addr { };
+	addr.sin_family      = AF_INET;
+	addr.sin_port        = htons(port);
+	addr.sin_addr.s_addr = INADDR_ANY;
+
+	if (bind(sd, (sockaddr *)&addr, sizeof(addr)) == -1) { perror("bind"); return 1; }
+	if (listen(sd, 1) == -1) { perror("listen"); return 1; }
+
+	enum { BUF_SIZE = 64*1024 };
+	static char buf[BUF_SIZE];
+
+	for (unsigned i = 0; i < connections; i++) {
+
+		int const cd = accept(sd, nullptr, nullptr);
+		if (cd == -1) { perror("accept"); return 1; }
+
+		unsigned long long bytes = 0;
+		unsigned long long const start = now_us();
+
+		for (ssize_t n; (n = read(cd, buf, sizeof(buf))) > 0; )
+			bytes += n;
+
+		report("server", sizeof(buf), bytes, now_us() - start);
+		close(cd);
+	}
+
+	close(sd);
+	return 0;
+}
+
+
+static int connect_to_server(char const *ip, unsigned port)
+{
+	sockaddr_in addr { };
+	addr.sin_family      = AF_INET;
+	addr.sin_port        = htons(port);
+	addr.sin_addr.s_addr = inet_addr(ip);
+
+	/* the server may not be listening yet */
+	for (;;) {
+		int const sd = socket(AF_INET, SOCK_STREAM, 0);
+		if (sd == -1) { perror("socket"); return -1; }
+
+		if (connect(sd, (sockaddr *)&addr, sizeof(addr)) == 0)
+			return sd;
+
+		close(sd);
+		sleep(1);
+	}
+}
+
+
+static int client(char const *ip, unsigned port, unsigned long mib,
+                  size_t chunk_size)
+{
+	char * const buf = (char *)malloc(chunk_size);
+	if (!buf) { perror("malloc"); return 1; }
+
+	memset(buf, 0x55, chunk_size);
+
+	int const sd = connect_to_server(ip, port);
+	if (sd == -1) return 1;
+
+	unsigned long long const total = mib*1024ULL*1024;
+	unsigned long long bytes = 0;
+	unsigned long long const start = now_us();
+
+	while (bytes < total) {
+		size_t  const len = total - bytes < chunk_size ? total - bytes : chunk_size;
+		ssize_t const n   = write(sd, buf, len);
+		if (n <= 0) { perror("write"); break; }
+		bytes += n;
+	}
+
+	report("client", chunk_size, bytes, now_us() - start);
+
+	close(sd);
+	free(buf);
+	return bytes == total ? 0 : 1;
+}
+
+
+int main(int argc, char **argv)
+{
+	if (argc >= 4 && !strcmp(argv[1], "server")) {
+
+		printf("--- TCP throughput server ---\n");
+		int const result = server(atoi(argv[2]), atoi(argv[3]));
+		printf("--- TCP throughput server finished ---\n");
+		return result;
+	}
+
+	if (argc >= 6 && !strcmp(argv[1], "client")) {
+
+		printf("--- TCP throughput client ---\n");
+		int result = 0;
+		for (int i = 5; i < argc && !result; i++)
+			result = client(argv[2], atoi(argv[3]), atol(argv[4]), atol(argv[i]));
+		printf("--- TCP throughput client finished ---\n");
+		return result;
+	}
+
+	fprintf(stderr, "usage: %s server <port> <connections>\n"
+	                "       %s client <ip> <port> <MiB> <chunk size>...\n",
+	        argv[0], argv[0]);
+	return 1;
+}
@@ -0,0 +1,5 @@
+TARGET = test-lwip_tcp_throughput
+LIBS   = posix
+SRC_CC = main.cc
+
+CC_CXX_WARN_STRICT =
@@ -31,4 +31,54 @@
 extern "C" void blit(void const *src, unsigned src_w,
                      void *dst, unsigned dst_w, int w, int h);
 
+
+/**
+ * Blend RGB888 pixels onto destination buffer according to alpha values
+ *
+ * \param src      address of source pixels
+ * \param src_w    line length of source buffer in bytes
+ * \param alpha    address of alpha values, one byte per source pixel
+ * \param alpha_w  line length of alpha buffer in bytes
+ * \param dst      address of destination pixels
+ * \param dst_w    line length of destination buffer in bytes
+ * \param w        number of pixels per line
+ * \param h        number of lines
+ *
+ * The result equals the one of 'Pixel_rgb888::mix' applied to each pixel
+ * with a non-zero alpha value. Pixels with an alpha value of zero are
+ * left untouched.
+ */
+extern "C" void blend_rgb888(void const *src, unsigned src_w,
+                             unsigned char const *alpha, unsigned alpha_w,
+                             void *dst, unsigned dst_w, int w, int h);
+
+/**
+ * Convert RGB565 pixels to RGB888 pixels
+ *
+ * The line lengths are given in bytes, 'w' and 'h' in pixels.
+ */
+extern "C" void convert_rgb565_to_rgb888(void const *src, unsigned src_w,
+                                         void *dst, unsigned dst_w, int w, int h);
+
+/**
+ * Convert RGB888 pixels to RGB565 pixels
+ *
+ * The line lengths are given in bytes, 'w' and 'h' in pixels.
+ */
+extern "C" void convert_rgb888_to_rgb565(void const *src, unsigned src_w,
+                                         void *dst, unsigned dst_w, int w, int h);
+
+/**
+ * Convert RGB888 pixels to RGB565 pixels with ordered dithering
+ *
+ * \param x  horizontal position of the first destination pixel
+ * \param y  vertical position of the first destination pixel
+ *
+ * The position selects the values of the 'Dither_matrix' applied to the
+ * pixels. The result equals the one of 'Dither_painter'.
+ */
+extern "C" void dither_rgb888_to_rgb565(void const *src, unsigned src_w,
+                                        void *dst, unsigned dst_w, int w, int h,
+                                        unsigned x, unsigned y);
+
 #endif /* _INCLUDE__BLIT__BLIT_H_ */
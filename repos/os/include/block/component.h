@@ -172,6 +172,8 @@ class Block::Session_component : public Block::Session_component_base,
 			     && tx_sink()->packet_avail();
 				 _ack_queue_full = (++_p_in_fly >= tx_sink()->ack_slots_free()))
 				_handle_packet(tx_sink()->get_packet());
+
+			_driver.submit_requests();
 		}
 
 	public:
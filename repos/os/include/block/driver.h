@@ -233,6 +233,15 @@ class Block::Driver : Genode::Interface
 		 */
 		virtual void sync() {}
 
+		/**
+		 * Submit requests the driver has deferred
+		 *
+		 * Called after the session handed over all requests currently
+		 * available. Drivers may hold back requests until then, e.g., to
+		 * merge adjacent requests or to notify the device only once.
+		 */
+		virtual void submit_requests() { }
+
 		/**
 		 * Informs the driver that the client session was closed
 		 *
@@ -103,6 +103,64 @@ namespace File_system {
 	}
 
 
+	/**
+	 * Transfer the extents of a vectored 'READV' or 'WRITEV' packet
+	 *
+	 * \param content  packet content
+	 * \param next     index of the first extent to transfer, updated with
+	 *                 the index of the first extent not transferred
+	 *                 completely
+	 * \param fn       functor 'size_t fn(seek_off_t, char *data, size_t)'
+	 *                 that transfers one extent and returns the number of
+	 *                 bytes transferred
+	 *
+	 * \return  number of bytes transferred
+	 *
+	 * Each extent is copied out of the packet before it is checked against
+	 * the packet boundaries, thereby the client cannot alter it afterwards.
+	 * The bytes transferred are written back to the extent table. The
+	 * transfer stops at the first invalid or incompletely transferred
+	 * extent, all succeeding extents are marked as empty.
+	 */
+	template <typename FN>
+	static inline size_t transfer_extents(Packet_descriptor const &packet,
+	                                      char *content, unsigned &next,
+	                                      FN const &fn)
+	{
+		size_t const size  = packet.size();
+		size_t const count = packet.length();
+
+		if (count > size / sizeof(Extent))
+			return 0;
+
+		size_t   const table_size = count * sizeof(Extent);
+		Extent * const table      = (Extent *)content;
+
+		size_t total = 0;
+		for (; next < count; next++) {
+			Extent const e = table[next];
+
+			bool const valid = e.offset >= table_size
+			                && e.offset <= size
+			                && e.length <= size - e.offset;
+
+			size_t const n = valid ? fn(e.position, content + e.offset, e.length) : 0;
+
+			table[next].length = n;
+			total += n;
+
+			if (!valid || n != e.length)
+				break;
+		}
+
+		/* mark all extents not transferred as empty */
+		for (unsigned i = next + 1; i < count; i++)
+			table[i].length = 0;
+
+		return total;
+	}
+
+
 	/**
 	 * Collect pending packet acknowledgements, freeing the space occupied
 	 * by the packet in the bulk buffer
@@ -75,6 +75,7 @@ namespace File_system {
 	typedef Genode::Out_of_caps Out_of_caps;
 
 	class Packet_descriptor;
+	struct Extent;
 
 	/**
 	 * Flags as supplied to 'file', 'dir', and 'symlink' calls
@@ -136,9 +137,24 @@ class File_system::Packet_descriptor : public Genode::Packet_descriptor
 			 * This is only needed by file systems that maintain an internal
 			 * cache, which needs to be flushed on certain occasions.
 			 */
-			SYNC
+			SYNC,
+
+			/**
+			 * Read or write multiple extents of a file at once
+			 *
+			 * The packet content starts with a table of 'Extent' structures
+			 * followed by the data of the extents. The number of table
+			 * entries is given as packet length. On acknowledgement, the
+			 * packet length holds the total number of bytes transferred.
+			 * The packet must be allocated with 'EXTENT_ALIGNMENT'.
+			 */
+			READV,
+			WRITEV
 		};
 
+		/* log2 alignment of vectored packets */
+		enum { EXTENT_ALIGNMENT = 3 };
+
 	private:
 
 		Node_handle _handle { 0 };   /* node handle */
@@ -203,6 +219,17 @@ class File_system::Packet_descriptor : public Genode::Packet_descriptor
 };
 
 
+/**
+ * Extent of a vectored 'READV' or 'WRITEV' operation
+ */
+struct File_system::Extent
+{
+	seek_off_t position; /* seek offset in bytes */
+	size_t     offset;   /* location of the data within the packet content */
+	size_t     length;   /* length in bytes, updated with the bytes transferred */
+};
+
+
 struct File_system::Status
 {
 	enum {
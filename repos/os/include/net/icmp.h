@@ -20,7 +20,11 @@
 
 namespace Genode { class Output; }
 
-namespace Net { class Icmp_packet; }
+namespace Net
+{
+	class Icmp_packet;
+	class Internet_checksum_diff;
+}
 
 
 class Net::Icmp_packet
@@ -57,6 +61,12 @@ class Net::Icmp_packet
 
 		void update_checksum(Genode::size_t data_sz);
 
+		/**
+		 * Update checksum incrementally according to the recorded
+		 * modifications of header fields
+		 */
+		void update_checksum(Internet_checksum_diff const &icd);
+
 		bool checksum_error(Genode::size_t data_sz) const;
 
 
@@ -100,6 +110,8 @@ class Net::Icmp_packet
 		void query_id(Genode::uint16_t v)       { _rest_of_header_u16[0] = host_to_big_endian(v); }
 		void query_seq(Genode::uint16_t v)      { _rest_of_header_u16[1] = host_to_big_endian(v); }
 
+		void query_id(Genode::uint16_t v, Internet_checksum_diff &icd);
+
 
 		/*********
 		 ** log **
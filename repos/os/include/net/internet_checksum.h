@@ -20,6 +20,8 @@
 
 namespace Net {
 
+	class Internet_checksum_diff;
+
 	Genode::uint16_t internet_checksum(Genode::uint16_t const *addr,
 	                                   Genode::size_t          size,
 	                                   Genode::addr_t          init_sum = 0);
@@ -32,4 +34,45 @@ namespace Net {
 	                                             Ipv4_address           &ip_dst);
 }
 
+
+/**
+ * Accumulated difference between the old and the new state of modified data
+ *
+ * Instead of re-calculating the checksum of a whole packet after having
+ * modified some header fields, the difference of each modified field is
+ * recorded and applied to the old checksum afterwards (RFC 1624).
+ */
+class Net::Internet_checksum_diff
+{
+	private:
+
+		Genode::addr_t _value { 0 };
+
+	public:
+
+		/**
+		 * Record the modification of 'size' bytes at an even offset
+		 *
+		 * \param new_data  data after the modification
+		 * \param old_data  data before the modification
+		 * \param size      size of the data in bytes, must be even
+		 */
+		void add_up_diff(Genode::uint8_t const *new_data,
+		                 Genode::uint8_t const *old_data,
+		                 Genode::size_t         size);
+
+		/**
+		 * Record all modifications recorded by 'icd'
+		 */
+		void add_up_diff(Internet_checksum_diff const &icd);
+
+		/**
+		 * Return checksum that results from applying the recorded
+		 * modifications to the checksum 'sum'
+		 *
+		 * Both checksums are in the byte order of the packet header.
+		 */
+		Genode::uint16_t apply_to(Genode::uint16_t sum) const;
+};
+
 #endif /* _NET__INTERNET_CHECKSUM_H_ */
@@ -32,6 +32,8 @@ namespace Net
 	class Ipv4_address;
 
 	class Ipv4_packet;
+
+	class Internet_checksum_diff;
 }
 
 
@@ -93,6 +95,12 @@ class Net::Ipv4_packet
 
 		void update_checksum();
 
+		/**
+		 * Update checksum incrementally according to the recorded
+		 * modifications of header fields
+		 */
+		void update_checksum(Internet_checksum_diff const &icd);
+
 		bool checksum_error() const;
 
 	private:
@@ -181,6 +189,15 @@ class Net::Ipv4_packet
 		void src(Ipv4_address v)                 { v.copy(&_src); }
 		void dst(Ipv4_address v)                 { v.copy(&_dst); }
 
+		/*
+		 * Modify address and record the modification in 'icd'
+		 *
+		 * The recorded difference also applies to the checksums of TCP and
+		 * UDP as both cover the addresses via their pseudo header.
+		 */
+		void src(Ipv4_address v, Internet_checksum_diff &icd);
+		void dst(Ipv4_address v, Internet_checksum_diff &icd);
+
 
 		/*********
 		 ** log **
@@ -27,6 +27,7 @@ namespace Net
 {
 	class Tcp_state;
 	class Tcp_packet;
+	class Internet_checksum_diff;
 }
 
 /**
@@ -74,6 +75,12 @@ class Net::Tcp_packet
 		                     Ipv4_address ip_dst,
 		                     size_t       tcp_size);
 
+		/**
+		 * Update checksum incrementally according to the recorded
+		 * modifications of header fields and IP addresses
+		 */
+		void update_checksum(Internet_checksum_diff const &icd);
+
 
 		/***************
 		 ** Accessors **
@@ -101,6 +108,9 @@ class Net::Tcp_packet
 		void src_port(Port p) { _src_port = host_to_big_endian(p.value); }
 		void dst_port(Port p) { _dst_port = host_to_big_endian(p.value); }
 
+		void src_port(Port p, Internet_checksum_diff &icd);
+		void dst_port(Port p, Internet_checksum_diff &icd);
+
 
 		/*********
 		 ** log **
@@ -61,6 +61,17 @@
  * acknowledge buffers using the methods 'packet_avail',
  * 'ready_to_submit', 'ready_to_ack', and 'ack_avail'.
  *
+ * Signals are sent only if the other side actually observed one of these
+ * conditions. As long as a side keeps processing packets without finding
+ * its queue empty (or full), the other side refrains from signalling.
+ *
+ * For high packet rates, source and sink can transfer arrays of packet
+ * descriptors via 'submit_packets', 'get_packets', 'acknowledge_packets',
+ * and 'get_acked_packets'. Each of those methods raises at most one signal
+ * per batch. A receiver that drains its queue via 'get_packets' or
+ * 'get_acked_packets' observes the empty queue once the method returns fewer
+ * packets than requested and gets signalled for the next packet.
+ *
  * If bidirectional data exchange between two processes is desired, two pairs
  * of 'Packet_stream_source' and 'Packet_stream_sink' should be instantiated.
  */
@@ -154,6 +165,22 @@ class Genode::Packet_descriptor
 /**
  * Ring buffer shared between source and sink, containing packet descriptors
  *
+ * The queue is a lock-free single-producer/single-consumer ring. The head
+ * index is written by the producer only, the tail index by the consumer
+ * only. Both indices are free-running counters that are mapped to queue
+ * slots by masking, which requires 'QUEUE_SIZE' to be a power of two. A
+ * slot is published to the other side by storing the respective index with
+ * release semantics after the slot content was written. The other side
+ * observes the index with acquire semantics before accessing the slot.
+ *
+ * Wakeup signals are suppressed by event indices similar to virtio. Before
+ * the consumer gives up on an empty queue, it stores the index of the next
+ * expected element as consumer event. The producer signals the consumer
+ * only if a newly published range of elements covers this index. As long
+ * as the consumer keeps processing elements, the event index stays behind
+ * and no signals are sent. The producer event works the same way for the
+ * producer waiting for free slots.
+ *
  * This class is private to the packet-stream interface.
  */
 template <typename PACKET_DESCRIPTOR, int QUEUE_SIZE>
@@ -161,17 +188,70 @@ class Genode::Packet_descriptor_queue
 {
 	private:
 
+		static_assert(QUEUE_SIZE > 1 && !(QUEUE_SIZE & (QUEUE_SIZE - 1)),
+		              "packet-descriptor queue size must be a power of two");
+
+		enum { MASK = QUEUE_SIZE - 1, CACHE_LINE_SIZE = 64 };
+
 		/*
 		 * The anonymous struct is needed to skip the initialization of the
 		 * members, which are shared by both sides of the packet stream.
+		 *
+		 * The members written by the producer and those written by the
+		 * consumer are placed in distinct cache lines to avoid false
+		 * sharing.
 		 */
 		struct
 		{
-			unsigned          _head;
-			unsigned          _tail;
-			PACKET_DESCRIPTOR _queue[QUEUE_SIZE];
+			/* written by the producer */
+			unsigned          _head __attribute__((aligned(CACHE_LINE_SIZE)));
+			unsigned          _producer_event;
+
+			/* written by the consumer */
+			unsigned          _tail __attribute__((aligned(CACHE_LINE_SIZE)));
+			unsigned          _consumer_event;
+
+			PACKET_DESCRIPTOR _queue[QUEUE_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
 		};
 
+		static unsigned _load_acquire(unsigned const &index) {
+			return __atomic_load_n(&index, __ATOMIC_ACQUIRE); }
+
+		static void _store_release(unsigned &index, unsigned value) {
+			__atomic_store_n(&index, value, __ATOMIC_RELEASE); }
+
+		/*
+		 * Order the store of an index before the subsequent load of an
+		 * index of the other side
+		 *
+		 * This is needed whenever a side decides about going to sleep or
+		 * about waking up the other side. Without the barrier, the store
+		 * of the own index may be delayed beyond the load of the other
+		 * index, which would result in a lost wakeup.
+		 */
+		static void _full_barrier() { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+		/*
+		 * Return true if moving an index from 'old_idx' to 'new_idx' passes
+		 * the event index 'event_idx'
+		 */
+		static bool _event_passed(unsigned event_idx, unsigned new_idx,
+		                          unsigned old_idx)
+		{
+			return (unsigned)(new_idx - event_idx - 1)
+			     < (unsigned)(new_idx - old_idx);
+		}
+
+		/*
+		 * Return number of queued elements
+		 *
+		 * The own index is never modified concurrently, the index of the
+		 * other side is observed with acquire semantics. Hence, the result
+		 * is valid for both sides.
+		 */
+		unsigned _used() const {
+			return _load_acquire(_head) - _load_acquire(_tail); }
+
 	public:
 
 		typedef PACKET_DESCRIPTOR Packet_descriptor;
@@ -189,10 +269,13 @@ class Genode::Packet_descriptor_queue
 		Packet_descriptor_queue(Role role)
 		{
 			if (role == PRODUCER) {
-				_head = 0;
+				_head           = 0;
+				_producer_event = 0;
 				Genode::memset(_queue, 0, sizeof(_queue));
-			} else
-				_tail = 0;
+			} else {
+				_tail           = 0;
+				_consumer_event = 0;
+			}
 		}
 
 		/**
@@ -201,13 +284,29 @@ class Genode::Packet_descriptor_queue
 		 * \return true on success, or
 		 *         false if queue is full
 		 */
-		bool add(PACKET_DESCRIPTOR packet)
+		bool add(PACKET_DESCRIPTOR packet) { return add(&packet, 1) == 1; }
+
+		/**
+		 * Place up to 'count' packet descriptors into queue
+		 *
+		 * All added descriptors are published to the consumer at once.
+		 *
+		 * \return number of added packet descriptors, which is lower than
+		 *         'count' if the queue became full
+		 */
+		unsigned add(PACKET_DESCRIPTOR const *packets, unsigned count)
 		{
-			if (full()) return false;
+			unsigned const head = _head;
+			unsigned const free = QUEUE_SIZE - _used();
+			unsigned const n    = count < free ? count : free;
+
+			for (unsigned i = 0; i < n; i++)
+				_queue[(head + i) & MASK] = packets[i];
+
+			if (n)
+				_store_release(_head, head + n);
 
-			_queue[_head%QUEUE_SIZE] = packet;
-			_head = (_head + 1)%QUEUE_SIZE;
-			return true;
+			return n;
 		}
 
 		/**
@@ -217,52 +316,130 @@ class Genode::Packet_descriptor_queue
 		 */
 		PACKET_DESCRIPTOR get()
 		{
-			PACKET_DESCRIPTOR packet = _queue[_tail%QUEUE_SIZE];
-			_tail = (_tail + 1)%QUEUE_SIZE;
+			PACKET_DESCRIPTOR packet { };
+			get(&packet, 1);
 			return packet;
 		}
 
+		/**
+		 * Take up to 'max' packet descriptors from queue
+		 *
+		 * \return number of packet descriptors stored at 'packets'
+		 */
+		unsigned get(PACKET_DESCRIPTOR *packets, unsigned max)
+		{
+			unsigned const tail = _tail;
+			unsigned const used = _used();
+			unsigned const n    = max < used ? max : used;
+
+			for (unsigned i = 0; i < n; i++)
+				packets[i] = _queue[(tail + i) & MASK];
+
+			if (n)
+				_store_release(_tail, tail + n);
+
+			return n;
+		}
+
 		/**
 		 * Return current packet descriptor
 		 */
 		PACKET_DESCRIPTOR peek() const
 		{
-			return _queue[_tail%QUEUE_SIZE];
+			return _queue[_tail & MASK];
 		}
 
 		/**
 		 * Return true if packet-descriptor queue is empty
 		 */
-		bool empty() { return _tail == _head; }
+		bool empty() const { return _used() == 0; }
 
 		/**
 		 * Return true if packet-descriptor queue is full
 		 */
-		bool full() { return (_head + 1)%QUEUE_SIZE == _tail; }
+		bool full() const { return _used() >= QUEUE_SIZE; }
+
+		/**
+		 * Return true if the queue is empty and request a wakeup signal
+		 *
+		 * This method must be called by the consumer only. If the queue
+		 * appears to be empty, the consumer event is armed and the check
+		 * is repeated so that the consumer may safely block afterwards.
+		 */
+		bool consumer_empty()
+		{
+			if (!empty()) return false;
+
+			_store_release(_consumer_event, _tail);
+			_full_barrier();
+			return empty();
+		}
+
+		/**
+		 * Return true if the queue is full and request a wakeup signal
+		 *
+		 * This method must be called by the producer only. It is the
+		 * counterpart of 'consumer_empty'.
+		 */
+		bool producer_full()
+		{
+			if (!full()) return false;
+
+			_store_release(_producer_event, _load_acquire(_tail));
+			_full_barrier();
+			return full();
+		}
 
 		/**
-		 * Return true if a single element is stored in the queue
+		 * Return number of slots left to be put into the queue
+		 *
+		 * This method must be called by the producer only. Because the
+		 * caller may decide to wait for more free slots based on the
+		 * result, the producer event is armed.
 		 */
-		bool single_element() { return (_tail + 1)%QUEUE_SIZE == _head; }
+		unsigned producer_slots_free()
+		{
+			_store_release(_producer_event, _load_acquire(_tail));
+			_full_barrier();
+			return QUEUE_SIZE - _used();
+		}
 
+		/**
+		 * Return true if the consumer must be woken up after the producer
+		 * added 'count' elements
+		 */
+		bool consumer_wakeup_needed(unsigned count)
+		{
+			_full_barrier();
+			return _event_passed(_load_acquire(_consumer_event),
+			                     _head, _head - count);
+		}
 
 		/**
-		 * Return true if a single slot is left to be put into the queue
+		 * Return true if the producer must be woken up after the consumer
+		 * removed 'count' elements
 		 */
-		bool single_slot_free() { return (_head + 2)%QUEUE_SIZE == _tail; }
+		bool producer_wakeup_needed(unsigned count)
+		{
+			_full_barrier();
+			return _event_passed(_load_acquire(_producer_event),
+			                     _tail, _tail - count);
+		}
 
 		/**
 		 * Return number of slots left to be put into the queue
 		 */
-		unsigned slots_free() {
-			return ((_tail > _head) ? _tail - _head
-			                        : QUEUE_SIZE - _head + _tail) - 1; }
+		unsigned slots_free() const { return QUEUE_SIZE - _used(); }
 };
 
 
 /**
  * Transmit packet descriptors with data-flow control
  *
+ * The lock serializes threads of the same component that share one
+ * transmitter. It is never contended across the packet-stream boundary
+ * because the shared queue itself is lock free.
+ *
  * This class is private to the packet-stream interface.
  */
 template <typename TX_QUEUE>
@@ -289,6 +466,8 @@ class Genode::Packet_descriptor_transmitter
 
 	public:
 
+		typedef typename TX_QUEUE::Packet_descriptor Packet_descriptor;
+
 		/**
 		 * Constructor
 		 */
@@ -321,37 +500,48 @@ class Genode::Packet_descriptor_transmitter
 				_rx_ready.submit();
 		}
 
-		bool ready_for_tx()
-		{
-			Genode::Lock::Guard lock_guard(_tx_queue_lock);
-			return !_tx_queue->full();
-		}
+		bool ready_for_tx() { return !_tx_queue->producer_full(); }
 
-		void tx(typename TX_QUEUE::Packet_descriptor packet)
+		void tx(Packet_descriptor packet) { tx(&packet, 1); }
+
+		/**
+		 * Transmit 'count' packet descriptors
+		 *
+		 * The receiver is woken up at most once, unless the queue becomes
+		 * full in the middle of the batch. In this case, the receiver is
+		 * notified about the partial batch before the transmitter blocks.
+		 */
+		void tx(Packet_descriptor const *packets, unsigned count)
 		{
 			Genode::Lock::Guard lock_guard(_tx_queue_lock);
 
-			do {
+			while (count) {
+
 				/* block for signal if tx queue is full */
-				if (_tx_queue->full())
+				if (_tx_queue->producer_full())
 					_tx_ready.wait_for_signal();
 
 				/*
 				 * It could happen that pending signals do not refer to the
-				 * current queue situation. Therefore, we need to double check
-				 * if the queue insertion succeeds and retry if needed.
+				 * current queue situation. Therefore, we add as many
+				 * descriptors as currently fit and retry if needed.
 				 */
+				unsigned const n = _tx_queue->add(packets, count);
+				if (!n)
+					continue;
 
-			} while (_tx_queue->add(packet) == false);
+				if (_tx_queue->consumer_wakeup_needed(n))
+					_rx_ready.submit();
 
-			if (_tx_queue->single_element())
-				_rx_ready.submit();
+				packets += n;
+				count   -= n;
+			}
 		}
 
 		/**
 		 * Return number of slots left to be put into the tx queue
 		 */
-		unsigned tx_slots_free() { return _tx_queue->slots_free(); }
+		unsigned tx_slots_free() { return _tx_queue->producer_slots_free(); }
 };
 
 
@@ -373,8 +563,55 @@ class Genode::Packet_descriptor_receiver
 		/* facility to send ready-to-transmit signals */
 		Genode::Signal_transmitter        _tx_ready { };
 
-		Genode::Lock mutable  _rx_queue_lock { };
-		RX_QUEUE             *_rx_queue;
+		Genode::Lock  _rx_queue_lock { };
+		RX_QUEUE     *_rx_queue;
+
+		/*
+		 * Adaptive polling of an empty queue
+		 *
+		 * The poll window is doubled whenever polling found a new element
+		 * and halved whenever polling was in vain. It stays within the
+		 * bounds of '_poll_window_min' and '_poll_window_max'.
+		 *
+		 * '_poll' is called by 'ready_for_rx' without holding
+		 * '_rx_queue_lock'. Hence, the window is accessed atomically. A
+		 * concurrent update may get lost, which merely affects the length
+		 * of the next poll.
+		 */
+		unsigned _poll_window_max = 0;
+		unsigned _poll_window_min = 0;
+		unsigned _poll_window     = 0;
+
+		unsigned _load_poll_window() const {
+			return __atomic_load_n(&_poll_window, __ATOMIC_RELAXED); }
+
+		void _store_poll_window(unsigned value) {
+			__atomic_store_n(&_poll_window, value, __ATOMIC_RELAXED); }
+
+		bool _poll()
+		{
+			unsigned const window = _load_poll_window();
+			if (!window)
+				return false;
+
+			for (unsigned i = 0; i < window; i++) {
+				if (_rx_queue->empty())
+					continue;
+
+				_store_poll_window(Genode::min(window*2, _poll_window_max));
+				return true;
+			}
+			_store_poll_window(Genode::max(window/2, _poll_window_min));
+			return false;
+		}
+
+		bool _empty()
+		{
+			if (!_rx_queue->empty()) return false;
+			if (_poll())             return false;
+
+			return _rx_queue->consumer_empty();
+		}
 
 		/*
 		 * Noncopyable
@@ -384,6 +621,8 @@ class Genode::Packet_descriptor_receiver
 
 	public:
 
+		typedef typename RX_QUEUE::Packet_descriptor Packet_descriptor;
+
 		/**
 		 * Constructor
 		 */
@@ -416,30 +655,64 @@ class Genode::Packet_descriptor_receiver
 				_tx_ready.submit();
 		}
 
-		bool ready_for_rx()
+		/**
+		 * Poll an empty queue for up to 'max_iterations' before blocking
+		 *
+		 * A value of zero disables polling.
+		 */
+		void poll_window(unsigned max_iterations)
 		{
-			Genode::Lock::Guard lock_guard(_rx_queue_lock);
-			return !_rx_queue->empty();
+			_poll_window_max = max_iterations;
+			_poll_window_min = max_iterations ? max_iterations/16 + 1 : 0;
+			_store_poll_window(_poll_window_min);
 		}
 
-		void rx(typename RX_QUEUE::Packet_descriptor *out_packet)
+		bool ready_for_rx() { return !_empty(); }
+
+		void rx(Packet_descriptor *out_packet)
 		{
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
 
-			while (_rx_queue->empty())
+			while (_empty())
 				_rx_ready.wait_for_signal();
 
-			*out_packet = _rx_queue->get();
+			_rx_queue->get(out_packet, 1);
 
-			if (_rx_queue->single_slot_free())
+			if (_rx_queue->producer_wakeup_needed(1))
 				_tx_ready.submit();
 		}
 
-		typename RX_QUEUE::Packet_descriptor rx_peek() const
+		/**
+		 * Receive up to 'max' packet descriptors without blocking
+		 *
+		 * The transmitter is woken up at most once per call. If the queue
+		 * gets drained, i.e., if fewer than 'max' descriptors are returned,
+		 * the wakeup signal for the next descriptor is requested. Hence, a
+		 * signal-driven receiver may safely wait for the next signal once
+		 * this method returned fewer than 'max' descriptors, in particular 0.
+		 *
+		 * \return number of packet descriptors stored at 'out_packets'
+		 */
+		unsigned rx(Packet_descriptor *out_packets, unsigned max)
 		{
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
-			return _rx_queue->peek();
+
+			unsigned n = 0;
+			for (;;) {
+				n += _rx_queue->get(out_packets + n, max - n);
+
+				/* arm the wakeup signal before reporting a drained queue */
+				if (n == max || _empty())
+					break;
+			}
+
+			if (n && _rx_queue->producer_wakeup_needed(n))
+				_tx_ready.submit();
+
+			return n;
 		}
+
+		Packet_descriptor rx_peek() const { return _rx_queue->peek(); }
 };
 
 
@@ -730,6 +1003,18 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			_submit_transmitter.tx(packet);
 		}
 
+		/**
+		 * Tell sink about 'count' packets to process
+		 *
+		 * This method blocks until all packets are placed into the submit
+		 * queue. The sink is signalled at most once unless the submit queue
+		 * becomes full in the middle of the batch.
+		 */
+		void submit_packets(Packet_descriptor const *packets, unsigned count)
+		{
+			_submit_transmitter.tx(packets, count);
+		}
+
 		/**
 		 * Returns true if one or more packet acknowledgements are available
 		 */
@@ -745,6 +1030,19 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get up to 'max' acknowledged packets without blocking
+		 *
+		 * If fewer than 'max' packets are returned, including none, the
+		 * signal for the next packet is re-armed.
+		 *
+		 * \return number of packets stored at 'packets'
+		 */
+		unsigned get_acked_packets(Packet_descriptor *packets, unsigned max)
+		{
+			return _ack_receiver.rx(packets, max);
+		}
+
 		/**
 		 * Release bulk-buffer space consumed by the packet
 		 */
@@ -838,6 +1136,21 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			return _submit_receiver.rx_ready_cap();
 		}
 
+		/**
+		 * Enable adaptive polling of the submit queue
+		 *
+		 * If the submit queue becomes empty, 'packet_avail' and 'get_packet'
+		 * poll the queue for up to 'max_iterations' before reporting the
+		 * queue as empty or blocking. The effective poll window adapts to
+		 * the observed packet rate. Polling pays off only if source and sink
+		 * execute on different CPUs. A value of zero disables polling, which
+		 * is the default.
+		 */
+		void poll_before_block(unsigned max_iterations)
+		{
+			_submit_receiver.poll_window(max_iterations);
+		}
+
 		/**
 		 * Return true if a packet is available
 		 */
@@ -855,6 +1168,19 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get up to 'max' packets from source without blocking
+		 *
+		 * If fewer than 'max' packets are returned, including none, the
+		 * signal for the next packet is re-armed.
+		 *
+		 * \return number of packets stored at 'packets'
+		 */
+		unsigned get_packets(Packet_descriptor *packets, unsigned max)
+		{
+			return _submit_receiver.rx(packets, max);
+		}
+
 		/**
 		 * Return but do not dequeue next packet
 		 *
@@ -895,6 +1221,19 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			_ack_transmitter.tx(packet);
 		}
 
+		/**
+		 * Acknowledge the processing of 'count' packets at once
+		 *
+		 * This method blocks until all acknowledgements are placed into the
+		 * acknowledgement queue. The source is signalled at most once
+		 * unless the acknowledgement queue becomes full in the middle of the
+		 * batch.
+		 */
+		void acknowledge_packets(Packet_descriptor const *packets, unsigned count)
+		{
+			_ack_transmitter.tx(packets, count);
+		}
+
 		void debug_print_buffers() {
 			Packet_stream_base::_debug_print_buffers(); }
 
@@ -18,8 +18,11 @@
 #include <util/xml_node.h>
 #include <util/reconstructible.h>
 #include <base/attached_dataspace.h>
+#include <base/attached_ram_dataspace.h>
 #include <report_session/connection.h>
 #include <util/xml_generator.h>
+#include <util/xml_delta.h>
+#include <base/log.h>
 
 namespace Genode {
 	class Reporter;
@@ -35,6 +38,14 @@ class Genode::Reporter
 
 	private:
 
+		/*
+		 * Noncopyable
+		 */
+		Reporter(Reporter const &);
+		Reporter &operator = (Reporter const &);
+
+		Env * const _env;   /* 0 if constructed via the deprecated constructor */
+
 		Name const _xml_name;
 		Name const _label;
 
@@ -53,6 +64,43 @@ class Genode::Reporter
 
 		Constructible<Connection> _conn { };
 
+		bool _incremental = false;
+
+		/**
+		 * Local copies of the previous and the current report
+		 *
+		 * In incremental mode, reports are generated into 'curr' and
+		 * compared with 'prev', which corresponds to the content the
+		 * recipient has.
+		 */
+		struct Snapshots
+		{
+			enum { MAX_DELTAS = 64 };
+
+			Attached_ram_dataspace prev, curr;
+
+			size_t              prev_size = 0;  /* 0 if nothing was reported */
+			Xml_delta::Checksum prev_checksum = 0;
+
+			/* number of deltas since the last full report */
+			unsigned num_deltas = 0;
+
+			Snapshots(Env &env, size_t size)
+			:
+				prev(env.ram(), env.rm(), size), curr(env.ram(), env.rm(), size)
+			{ }
+		};
+
+		Constructible<Snapshots> _snapshots { };
+
+		void _construct_snapshots()
+		{
+			if (_enabled && _incremental && _env)
+				_snapshots.construct(*_env, _conn->ds.size());
+			else
+				_snapshots.destruct();
+		}
+
 		/**
 		 * Return size of report buffer
 		 */
@@ -63,12 +111,82 @@ class Genode::Reporter
 		 */
 		char *_base() { return _enabled ? _conn->ds.local_addr<char>() : 0; }
 
+		/**
+		 * Return buffer for generating the report
+		 */
+		char *_generator_base()
+		{
+			return _snapshots.constructed() ? _snapshots->curr.local_addr<char>()
+			                                : _base();
+		}
+
+		/**
+		 * Submit report generated into the buffer returned by '_generator_base'
+		 */
+		void _submit(size_t length)
+		{
+			if (!_enabled)
+				return;
+
+			if (!_snapshots.constructed()) {
+				_conn->report.submit(length);
+				return;
+			}
+
+			Snapshots &s = *_snapshots;
+
+			char const * const curr_base = s.curr.local_addr<char>();
+			char const * const prev_base = s.prev.local_addr<char>();
+
+			/* spare the recipient from an update without any change */
+			if (length == s.prev_size && !memcmp(curr_base, prev_base, length))
+				return;
+
+			Xml_node const curr(curr_base, length);
+
+			bool const delta_possible = s.prev_size
+			                         && s.num_deltas < Snapshots::MAX_DELTAS
+			                         && Xml_delta::representable(curr);
+			bool delta_submitted = false;
+
+			if (delta_possible) {
+				Xml_node const prev(prev_base, s.prev_size);
+				try {
+					Genode::Xml_generator xml(_base(), _size(), _xml_name.string(), [&] () {
+						Xml_delta::generate(xml, prev, curr, s.prev_checksum); });
+
+					if (xml.used() < length) {
+						_conn->report.submit(xml.used());
+
+						/*
+						 * A recipient that cannot apply the delta clears
+						 * the report buffer, e.g., if its content does not
+						 * match the base of the delta.
+						 */
+						delta_submitted = _base()[0] != 0;
+					}
+				}
+				catch (Genode::Xml_generator::Buffer_exceeded) { }
+			}
+
+			/* fall back to the full report */
+			if (!delta_submitted) {
+				memcpy(_base(), curr_base, length);
+				_conn->report.submit(length);
+			}
+
+			s.num_deltas    = delta_submitted ? s.num_deltas + 1 : 0;
+			s.prev_size     = length;
+			s.prev_checksum = Xml_delta::checksum(curr);
+			s.prev.swap(s.curr);
+		}
+
 	public:
 
-		Reporter(Env &, char const *xml_name, char const *label = nullptr,
+		Reporter(Env &env, char const *xml_name, char const *label = nullptr,
 		         size_t buffer_size = 4096)
 		:
-			_xml_name(xml_name), _label(label ? label : xml_name),
+			_env(&env), _xml_name(xml_name), _label(label ? label : xml_name),
 			_buffer_size(buffer_size)
 		{ }
 
@@ -81,7 +199,7 @@ class Genode::Reporter
 		Reporter(char const *xml_name, char const *label = nullptr,
 		         size_t buffer_size = 4096) __attribute__((deprecated))
 		:
-			_xml_name(xml_name), _label(label ? label : xml_name),
+			_env(nullptr), _xml_name(xml_name), _label(label ? label : xml_name),
 			_buffer_size(buffer_size)
 		{ }
 
@@ -98,6 +216,34 @@ class Genode::Reporter
 				_conn.destruct();
 
 			_enabled = enabled;
+
+			_construct_snapshots();
+		}
+
+		/**
+		 * Enable or disable incremental reporting
+		 *
+		 * In incremental mode, the reporter keeps a local copy of the
+		 * previously submitted report. A report without any change is not
+		 * submitted. Otherwise, the reporter submits an XML delta that
+		 * carries only the changed sub nodes (see 'util/xml_delta.h'),
+		 * falling back to the full report if the delta would not be
+		 * smaller. The mode should be enabled only if the recipient of
+		 * the reports is able to apply deltas, like the report-ROM
+		 * server. The local copies require twice the buffer size of RAM.
+		 * The mode is available only for a reporter constructed with the
+		 * 'Env' argument.
+		 */
+		void incremental(bool incremental)
+		{
+			if (incremental == _incremental) return;
+
+			if (incremental && !_env)
+				warning("incremental reporting of '", _label, "' requires 'Env'");
+
+			_incremental = incremental;
+
+			_construct_snapshots();
 		}
 
 		/**
@@ -118,7 +264,14 @@ class Genode::Reporter
 		/**
 		 * Clear report buffer
 		 */
-		void clear() { memset(_base(), 0, _size()); }
+		void clear()
+		{
+			memset(_base(), 0, _size());
+
+			/* the next incremental report must not refer to the old content */
+			if (_snapshots.constructed())
+				_snapshots->prev_size = 0;
+		}
 
 		/**
 		 * Report data buffer
@@ -135,6 +288,9 @@ class Genode::Reporter
 
 			memcpy(base, data, length);
 			_conn->report.submit(length);
+
+			if (_snapshots.constructed())
+				_snapshots->prev_size = 0;
 		}
 
 		/**
@@ -145,13 +301,12 @@ class Genode::Reporter
 			template <typename FUNC>
 			Xml_generator(Reporter &reporter, FUNC const &func)
 			:
-				Genode::Xml_generator(reporter._base(),
+				Genode::Xml_generator(reporter._generator_base(),
 				                      reporter._size(),
 				                      reporter._xml_name.string(),
 				                      func)
 			{
-				if (reporter.enabled())
-					reporter._conn->report.submit(used());
+				reporter._submit(used());
 			}
 		};
 };
@@ -185,10 +340,13 @@ class Genode::Expanding_reporter
 
 		size_t _buffer_size = 4096;
 
+		bool _incremental = false;
+
 		void _construct()
 		{
 			_reporter.construct(_env, _type.string(), _label.string(), _buffer_size);
 			_reporter->enabled(true);
+			_reporter->incremental(_incremental);
 		}
 
 		void _increase_report_buffer()
@@ -202,6 +360,17 @@ class Genode::Expanding_reporter
 		Expanding_reporter(Env &env, Node_type const &type, Label const &label)
 		: _env(env), _type(type), _label(label) { _construct(); }
 
+		/**
+		 * Enable or disable incremental reporting
+		 *
+		 * \see Reporter::incremental
+		 */
+		void incremental(bool incremental)
+		{
+			_incremental = incremental;
+			_reporter->incremental(incremental);
+		}
+
 		template <typename FN>
 		void generate(FN const &fn)
 		{
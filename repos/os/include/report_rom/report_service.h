@@ -89,7 +89,15 @@ struct Report::Session_component : Genode::Rpc_object<Session>, Rom::Writer
 				_log_lines(_ds.local_addr<char>(), length);
 			}
 
-			_module.write_content(*this, _ds.local_addr<char>(), length);
+			char * const report = _ds.local_addr<char>();
+
+			/*
+			 * Tell the reporter about a rejected XML delta by clearing the
+			 * report buffer. The reporter checks the buffer after
+			 * submitting a delta and falls back to the full report.
+			 */
+			if (!_module.write_content(*this, report, length, _ds.size()) && length)
+				report[0] = 0;
 		}
 
 		void response_sigh(Genode::Signal_context_capability) override { }
@@ -18,12 +18,15 @@
 #include <util/reconstructible.h>
 #include <os/session_policy.h>
 #include <base/attached_ram_dataspace.h>
+#include <util/xml_delta.h>
+#include <base/log.h>
 
 namespace Rom {
 	using Genode::size_t;
 	using Genode::Constructible;
 	using Genode::Attached_ram_dataspace;
 	using Genode::Interface;
+	using Genode::Xml_delta;
 
 	class Module;
 	class Readable_module;
@@ -164,6 +167,64 @@ struct Rom::Module : private Module_list::Element, Readable_module
 		 */
 		size_t _size = 0;
 
+		/**
+		 * Backing store for applying XML deltas, swapped with '_ds'
+		 */
+		Constructible<Attached_ram_dataspace> _delta_ds { };
+
+		/**
+		 * Apply XML delta to the current content
+		 *
+		 * \param max_len  maximum size of the resulting content
+		 *
+		 * \return true if the content got updated
+		 */
+		bool _apply_delta(Writer const &writer, char const *src, size_t src_len,
+		                  size_t max_len)
+		{
+			using namespace Genode;
+
+			/* a delta refers to the previous report of the same writer */
+			if (_last_writer != &writer || !_ds.constructed() || !_size) {
+				warning("discarding XML delta for '", _name, "' without base");
+				return false;
+			}
+
+			/*
+			 * The result consists of parts of the content and the delta. It
+			 * must fit into the report buffer of the writer, which would
+			 * have to carry the result as full report otherwise.
+			 */
+			size_t const capacity = min(_size + src_len, max_len) + 1;
+			if (!_delta_ds.constructed() || _delta_ds->size() < capacity)
+				_delta_ds.construct(_ram, _rm, capacity);
+
+			char * const dst = _delta_ds->local_addr<char>();
+
+			try {
+				Xml_node const prev (_ds->local_addr<char>(), _size);
+				Xml_node const delta(src, src_len);
+
+				Xml_generator xml(dst, capacity - 1, delta.type().string(), [&] () {
+					Xml_delta::apply(xml, prev, delta); });
+
+				_size = xml.used();
+			}
+			catch (Xml_generator::Buffer_exceeded) {
+				warning("discarding XML delta for '", _name, "' exceeding "
+				        "the report buffer");
+				return false;
+			}
+			catch (...) {
+				warning("discarding invalid XML delta for '", _name, "'");
+				return false;
+			}
+
+			dst[_size] = 0;
+			_ds->swap(*_delta_ds);
+			return true;
+		}
+
 
 		/********************************
 		 ** Interface used by registry **
@@ -245,17 +306,48 @@ struct Rom::Module : private Module_list::Element, Readable_module
 			return cnt;
 		}
 
+		/**
+		 * Notify ROM clients that access the module
+		 */
+		void _notify_readers()
+		{
+			for (Reader *r = _readers.first(); r; r = r->next()) {
+
+				if (_read_policy.read_permitted(*this, *_last_writer, *r))
+					r->notify_module_changed();
+				else
+					r->notify_module_invalidated();
+			}
+		}
+
 	public:
 
 		/**
 		 * Assign new content to the ROM module
 		 *
-		 * Called by report service when a new report comes in.
+		 * Called by report service when a new report comes in. If the
+		 * report is an XML delta, it is applied to the current content.
+		 *
+		 * \param max_len  size of the writer's report buffer, which limits
+		 *                 the content resulting from an XML delta
+		 *
+		 * \return false if the report is an XML delta that could not be
+		 *         applied, in which case the writer must submit the full
+		 *         report
 		 */
-		void write_content(Writer const &writer, char const * const src, size_t const src_len)
+		bool write_content(Writer const &writer, char const * const src,
+		                   size_t const src_len, size_t const max_len)
 		{
 			if (!_write_policy.write_permitted(*this, writer))
-				return;
+				return true;
+
+			if (Xml_delta::delta(src, src_len)) {
+				if (!_apply_delta(writer, src, src_len, max_len))
+					return false;
+
+				_notify_readers();
+				return true;
+			}
 
 			_size = 0;
 
@@ -278,14 +370,8 @@ struct Rom::Module : private Module_list::Element, Readable_module
 			/* append zero termination */
 			_ds->local_addr<char>()[src_len] = 0;
 
-			/* notify ROM clients that access the module */
-			for (Reader *r = _readers.first(); r; r = r->next()) {
-
-				if (_read_policy.read_permitted(*this, *_last_writer, *r))
-					r->notify_module_changed();
-				else
-					r->notify_module_invalidated();
-			}
+			_notify_readers();
+			return true;
 		}
 
 		/**
@@ -0,0 +1,66 @@
+/*
+ * \brief  Runtime query of x86 CPU features
+ * \author Genode Labs
+ * \date   2018-12-28
+ *
+ * Instruction-set extensions beyond the baseline of the build are usable
+ * only if the CPU supports them and, for extensions with additional
+ * register state, the kernel saves this state on context switches.
+ * Callers are expected to cache the result, e.g., in a static local.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__SPEC__X86__CPU__FEATURES_H_
+#define _INCLUDE__SPEC__X86__CPU__FEATURES_H_
+
+#include <base/fixed_stdint.h>
+
+namespace Genode {
+
+	struct Cpuid_regs { uint32_t eax, ebx, ecx, edx; };
+
+	static inline Cpuid_regs cpuid(uint32_t leaf, uint32_t subleaf = 0)
+	{
+		Cpuid_regs r { 0, 0, 0, 0 };
+		asm volatile ("cpuid" : "=a"(r.eax), "=b"(r.ebx), "=c"(r.ecx), "=d"(r.edx)
+		                      : "a"(leaf), "c"(subleaf));
+		return r;
+	}
+
+	/**
+	 * Return true if the CPU supports AVX and the kernel saves the AVX state
+	 */
+	static inline bool avx_supported()
+	{
+		/* check for OSXSAVE and AVX */
+		enum { OSXSAVE = 1U << 27, AVX = 1U << 28 };
+		if ((cpuid(1).ecx & (OSXSAVE | AVX)) != (OSXSAVE | AVX))
+			return false;
+
+		/* check whether the kernel saves the SSE and AVX state */
+		uint32_t xcr0_lo = 0, xcr0_hi = 0;
+		asm volatile ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		enum { XCR0_SSE = 1U << 1, XCR0_AVX = 1U << 2 };
+		return (xcr0_lo & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX);
+	}
+
+	/**
+	 * Return true if the CPU supports AVX2 and the kernel saves the AVX state
+	 */
+	static inline bool avx2_supported()
+	{
+		if (cpuid(0).eax < 7 || !avx_supported())
+			return false;
+
+		enum { AVX2 = 1U << 5 };
+		return cpuid(7, 0).ebx & AVX2;
+	}
+}
+
+#endif /* _INCLUDE__SPEC__X86__CPU__FEATURES_H_ */
@@ -158,35 +158,34 @@ class Genode::Timeout : private Noncopyable
 
 			private:
 
-				typedef unsigned long Time;
-
-				struct Raw
-				{
-					Time deadline;
-					bool deadline_period;
-					Time period;
-
-					bool is_pending_at(unsigned long time, bool time_period) const;
-				};
+				typedef unsigned long    Time;
+				typedef Genode::uint64_t Tick;
 
 				Lock                     _dispatch_lock { };
-				Raw                      _raw           { };
+				Tick                     _deadline      { 0 };
+				Time                     _period        { 0 };
 				int                      _active        { 0 };
 				Alarm                   *_next          { nullptr };
+				Alarm                   *_prev          { nullptr };
+				Alarm                  **_list          { nullptr };
 				Alarm_timeout_scheduler *_scheduler     { nullptr };
 
 				void _alarm_assign(Time                     period,
-				                   Time                     deadline,
-				                   bool                     deadline_period,
+				                   Tick                     deadline,
 				                   Alarm_timeout_scheduler *scheduler)
 				{
-					_raw.period          = period;
-					_raw.deadline_period = deadline_period;
-					_raw.deadline        = deadline;
-					_scheduler           = scheduler;
+					_period    = period;
+					_deadline  = deadline;
+					_scheduler = scheduler;
 				}
 
-				void _alarm_reset() { _alarm_assign(0, 0, false, 0), _active = 0, _next = 0; }
+				void _alarm_reset()
+				{
+					_alarm_assign(0, 0, 0);
+					_active = 0;
+					_next = _prev = nullptr;
+					_list = nullptr;
+				}
 
 				bool _on_alarm(unsigned);
 
@@ -224,7 +223,16 @@ class Genode::Timeout : private Noncopyable
 
 
 /**
- * Timeout-scheduler implementation using the Alarm framework
+ * Timeout-scheduler implementation using a hierarchical timing wheel
+ *
+ * Scheduled alarms are kept in 'LEVELS' wheels of 'SLOTS' slots each. A
+ * slot of level n covers 'SLOTS^n' microseconds and an alarm is put into
+ * the lowest level that can hold the distance of its deadline to the time
+ * the wheel was last advanced to. Thereby, scheduling and discarding an
+ * alarm costs constant time. When the time advances, the slots passed by
+ * are emptied and their alarms get either expired or moved to a lower
+ * level. Alarms that lie beyond the range of the highest level are parked
+ * in its last slot and re-sorted once this slot is reached.
  */
 class Genode::Alarm_timeout_scheduler : private Noncopyable,
                                         public  Timeout_scheduler,
@@ -237,19 +245,39 @@ class Genode::Alarm_timeout_scheduler : private Noncopyable,
 	private:
 
 		using Alarm = Timeout::Alarm;
+		using Tick  = Alarm::Tick;
+
+		enum { SLOT_BITS = 6, SLOTS = 1 << SLOT_BITS, LEVELS = 6 };
 
 		Time_source     &_time_source;
 		Lock             _lock              { };
-		Alarm           *_active_head       { nullptr };
+		Alarm           *_wheel[LEVELS][SLOTS] { };
+		uint64_t         _occupied[LEVELS]  { };       /* non-empty slots    */
+		Alarm           *_expired_head      { nullptr };
 		Alarm           *_pending_head      { nullptr };
-		Alarm::Time      _now               { 0UL };
-		bool             _now_period        { false };
-		Alarm::Raw       _min_handle_period { };
+		Alarm::Time      _now               { 0UL };   /* last source time   */
+		Tick             _ticks             { 0 };     /* monotonic 'now'    */
+		Tick             _wheel_ticks       { 0 };     /* wheel advanced to  */
+		Tick             _wakeup            { ~(Tick)0 };
+		Alarm::Time      _min_handle_period { 0 };
+		Tick             _min_handle_ticks  { 0 };
+
+		static unsigned _shift(unsigned level) { return SLOT_BITS*level; }
 
 		void _alarm_unsynchronized_enqueue(Alarm *alarm);
 
 		void _alarm_unsynchronized_dequeue(Alarm *alarm);
 
+		/**
+		 * Move all alarms of a wheel slot to their new places
+		 */
+		void _alarm_unsynchronized_cascade(unsigned level, unsigned slot);
+
+		/**
+		 * Advance the wheel to the current time
+		 */
+		void _alarm_unsynchronized_advance();
+
 		Alarm *_alarm_get_pending_alarm();
 
 		void _alarm_setup_alarm(Alarm &alarm, Alarm::Time period, Alarm::Time first_duration);
@@ -282,9 +310,18 @@ class Genode::Alarm_timeout_scheduler : private Noncopyable,
 
 		void _alarm_handle(Alarm::Time now);
 
+		/**
+		 * Determine the point in time the scheduler must be called next
+		 *
+		 * For alarms in higher levels of the wheel, this is the start of
+		 * their slot, which may lie before the actual deadline.
+		 */
 		bool _alarm_next_deadline(Alarm::Time *deadline);
 
-		bool _alarm_head_timeout(const Alarm * alarm) { return _active_head == alarm; }
+		/**
+		 * Return whether the alarm expires before the time-source timeout
+		 */
+		bool _alarm_head_timeout(const Alarm * alarm);
 
 		Alarm_timeout_scheduler(Alarm_timeout_scheduler const &);
 		Alarm_timeout_scheduler &operator = (Alarm_timeout_scheduler const &);
@@ -0,0 +1,43 @@
+/*
+ * \brief  Binary trace-event record
+ * \author Genode Labs
+ * \date   2018-12-10
+ *
+ * Record generated by the 'binary' trace policy. In contrast to textual
+ * records, the record is cheap to generate and compact to store. It is
+ * meant to be decoded offline.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__TRACE__BINARY_EVENT_H_
+#define _INCLUDE__TRACE__BINARY_EVENT_H_
+
+#include <base/fixed_stdint.h>
+
+namespace Genode { namespace Trace { struct Binary_event; } }
+
+
+struct Genode::Trace::Binary_event
+{
+	enum Type { RPC_CALL        = 1, RPC_RETURNED = 2, RPC_DISPATCH = 3,
+	            RPC_REPLY       = 4, SIGNAL_SUBMIT = 5,
+	            SIGNAL_RECEIVED = 6 };
+
+	enum { MAX_NAME_LEN = 48 };
+
+	uint64_t timestamp;  /* CPU-local time stamp */
+	uint16_t type;
+	uint16_t arg;        /* number of signals, 0 for RPC events */
+
+	/* RPC name up to the end of the record, not null-terminated */
+	char     name[0];
+
+} __attribute__((packed));
+
+#endif /* _INCLUDE__TRACE__BINARY_EVENT_H_ */
@@ -85,16 +85,23 @@ class Genode::Dirty_rect
 			 * areas. This happens if both rectangles overlap. In this case, it
 			 * is cheaper to process the compound (including some portions that
 			 * aren't actually dirty) instead of processing the overlap twice.
+			 *
+			 * A merged rectangle may overlap with rectangles that were
+			 * checked before. Hence, we repeat until no merge happens.
 			 */
-			for (unsigned i = 0; i < NUM_RECTS - 1; i++) {
-				for (unsigned j = i + 1; j < NUM_RECTS; j++) {
-
-					Rect &r1 = _rects[i];
-					Rect &r2 = _rects[j];
-
-					if (r1.valid() && r2.valid() && _should_be_merged(r1, r2)) {
-						r1 = Rect::compound(r1, r2);
-						r2 = Rect();
+			for (bool merged = true; merged; ) {
+				merged = false;
+				for (unsigned i = 0; i < NUM_RECTS - 1; i++) {
+					for (unsigned j = i + 1; j < NUM_RECTS; j++) {
+
+						Rect &r1 = _rects[i];
+						Rect &r2 = _rects[j];
+
+						if (r1.valid() && r2.valid() && _should_be_merged(r1, r2)) {
+							r1 = Rect::compound(r1, r2);
+							r2 = Rect();
+							merged = true;
+						}
 					}
 				}
 			}
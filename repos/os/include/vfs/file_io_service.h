@@ -104,6 +104,69 @@ struct Vfs::File_io_service : Interface
 	virtual bool notify_read_ready(Vfs_handle *) { return true; }
 
 
+	/******************
+	 ** Vectored I/O **
+	 ******************/
+
+	/**
+	 * File range accessed by a vectored operation
+	 */
+	struct Io_extent
+	{
+		file_size  seek;   /* absolute file offset */
+		char      *buf;    /* source or destination buffer */
+		file_size  count;
+	};
+
+	/**
+	 * Return true if the handle supports vectored I/O
+	 *
+	 * Callers fall back to consecutive 'write' or 'queue_read' and
+	 * 'complete_read' calls if vectored I/O is not supported.
+	 */
+	virtual bool vectored_io(Vfs_handle *) { return false; }
+
+	/**
+	 * Write extents
+	 *
+	 * As with 'write', the operation may transfer fewer bytes than
+	 * requested. Extents are written in order, a short count refers to the
+	 * leading bytes of the extents.
+	 */
+	virtual Write_result writev(Vfs_handle *, Io_extent const *, unsigned,
+	                            file_size &out_count)
+	{
+		out_count = 0;
+		return WRITE_ERR_INVALID;
+	}
+
+	/**
+	 * Queue vectored read operation
+	 *
+	 * \return false if queue is full
+	 *
+	 * The extents must stay valid until 'complete_readv' is called with the
+	 * same arguments.
+	 */
+	virtual bool queue_readv(Vfs_handle *, Io_extent const *, unsigned)
+	{
+		return true;
+	}
+
+	/**
+	 * Complete vectored read operation
+	 *
+	 * The reading stops at the first extent that could not be filled
+	 * completely, e.g., at the end of the file.
+	 */
+	virtual Read_result complete_readv(Vfs_handle *, Io_extent const *, unsigned,
+	                                   file_size &out_count)
+	{
+		out_count = 0;
+		return READ_ERR_INVALID;
+	}
+
+
 	/***************
 	 ** Ftruncate **
 	 ***************/
@@ -1,5 +1,7 @@
-SRC_CC  = blit.cc
+SRC_CC  = blit.cc pixel.cc
 REQUIRES = arm 32bit
-INC_DIR += $(REP_DIR)/src/lib/blit/spec/arm
+INC_DIR += $(REP_DIR)/src/lib/blit/spec/arm \
+           $(REP_DIR)/src/lib/blit
 
-vpath blit.cc $(REP_DIR)/src/lib/blit
+vpath blit.cc  $(REP_DIR)/src/lib/blit
+vpath pixel.cc $(REP_DIR)/src/lib/blit
@@ -1,6 +1,8 @@
-SRC_CC  = blit.cc
+SRC_CC  = blit.cc pixel.cc
 REQUIRES = x86 32bit
 INC_DIR += $(REP_DIR)/src/lib/blit/spec/x86_32 \
-           $(REP_DIR)/src/lib/blit/spec/x86
+           $(REP_DIR)/src/lib/blit/spec/x86 \
+           $(REP_DIR)/src/lib/blit
 
-vpath blit.cc $(REP_DIR)/src/lib/blit
+vpath blit.cc  $(REP_DIR)/src/lib/blit
+vpath pixel.cc $(REP_DIR)/src/lib/blit
@@ -1,6 +1,12 @@
-SRC_CC  = blit.cc
+SRC_CC  = blit.cc pixel.cc pixel_avx2.cc
 REQUIRES = x86 64bit
 INC_DIR += $(REP_DIR)/src/lib/blit/spec/x86_64 \
-           $(REP_DIR)/src/lib/blit/spec/x86
+           $(REP_DIR)/src/lib/blit/spec/x86 \
+           $(REP_DIR)/src/lib/blit
 
-vpath blit.cc $(REP_DIR)/src/lib/blit
+# the AVX2 kernels are called only if the CPU supports AVX2
+CC_OPT_pixel_avx2 = -mavx2
+
+vpath blit.cc       $(REP_DIR)/src/lib/blit
+vpath pixel.cc      $(REP_DIR)/src/lib/blit
+vpath pixel_avx2.cc $(REP_DIR)/src/lib/blit/spec/x86_64
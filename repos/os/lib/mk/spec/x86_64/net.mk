@@ -0,0 +1,3 @@
+INC_DIR += $(REP_DIR)/src/lib/net/spec/x86_64
+
+include $(REP_DIR)/lib/mk/net.mk
@@ -1,7 +1,7 @@
 SRC_DIR = src/server/nic_bridge
 include $(GENODE_DIR)/repos/base/recipes/src/content.inc
 
-MIRROR_FROM_REP_DIR := lib/mk/net.mk include/net src/lib/net
+MIRROR_FROM_REP_DIR := lib/mk/net.mk lib/mk/spec/x86_64/net.mk include/net src/lib/net
 
 content: $(MIRROR_FROM_REP_DIR)
 
@@ -0,0 +1,214 @@
+/*
+ * \brief  Export of trace-buffer entries as binary stream to a file
+ * \author Genode Labs
+ * \date   2018-12-10
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _BINARY_STREAM_H_
+#define _BINARY_STREAM_H_
+
+/* Genode includes */
+#include <base/allocator_avl.h>
+#include <base/trace/buffer.h>
+#include <base/trace/types.h>
+#include <file_system_session/connection.h>
+#include <file_system/util.h>
+#include <os/path.h>
+
+
+/**
+ * Stream of records written to a file via a File_system session
+ *
+ * The stream starts with the 'Header'. It is followed by records, each
+ * starting with a 'Record' header. Subject records carry the null-
+ * terminated session label and thread name of the subject. Entry records
+ * carry the data of one trace-buffer entry. All values are stored in the
+ * native byte order of the machine, as indicated by the byte-order mark.
+ *
+ * Records are collected in packets of the File_system session, so the
+ * entries are copied from the trace buffers directly to the packet stream.
+ */
+class Binary_stream
+{
+	public:
+
+		typedef Genode::Path<File_system::MAX_PATH_LEN> Path;
+
+		struct Header
+		{
+			enum { MAGIC = 0x53525447, VERSION = 1, BYTE_ORDER = 0x0102 };
+
+			Genode::uint32_t magic;       /* "GTRS" in little endian */
+			Genode::uint16_t version;
+			Genode::uint16_t byte_order;
+		} __attribute__((packed));
+
+		struct Record
+		{
+			enum Type { SUBJECT = 1, ENTRY = 2 };
+
+			Genode::uint16_t type;
+			Genode::uint16_t reserved;
+			Genode::uint32_t subject;   /* subject ID */
+			Genode::uint32_t sequence;  /* sequence number of entry */
+			Genode::uint32_t lost;      /* entries lost before the entry */
+			Genode::uint32_t length;    /* length of data following the record */
+		} __attribute__((packed));
+
+	private:
+
+		enum { PACKET_SIZE = 64*1024, TX_BUF_SIZE = 2*PACKET_SIZE + 4096 };
+
+		Genode::Allocator_avl       _tx_alloc;
+		File_system::Connection     _fs;
+		File_system::File_handle    _file;
+		File_system::seek_off_t     _seek   { 0 };
+		File_system::Session::Tx::Source &_source { *_fs.tx() };
+
+		Genode::Constructible<File_system::Packet_descriptor> _packet { };
+
+		Genode::size_t _used { 0 };
+
+		static File_system::File_handle _open(File_system::Session &fs,
+		                                      Path const &path)
+		{
+			using namespace File_system;
+
+			Path dir_path(path);
+			dir_path.strip_last_element();
+
+			Path file_name(path);
+			file_name.keep_only_last_element();
+
+			Dir_handle   dir = ensure_dir(fs, dir_path.base());
+			Handle_guard dir_guard(fs, dir);
+
+			/* the name obtained via 'keep_only_last_element' starts with '/' */
+			try { return fs.file(dir, file_name.base() + 1, WRITE_ONLY, true); }
+			catch (Node_already_exists) { }
+
+			File_handle file = fs.file(dir, file_name.base() + 1, WRITE_ONLY, false);
+			fs.truncate(file, 0);
+			return file;
+		}
+
+		/**
+		 * Return pointer to 'len' bytes of the current packet
+		 */
+		char *_reserve(Genode::size_t len)
+		{
+			if (_packet.constructed() && _used + len > _packet->size())
+				flush();
+
+			if (!_packet.constructed()) {
+				_packet.construct(_source.alloc_packet(PACKET_SIZE), _file,
+				                  File_system::Packet_descriptor::WRITE,
+				                  PACKET_SIZE, _seek);
+				_used = 0;
+			}
+
+			char * const dst = _source.packet_content(*_packet) + _used;
+			_used += len;
+			return dst;
+		}
+
+		void _append(Record const &record, char const *data, Genode::size_t len)
+		{
+			if (sizeof(record) + len > PACKET_SIZE) {
+				Genode::warning("dropping trace record of ", len, " bytes");
+				return;
+			}
+
+			char * const dst = _reserve(sizeof(record) + len);
+
+			Genode::memcpy(dst, &record, sizeof(record));
+			Genode::memcpy(dst + sizeof(record), data, len);
+		}
+
+		/*
+		 * Noncopyable
+		 */
+		Binary_stream(Binary_stream const &);
+		Binary_stream &operator = (Binary_stream const &);
+
+	public:
+
+		Binary_stream(Genode::Env &env, Genode::Allocator &alloc, Path const &path)
+		:
+			_tx_alloc(&alloc),
+			_fs(env, _tx_alloc, "", "/", true, TX_BUF_SIZE),
+			_file(_open(_fs, path))
+		{
+			Header const header { Header::MAGIC, Header::VERSION, Header::BYTE_ORDER };
+			Genode::memcpy(_reserve(sizeof(header)), &header, sizeof(header));
+		}
+
+		~Binary_stream()
+		{
+			flush();
+			_fs.close(_file);
+		}
+
+		/**
+		 * Append record that describes a trace subject
+		 */
+		template <typename LABEL, typename THREAD>
+		void subject(Genode::Trace::Subject_id id, LABEL const &label,
+		             THREAD const &thread)
+		{
+			Genode::size_t const label_len  = Genode::strlen(label.string())  + 1;
+			Genode::size_t const thread_len = Genode::strlen(thread.string()) + 1;
+
+			Record const record { Record::SUBJECT, 0, id.id, 0, 0,
+			                      (Genode::uint32_t)(label_len + thread_len) };
+
+			char * const dst = _reserve(sizeof(record) + label_len + thread_len);
+			Genode::memcpy(dst, &record, sizeof(record));
+			Genode::memcpy(dst + sizeof(record), label.string(), label_len);
+			Genode::memcpy(dst + sizeof(record) + label_len, thread.string(), thread_len);
+		}
+
+		/**
+		 * Append record of a trace-buffer entry
+		 */
+		void entry(Genode::Trace::Subject_id id,
+		           Genode::Trace::Buffer::Entry const &entry, unsigned lost)
+		{
+			Record const record { Record::ENTRY, 0, id.id, entry.sequence(),
+			                      lost, (Genode::uint32_t)entry.length() };
+
+			_append(record, entry.data(), entry.length());
+		}
+
+		/**
+		 * Write pending records to the file
+		 */
+		void flush()
+		{
+			if (!_packet.constructed())
+				return;
+
+			File_system::Packet_descriptor const packet(*_packet, _file,
+			                                            File_system::Packet_descriptor::WRITE,
+			                                            _used, _seek);
+			_packet.destruct();
+
+			_source.submit_packet(packet);
+
+			File_system::Packet_descriptor const ack = _source.get_acked_packet();
+			if (!ack.succeeded())
+				Genode::warning("failed to write trace records");
+
+			_seek += ack.length();
+			_source.release_packet(ack);
+		}
+};
+
+#endif /* _BINARY_STREAM_H_ */
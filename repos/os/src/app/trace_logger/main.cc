@@ -23,6 +23,7 @@
 #include <os/session_policy.h>
 #include <timer_session/connection.h>
 #include <util/construct_at.h>
+#include <util/reconstructible.h>
 
 using namespace Genode;
 using Thread_name = String<40>;
@@ -38,6 +39,7 @@ class Main
 		enum { DEFAULT_SESSION_ARG_BUFFER    = 1024 * 4 };
 		enum { DEFAULT_SESSION_RAM           = 1024 * 1024 };
 		enum { DEFAULT_SESSION_PARENT_LEVELS = 0 };
+		enum { EXPORT_BATCH                  = 64 };
 
 		Env                           &_env;
 		Timer::Connection              _timer               { _env };
@@ -64,6 +66,24 @@ class Main
 		unsigned long                  _num_subjects        { 0 };
 		unsigned long                  _num_monitors        { 0 };
 		Trace::Subject_id              _subjects[MAX_SUBJECTS];
+		Constructible<Binary_stream>   _binary_stream       { };
+
+		/**
+		 * Export new buffer entries of all monitors to the binary stream
+		 *
+		 * The monitors are drained in batches so that no single subject can
+		 * make the others fall behind and lose entries.
+		 */
+		void _export_binary(Monitor_tree &monitors)
+		{
+			for (bool pending = true; pending; ) {
+				pending = false;
+				monitors.for_each([&] (Monitor &monitor) {
+					if (monitor.export_entries(*_binary_stream, EXPORT_BATCH) == EXPORT_BATCH)
+						pending = true; });
+			}
+			_binary_stream->flush();
+		}
 
 		void _handle_period(Duration)
 		{
@@ -124,6 +144,11 @@ class Main
 			while (Monitor *monitor = old_monitors.first())
 				_destroy_monitor(old_monitors, *monitor);
 
+			if (_binary_stream.constructed()) {
+				_export_binary(new_monitors);
+				return;
+			}
+
 			/* dump information of each monitor in the new tree */
 			log("");
 			log("--- Report ", _report_id++, " (", _num_monitors, "/", _num_subjects, " subjects) ---");
@@ -189,7 +214,16 @@ class Main
 
 	public:
 
-		Main(Env &env) : _env(env) { _policies.insert(_default_policy); }
+		Main(Env &env) : _env(env)
+		{
+			_policies.insert(_default_policy);
+
+			typedef String<File_system::MAX_PATH_LEN> File_name;
+
+			if (_config.has_attribute("binary_file"))
+				_binary_stream.construct(_env, _heap,
+					_config.attribute_value("binary_file", File_name()).string());
+		}
 };
 
 
@@ -113,7 +113,7 @@ void Monitor::print(bool activity, bool affinity)
 
 	/* print all buffer entries that we haven't yet printed */
 	bool printed_buf_entries = false;
-	_buffer.for_each_new_entry([&] (Trace::Buffer::Entry entry) {
+	_buffer.for_each_new_entry([&] (Trace::Buffer::Entry entry, unsigned lost) {
 
 		/* get readable data length and skip empty entries */
 		size_t length = min(entry.length(), (unsigned)MAX_ENTRY_LENGTH - 1);
@@ -129,6 +129,10 @@ void Monitor::print(bool activity, bool affinity)
 			log("   <buffer>");
 			printed_buf_entries = true;
 		}
+		/* mark entries overwritten before we got hold of them */
+		if (lost)
+			log("   <lost count=\"", lost, "\"/>");
+
 		log(Cstring(_curr_entry_data));
 	});
 	/* print end tags */
@@ -140,6 +144,19 @@ void Monitor::print(bool activity, bool affinity)
 }
 
 
+unsigned Monitor::export_entries(Binary_stream &stream, unsigned max_entries)
+{
+	if (!_exported_subject) {
+		_update_info();
+		stream.subject(_subject_id, _info.session_label(), _info.thread_name());
+		_exported_subject = true;
+	}
+
+	return _buffer.for_each_new_entry([&] (Trace::Buffer::Entry entry, unsigned lost) {
+		stream.entry(_subject_id, entry, lost); }, max_entries);
+}
+
+
 /******************
  ** Monitor_tree **
  ******************/
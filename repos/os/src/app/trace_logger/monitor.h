@@ -16,7 +16,7 @@
 
 /* local includes */
 #include <avl_tree.h>
-#include <trace_buffer.h>
+#include <binary_stream.h>
 
 /* Genode includes */
 #include <base/trace/types.h>
@@ -54,7 +54,8 @@ class Monitor : public Monitor_base,
 		enum { MAX_ENTRY_LENGTH = 256 };
 
 		Genode::Trace::Subject_id const  _subject_id;
-		Trace_buffer                     _buffer;
+		Genode::Trace::Buffer_reader     _buffer;
+		bool                             _exported_subject { false };
 		unsigned long                    _report_id        { 0 };
 		Genode::Trace::Subject_info      _info             { };
 		unsigned long long               _recent_exec_time { 0 };
@@ -70,6 +71,15 @@ class Monitor : public Monitor_base,
 
 		void print(bool activity, bool affinity);
 
+		/**
+		 * Append new buffer entries to binary stream
+		 *
+		 * \param max_entries  maximum number of entries to export
+		 *
+		 * \return number of exported entries
+		 */
+		unsigned export_entries(Binary_stream &stream, unsigned max_entries);
+
 
 		/**************
 		 ** Avl_node **
@@ -63,6 +63,7 @@ namespace Nvme {
 	struct Sqe_create_sq;
 	struct Sqe_identify;
 	struct Sqe_io;
+	struct Sqe_set_features;
 
 	struct Queue;
 	struct Sq;
@@ -73,10 +74,8 @@ namespace Nvme {
 	enum {
 		CQE_LEN                = 16,
 		SQE_LEN                = 64,
-		MAX_IO_QUEUES          = 1,
-		MAX_IO_ENTRIES         = 128,
-		MAX_IO_ENTRIES_MASK    = MAX_IO_ENTRIES - 1,
-		MAX_IO_PENDING         = MAX_IO_ENTRIES - 1, /* tail + 1 == head -> full */
+		MAX_IO_QUEUES          = 4,
+		MAX_IO_ENTRIES         = 1024,
 		MAX_ADMIN_ENTRIES      = 128,
 		MAX_ADMIN_ENTRIES_MASK = MAX_ADMIN_ENTRIES - 1,
 	};
@@ -87,7 +86,7 @@ namespace Nvme {
 		 * page (4K/8 = 512 * 4K) but 1MiB is plenty
 		 */
 		MAX_IO_LEN       =   1u << 20,
-		DMA_DS_SIZE      =   4u << 20,
+		DMA_DS_SIZE      =   8u << 20,
 		DMA_LIST_DS_SIZE = 256u << 10,
 		MPS              = 4096u,
 	};
@@ -95,7 +94,12 @@ namespace Nvme {
 	enum {
 		IO_NSID    = 1u,
 		MAX_NS     = 1u,
-		NUM_QUEUES = 1 + MAX_NS,
+		NUM_QUEUES = 1 + MAX_IO_QUEUES,
+	};
+
+	enum Feature {
+		NUMBER_OF_QUEUES   = 0x07,
+		INTR_COALESCING    = 0x08,
 	};
 
 	enum Opcode {
@@ -199,15 +203,14 @@ struct Nvme::Identify_ns_data : public Genode::Mmio
  */
 struct Nvme::Doorbell : public Genode::Mmio
 {
-	struct Sqtdbl : Register<0x00, 32>
-	{
-		struct Sqt : Bitfield< 0, 16> { }; /* submission queue tail */
-	};
+	/*
+	 * The doorbell of queue 'y' is located at 0x1000 + (2y * (4 << Dstrd))
+	 * for the submission and at 0x1000 + ((2y + 1) * (4 << Dstrd)) for the
+	 * completion queue.
+	 */
+	enum { BASE = 0x1000 };
 
-	struct Cqhdbl : Register<0x04, 32>
-	{
-		struct Cqh : Bitfield< 0, 16> { }; /* submission queue tail */
-	};
+	struct Dbl : Register<0x00, 32> { }; /* submission tail or completion head */
 
 	Doorbell(addr_t const base)
 	: Genode::Mmio(base) { }
@@ -219,7 +222,12 @@ struct Nvme::Doorbell : public Genode::Mmio
  */
 struct Nvme::Cqe : Genode::Mmio
 {
-	struct Dw0  : Register<0x00, 32> { }; /* command specific */
+	struct Dw0  : Register<0x00, 32>      /* command specific */
+	{
+		/* number of queues feature */
+		struct Nsqa : Bitfield< 0, 16> { }; /* I/O submission queues allocated 0-based */
+		struct Ncqa : Bitfield<16, 16> { }; /* I/O completion queues allocated 0-based */
+	};
 	struct Dw1  : Register<0x04, 32> { }; /* reserved */
 
 	struct Sqhd : Register<0x08, 16> { };
@@ -345,6 +353,31 @@ struct Nvme::Sqe_create_sq : Nvme::Sqe
 };
 
 
+/*
+ * Set features command
+ */
+struct Nvme::Sqe_set_features : Nvme::Sqe
+{
+	struct Cdw10 : Register<0x28, 32>
+	{
+		struct Fid : Bitfield< 0,  8> { }; /* feature identifier */
+	};
+
+	struct Cdw11 : Register<0x2c, 32>
+	{
+		/* number of queues feature */
+		struct Nsqr : Bitfield< 0, 16> { }; /* I/O submission queues requested 0-based */
+		struct Ncqr : Bitfield<16, 16> { }; /* I/O completion queues requested 0-based */
+
+		/* interrupt coalescing feature */
+		struct Thr  : Bitfield< 0,  8> { }; /* aggregation threshold 0-based */
+		struct Time : Bitfield< 8,  8> { }; /* aggregation time in 100us units */
+	};
+
+	Sqe_set_features(addr_t const base) : Sqe(base) { }
+};
+
+
 /*
  * I/O command
  */
@@ -382,8 +415,9 @@ struct Nvme::Queue
  */
 struct Nvme::Sq : Nvme::Queue
 {
-	uint32_t tail { 0 };
-	uint16_t id   { 0 };
+	uint32_t tail      { 0 };
+	uint32_t committed { 0 }; /* tail last written to the doorbell */
+	uint32_t pending   { 0 }; /* entries not yet completed */
 
 	addr_t next()
 	{
@@ -577,38 +611,6 @@ struct Nvme::Controller : public Genode::Attached_mmio
 		struct Bmbba : Bitfield<12, 52> { }; /* boot partition memory buffer base address */
 	};
 
-	/*
-	 * Admin submission doorbell
-	 */
-	struct Admin_sdb : Register<0x1000, 32>
-	{
-		struct Sqt : Bitfield< 0, 16> { }; /* submission queue tail */
-	};
-
-	/*
-	 * Admin completion doorbell
-	 */
-	struct Admin_cdb : Register<0x1004, 32>
-	{
-		struct Cqh : Bitfield< 0, 16> { }; /* completion queue tail */
-	};
-
-	/*
-	 * I/O submission doorbell
-	 */
-	struct Io_sdb : Register<0x1008, 32>
-	{
-		struct Sqt : Bitfield< 0, 16> { }; /* submission queue tail */
-	};
-
-	/*
-	 * I/O completion doorbell
-	 */
-	struct Io_cdb : Register<0x100C, 32>
-	{
-		struct Cqh : Bitfield< 0, 16> { }; /* completion queue tail */
-	};
-
 	/**********
 	 ** CODE **
 	 **********/
@@ -628,6 +630,12 @@ struct Nvme::Controller : public Genode::Attached_mmio
 
 	size_t _mps { 0 };
 
+	/* distance between two doorbell registers */
+	size_t _dstrd { 4 };
+
+	uint16_t _io_queues  { 0 };
+	uint32_t _io_entries { 0 };
+
 	Nvme::Cq _cq[NUM_QUEUES] { };
 	Nvme::Sq _sq[NUM_QUEUES] { };
 
@@ -655,8 +663,11 @@ struct Nvme::Controller : public Genode::Attached_mmio
 		QUERYNS_CID,
 		CREATE_IO_CQ_CID,
 		CREATE_IO_SQ_CID,
+		SET_FEATURES_CID,
 	};
 
+	uint32_t _admin_result { 0 };
+
 	Mem_address _nvme_query_ns[MAX_NS] { };
 
 	struct Info
@@ -724,6 +735,32 @@ struct Nvme::Controller : public Genode::Attached_mmio
 
 		write<Cc::Iocqes>(log2((unsigned)CQE_LEN));
 		write<Cc::Iosqes>(log2((unsigned)SQE_LEN));
+
+		_dstrd = 4u << read<Cap::Dstrd>();
+	}
+
+	/**
+	 * Write submission queue tail to the doorbell of the queue
+	 *
+	 * \param qid  queue identifier
+	 */
+	void _ring_sq(uint16_t qid)
+	{
+		Nvme::Sq &sq = _sq[qid];
+		Doorbell(base() + Doorbell::BASE + (2*qid) * _dstrd)
+			.write<Doorbell::Dbl>(sq.tail);
+		sq.committed = sq.tail;
+	}
+
+	/**
+	 * Write completion queue head to the doorbell of the queue
+	 *
+	 * \param qid  queue identifier
+	 */
+	void _ring_cq(uint16_t qid)
+	{
+		Doorbell(base() + Doorbell::BASE + (2*qid + 1) * _dstrd)
+			.write<Doorbell::Dbl>(_cq[qid].head);
 	}
 
 	/**
@@ -752,7 +789,7 @@ struct Nvme::Controller : public Genode::Attached_mmio
 	 */
 	bool _queue_full(Nvme::Sq const &sq, Nvme::Cq const &cq) const
 	{
-		return ((sq.tail + 1) & (MAX_IO_ENTRIES_MASK)) == cq.head;
+		return ((sq.tail + 1) % sq.max_entries) == cq.head;
 	}
 
 	/**
@@ -812,11 +849,12 @@ struct Nvme::Controller : public Genode::Attached_mmio
 				continue;
 			}
 
-			_admin_cq.advance_head();
-
-			success = true;
+			_admin_result = b.read<Nvme::Cqe::Dw0>();
+			success       = true;
 
-			write<Admin_cdb::Cqh>(_admin_cq.head);
+			_admin_cq.advance_head();
+			_ring_cq(0);
+			break;
 		}
 
 		return success;
@@ -847,7 +885,7 @@ struct Nvme::Controller : public Genode::Attached_mmio
 		b.write<Nvme::Sqe::Prp1>(_nvme_nslist.pa);
 		b.write<Nvme::Sqe_identify::Cdw10::Cns>(Cns::NSLIST);
 
-		write<Admin_sdb::Sqt>(_admin_sq.tail);
+		_ring_sq(0);
 
 		if (!_wait_for_admin_cq(10, NSLIST_CID)) {
 			Genode::error("identify name space list failed");
@@ -888,7 +926,7 @@ struct Nvme::Controller : public Genode::Attached_mmio
 		b.write<Nvme::Sqe::Prp1>(_nvme_query_ns[id].pa);
 		b.write<Nvme::Sqe_identify::Cdw10::Cns>(Cns::IDENTIFY_NS);
 
-		write<Admin_sdb::Sqt>(_admin_sq.tail);
+		_ring_sq(0);
 
 		if (!_wait_for_admin_cq(10, QUERYNS_CID)) {
 			Genode::error("identify name space failed");
@@ -917,7 +955,7 @@ struct Nvme::Controller : public Genode::Attached_mmio
 		b.write<Nvme::Sqe::Prp1>(_nvme_identify.pa);
 		b.write<Nvme::Sqe_identify::Cdw10::Cns>(Cns::IDENTIFY);
 
-		write<Admin_sdb::Sqt>(_admin_sq.tail);
+		_ring_sq(0);
 
 		if (!_wait_for_admin_cq(10, IDENTIFY_CID)) {
 			Genode::error("identify failed");
@@ -945,16 +983,16 @@ struct Nvme::Controller : public Genode::Attached_mmio
 	void _setup_io_cq(uint16_t id)
 	{
 		Nvme::Cq &cq = _cq[id];
-		if (!cq.valid()) { _setup_queue(cq, MAX_IO_ENTRIES, CQE_LEN); }
+		if (!cq.valid()) { _setup_queue(cq, _io_entries, CQE_LEN); }
 
 		Sqe_create_cq b(_admin_command(Opcode::CREATE_IO_CQ, 0, CREATE_IO_CQ_CID));
 		b.write<Nvme::Sqe::Prp1>(cq.pa);
 		b.write<Nvme::Sqe_create_cq::Cdw10::Qid>(id);
-		b.write<Nvme::Sqe_create_cq::Cdw10::Qsize>(MAX_IO_ENTRIES_MASK);
+		b.write<Nvme::Sqe_create_cq::Cdw10::Qsize>(_io_entries - 1);
 		b.write<Nvme::Sqe_create_cq::Cdw11::Pc>(1);
 		b.write<Nvme::Sqe_create_cq::Cdw11::En>(1);
 
-		write<Admin_sdb::Sqt>(_admin_sq.tail);
+		_ring_sq(0);
 
 		if (!_wait_for_admin_cq(10, CREATE_IO_CQ_CID)) {
 			Genode::error("create I/O cq failed");
@@ -973,17 +1011,17 @@ struct Nvme::Controller : public Genode::Attached_mmio
 	void _setup_io_sq(uint16_t id, uint16_t cqid)
 	{
 		Nvme::Sq &sq = _sq[id];
-		if (!sq.valid()) { _setup_queue(sq, MAX_IO_ENTRIES, SQE_LEN); }
+		if (!sq.valid()) { _setup_queue(sq, _io_entries, SQE_LEN); }
 
 		Sqe_create_sq b(_admin_command(Opcode::CREATE_IO_SQ, 0, CREATE_IO_SQ_CID));
 		b.write<Nvme::Sqe::Prp1>(sq.pa);
 		b.write<Nvme::Sqe_create_sq::Cdw10::Qid>(id);
-		b.write<Nvme::Sqe_create_sq::Cdw10::Qsize>(MAX_IO_ENTRIES_MASK);
+		b.write<Nvme::Sqe_create_sq::Cdw10::Qsize>(_io_entries - 1);
 		b.write<Nvme::Sqe_create_sq::Cdw11::Pc>(1);
 		b.write<Nvme::Sqe_create_sq::Cdw11::Qprio>(0b00); /* urgent for now */
 		b.write<Nvme::Sqe_create_sq::Cdw11::Cqid>(cqid);
 
-		write<Admin_sdb::Sqt>(_admin_sq.tail);
+		_ring_sq(0);
 
 		if (!_wait_for_admin_cq(10, CREATE_IO_SQ_CID)) {
 			Genode::error("create I/O sq failed");
@@ -991,6 +1029,50 @@ struct Nvme::Controller : public Genode::Attached_mmio
 		}
 	}
 
+	/**
+	 * Set feature
+	 *
+	 * \param fid    feature identifier
+	 * \param cdw11  feature specific value
+	 *
+	 * \return  returns true if the feature was set, otherwise false
+	 */
+	bool _set_feature(Feature fid, uint32_t cdw11)
+	{
+		Sqe_set_features b(_admin_command(Opcode::SET_FEATURES, 0, SET_FEATURES_CID));
+		if (!b.valid()) { return false; }
+
+		b.write<Nvme::Sqe_set_features::Cdw10::Fid>(fid);
+		b.write<Nvme::Sqe_set_features::Cdw11>(cdw11);
+
+		_ring_sq(0);
+
+		return _wait_for_admin_cq(10, SET_FEATURES_CID);
+	}
+
+	/**
+	 * Request number of I/O queues
+	 *
+	 * \param num  number of I/O queue pairs requested
+	 *
+	 * \return  number of I/O queue pairs allocated by the controller
+	 */
+	uint16_t _request_io_queues(uint16_t num)
+	{
+		Sqe_set_features::Cdw11::access_t v = 0;
+		Sqe_set_features::Cdw11::Nsqr::set(v, num - 1);
+		Sqe_set_features::Cdw11::Ncqr::set(v, num - 1);
+
+		if (!_set_feature(Feature::NUMBER_OF_QUEUES, v)) {
+			Genode::warning("could not request ", num, " I/O queues");
+			return 1;
+		}
+
+		uint32_t const nsqa = Cqe::Dw0::Nsqa::get(_admin_result) + 1;
+		uint32_t const ncqa = Cqe::Dw0::Ncqa::get(_admin_result) + 1;
+		return (uint16_t)min((uint32_t)num, min(nsqa, ncqa));
+	}
+
 	/**
 	 * Constructor
 	 */
@@ -1044,37 +1126,96 @@ struct Nvme::Controller : public Genode::Attached_mmio
 	}
 
 	/**
-	 * Setup I/O queue
+	 * Setup I/O queues
+	 *
+	 * \param queues   number of I/O queue pairs
+	 * \param entries  number of entries per queue
+	 *
+	 * Each submission queue is paired with its own completion queue. The
+	 * controller may allocate less queues or support less entries than
+	 * requested, in which case the lower values are used.
 	 */
-	void setup_io(uint16_t cid, uint16_t sid)
+	void setup_io(uint16_t queues, uint32_t entries)
 	{
-		_setup_io_cq(cid);
-		_setup_io_sq(sid, cid);
+		uint32_t const mqes = read<Cap::Mqes>() + 1;
+
+		queues  = max((uint16_t)1, min(queues, (uint16_t)MAX_IO_QUEUES));
+		entries = max(2u, min(entries, min(mqes, (uint32_t)MAX_IO_ENTRIES)));
+
+		_io_entries = entries;
+		_io_queues  = _request_io_queues(queues);
+
+		for (uint16_t qid = 1; qid <= _io_queues; qid++) {
+			_setup_io_cq(qid);
+			_setup_io_sq(qid, qid);
+		}
 	}
 
 	/**
-	 * Get next free IO submission queue slot
+	 * Set interrupt coalescing
+	 *
+	 * \param threshold  number of completions to aggregate, 0 disables
+	 *                   the coalescing
+	 * \param time_us    maximum time in microseconds an interrupt is
+	 *                   delayed
 	 */
-	addr_t io_command(uint16_t id)
+	void intr_coalescing(unsigned threshold, unsigned time_us)
 	{
-		Nvme::Sq &sq = _sq[id];
-		Nvme::Cq &cq = _cq[id];
+		Sqe_set_features::Cdw11::access_t v = 0;
+		if (threshold) {
+			Sqe_set_features::Cdw11::Thr::set(v, min(threshold, 256u) - 1);
+			Sqe_set_features::Cdw11::Time::set(v, min(time_us / 100, 255u));
+		}
+
+		if (!_set_feature(Feature::INTR_COALESCING, v)) {
+			Genode::warning("could not set interrupt coalescing");
+		}
+	}
 
-		if (_queue_full(sq, cq)) { return 0ul; }
+	/**
+	 * Get I/O queue with the least pending entries
+	 *
+	 * \return  queue identifier or 0 if all I/O queues are full
+	 */
+	uint16_t io_queue() const
+	{
+		uint16_t qid     = 0;
+		uint32_t pending = _io_entries - 1; /* tail + 1 == head -> full */
+
+		for (uint16_t i = 1; i <= _io_queues; i++) {
+			if (_sq[i].pending >= pending) { continue; }
+			pending = _sq[i].pending;
+			qid     = i;
+		}
+		return qid;
+	}
+
+	/**
+	 * Get next free I/O submission queue entry
+	 *
+	 * \param qid  queue identifier as returned by 'io_queue()'
+	 * \param cid  command identifier
+	 */
+	addr_t io_command(uint16_t qid, uint16_t cid)
+	{
+		Nvme::Sq &sq = _sq[qid];
+
+		++sq.pending;
 
 		Sqe e(sq.next());
-		e.write<Nvme::Sqe::Cdw0::Cid>(sq.id++);
-		e.write<Nvme::Sqe::Nsid>(id);
+		e.write<Nvme::Sqe::Cdw0::Cid>(cid);
+		e.write<Nvme::Sqe::Nsid>(IO_NSID);
 		return e.base();
 	}
 
 	/**
-	 * Write current I/O submission queue tail
+	 * Write tail of all I/O submission queues with new entries
 	 */
-	void commit_io(uint16_t id)
+	void commit_io()
 	{
-		Nvme::Sq &sq = _sq[id];
-		write<Io_sdb::Sqt>(sq.tail);
+		for (uint16_t qid = 1; qid <= _io_queues; qid++) {
+			if (_sq[qid].tail != _sq[qid].committed) { _ring_sq(qid); }
+		}
 	}
 
 	/**
@@ -1091,30 +1232,44 @@ struct Nvme::Controller : public Genode::Attached_mmio
 	 * \param func  function that is called on each completion
 	 */
 	template <typename FUNC>
-	void handle_io_completions(uint16_t id, FUNC const &func)
+	void handle_io_completions(FUNC const &func)
 	{
-		Nvme::Cq &cq = _cq[id];
+		for (uint16_t qid = 1; qid <= _io_queues; qid++) {
 
-		if (!cq.valid()) { return; }
+			Nvme::Cq &cq = _cq[qid];
+			Nvme::Sq &sq = _sq[qid];
 
-		for (;;) {
-			Cqe e(cq.next());
+			if (!cq.valid()) { continue; }
 
-			/* process until old phase */
-			if (e.read<Nvme::Cqe::Sf::P>() != cq.phase) { break; }
+			bool completed = false;
+			for (;;) {
+				Cqe e(cq.next());
 
-			func(e);
+				/* process until old phase */
+				if (e.read<Nvme::Cqe::Sf::P>() != cq.phase) { break; }
 
-			cq.advance_head();
+				cq.advance_head();
+				--sq.pending;
+				completed = true;
 
-			/*
-			 * Instead of acknowledging the completions here,
-			 * we could handle them batch-wise after the loop.
-			 */
-			write<Io_cdb::Cqh>(cq.head);
+				func(e);
+			}
+
+			/* acknowledge all processed entries at once */
+			if (completed) { _ring_cq(qid); }
 		}
 	}
 
+	/**
+	 * Get number of I/O queue pairs in use
+	 */
+	uint16_t io_queues() const { return _io_queues; }
+
+	/**
+	 * Get number of entries per I/O queue
+	 */
+	uint32_t io_entries() const { return _io_entries; }
+
 	/**
 	 * Get memory page size in bytes
 	 */
@@ -1201,8 +1356,22 @@ class Driver : public Block::Driver
 		bool _verbose_mem      { false };
 		bool _verbose_regs     { false };
 
+		/* I/O queue setup, only evaluated on startup */
+		unsigned _io_queues              { Nvme::MAX_IO_QUEUES };
+		unsigned _io_queue_entries       { 256 };
+		unsigned _irq_coalescing_thr     { 0 };
+		unsigned _irq_coalescing_time_us { 0 };
+
 	private:
 
+		/*
+		 * Noncopyable
+		 */
+		Driver(Driver const &);
+		Driver &operator = (Driver const &);
+
+		enum { MAX_REQUESTS = Block::Session::TX_QUEUE_SIZE };
+
 		Genode::Env       &_env;
 		Genode::Allocator &_alloc;
 
@@ -1222,6 +1391,11 @@ class Driver : public Block::Driver
 			_verbose_io       = config.attribute_value("verbose_io",       _verbose_io);
 			_verbose_mem      = config.attribute_value("verbose_mem",      _verbose_mem);
 			_verbose_regs     = config.attribute_value("verbose_regs",     _verbose_regs);
+
+			_io_queues              = config.attribute_value("io_queues",              _io_queues);
+			_io_queue_entries       = config.attribute_value("io_queue_entries",       _io_queue_entries);
+			_irq_coalescing_thr     = config.attribute_value("irq_coalescing_threshold", _irq_coalescing_thr);
+			_irq_coalescing_time_us = config.attribute_value("irq_coalescing_time_us", _irq_coalescing_time_us);
 		}
 
 		Genode::Signal_handler<Driver> _config_sigh {
@@ -1277,7 +1451,7 @@ class Driver : public Block::Driver
 			using Bitmap = Util::Bitmap<ENTRIES>;
 			Bitmap _bitmap { };
 
-			Util::Slots<Io_buffer, Nvme::MAX_IO_ENTRIES> _buffers { };
+			Util::Slots<Io_buffer, MAX_REQUESTS> _buffers { };
 
 			Genode::Ram_dataspace_capability _ds { };
 			addr_t _phys_addr { 0 };
@@ -1341,30 +1515,210 @@ class Driver : public Block::Driver
 		 ** Requests **
 		 **************/
 
+		/*
+		 * Each request is part of an NVMe command. As long as a command
+		 * is open, i.e., not yet submitted to the controller, succeeding
+		 * requests of the same kind that are adjacent to the command are
+		 * merged into it. The command gets closed by the first request
+		 * that cannot be merged or when the Block session has handed over
+		 * all requests currently available.
+		 */
+
 		struct Request
 		{
-			uint32_t           id     { 0 };
 			Packet_descriptor  pd     {   };
 			char              *buffer { nullptr };
+			Request           *next   { nullptr };
+		};
+
+		struct Command
+		{
+			enum State { FREE, OPEN, QUEUED, SUBMITTED };
+
+			State           state { FREE };
+			bool            write { false };
+			Block::sector_t lba   { 0 };
+			size_t          count { 0 };
+			uint16_t        qid   { 0 };
+
+			Request *first { nullptr };
+			Request *last  { nullptr };
 
 			Io_buffer *iob           { nullptr };
 			Io_buffer *large_request { nullptr };
 
-			bool valid() const { return id != 0; }
+			Command *next        { nullptr }; /* free or queued list */
+			Command *prev_active { nullptr };
+			Command *next_active { nullptr };
 
-			void invalidate()
-			{
-				id     = 0;
-				buffer = nullptr;
-				pd     = Packet_descriptor();
+			bool overlaps(Block::sector_t const start, size_t const num) const {
+				return start < lba + count && lba < start + num; }
+		};
+
+		Request  _requests[MAX_REQUESTS] {   };
+		Request *_free_requests          { nullptr };
 
-				iob           = nullptr;
-				large_request = nullptr;
+		/* the index of a command is used as command identifier */
+		Command  _commands[MAX_REQUESTS] {   };
+		Command *_free_commands          { nullptr };
+		Command *_active_commands        { nullptr };
+		Command *_open_command           { nullptr };
+		Command *_queued_head            { nullptr };
+		Command *_queued_tail            { nullptr };
+
+		Request *_alloc_request()
+		{
+			Request *r = _free_requests;
+			if (r) {
+				_free_requests = r->next;
+				r->next = nullptr;
 			}
-		};
+			return r;
+		}
+
+		void _free_request(Request &r)
+		{
+			r = Request();
+			r.next = _free_requests;
+			_free_requests = &r;
+		}
+
+		Command *_alloc_command()
+		{
+			Command *c = _free_commands;
+			if (!c) { return nullptr; }
+
+			_free_commands = c->next;
+			c->next        = nullptr;
+
+			c->next_active = _active_commands;
+			if (_active_commands) { _active_commands->prev_active = c; }
+			_active_commands = c;
+			return c;
+		}
+
+		void _free_command(Command &c)
+		{
+			if (c.prev_active) { c.prev_active->next_active = c.next_active; }
+			else               { _active_commands           = c.next_active; }
+			if (c.next_active) { c.next_active->prev_active = c.prev_active; }
+
+			c = Command();
+			c.next = _free_commands;
+			_free_commands = &c;
+		}
+
+		uint16_t _cid(Command const &c) const { return (uint16_t)(&c - _commands); }
+
+		/**
+		 * Check if request conflicts with any command not yet completed
+		 */
+		bool _conflicts(bool write, Block::sector_t lba, size_t count) const
+		{
+			for (Command const *c = _active_commands; c; c = c->next_active) {
+
+				/* reads do not need to be ordered among each other */
+				if (!write && !c->write)     { continue; }
+				if (!c->overlaps(lba, count)) { continue; }
+
+				if (_verbose_checks) {
+					Genode::warning("overlap: ", "[", lba, ",", lba + count, ") with "
+					                "[", c->lba, ",", c->lba + c->count, ")");
+				}
+				return true;
+			}
+			return false;
+		}
+
+		void _close_open_command()
+		{
+			Command *c = _open_command;
+			if (!c) { return; }
+
+			_open_command = nullptr;
+
+			c->state = Command::QUEUED;
+			if (_queued_tail) { _queued_tail->next = c; }
+			else              { _queued_head       = c; }
+			_queued_tail = c;
+		}
+
+		/**
+		 * Submit command to the controller
+		 *
+		 * \return  true if the command was submitted, false if the
+		 *          resources needed are exhausted
+		 */
+		bool _submit(Command &c)
+		{
+			uint16_t const qid = _nvme_ctrlr->io_queue();
+			if (!qid) { return false; }
+
+			size_t const len       = c.count * _block_size;
+			size_t const mps       = _nvme_ctrlr->mps();
+			size_t const mps_len   = Genode::align_addr(len, Genode::log2(mps));
+			bool   const need_list = len > 2 * mps;
+
+			Io_buffer *iob = _io_mapper->alloc(mps_len);
+			if (!iob) { return false; }
+
+			Io_buffer *list = nullptr;
+			if (need_list) {
+				list = _io_list_mapper->alloc(mps);
+				if (!list) {
+					_io_mapper->free(iob);
+					return false;
+				}
+			}
+
+			if (c.write) {
+				addr_t dst = iob->va;
+				for (Request const *r = c.first; r; r = r->next) {
+					size_t const n = r->pd.block_count() * _block_size;
+					Genode::memcpy((void*)dst, r->buffer, n);
+					dst += n;
+				}
+			}
+
+			Nvme::Sqe_io b(_nvme_ctrlr->io_command(qid, _cid(c)));
+
+			addr_t const pa = iob->pa;
+
+			Nvme::Opcode op = c.write ? Nvme::Opcode::WRITE : Nvme::Opcode::READ;
+			b.write<Nvme::Sqe::Cdw0::Opc>(op);
+			b.write<Nvme::Sqe::Prp1>(pa);
+
+			/* payload will fit into 2 mps chunks */
+			if (len > mps && !list) {
+				b.write<Nvme::Sqe::Prp2>(pa + mps);
+			} else if (list) {
+				/* payload needs list of mps chunks */
+				_setup_large_request(list->va, *iob, (mps_len - mps)/mps, mps);
+				b.write<Nvme::Sqe::Prp2>(list->pa);
+			}
+
+			b.write<Nvme::Sqe_io::Slba>(c.lba);
+			b.write<Nvme::Sqe_io::Cdw12::Nlb>(c.count - 1); /* 0-base value */
+
+			c.state         = Command::SUBMITTED;
+			c.qid           = qid;
+			c.iob           = iob;
+			c.large_request = list;
+			return true;
+		}
 
-		Util::Slots<Request, Nvme::MAX_IO_ENTRIES> _requests         {   };
-		size_t                                     _requests_pending { 0 };
+		/**
+		 * Submit queued commands in order as long as resources suffice
+		 */
+		void _submit_queued()
+		{
+			while (_queued_head && _submit(*_queued_head)) {
+				Command &c = *_queued_head;
+				_queued_head = c.next;
+				c.next = nullptr;
+			}
+			if (!_queued_head) { _queued_tail = nullptr; }
+		}
 
 		/*********************
 		 ** MMIO Controller **
@@ -1383,17 +1737,15 @@ class Driver : public Block::Driver
 
 		void _handle_completions()
 		{
-			_nvme_ctrlr->handle_io_completions(Nvme::IO_NSID, [&] (Nvme::Cqe const &b) {
+			_nvme_ctrlr->handle_io_completions([&] (Nvme::Cqe const &b) {
 
 				if (_verbose_io) { Nvme::Cqe::dump(b); }
 
-				uint32_t const id = Nvme::Cqe::request_id(b);
+				uint16_t const cid = b.read<Nvme::Cqe::Cid>();
 
-				Request *r = _requests.lookup([&] (Request &r) {
-					if (r.id == id) { return true; }
-					return false;
-				});
-				if (!r) {
+				Command *c = cid < MAX_REQUESTS ? &_commands[cid] : nullptr;
+				if (!c || c->state != Command::SUBMITTED
+				       || c->qid   != b.read<Nvme::Cqe::Sqid>()) {
 					Genode::error("no pending request found for CQ entry");
 					Nvme::Cqe::dump(b);
 					return;
@@ -1401,25 +1753,41 @@ class Driver : public Block::Driver
 
 				bool const succeeded = Nvme::Cqe::succeeded(b);
 
-				Packet_descriptor pd = r->pd;
-				pd.succeeded(succeeded);
-
-				Io_buffer *iob = r->iob;
-
-				if (succeeded && pd.operation() == Packet_descriptor::READ) {
-					size_t const len = pd.block_count() * _block_size;
-					Genode::memcpy(r->buffer, (void*)iob->va, len);
+				if (succeeded && !c->write) {
+					addr_t src = c->iob->va;
+					for (Request const *r = c->first; r; r = r->next) {
+						size_t const len = r->pd.block_count() * _block_size;
+						Genode::memcpy(r->buffer, (void*)src, len);
+						src += len;
+					}
 				}
-				_io_mapper->free(iob);
+				_io_mapper->free(c->iob);
 
-				if (r->large_request) {
-					_io_list_mapper->free(r->large_request);
+				if (c->large_request) {
+					_io_list_mapper->free(c->large_request);
 				}
 
-				r->invalidate();
-				--_requests_pending;
-				ack_packet(pd, succeeded);
+				/*
+				 * Release the command before acknowledging the requests as
+				 * acknowledging may immediately lead to new requests.
+				 */
+				Request *r = c->first;
+				_free_command(*c);
+
+				while (r) {
+					Request *next = r->next;
+
+					Packet_descriptor pd = r->pd;
+					_free_request(*r);
+					ack_packet(pd, succeeded);
+
+					r = next;
+				}
 			});
+
+			/* resources were freed, retry commands that had to wait */
+			_submit_queued();
+			_nvme_ctrlr->commit_io();
 		}
 
 		void _handle_intr()
@@ -1478,7 +1846,6 @@ class Driver : public Block::Driver
 			_nvme_ctrlr->identify();
 
 			if (_verbose_identify) {
-				Genode::warning(_requests_pending);
 				_nvme_ctrlr->dump_identify();
 				_nvme_ctrlr->dump_nslist();
 			}
@@ -1523,7 +1890,19 @@ class Driver : public Block::Driver
 				}
 			}
 
-			_nvme_ctrlr->setup_io(Nvme::IO_NSID, Nvme::IO_NSID);
+			for (unsigned i = 0; i < MAX_REQUESTS; i++) {
+				_free_request(_requests[i]);
+
+				_commands[i].next = _free_commands;
+				_free_commands    = &_commands[i];
+			}
+
+			_nvme_ctrlr->setup_io(_io_queues, _io_queue_entries);
+
+			if (_irq_coalescing_thr) {
+				_nvme_ctrlr->intr_coalescing(_irq_coalescing_thr,
+				                             _irq_coalescing_time_us);
+			}
 
 			/* from now on use interrupts */
 			_nvme_pci->sigh_irq(_intr_sigh);
@@ -1557,6 +1936,10 @@ class Driver : public Block::Driver
 			            "size:",  _block_size,  " "
 			            "count:", _block_count);
 
+			Genode::log("I/O",                                  " "
+			            "queues:",  _nvme_ctrlr->io_queues(),  " "
+			            "entries:", _nvme_ctrlr->io_entries());
+
 			/* generate Report if requested */
 			try {
 				Genode::Xml_node report = _config_rom.xml().sub_node("report");
@@ -1600,86 +1983,43 @@ class Driver : public Block::Driver
 				throw Io_error();
 			}
 
-			if (_requests_pending == (Nvme::MAX_IO_PENDING)) {
-				throw Request_congestion();
-			}
-
-			Block::sector_t const lba_end = lba + count - 1;
-			auto overlap_check = [&] (Request &req) {
-				Block::sector_t const start = req.pd.block_number();
-				Block::sector_t const end   = start + req.pd.block_count() - 1;
-
-				bool const in_req    = (lba >= start && lba_end <= end);
-				bool const over_req  = (lba <= start && lba_end <= end) &&
-				                       (start >= lba && start <= lba_end);
-				bool const cross_req = (lba <= start && lba_end >= end);
-				bool const overlap   = (in_req || over_req || cross_req);
-
-				if (_verbose_checks && overlap) {
-					warning("overlap: ", "[", lba, ",", lba_end, ") with "
-					        "[", start,   ",", end, ")",
-					        " ", in_req, " ", over_req, " ", cross_req);
-				}
-				return overlap;
-			};
-			if (_requests.for_each(overlap_check)) { throw Request_congestion(); }
-
-			Request *r = _requests.get();
-			if (!r) { throw Request_congestion(); }
+			if (_conflicts(write, lba, count)) { throw Request_congestion(); }
 
-			size_t const mps       = _nvme_ctrlr->mps();
-			size_t const mps_len   = Genode::align_addr(len, Genode::log2(mps));
-			bool   const need_list = len > 2 * mps;
+			Command *open = _open_command;
+			bool const merge = open && open->write == write
+			                        && open->lba + open->count == lba
+			                        && (open->count + count) * _block_size
+			                           <= Nvme::MAX_IO_LEN;
 
-			Io_buffer *iob = _io_mapper->alloc(mps_len);
-			if (!iob) { throw Request_congestion(); }
+			if (!merge && !_free_commands) { throw Request_congestion(); }
 
-			if (need_list) {
-				r->large_request = _io_list_mapper->alloc(mps);
-				if (!r->large_request) {
-					_io_mapper->free(iob);
-					throw Request_congestion();
-				}
-			}
+			Request *r = _alloc_request();
+			if (!r) { throw Request_congestion(); }
 
-			if (write) { Genode::memcpy((void*)iob->va, buffer, len); }
+			r->pd     = pd; /* must be a copy */
+			r->buffer = buffer;
 
-			Nvme::Sqe_io b(_nvme_ctrlr->io_command(Nvme::IO_NSID));
-			if (!b.valid()) {
-				if (r->large_request) {
-					_io_list_mapper->free(r->large_request);
-				}
-				_io_mapper->free(iob);
-				throw Request_congestion();
+			if (merge) {
+				open->last->next  = r;
+				open->last        = r;
+				open->count      += count;
+				return;
 			}
 
-			addr_t const pa = iob->pa;
-
-			Nvme::Opcode op = write ? Nvme::Opcode::WRITE : Nvme::Opcode::READ;
-			b.write<Nvme::Sqe::Cdw0::Opc>(op);
-			b.write<Nvme::Sqe::Prp1>(pa);
-
-			/* payload will fit into 2 mps chunks */
-			if (len > mps && !r->large_request) {
-				b.write<Nvme::Sqe::Prp2>(pa + mps);
-			} else if (r->large_request) {
-				/* payload needs list of mps chunks */
-				Io_buffer &lr = *r->large_request;
-				_setup_large_request(lr.va,
-				                     *iob, (mps_len - mps)/mps, mps);
-				b.write<Nvme::Sqe::Prp2>(lr.pa);
-			}
+			_close_open_command();
 
-			b.write<Nvme::Sqe_io::Slba>(lba);
-			b.write<Nvme::Sqe_io::Cdw12::Nlb>(count - 1); /* 0-base value */
+			Command &c = *_alloc_command();
+			c.state = Command::OPEN;
+			c.write = write;
+			c.lba   = lba;
+			c.count = count;
+			c.first = r;
+			c.last  = r;
 
-			r->iob    = iob;
-			r->pd     = pd; /* must be a copy */
-			r->buffer = write ? nullptr : buffer;
-			r->id     = b.read<Nvme::Sqe_io::Cdw0::Cid>() | (Nvme::IO_NSID<<16);
+			_open_command = &c;
 
-			++_requests_pending;
-			_nvme_ctrlr->commit_io(Nvme::IO_NSID);
+			/* the doorbells are written in 'submit_requests' */
+			_submit_queued();
 		}
 
 		void read(Block::sector_t lba, size_t count,
@@ -1700,7 +2040,18 @@ class Driver : public Block::Driver
 			_io(true, lba, count, const_cast<char*>(buffer), pd);
 		}
 
-		void sync() override { _nvme_ctrlr->flush_cache(Nvme::IO_NSID); }
+		void submit_requests() override
+		{
+			_close_open_command();
+			_submit_queued();
+			_nvme_ctrlr->commit_io();
+		}
+
+		void sync() override
+		{
+			submit_requests();
+			_nvme_ctrlr->flush_cache(Nvme::IO_NSID);
+		}
 };
 
 
@@ -23,6 +23,19 @@ void Init::Child::destroy_services()
 }
 
 
+bool Init::Child::env_complete()
+{
+	bool env_log_exists = false, env_binary_exists = false;
+	_child.for_each_session([&] (Session_state const &session) {
+		Parent::Client::Id const id = session.id_at_client();
+		env_log_exists    |= (id == Parent::Env::log());
+		env_binary_exists |= (id == Parent::Env::binary());
+	});
+
+	return env_binary_exists && env_log_exists;
+}
+
+
 Init::Child::Apply_config_result
 Init::Child::apply_config(Xml_node start_node)
 {
@@ -33,18 +46,9 @@ Init::Child::apply_config(Xml_node start_node)
 	 * If the child's environment is incomplete, restart it to attempt
 	 * the re-routing of its environment sessions.
 	 */
-	{
-		bool env_log_exists = false, env_binary_exists = false;
-		_child.for_each_session([&] (Session_state const &session) {
-			Parent::Client::Id const id = session.id_at_client();
-			env_log_exists    |= (id == Parent::Env::log());
-			env_binary_exists |= (id == Parent::Env::binary());
-		});
-
-		if (!env_binary_exists || !env_log_exists) {
-			abandon();
-			return MAY_HAVE_SIDE_EFFECTS;
-		}
+	if (!env_complete()) {
+		abandon();
+		return MAY_HAVE_SIDE_EFFECTS;
 	}
 
 	bool provided_services_changed = false;
@@ -55,9 +59,7 @@ Init::Child::apply_config(Xml_node start_node)
 	Config_update config_update = CONFIG_UNCHANGED;
 
 	/* import new start node if new version differs */
-	if (start_node.size() != _start_node->xml().size() ||
-	    Genode::memcmp(start_node.addr(), _start_node->xml().addr(),
-	                   start_node.size()) != 0)
+	if (start_node_changed(start_node))
 	{
 		/*
 		 * Check for a change of the version attribute, force restart
@@ -509,6 +509,27 @@ class Init::Child : Child_policy, Routed_service::Wakeup
 
 		bool env_sessions_closed() const { return _child.env_sessions_closed(); }
 
+		/**
+		 * Return true if the child's process is running
+		 */
+		bool active() const { return _child.active(); }
+
+		/**
+		 * Return true if the environment sessions needed to start the child
+		 * exist
+		 */
+		bool env_complete();
+
+		/**
+		 * Return true if the start node differs from the imported one
+		 */
+		bool start_node_changed(Xml_node start_node) const
+		{
+			return start_node.size() != _start_node->xml().size()
+			    || Genode::memcmp(start_node.addr(), _start_node->xml().addr(),
+			                      start_node.size()) != 0;
+		}
+
 		enum Apply_config_result { MAY_HAVE_SIDE_EFFECTS, NO_SIDE_EFFECTS };
 
 		/**
@@ -14,17 +14,19 @@
 /* Genode includes */
 #include <base/component.h>
 #include <base/attached_rom_dataspace.h>
+#include <util/xml_delta.h>
 
 /* local includes */
 #include <child.h>
 #include <alias.h>
 #include <server.h>
 #include <heartbeat.h>
+#include <start_index.h>
 
 namespace Init { struct Main; }
 
 
-struct Init::Main : State_reporter::Producer,
+struct Init::Main : State_reporter::Producer, Report_update_trigger,
                     Child::Default_route_accessor, Child::Default_caps_accessor,
                     Child::Ram_limit_accessor, Child::Cap_limit_accessor
 {
@@ -48,6 +50,61 @@ struct Init::Main : State_reporter::Producer,
 
 	unsigned _child_cnt = 0;
 
+	/*
+	 * Index of the start nodes of the current config
+	 */
+	Constructible<Start_index> _start_index { };
+
+	/*
+	 * Checksum of the config content apart from the start nodes, which
+	 * may affect the routes of all children
+	 */
+	Xml_delta::Checksum _routing_checksum = 0;
+
+	Xml_delta::Checksum _routing_checksum_from_config() const
+	{
+		Xml_delta::Checksum result = 0;
+
+		_config_xml.for_each_sub_node([&] (Xml_node node) {
+			if (!node.has_type("start"))
+				result = result*31 + Xml_delta::checksum(node); });
+
+		return result;
+	}
+
+	/*
+	 * Time from the import of a config that starts new children until all
+	 * children are running
+	 */
+	struct Startup
+	{
+		bool          pending     = false;
+		bool          measured    = false;
+		unsigned      children    = 0;
+		unsigned long start_ms    = 0;
+		unsigned long duration_ms = 0;
+	} _startup { };
+
+	void _check_startup_complete()
+	{
+		if (!_startup.pending)
+			return;
+
+		bool all_active = true;
+		_children.for_each_child([&] (Child const &child) {
+			if (!child.abandoned() && !child.active())
+				all_active = false; });
+
+		if (!all_active)
+			return;
+
+		_startup.pending     = false;
+		_startup.measured    = true;
+		_startup.duration_ms = _state_reporter.elapsed_ms() - _startup.start_ms;
+
+		_state_reporter.trigger_report_update();
+	}
+
 	static Ram_quota _preserved_ram_from_config(Xml_node config)
 	{
 		Number_of_bytes preserve { 40*sizeof(long)*1024 };
@@ -120,6 +177,15 @@ struct Init::Main : State_reporter::Producer,
 		if (detail.init_caps())
 			xml.node("caps", [&] () { generate_caps_info(xml, _env.pd()); });
 
+		if (detail.startup() && (_startup.pending || _startup.measured))
+			xml.node("startup", [&] () {
+				xml.attribute("children", _startup.children);
+				if (_startup.pending)
+					xml.attribute("state", "incomplete");
+				else
+					xml.attribute("ms", _startup.duration_ms);
+			});
+
 		if (detail.children())
 			_children.report_state(xml, detail);
 	}
@@ -140,15 +206,33 @@ struct Init::Main : State_reporter::Producer,
 
 	State_reporter _state_reporter { _env, *this };
 
+	/**
+	 * Report_update_trigger interface
+	 *
+	 * State changes of children are observed for detecting the completion
+	 * of their startup before being forwarded to the state reporter.
+	 */
+	void trigger_report_update() override
+	{
+		_check_startup_complete();
+		_state_reporter.trigger_report_update();
+	}
+
+	void trigger_immediate_report_update() override
+	{
+		_check_startup_complete();
+		_state_reporter.trigger_immediate_report_update();
+	}
+
 	Heartbeat _heartbeat { _env, _children, _state_reporter };
 
 	Signal_handler<Main> _resource_avail_handler {
 		_env.ep(), *this, &Main::_handle_resource_avail };
 
 	void _update_aliases_from_config();
-	void _update_parent_services_from_config();
-	void _abandon_obsolete_children();
-	void _update_children_config();
+	bool _update_parent_services_from_config();
+	bool _abandon_obsolete_children();
+	void _update_children_config(bool);
 	void _destroy_abandoned_parent_services();
 	void _handle_config();
 
@@ -169,8 +253,10 @@ struct Init::Main : State_reporter::Producer,
 };
 
 
-void Init::Main::_update_parent_services_from_config()
+bool Init::Main::_update_parent_services_from_config()
 {
+	bool changed = false;
+
 	Xml_node const node = _config_xml.has_sub_node("parent-provides")
 	                    ? _config_xml.sub_node("parent-provides")
 	                    : Xml_node("<empty/>");
@@ -185,8 +271,10 @@ void Init::Main::_update_parent_services_from_config()
 			if (name == service.attribute_value("name", Service::Name())) {
 				obsolete = false; }});
 
-		if (obsolete)
+		if (obsolete) {
 			service.abandon();
+			changed = true;
+		}
 	});
 
 	/* used to prepend the list of new parent services with title */
@@ -204,6 +292,7 @@ void Init::Main::_update_parent_services_from_config()
 
 		if (!registered) {
 			new (_heap) Init::Parent_service(_parent_services, _env, name);
+			changed = true;
 			if (_verbose->enabled()) {
 				if (first_log)
 					log("parent provides");
@@ -212,6 +301,8 @@ void Init::Main::_update_parent_services_from_config()
 			}
 		}
 	});
+
+	return changed;
 }
 
 
@@ -245,48 +336,57 @@ void Init::Main::_update_aliases_from_config()
 }
 
 
-void Init::Main::_abandon_obsolete_children()
+bool Init::Main::_abandon_obsolete_children()
 {
-	_children.for_each_child([&] (Child &child) {
+	bool abandoned = false;
 
-		Child_policy::Name const name = child.name();
+	_children.for_each_child([&] (Child &child) {
 
-		bool obsolete = true;
-		_config_xml.for_each_sub_node("start", [&] (Xml_node node) {
-			if (node.attribute_value("name", Child_policy::Name()) == name)
-				obsolete = false; });
+		if (child.abandoned() || _start_index->exists(child.name()))
+			return;
 
-		if (obsolete)
-			child.abandon();
+		child.abandon();
+		abandoned = true;
 	});
+
+	return abandoned;
 }
 
 
-void Init::Main::_update_children_config()
+void Init::Main::_update_children_config(bool routing_changed)
 {
-	for (;;) {
+	for (bool first_iteration = true; ; first_iteration = false) {
 
 		/*
 		 * Children are abandoned if any of their client sessions can no longer
 		 * be routed or result in a different route. As each child may be a
 		 * service, an avalanche effect may occur. It stops if no update causes
 		 * a potential side effect in one iteration over all chilren.
+		 *
+		 * Unless the config changed in a way that may affect the routes of
+		 * all children, the routes of a child can only change with its start
+		 * node or as a side effect of the update of another child. Hence,
+		 * the first iteration skips children with an unchanged start node.
 		 */
 		bool side_effects = false;
 
-		_config_xml.for_each_sub_node("start", [&] (Xml_node node) {
+		_children.for_each_child([&] (Child &child) {
 
-			Child_policy::Name const start_node_name =
-				node.attribute_value("name", Child_policy::Name());
+			if (child.abandoned())
+				return;
 
-			_children.for_each_child([&] (Child &child) {
-				if (!child.abandoned() && child.name() == start_node_name) {
-					switch (child.apply_config(node)) {
-					case Child::NO_SIDE_EFFECTS: break;
-					case Child::MAY_HAVE_SIDE_EFFECTS: side_effects = true; break;
-					};
-				}
-			});
+			Start_index::Entry const * const entry = _start_index->lookup(child.name());
+			if (!entry)
+				return;
+
+			if (first_iteration && !routing_changed && child.env_complete()
+			 && !child.start_node_changed(entry->start_node))
+				return;
+
+			switch (child.apply_config(entry->start_node)) {
+			case Child::NO_SIDE_EFFECTS: break;
+			case Child::MAY_HAVE_SIDE_EFFECTS: side_effects = true; break;
+			};
 		});
 
 		if (!side_effects)
@@ -307,6 +407,10 @@ void Init::Main::_handle_config()
 	_state_reporter.apply_config(_config_xml);
 	_heartbeat.apply_config(_config_xml);
 
+	unsigned long const config_imported_ms = _state_reporter.elapsed_ms();
+
+	_start_index.construct(_heap, _config_xml);
+
 	/* determine default route for resolving service requests */
 	try {
 		_default_route.construct(_heap, _config_xml.sub_node("default-route")); }
@@ -321,10 +425,15 @@ void Init::Main::_handle_config()
 	Prio_levels     const prio_levels    = prio_levels_from_xml(_config_xml);
 	Affinity::Space const affinity_space = affinity_space_from_xml(_config_xml);
 
+	Xml_delta::Checksum const routing_checksum = _routing_checksum_from_config();
+
+	bool routing_changed = (routing_checksum != _routing_checksum);
+	_routing_checksum = routing_checksum;
+
 	_update_aliases_from_config();
-	_update_parent_services_from_config();
-	_abandon_obsolete_children();
-	_update_children_config();
+	routing_changed |= _update_parent_services_from_config();
+	routing_changed |= _abandon_obsolete_children();
+	_update_children_config(routing_changed);
 
 	/* kill abandoned children */
 	_children.for_each_child([&] (Child &child) {
@@ -354,29 +463,31 @@ void Init::Main::_handle_config()
 	Ram_quota used_ram  { 0 };
 	Cap_quota used_caps { 0 };
 
+	unsigned num_started = 0;
+
+	/* count existing children per start node */
+	_children.for_each_child([&] (Child const &child) {
+		if (Start_index::Entry * const entry = _start_index->lookup(child.name())) {
+			if (child.abandoned())
+				entry->num_abandoned++;
+			else
+				entry->num_existing++;
+		}
+	});
+
 	/* create new children */
 	try {
 		_config_xml.for_each_sub_node("start", [&] (Xml_node start_node) {
 
-			bool exists = false;
-
-			unsigned num_abandoned = 0;
-
-			_children.for_each_child([&] (Child const &child) {
-				if (child.name() == start_node.attribute_value("name", Child_policy::Name())) {
-					if (child.abandoned())
-						num_abandoned++;
-					else
-						exists = true;
-				}
-			});
+			Start_index::Entry * const entry = _start_index->lookup(
+				start_node.attribute_value("name", Child_policy::Name()));
 
 			/* skip start node if corresponding child already exists */
-			if (exists)
+			if (entry && entry->num_existing)
 				return;
 
 			/* prevent queuing up abandoned children with the same name */
-			if (num_abandoned > 1)
+			if (entry && entry->num_abandoned > 1)
 				return;
 
 			if (used_ram.value > avail_ram.value) {
@@ -392,7 +503,7 @@ void Init::Main::_handle_config()
 			try {
 				Init::Child &child = *new (_heap)
 					Init::Child(_env, _heap, *_verbose,
-					            Init::Child::Id { ++_child_cnt }, _state_reporter,
+					            Init::Child::Id { ++_child_cnt }, *this,
 					            start_node, *this, *this, _children,
 					            Ram_quota { avail_ram.value  - used_ram.value },
 					            Cap_quota { avail_caps.value - used_caps.value },
@@ -400,6 +511,10 @@ void Init::Main::_handle_config()
 					            _parent_services, _child_services);
 				_children.insert(&child);
 
+				if (entry)
+					entry->num_existing++;
+
+				num_started++;
 				update_state_report = true;
 
 				/* account for the start XML node buffered in the child */
@@ -464,6 +579,24 @@ void Init::Main::_handle_config()
 
 	_server.apply_config(_config_xml);
 
+	/*
+	 * New children are started all at once. Each child blocks on its
+	 * sessions to services that are not yet available only, which lets
+	 * the children start in the order of their dependencies.
+	 */
+	if (num_started && _state_reporter.time_available()) {
+
+		if (!_startup.pending) {
+			_startup.pending  = true;
+			_startup.children = 0;
+			_startup.start_ms = config_imported_ms;
+		}
+
+		_startup.children += num_started;
+	}
+
+	_check_startup_complete();
+
 	if (update_state_report)
 		_state_reporter.trigger_immediate_report_update();
 }
@@ -0,0 +1,95 @@
+/*
+ * \brief  Index of the start nodes of a configuration
+ * \author Genode Labs
+ * \date   2018-12-14
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _SRC__INIT__START_INDEX_H_
+#define _SRC__INIT__START_INDEX_H_
+
+/* Genode includes */
+#include <util/avl_string.h>
+#include <base/child.h>
+
+/* local includes */
+#include <types.h>
+
+namespace Init { class Start_index; }
+
+
+/**
+ * Start nodes of a config version, looked up by the name of the child
+ *
+ * The index refers to the XML data of the config, which must remain
+ * unchanged during the lifetime of the index.
+ */
+class Init::Start_index : Noncopyable
+{
+	public:
+
+		typedef Child_policy::Name Name;
+
+		struct Entry : Avl_string<Name::capacity()>
+		{
+			Xml_node const start_node;
+
+			/*
+			 * Children with the name of the start node, counted by the user
+			 * of the index
+			 */
+			unsigned num_existing  = 0;
+			unsigned num_abandoned = 0;
+
+			Entry(Name const &name, Xml_node start_node)
+			: Avl_string(name.string()), start_node(start_node) { }
+		};
+
+	private:
+
+		Allocator &_alloc;
+
+		Avl_tree<Avl_string_base> _tree { };
+
+	public:
+
+		Start_index(Allocator &alloc, Xml_node config) : _alloc(alloc)
+		{
+			config.for_each_sub_node("start", [&] (Xml_node node) {
+
+				Name const name = node.attribute_value("name", Name());
+
+				/* the first of equally named start nodes takes effect */
+				if (name.valid() && !lookup(name))
+					_tree.insert(new (_alloc) Entry(name, node));
+			});
+		}
+
+		~Start_index()
+		{
+			while (Avl_string_base *entry = _tree.first()) {
+				_tree.remove(entry);
+				destroy(_alloc, static_cast<Entry *>(entry));
+			}
+		}
+
+		/**
+		 * Return entry of the start node named 'name', or nullptr
+		 */
+		Entry *lookup(Name const &name) const
+		{
+			Avl_string_base * const root = _tree.first();
+			return root ? static_cast<Entry *>(root->find_by_name(name.string()))
+			            : nullptr;
+		}
+
+		bool exists(Name const &name) const { return lookup(name) != nullptr; }
+};
+
+#endif /* _SRC__INIT__START_INDEX_H_ */
@@ -118,6 +118,9 @@ class Init::State_reporter : public Report_update_trigger
 				_report_detail.construct(report);
 				_report_delay_ms = report.attribute_value("delay_ms", 100UL);
 				_reporter->enabled(true);
+
+				/* report only changes if the recipient is able to apply deltas */
+				_reporter->incremental(report.attribute_value("delta", false));
 			}
 			catch (Xml_node::Nonexistent_sub_node) {
 				_report_detail.construct();
@@ -179,6 +182,22 @@ class Init::State_reporter : public Report_update_trigger
 			}
 		}
 
+		/**
+		 * Return true if the reporter has a time source
+		 *
+		 * A time source is present if the report is configured with a
+		 * delay.
+		 */
+		bool time_available() const { return _timer.constructed(); }
+
+		/**
+		 * Return milliseconds elapsed since the start of the time source
+		 */
+		unsigned long elapsed_ms() const
+		{
+			return _timer.constructed() ? _timer->elapsed_ms() : 0;
+		}
+
 		void trigger_report_update() override
 		{
 			if (!_scheduled && _timer.constructed() && _report_delay_ms) {
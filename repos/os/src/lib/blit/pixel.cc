@@ -0,0 +1,329 @@
+/*
+ * \brief  Blending and conversion of pixel buffers
+ * \author Genode Labs
+ * \date   2018-12-11
+ *
+ * The functions process whole lines of pixels. The bulk of each line is
+ * first handed to the wide kernels of 'pixel_kernel.h', which are selected
+ * at runtime according to the CPU features, e.g., AVX2 on x86_64. If the
+ * target has SSE2, the rest is processed in vectors of 16 bytes using the
+ * vector extension of the compiler. The remaining pixels of a line are
+ * processed one by one. All paths yield the same results as the pixel
+ * operations of the 'Pixel_rgb888' and 'Pixel_rgb565' types.
+ *
+ * NEON is not used on ARM because it is optional for ARMv7 and the
+ * default build flags do not enable it.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <blit/blit.h>
+#include <base/stdint.h>
+#include <util/dither_matrix.h>
+
+/* local includes */
+#include <pixel_kernel.h>
+
+using Genode::uint8_t;
+using Genode::uint16_t;
+using Genode::uint32_t;
+
+
+/********************
+ ** Single pixels **
+ ********************/
+
+static inline uint32_t blend_pixel(uint32_t d, uint32_t s, unsigned a)
+{
+	unsigned const inv = 255 - a;
+
+	return (((inv*((d >> 16) & 0xff)) >> 8) + ((a*((s >> 16) & 0xff)) >> 8)) << 16
+	     | (((inv*((d >>  8) & 0xff)) >> 8) + ((a*((s >>  8) & 0xff)) >> 8)) << 8
+	     | (((inv*( d        & 0xff)) >> 8) + ((a*( s        & 0xff)) >> 8));
+}
+
+
+static inline uint32_t rgb565_to_rgb888(uint16_t p)
+{
+	return ((p & 0xf800) << 8) | ((p & 0x07e0) << 5) | ((p & 0x1f) << 3);
+}
+
+
+static inline uint16_t rgb888_to_rgb565(uint32_t p)
+{
+	return ((p >> 8) & 0xf800) | ((p >> 5) & 0x07e0) | ((p >> 3) & 0x1f);
+}
+
+
+/**
+ * Subtract dither value 'v' from each color channel, saturating at zero
+ */
+static inline uint32_t dither_pixel(uint32_t p, unsigned v)
+{
+	unsigned const r = (p >> 16) & 0xff, g = (p >> 8) & 0xff, b = p & 0xff;
+
+	return (r > v ? r - v : 0) << 16 | (g > v ? g - v : 0) << 8 | (b > v ? b - v : 0);
+}
+
+
+#ifdef __SSE2__
+
+/*************
+ ** Vectors **
+ *************/
+
+typedef uint8_t  V16u8 __attribute__((vector_size(16)));
+typedef uint16_t V8u16 __attribute__((vector_size(16)));
+typedef uint32_t V4u32 __attribute__((vector_size(16)));
+
+/* types for accessing vectors at unaligned addresses */
+typedef V16u8 V16u8_unaligned __attribute__((aligned(1), may_alias));
+typedef V8u16 V8u16_unaligned __attribute__((aligned(1), may_alias));
+typedef V4u32 V4u32_unaligned __attribute__((aligned(1), may_alias));
+
+enum { VECTOR_PIXELS_32 = 4, VECTOR_PIXELS_16 = 8 };
+
+
+static inline V8u16 low_bytes_to_words(V16u8 v)
+{
+	V16u8 const zero = { };
+	return (V8u16)__builtin_shuffle(v, zero, (V16u8){ 0, 16, 1, 17, 2, 18, 3, 19,
+	                                                  4, 20, 5, 21, 6, 22, 7, 23 });
+}
+
+
+static inline V8u16 high_bytes_to_words(V16u8 v)
+{
+	V16u8 const zero = { };
+	return (V8u16)__builtin_shuffle(v, zero, (V16u8){  8, 24,  9, 25, 10, 26, 11, 27,
+	                                                  12, 28, 13, 29, 14, 30, 15, 31 });
+}
+
+
+static inline V16u8 words_to_bytes(V8u16 lo, V8u16 hi)
+{
+	return __builtin_shuffle((V16u8)lo, (V16u8)hi,
+	                         (V16u8){  0,  2,  4,  6,  8, 10, 12, 14,
+	                                  16, 18, 20, 22, 24, 26, 28, 30 });
+}
+
+
+/**
+ * Blend four pixels
+ */
+static inline V4u32 blend_vector(V4u32 d, V4u32 s, V4u32 a)
+{
+	/* replicate alpha value to the color channels of each pixel */
+	V16u8 const alpha = (V16u8)(a | (a << 8) | (a << 16));
+	V16u8 const inv   = (V16u8)((V4u32){ 0xffffff, 0xffffff, 0xffffff, 0xffffff })
+	                  - alpha;
+
+	V8u16 const lo = ((low_bytes_to_words(alpha) * low_bytes_to_words((V16u8)s)) >> 8)
+	               + ((low_bytes_to_words(inv)   * low_bytes_to_words((V16u8)d)) >> 8);
+
+	V8u16 const hi = ((high_bytes_to_words(alpha) * high_bytes_to_words((V16u8)s)) >> 8)
+	               + ((high_bytes_to_words(inv)   * high_bytes_to_words((V16u8)d)) >> 8);
+
+	V4u32 const blended = (V4u32)words_to_bytes(lo, hi) & 0xffffff;
+
+	/* keep destination pixels with an alpha value of zero */
+	V4u32 const keep = (V4u32)(a == 0);
+
+	return (d & keep) | (blended & ~keep);
+}
+
+
+/**
+ * Convert eight RGB888 pixels to RGB565
+ */
+static inline V8u16 rgb888_to_rgb565_vector(V4u32 p0, V4u32 p1)
+{
+	V4u32 const q0 = ((p0 >> 8) & 0xf800) | ((p0 >> 5) & 0x07e0) | ((p0 >> 3) & 0x1f);
+	V4u32 const q1 = ((p1 >> 8) & 0xf800) | ((p1 >> 5) & 0x07e0) | ((p1 >> 3) & 0x1f);
+
+	return __builtin_shuffle((V8u16)q0, (V8u16)q1,
+	                         (V8u16){ 0, 2, 4, 6, 8, 10, 12, 14 });
+}
+
+
+/**
+ * Subtract dither values from the color channels, saturating at zero
+ */
+static inline V4u32 dither_vector(V4u32 p, V16u8 v)
+{
+	V16u8 const c = (V16u8)p;
+	return (V4u32)((c - v) & (V16u8)(c > v));
+}
+
+#endif /* __SSE2__ */
+
+
+/***********
+ ** Lines **
+ ***********/
+
+static inline void blend_line(uint32_t const *src, uint8_t const *alpha,
+                              uint32_t *dst, int w)
+{
+	int const n = blend_line_bulk(src, alpha, dst, w);
+	src += n; alpha += n; dst += n; w -= n;
+
+#ifdef __SSE2__
+	for (; w >= VECTOR_PIXELS_32; w -= VECTOR_PIXELS_32,
+	     src += VECTOR_PIXELS_32, alpha += VECTOR_PIXELS_32, dst += VECTOR_PIXELS_32) {
+
+		uint32_t a4 = 0;
+		__builtin_memcpy(&a4, alpha, sizeof(a4));
+
+		/* skip fully transparent pixels, which are common in textures */
+		if (!a4)
+			continue;
+
+		V4u32 const a = { alpha[0], alpha[1], alpha[2], alpha[3] };
+
+		*(V4u32_unaligned *)dst = blend_vector(*(V4u32_unaligned const *)dst,
+		                                       *(V4u32_unaligned const *)src, a);
+	}
+#endif
+
+	for (; w > 0; w--, src++, alpha++, dst++)
+		if (*alpha)
+			*dst = blend_pixel(*dst, *src, *alpha);
+}
+
+
+static inline void rgb565_to_rgb888_line(uint16_t const *src, uint32_t *dst, int w)
+{
+	int const n = rgb565_to_rgb888_line_bulk(src, dst, w);
+	src += n; dst += n; w -= n;
+
+#ifdef __SSE2__
+	for (; w >= VECTOR_PIXELS_16; w -= VECTOR_PIXELS_16,
+	     src += VECTOR_PIXELS_16, dst += VECTOR_PIXELS_16) {
+
+		V8u16 const zero = { };
+		V8u16 const p    = *(V8u16_unaligned const *)src;
+
+		V4u32 const lo = (V4u32)__builtin_shuffle(p, zero, (V8u16){ 0, 8, 1,  9, 2, 10, 3, 11 });
+		V4u32 const hi = (V4u32)__builtin_shuffle(p, zero, (V8u16){ 4, 12, 5, 13, 6, 14, 7, 15 });
+
+		((V4u32_unaligned *)dst)[0] = ((lo & 0xf800) << 8) | ((lo & 0x07e0) << 5) | ((lo & 0x1f) << 3);
+		((V4u32_unaligned *)dst)[1] = ((hi & 0xf800) << 8) | ((hi & 0x07e0) << 5) | ((hi & 0x1f) << 3);
+	}
+#endif
+
+	for (; w > 0; w--)
+		*dst++ = rgb565_to_rgb888(*src++);
+}
+
+
+/**
+ * Convert line of RGB888 pixels to RGB565
+ *
+ * \param row  dither-matrix row, or nullptr for plain conversion
+ * \param x    horizontal position of the first pixel within the matrix
+ */
+static inline void rgb888_to_rgb565_line(uint32_t const *src, uint16_t *dst, int w,
+                                         Genode::Dither_matrix::Row const *row,
+                                         unsigned x)
+{
+	/* the matrix repeats every 16 pixels */
+	uint8_t dither[16] = { };
+	if (row)
+		for (unsigned i = 0; i < 16; i++)
+			dither[i] = row->value(x + i) >> 4;
+
+	/* the bulk kernels process multiples of 16 pixels */
+	int const n = rgb888_to_rgb565_line_bulk(src, dst, w, row ? dither : nullptr);
+	src += n; dst += n; w -= n; x += n;
+
+#ifdef __SSE2__
+
+	/*
+	 * The 16 pixels of the matrix correspond to four vectors of four pixels
+	 * each. Hence, the dither values for the vectors of a line cycle through
+	 * four variants.
+	 */
+	V16u8 v[4] = { };
+	for (unsigned i = 0; i < 16; i++)
+		for (unsigned c = 0; c < 3; c++)
+			v[i/4][(i % 4)*4 + c] = dither[i];
+
+	for (unsigned i = 0; w >= VECTOR_PIXELS_16; w -= VECTOR_PIXELS_16,
+	     src += VECTOR_PIXELS_16, dst += VECTOR_PIXELS_16, i += 2, x += VECTOR_PIXELS_16) {
+
+		V4u32 p0 = ((V4u32_unaligned const *)src)[0];
+		V4u32 p1 = ((V4u32_unaligned const *)src)[1];
+
+		if (row) {
+			p0 = dither_vector(p0, v[ i      % 4]);
+			p1 = dither_vector(p1, v[(i + 1) % 4]);
+		}
+
+		*(V8u16_unaligned *)dst = rgb888_to_rgb565_vector(p0, p1);
+	}
+#endif
+
+	for (; w > 0; w--, x++) {
+		uint32_t const p = *src++;
+		*dst++ = rgb888_to_rgb565(row ? dither_pixel(p, row->value(x) >> 4) : p);
+	}
+}
+
+
+/***************
+ ** Interface **
+ ***************/
+
+extern "C" void blend_rgb888(void const *s, unsigned src_w,
+                             unsigned char const *alpha, unsigned alpha_w,
+                             void *d, unsigned dst_w, int w, int h)
+{
+	char const *src = (char const *)s;
+	char       *dst = (char       *)d;
+
+	for (; h-- > 0; src += src_w, alpha += alpha_w, dst += dst_w)
+		blend_line((uint32_t const *)src, alpha, (uint32_t *)dst, w);
+}
+
+
+extern "C" void convert_rgb565_to_rgb888(void const *s, unsigned src_w,
+                                         void *d, unsigned dst_w, int w, int h)
+{
+	char const *src = (char const *)s;
+	char       *dst = (char       *)d;
+
+	for (; h-- > 0; src += src_w, dst += dst_w)
+		rgb565_to_rgb888_line((uint16_t const *)src, (uint32_t *)dst, w);
+}
+
+
+extern "C" void convert_rgb888_to_rgb565(void const *s, unsigned src_w,
+                                         void *d, unsigned dst_w, int w, int h)
+{
+	char const *src = (char const *)s;
+	char       *dst = (char       *)d;
+
+	for (; h-- > 0; src += src_w, dst += dst_w)
+		rgb888_to_rgb565_line((uint32_t const *)src, (uint16_t *)dst, w, nullptr, 0);
+}
+
+
+extern "C" void dither_rgb888_to_rgb565(void const *s, unsigned src_w,
+                                        void *d, unsigned dst_w, int w, int h,
+                                        unsigned x, unsigned y)
+{
+	char const *src = (char const *)s;
+	char       *dst = (char       *)d;
+
+	for (; h-- > 0; src += src_w, dst += dst_w, y++) {
+		Genode::Dither_matrix::Row const row = Genode::Dither_matrix::row(y);
+		rgb888_to_rgb565_line((uint32_t const *)src, (uint16_t *)dst, w, &row, x);
+	}
+}
@@ -0,0 +1,32 @@
+/*
+ * \brief  Wide pixel kernels, not available on this platform
+ * \author Genode Labs
+ * \date   2018-12-28
+ *
+ * The functions process the bulk of a line and return the number of
+ * processed pixels. The remainder is processed by the generic code.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__PIXEL_KERNEL_H_
+#define _LIB__BLIT__PIXEL_KERNEL_H_
+
+#include <base/stdint.h>
+
+static inline int blend_line_bulk(Genode::uint32_t const *, Genode::uint8_t const *,
+                                  Genode::uint32_t *, int) { return 0; }
+
+static inline int rgb565_to_rgb888_line_bulk(Genode::uint16_t const *,
+                                             Genode::uint32_t *, int) { return 0; }
+
+static inline int rgb888_to_rgb565_line_bulk(Genode::uint32_t const *,
+                                             Genode::uint16_t *, int,
+                                             Genode::uint8_t const *) { return 0; }
+
+#endif /* _LIB__BLIT__PIXEL_KERNEL_H_ */
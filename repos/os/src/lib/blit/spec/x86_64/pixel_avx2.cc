@@ -0,0 +1,207 @@
+/*
+ * \brief  AVX2-based blending and conversion of pixel lines
+ * \author Genode Labs
+ * \date   2018-12-28
+ *
+ * This compilation unit is built with '-mavx2'. It must not define or
+ * instantiate any inline function that is shared with other compilation
+ * units, because the linker might pick the AVX2 variant for all of them.
+ * Hence, the dither values are passed as plain array instead of a
+ * 'Dither_matrix::Row'.
+ *
+ * The vectors hold 32 bytes. The byte-to-word expansion interleaves the
+ * bytes within each 128-bit half of a vector, which matches the AVX2
+ * unpack instructions. The results are the same as of the SSE2 and scalar
+ * code in 'pixel.cc'.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* local includes */
+#include <pixel_kernel.h>
+
+using Genode::uint8_t;
+using Genode::uint16_t;
+using Genode::uint32_t;
+using Genode::uint64_t;
+
+
+/*************
+ ** Vectors **
+ *************/
+
+typedef uint8_t  V32u8  __attribute__((vector_size(32)));
+typedef uint16_t V16u16 __attribute__((vector_size(32)));
+typedef uint32_t V8u32  __attribute__((vector_size(32)));
+
+/* types for accessing vectors at unaligned addresses */
+typedef V16u16 V16u16_unaligned __attribute__((aligned(1), may_alias));
+typedef V8u32  V8u32_unaligned  __attribute__((aligned(1), may_alias));
+
+enum { VECTOR_PIXELS_32 = 8, VECTOR_PIXELS_16 = 16 };
+
+
+static inline V16u16 low_bytes_to_words(V32u8 v)
+{
+	V32u8 const zero = { };
+	return (V16u16)__builtin_shuffle(v, zero, (V32u8){  0, 32,  1, 33,  2, 34,  3, 35,
+	                                                    4, 36,  5, 37,  6, 38,  7, 39,
+	                                                   16, 48, 17, 49, 18, 50, 19, 51,
+	                                                   20, 52, 21, 53, 22, 54, 23, 55 });
+}
+
+
+static inline V16u16 high_bytes_to_words(V32u8 v)
+{
+	V32u8 const zero = { };
+	return (V16u16)__builtin_shuffle(v, zero, (V32u8){  8, 40,  9, 41, 10, 42, 11, 43,
+	                                                   12, 44, 13, 45, 14, 46, 15, 47,
+	                                                   24, 56, 25, 57, 26, 58, 27, 59,
+	                                                   28, 60, 29, 61, 30, 62, 31, 63 });
+}
+
+
+/**
+ * Inverse of 'low_bytes_to_words' and 'high_bytes_to_words'
+ */
+static inline V32u8 words_to_bytes(V16u16 lo, V16u16 hi)
+{
+	return __builtin_shuffle((V32u8)lo, (V32u8)hi,
+	                         (V32u8){  0,  2,  4,  6,  8, 10, 12, 14,
+	                                  32, 34, 36, 38, 40, 42, 44, 46,
+	                                  16, 18, 20, 22, 24, 26, 28, 30,
+	                                  48, 50, 52, 54, 56, 58, 60, 62 });
+}
+
+
+/**
+ * Blend eight pixels
+ */
+static inline V8u32 blend_vector(V8u32 d, V8u32 s, V8u32 a)
+{
+	/* replicate alpha value to the color channels of each pixel */
+	V32u8 const alpha = (V32u8)(a | (a << 8) | (a << 16));
+	V32u8 const inv   = (V32u8)((V8u32){ 0xffffff, 0xffffff, 0xffffff, 0xffffff,
+	                                     0xffffff, 0xffffff, 0xffffff, 0xffffff })
+	                  - alpha;
+
+	V16u16 const lo = ((low_bytes_to_words(alpha) * low_bytes_to_words((V32u8)s)) >> 8)
+	                + ((low_bytes_to_words(inv)   * low_bytes_to_words((V32u8)d)) >> 8);
+
+	V16u16 const hi = ((high_bytes_to_words(alpha) * high_bytes_to_words((V32u8)s)) >> 8)
+	                + ((high_bytes_to_words(inv)   * high_bytes_to_words((V32u8)d)) >> 8);
+
+	V8u32 const blended = (V8u32)words_to_bytes(lo, hi) & 0xffffff;
+
+	/* keep destination pixels with an alpha value of zero */
+	V8u32 const keep = (V8u32)(a == 0);
+
+	return (d & keep) | (blended & ~keep);
+}
+
+
+/**
+ * Convert sixteen RGB888 pixels to RGB565
+ */
+static inline V16u16 rgb888_to_rgb565_vector(V8u32 p0, V8u32 p1)
+{
+	V8u32 const q0 = ((p0 >> 8) & 0xf800) | ((p0 >> 5) & 0x07e0) | ((p0 >> 3) & 0x1f);
+	V8u32 const q1 = ((p1 >> 8) & 0xf800) | ((p1 >> 5) & 0x07e0) | ((p1 >> 3) & 0x1f);
+
+	return __builtin_shuffle((V16u16)q0, (V16u16)q1,
+	                         (V16u16){  0,  2,  4,  6,  8, 10, 12, 14,
+	                                   16, 18, 20, 22, 24, 26, 28, 30 });
+}
+
+
+/**
+ * Subtract dither values from the color channels, saturating at zero
+ */
+static inline V8u32 dither_vector(V8u32 p, V32u8 v)
+{
+	V32u8 const c = (V32u8)p;
+	return (V8u32)((c - v) & (V32u8)(c > v));
+}
+
+
+/***********
+ ** Lines **
+ ***********/
+
+int blend_line_avx2(uint32_t const *src, uint8_t const *alpha, uint32_t *dst, int w)
+{
+	int n = 0;
+	for (; w - n >= VECTOR_PIXELS_32; n += VECTOR_PIXELS_32) {
+
+		uint8_t const *a8 = alpha + n;
+
+		uint64_t a8_all = 0;
+		__builtin_memcpy(&a8_all, a8, sizeof(a8_all));
+
+		/* skip fully transparent pixels, which are common in textures */
+		if (!a8_all)
+			continue;
+
+		V8u32 const a = { a8[0], a8[1], a8[2], a8[3], a8[4], a8[5], a8[6], a8[7] };
+
+		*(V8u32_unaligned *)(dst + n) = blend_vector(*(V8u32_unaligned const *)(dst + n),
+		                                             *(V8u32_unaligned const *)(src + n), a);
+	}
+	return n;
+}
+
+
+int rgb565_to_rgb888_line_avx2(uint16_t const *src, uint32_t *dst, int w)
+{
+	int n = 0;
+	for (; w - n >= VECTOR_PIXELS_16; n += VECTOR_PIXELS_16) {
+
+		V16u16 const zero = { };
+		V16u16 const p    = *(V16u16_unaligned const *)(src + n);
+
+		V8u32 const lo = (V8u32)__builtin_shuffle(p, zero, (V16u16){ 0, 16, 1, 17, 2, 18, 3, 19,
+		                                                             4, 20, 5, 21, 6, 22, 7, 23 });
+		V8u32 const hi = (V8u32)__builtin_shuffle(p, zero, (V16u16){  8, 24,  9, 25, 10, 26, 11, 27,
+		                                                             12, 28, 13, 29, 14, 30, 15, 31 });
+
+		V8u32_unaligned *d = (V8u32_unaligned *)(dst + n);
+		d[0] = ((lo & 0xf800) << 8) | ((lo & 0x07e0) << 5) | ((lo & 0x1f) << 3);
+		d[1] = ((hi & 0xf800) << 8) | ((hi & 0x07e0) << 5) | ((hi & 0x1f) << 3);
+	}
+	return n;
+}
+
+
+int rgb888_to_rgb565_line_avx2(uint32_t const *src, uint16_t *dst, int w,
+                               uint8_t const *dither)
+{
+	/*
+	 * The dither matrix repeats every 16 pixels, which correspond to the
+	 * two vectors of eight pixels processed per iteration.
+	 */
+	V32u8 v[2] = { };
+	if (dither)
+		for (unsigned i = 0; i < 16; i++)
+			for (unsigned c = 0; c < 3; c++)
+				v[i/8][(i % 8)*4 + c] = dither[i];
+
+	int n = 0;
+	for (; w - n >= VECTOR_PIXELS_16; n += VECTOR_PIXELS_16) {
+
+		V8u32 p0 = ((V8u32_unaligned const *)(src + n))[0];
+		V8u32 p1 = ((V8u32_unaligned const *)(src + n))[1];
+
+		if (dither) {
+			p0 = dither_vector(p0, v[0]);
+			p1 = dither_vector(p1, v[1]);
+		}
+
+		*(V16u16_unaligned *)(dst + n) = rgb888_to_rgb565_vector(p0, p1);
+	}
+	return n;
+}
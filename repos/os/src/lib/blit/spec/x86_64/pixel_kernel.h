@@ -0,0 +1,74 @@
+/*
+ * \brief  AVX2-based pixel kernels for x86_64
+ * \author Genode Labs
+ * \date   2018-12-28
+ *
+ * The AVX2 kernels reside in 'pixel_avx2.cc', which is the only compilation
+ * unit built with '-mavx2'. They are called only if the CPU supports AVX2,
+ * which is detected at runtime. Otherwise, the functions return zero and
+ * the generic code processes the whole line with SSE2.
+ *
+ * The functions process the bulk of a line and return the number of
+ * processed pixels.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__SPEC__X86_64__PIXEL_KERNEL_H_
+#define _LIB__BLIT__SPEC__X86_64__PIXEL_KERNEL_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+#include <cpu/features.h>
+
+int blend_line_avx2(Genode::uint32_t const *src, Genode::uint8_t const *alpha,
+                    Genode::uint32_t *dst, int w);
+
+int rgb565_to_rgb888_line_avx2(Genode::uint16_t const *src,
+                               Genode::uint32_t *dst, int w);
+
+/**
+ * \param dither  dither values of 16 consecutive pixels starting with the
+ *                first pixel of the line, or nullptr for plain conversion
+ */
+int rgb888_to_rgb565_line_avx2(Genode::uint32_t const *src,
+                               Genode::uint16_t *dst, int w,
+                               Genode::uint8_t const *dither);
+
+
+static inline bool pixel_avx2_supported()
+{
+	static bool const avx2 = Genode::avx2_supported();
+	return avx2;
+}
+
+
+static inline int blend_line_bulk(Genode::uint32_t const *src,
+                                  Genode::uint8_t const *alpha,
+                                  Genode::uint32_t *dst, int w)
+{
+	return pixel_avx2_supported() ? blend_line_avx2(src, alpha, dst, w) : 0;
+}
+
+
+static inline int rgb565_to_rgb888_line_bulk(Genode::uint16_t const *src,
+                                             Genode::uint32_t *dst, int w)
+{
+	return pixel_avx2_supported() ? rgb565_to_rgb888_line_avx2(src, dst, w) : 0;
+}
+
+
+static inline int rgb888_to_rgb565_line_bulk(Genode::uint32_t const *src,
+                                             Genode::uint16_t *dst, int w,
+                                             Genode::uint8_t const *dither)
+{
+	return pixel_avx2_supported()
+	       ? rgb888_to_rgb565_line_avx2(src, dst, w, dither) : 0;
+}
+
+#endif /* _LIB__BLIT__SPEC__X86_64__PIXEL_KERNEL_H_ */
@@ -0,0 +1,30 @@
+/*
+ * \brief  Summation kernel of the Internet Checksum
+ * \author Genode Labs
+ * \date   2018-12-04
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CHECKSUM_KERNEL_H_
+#define _CHECKSUM_KERNEL_H_
+
+/* local includes */
+#include <checksum_kernel_generic.h>
+
+namespace Net {
+
+	static inline Genode::uint64_t
+	checksum_add_up(Genode::uint8_t const *data, Genode::size_t size,
+	                Genode::uint64_t sum)
+	{
+		return checksum_add_up_generic(data, size, sum);
+	}
+}
+
+#endif /* _CHECKSUM_KERNEL_H_ */
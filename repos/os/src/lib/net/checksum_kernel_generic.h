@@ -0,0 +1,70 @@
+/*
+ * \brief  Generic summation kernel of the Internet Checksum
+ * \author Genode Labs
+ * \date   2018-12-04
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CHECKSUM_KERNEL_GENERIC_H_
+#define _CHECKSUM_KERNEL_GENERIC_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+
+namespace Net {
+
+	struct Unaligned_uint32
+	{
+		Genode::uint32_t value;
+
+	} __attribute__((packed, may_alias));
+
+	struct Unaligned_uint16
+	{
+		Genode::uint16_t value;
+
+	} __attribute__((packed, may_alias));
+
+	/**
+	 * Add up 'size' bytes at 'data' to 'sum' without folding the result
+	 *
+	 * The data is added up in 32-bit words. Because 2^16 is congruent to 1
+	 * modulo 2^16-1, folding the 64-bit sum yields the same one's
+	 * complement sum as adding up the data in 16-bit words.
+	 */
+	static inline Genode::uint64_t
+	checksum_add_up_generic(Genode::uint8_t const *data,
+	                        Genode::size_t         size,
+	                        Genode::uint64_t       sum)
+	{
+		typedef Unaligned_uint32 const U32;
+
+		for (; size >= 16; size -= 16, data += 16)
+			sum += (Genode::uint64_t)((U32 *)data)[0].value
+			     + ((U32 *)data)[1].value
+			     + ((U32 *)data)[2].value
+			     + ((U32 *)data)[3].value;
+
+		for (; size >= 4; size -= 4, data += 4)
+			sum += ((U32 *)data)->value;
+
+		if (size >= 2) {
+			sum  += ((Unaligned_uint16 const *)data)->value;
+			size -= 2;
+			data += 2;
+		}
+		/* add left-over byte, if any */
+		if (size)
+			sum += *data;
+
+		return sum;
+	}
+}
+
+#endif /* _CHECKSUM_KERNEL_GENERIC_H_ */
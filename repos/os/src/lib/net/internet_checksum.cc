@@ -14,26 +14,29 @@
 /* Genode includes */
 #include <net/internet_checksum.h>
 
+/* local includes */
+#include <checksum_kernel.h>
+
 using namespace Net;
 using namespace Genode;
 
 
+static uint16_t fold(uint64_t sum)
+{
+	while (uint64_t const sum_rsh = sum >> 16)
+		sum = (sum & 0xffff) + sum_rsh;
+
+	return sum;
+}
+
+
 uint16_t Net::internet_checksum(uint16_t const *addr,
                                 size_t          size,
                                 addr_t          init_sum)
 {
-	/* add up bytes in pairs */
-	addr_t sum = init_sum;
-	for (; size > 1; size -= 2)
-		sum += *addr++;
-
-	/* add left-over byte, if any */
-	if (size > 0)
-		sum += *(uint8_t *)addr;
-
-	/* fold sum to 16-bit value */
-	while (addr_t const sum_rsh = sum >> 16)
-		sum = (sum & 0xffff) + sum_rsh;
+	/* add up bytes in wide words and fold sum to 16-bit value */
+	uint16_t const sum =
+		fold(checksum_add_up((uint8_t const *)addr, size, init_sum));
 
 	/* return one's complement */
 	return ~sum;
@@ -62,3 +65,34 @@ uint16_t Net::internet_checksum_pseudo_ip(uint16_t        const *ip_data,
 	/* add up IP data bytes */
 	return internet_checksum(ip_data, ip_data_sz, sum);
 }
+
+
+/****************************
+ ** Internet_checksum_diff **
+ ****************************/
+
+void Internet_checksum_diff::add_up_diff(uint8_t const *new_data,
+                                         uint8_t const *old_data,
+                                         size_t         size)
+{
+	/*
+	 * Add up the one's complement of the old words and the new words
+	 * (RFC 1624, equation 3)
+	 */
+	for (size_t i = 0; i + 1 < size; i += 2) {
+		_value += (uint16_t)~*(uint16_t const *)&old_data[i];
+		_value += *(uint16_t const *)&new_data[i];
+	}
+}
+
+
+void Internet_checksum_diff::add_up_diff(Internet_checksum_diff const &icd)
+{
+	_value += icd._value;
+}
+
+
+uint16_t Internet_checksum_diff::apply_to(uint16_t sum) const
+{
+	return ~fold((uint16_t)~sum + (uint64_t)_value);
+}
@@ -0,0 +1,108 @@
+/*
+ * \brief  SSE2/AVX2-based summation kernel of the Internet Checksum
+ * \author Genode Labs
+ * \date   2018-12-04
+ *
+ * SSE2 is always present on x86_64. AVX2 is used only if the CPU supports
+ * it and the kernel enabled the saving of the AVX register state, which is
+ * detected at runtime.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _SPEC__X86_64__CHECKSUM_KERNEL_H_
+#define _SPEC__X86_64__CHECKSUM_KERNEL_H_
+
+/* Genode includes */
+#include <cpu/features.h>
+
+/* local includes */
+#include <checksum_kernel_generic.h>
+
+namespace Net {
+
+	enum { CHECKSUM_AVX2_MIN_SIZE = 256 };
+
+	/*
+	 * The kernels widen the 32-bit words of the data to 64-bit lanes so
+	 * that no carry gets lost. They expect at least one block of data.
+	 */
+
+	static inline Genode::uint64_t
+	checksum_add_up_sse2(Genode::uint8_t const *&data, Genode::size_t &size,
+	                     Genode::uint64_t sum)
+	{
+		Genode::uint64_t lanes[2];
+
+		asm volatile (
+			"pxor      %%xmm0, %%xmm0     \n\t"
+			"pxor      %%xmm1, %%xmm1     \n\t"
+			"0:                           \n\t"
+			"movdqu    (%[data]), %%xmm2  \n\t"
+			"movdqa    %%xmm2, %%xmm3     \n\t"
+			"punpckldq %%xmm0, %%xmm2     \n\t"
+			"punpckhdq %%xmm0, %%xmm3     \n\t"
+			"paddq     %%xmm2, %%xmm1     \n\t"
+			"paddq     %%xmm3, %%xmm1     \n\t"
+			"add       $16, %[data]       \n\t"
+			"sub       $16, %[size]       \n\t"
+			"cmp       $16, %[size]       \n\t"
+			"jae       0b                 \n\t"
+			"movdqu    %%xmm1, %[lanes]   \n\t"
+			: [data] "+r" (data), [size] "+r" (size), [lanes] "=m" (lanes)
+			:
+			: "xmm0", "xmm1", "xmm2", "xmm3", "cc", "memory");
+
+		return sum + lanes[0] + lanes[1];
+	}
+
+	static inline Genode::uint64_t
+	checksum_add_up_avx2(Genode::uint8_t const *&data, Genode::size_t &size,
+	                     Genode::uint64_t sum)
+	{
+		Genode::uint64_t lanes[4];
+
+		asm volatile (
+			"vpxor      %%ymm0, %%ymm0, %%ymm0  \n\t"
+			"vpxor      %%ymm1, %%ymm1, %%ymm1  \n\t"
+			"0:                                 \n\t"
+			"vmovdqu    (%[data]), %%ymm2       \n\t"
+			"vpunpckldq %%ymm0, %%ymm2, %%ymm3  \n\t"
+			"vpunpckhdq %%ymm0, %%ymm2, %%ymm2  \n\t"
+			"vpaddq     %%ymm3, %%ymm1, %%ymm1  \n\t"
+			"vpaddq     %%ymm2, %%ymm1, %%ymm1  \n\t"
+			"add        $32, %[data]            \n\t"
+			"sub        $32, %[size]            \n\t"
+			"cmp        $32, %[size]            \n\t"
+			"jae        0b                      \n\t"
+			"vmovdqu    %%ymm1, %[lanes]        \n\t"
+			"vzeroupper                         \n\t"
+			: [data] "+r" (data), [size] "+r" (size), [lanes] "=m" (lanes)
+			:
+			: "xmm0", "xmm1", "xmm2", "xmm3", "cc", "memory");
+
+		return sum + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+
+	static inline Genode::uint64_t
+	checksum_add_up(Genode::uint8_t const *data, Genode::size_t size,
+	                Genode::uint64_t sum)
+	{
+		static bool const avx2 = Genode::avx2_supported();
+
+		if (size >= CHECKSUM_AVX2_MIN_SIZE && avx2)
+			sum = checksum_add_up_avx2(data, size, sum);
+
+		if (size >= 16)
+			sum = checksum_add_up_sse2(data, size, sum);
+
+		return checksum_add_up_generic(data, size, sum);
+	}
+}
+
+#endif /* _SPEC__X86_64__CHECKSUM_KERNEL_H_ */
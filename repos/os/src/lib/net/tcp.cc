@@ -47,3 +47,25 @@ void Net::Tcp_packet::update_checksum(Ipv4_address ip_src,
 	                                        host_to_big_endian((uint16_t)tcp_size),
 	                                        Ipv4_packet::Protocol::TCP, ip_src, ip_dst);
 }
+
+
+void Net::Tcp_packet::update_checksum(Internet_checksum_diff const &icd)
+{
+	_checksum = icd.apply_to(_checksum);
+}
+
+
+void Net::Tcp_packet::src_port(Port p, Internet_checksum_diff &icd)
+{
+	uint16_t const p_be = host_to_big_endian(p.value);
+	icd.add_up_diff((uint8_t const *)&p_be, (uint8_t const *)&_src_port, 2);
+	_src_port = p_be;
+}
+
+
+void Net::Tcp_packet::dst_port(Port p, Internet_checksum_diff &icd)
+{
+	uint16_t const p_be = host_to_big_endian(p.value);
+	icd.add_up_diff((uint8_t const *)&p_be, (uint8_t const *)&_dst_port, 2);
+	_dst_port = p_be;
+}
@@ -13,6 +13,7 @@
 
 /* Genode includes */
 #include <timer/timeout.h>
+#include <util/misc_math.h>
 
 using namespace Genode;
 
@@ -68,15 +69,6 @@ Timeout::Alarm::~Alarm()
 }
 
 
-bool Timeout::Alarm::Raw::is_pending_at(unsigned long time, bool time_period) const
-{
-	return (time_period == deadline_period &&
-	        time        >= deadline) ||
-	       (time_period != deadline_period &&
-	        time        <  deadline);
-}
-
-
 /*****************************
  ** Alarm_timeout_scheduler **
  *****************************/
@@ -101,6 +93,10 @@ void Alarm_timeout_scheduler::handle_timeout(Duration duration)
 	} else if (sleep_time_us == 0) {
 		sleep_time_us = 1; }
 
+	{
+		Lock::Guard lock_guard(_lock);
+		_wakeup = _ticks + sleep_time_us;
+	}
 	_time_source.schedule_timeout(Microseconds(sleep_time_us), *this);
 }
 
@@ -108,29 +104,37 @@ void Alarm_timeout_scheduler::handle_timeout(Duration duration)
 Alarm_timeout_scheduler::Alarm_timeout_scheduler(Time_source  &time_source,
                                                  Microseconds  min_handle_period)
 :
-	_time_source(time_source)
-{
-	Alarm::Time const deadline         = _now + min_handle_period.value;
-	_min_handle_period.period          = min_handle_period.value;
-	_min_handle_period.deadline        = deadline;
-	_min_handle_period.deadline_period = _now > deadline ?
-	                                     !_now_period : _now_period;
-}
+	_time_source(time_source),
+	_min_handle_period(min_handle_period.value),
+	_min_handle_ticks(min_handle_period.value)
+{ }
 
 
 Alarm_timeout_scheduler::~Alarm_timeout_scheduler()
 {
 	Lock::Guard lock_guard(_lock);
-	while (_active_head) {
-		Alarm *next = _active_head->_next;
-		_active_head->_alarm_reset();
-		_active_head = next;
-	}
+
+	auto reset_list = [&] (Alarm *&head) {
+		while (head) {
+			Alarm *next = head->_next;
+			head->_alarm_reset();
+			head = next;
+		}
+	};
+	for (unsigned level = 0; level < LEVELS; level++) {
+		for (unsigned slot = 0; slot < SLOTS; slot++) {
+			reset_list(_wheel[level][slot]); } }
+
+	reset_list(_expired_head);
 }
 
 
 void Alarm_timeout_scheduler::_enable()
 {
+	{
+		Lock::Guard lock_guard(_lock);
+		_wakeup = _ticks;
+	}
 	_time_source.schedule_timeout(Microseconds(0), *this);
 }
 
@@ -166,6 +170,19 @@ void Alarm_timeout_scheduler::_schedule_periodic(Timeout      &timeout,
 }
 
 
+bool Alarm_timeout_scheduler::_alarm_head_timeout(const Alarm * alarm)
+{
+	Lock::Guard lock_guard(_lock);
+
+	if (!alarm->_active || alarm->_deadline >= _wakeup) {
+		return false; }
+
+	/* the time source gets reprogrammed by the caller */
+	_wakeup = _ticks;
+	return true;
+}
+
+
 void Alarm_timeout_scheduler::_alarm_unsynchronized_enqueue(Alarm *alarm)
 {
 	if (alarm->_active) {
@@ -175,60 +192,101 @@ void Alarm_timeout_scheduler::_alarm_unsynchronized_enqueue(Alarm *alarm)
 
 	alarm->_active++;
 
-	/* if active alarm list is empty add first element */
-	if (!_active_head) {
-		alarm->_next = 0;
-		_active_head = alarm;
-		return;
+	Alarm **list = &_expired_head;
+	if (alarm->_deadline > _wheel_ticks) {
+
+		/*
+		 * Select the lowest level whose range covers the distance to the
+		 * deadline. Alarms beyond the range of the wheel are parked in the
+		 * last slot of the highest level.
+		 */
+		Tick     const range = (Tick)1 << _shift(LEVELS);
+		Tick     const delta = alarm->_deadline - _wheel_ticks;
+		Tick     const tick  = delta < range ? alarm->_deadline
+		                                     : _wheel_ticks + range - 1;
+		unsigned       level = 0;
+		while (level < LEVELS - 1 && delta >> _shift(level + 1)) {
+			level++; }
+
+		unsigned const slot = (tick >> _shift(level)) & (SLOTS - 1);
+		_occupied[level] |= (uint64_t)1 << slot;
+		list = &_wheel[level][slot];
 	}
 
-	/* if deadline is smaller than any other deadline, put it on the head */
-	if (alarm->_raw.is_pending_at(_active_head->_raw.deadline, _active_head->_raw.deadline_period)) {
-		alarm->_next = _active_head;
-		_active_head = alarm;
-		return;
-	}
+	/* insert at the head of the list */
+	alarm->_list = list;
+	alarm->_prev = nullptr;
+	alarm->_next = *list;
+	if (alarm->_next) {
+		alarm->_next->_prev = alarm; }
+	*list = alarm;
+}
 
-	/* find list element with a higher deadline */
-	Alarm *curr = _active_head;
-	while (curr->_next &&
-	       curr->_next->_raw.is_pending_at(alarm->_raw.deadline, alarm->_raw.deadline_period))
-	{
-		curr = curr->_next;
-	}
 
-	/* if end of list is reached, append new element */
-	if (curr->_next == 0) {
-		curr->_next = alarm;
-		return;
+void Alarm_timeout_scheduler::_alarm_unsynchronized_dequeue(Alarm *alarm)
+{
+	/* alarm is not enqueued */
+	if (!alarm->_list) return;
+
+	if (alarm->_prev) {
+		alarm->_prev->_next = alarm->_next; }
+	else {
+		*alarm->_list = alarm->_next; }
+
+	if (alarm->_next) {
+		alarm->_next->_prev = alarm->_prev; }
+
+	/* update the occupation bitmap if a wheel slot got empty */
+	if (!*alarm->_list && alarm->_list != &_expired_head) {
+		unsigned const idx = alarm->_list - &_wheel[0][0];
+		_occupied[idx / SLOTS] &= ~((uint64_t)1 << (idx % SLOTS));
 	}
+	alarm->_alarm_reset();
+}
+
 
-	/* insert element in middle of list */
-	alarm->_next = curr->_next;
-	curr->_next  = alarm;
+void Alarm_timeout_scheduler::_alarm_unsynchronized_cascade(unsigned level,
+                                                            unsigned slot)
+{
+	Alarm *curr = _wheel[level][slot];
+	_wheel[level][slot] = nullptr;
+	_occupied[level] &= ~((uint64_t)1 << slot);
+
+	while (curr) {
+		Alarm *next = curr->_next;
+		curr->_active--;
+		curr->_list = nullptr;
+		_alarm_unsynchronized_enqueue(curr);
+		curr = next;
+	}
 }
 
 
-void Alarm_timeout_scheduler::_alarm_unsynchronized_dequeue(Alarm *alarm)
+void Alarm_timeout_scheduler::_alarm_unsynchronized_advance()
 {
-	if (!_active_head) return;
+	Tick const from = _wheel_ticks;
+	_wheel_ticks = _ticks;
 
-	if (_active_head == alarm) {
-		_active_head = alarm->_next;
-		alarm->_alarm_reset();
-		return;
-	}
+	/*
+	 * Visit the slots passed by since the last advance from the lowest to
+	 * the highest level. The alarms of a visited slot either expire or get
+	 * re-inserted into a lower level, which is already up to date.
+	 */
+	for (unsigned level = 0; level < LEVELS; level++) {
 
-	/* find predecessor in alarm queue */
-	Alarm *curr;
-	for (curr = _active_head; curr && (curr->_next != alarm); curr = curr->_next);
+		Tick const first = (from   >> _shift(level)) + 1;
+		Tick const last  = (_ticks >> _shift(level));
+		if (last < first) {
+			break; }
 
-	/* alarm is not enqueued */
-	if (!curr) return;
+		Tick const num = min(last - first + 1, (Tick)SLOTS);
+		for (Tick i = 0; i < num && _occupied[level]; i++) {
 
-	/* remove alarm from alarm queue */
-	curr->_next = alarm->_next;
-	alarm->_alarm_reset();
+			unsigned const slot = (first + i) & (SLOTS - 1);
+			if (_occupied[level] & ((uint64_t)1 << slot)) {
+				_alarm_unsynchronized_cascade(level, slot); }
+		}
+	}
 }
 
 
@@ -236,12 +294,14 @@ Timeout::Alarm *Alarm_timeout_scheduler::_alarm_get_pending_alarm()
 {
 	Lock::Guard lock_guard(_lock);
 
-	if (!_active_head || !_active_head->_raw.is_pending_at(_now, _now_period)) {
+	if (!_expired_head) {
 		return nullptr; }
 
 	/* remove alarm from head of the list */
-	Alarm *pending_alarm = _active_head;
-	_active_head = _active_head->_next;
+	Alarm *pending_alarm = _expired_head;
+	_expired_head = _expired_head->_next;
+	if (_expired_head) {
+		_expired_head->_prev = nullptr; }
 
 	/*
 	 * Acquire dispatch lock to defer destruction until the call of '_on_alarm'
@@ -251,6 +311,7 @@ Timeout::Alarm *Alarm_timeout_scheduler::_alarm_get_pending_alarm()
 
 	/* reset alarm object */
 	pending_alarm->_next = nullptr;
+	pending_alarm->_list = nullptr;
 	pending_alarm->_active--;
 
 	return pending_alarm;
@@ -259,34 +320,37 @@ Timeout::Alarm *Alarm_timeout_scheduler::_alarm_get_pending_alarm()
 
 void Alarm_timeout_scheduler::_alarm_handle(Alarm::Time curr_time)
 {
-	/*
-	 * Raise the time counter and if it wraps, update also in which
-	 * period of the time counter we are.
-	 */
-	if (_now > curr_time) {
-		_now_period = !_now_period;
-	}
-	_now = curr_time;
+	{
+		Lock::Guard lock_guard(_lock);
 
-	if (!_min_handle_period.is_pending_at(_now, _now_period)) {
-		return;
+		/*
+		 * Raise the monotonic time by the time passed since the last call,
+		 * which also covers a wrap of the time counter.
+		 */
+		_ticks += (Alarm::Time)(curr_time - _now);
+		_now    = curr_time;
+
+		if (_ticks < _min_handle_ticks) {
+			return; }
+
+		_min_handle_ticks = _ticks + _min_handle_period;
+
+		_alarm_unsynchronized_advance();
 	}
-	Alarm::Time const deadline         = _now + _min_handle_period.period;
-	_min_handle_period.deadline        = deadline;
-	_min_handle_period.deadline_period = _now > deadline ?
-	                                     !_now_period : _now_period;
 
 	/*
-	 * Dequeue all pending alarms before starting to re-schedule. Otherwise,
-	 * a long-lasting alarm that has a deadline in the next now_period might
-	 * get scheduled as head of this now_period falsely because the code
-	 * thinks that it belongs to the last now_period.
+	 * Collect all expired alarms first, keeping their order. The loop below
+	 * then dispatches the collected alarms one by one and re-enqueues each
+	 * periodic alarm right after its dispatch. An alarm that gets scheduled
+	 * while the collected alarms are dispatched is not handled before the
+	 * next call.
 	 */
+	Alarm **tail = &_pending_head;
 	while (Alarm *curr = _alarm_get_pending_alarm()) {
 
-		/* enqueue alarm into list of pending alarms */
-		curr->_next = _pending_head;
-		_pending_head = curr;
+		/* append alarm to the list of pending alarms */
+		*tail = curr;
+		tail  = &curr->_next;
 	}
 	while (Alarm *curr = _pending_head) {
 
@@ -296,41 +360,16 @@ void Alarm_timeout_scheduler::_alarm_handle(Alarm::Time curr_time)
 
 		unsigned long triggered = 1;
 
-		if (curr->_raw.period) {
-			Alarm::Time deadline = curr->_raw.deadline;
-
-			/* schedule next event */
-			if (deadline == 0)
-				 deadline = curr_time;
-
-			triggered += (curr_time - deadline) / curr->_raw.period;
-		}
+		if (curr->_period && _ticks > curr->_deadline) {
+			triggered += (_ticks - curr->_deadline) / curr->_period; }
 
 		/* do not reschedule if alarm function returns 0 */
 		bool reschedule = curr->_on_alarm(triggered);
 
 		if (reschedule) {
 
-			/*
-			 * At this point, the alarm deadline normally is somewhere near
-			 * the current time but If the alarm had no deadline by now,
-			 * initialize it with the current time.
-			 */
-			if (curr->_raw.deadline == 0) {
-				curr->_raw.deadline        = _now;
-				curr->_raw.deadline_period = _now_period;
-			}
-			/*
-			 * Raise the deadline value by one period of the alarm and
-			 * if the deadline value wraps thereby, update also in which
-			 * period it is located.
-			 */
-			Alarm::Time const deadline = curr->_raw.deadline +
-			                             triggered * curr->_raw.period;
-			if (curr->_raw.deadline > deadline) {
-				curr->_raw.deadline_period = !curr->_raw.deadline_period;
-			}
-			curr->_raw.deadline = deadline;
+			/* raise the deadline value by the triggered periods */
+			curr->_deadline += (Tick)triggered * curr->_period;
 
 			/* synchronize enqueue operation */
 			Lock::Guard lock_guard(_lock);
@@ -353,8 +392,7 @@ void Alarm_timeout_scheduler::_alarm_setup_alarm(Alarm &alarm, Alarm::Time perio
 	if (alarm._active)
 		_alarm_unsynchronized_dequeue(&alarm);
 
-	Alarm::Time deadline = _now + first_duration;
-	alarm._alarm_assign(period, deadline, _now > deadline ? !_now_period : _now_period, this);
+	alarm._alarm_assign(period, _ticks + first_duration, this);
 
 	_alarm_unsynchronized_enqueue(&alarm);
 }
@@ -412,13 +450,42 @@ bool Alarm_timeout_scheduler::_alarm_next_deadline(Alarm::Time *deadline)
 {
 	Lock::Guard alarm_list_lock_guard(_lock);
 
-	if (!_active_head) return false;
+	/* determine the earliest tick at which the wheel must be advanced */
+	bool  found = false;
+	Tick  next  = 0;
+	if (_expired_head) {
+		found = true;
+		next  = _wheel_ticks;
+	}
+	for (unsigned level = 0; level < LEVELS; level++) {
+
+		uint64_t const occupied = _occupied[level];
+		if (!occupied) {
+			continue; }
+
+		/* find first occupied slot after the current one */
+		Tick     const base  = _wheel_ticks >> _shift(level);
+		unsigned const start = (base + 1) & (SLOTS - 1);
+		uint64_t const rot   = start ? (occupied >> start) |
+		                               (occupied << (SLOTS - start))
+		                             : occupied;
+
+		Tick const slot_start = (base + 1 + __builtin_ctzll(rot)) << _shift(level);
+		if (!found || slot_start < next) {
+			found = true;
+			next  = slot_start;
+		}
+	}
+	if (!found) {
+		return false; }
 
-	if (deadline)
-		*deadline = _active_head->_raw.deadline;
+	if (next < _min_handle_ticks) {
+		next = _min_handle_ticks; }
 
-	if (*deadline < _min_handle_period.deadline) {
-		*deadline = _min_handle_period.deadline;
+	if (deadline) {
+		Tick const delta = next > _ticks ? next - _ticks : 0;
+		*deadline = _now + (Alarm::Time)min(delta, (Tick)~0UL);
 	}
+
 	return true;
 }
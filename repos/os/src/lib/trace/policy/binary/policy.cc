@@ -0,0 +1,58 @@
+#include <util/string.h>
+#include <trace/policy.h>
+#include <trace/timestamp.h>
+#include <trace/binary_event.h>
+
+using namespace Genode;
+
+typedef Trace::Binary_event Event;
+
+static size_t event(char *dst, Event::Type type, char const *name, unsigned arg)
+{
+	Event &event = *(Event *)dst;
+
+	event.timestamp = Trace::timestamp();
+	event.type      = type;
+	event.arg       = arg;
+
+	size_t len = 0;
+	for (; name && name[len] && len < Event::MAX_NAME_LEN; len++)
+		event.name[len] = name[len];
+
+	return sizeof(Event) + len;
+}
+
+size_t max_event_size()
+{
+	return sizeof(Event) + Event::MAX_NAME_LEN;
+}
+
+size_t rpc_call(char *dst, char const *rpc_name, Msgbuf_base const &)
+{
+	return event(dst, Event::RPC_CALL, rpc_name, 0);
+}
+
+size_t rpc_returned(char *dst, char const *rpc_name, Msgbuf_base const &)
+{
+	return event(dst, Event::RPC_RETURNED, rpc_name, 0);
+}
+
+size_t rpc_dispatch(char *dst, char const *rpc_name)
+{
+	return event(dst, Event::RPC_DISPATCH, rpc_name, 0);
+}
+
+size_t rpc_reply(char *dst, char const *rpc_name)
+{
+	return event(dst, Event::RPC_REPLY, rpc_name, 0);
+}
+
+size_t signal_submit(char *dst, unsigned const num)
+{
+	return event(dst, Event::SIGNAL_SUBMIT, nullptr, num);
+}
+
+size_t signal_receive(char *dst, Signal_context const &, unsigned num)
+{
+	return event(dst, Event::SIGNAL_RECEIVED, nullptr, num);
+}
@@ -18,6 +18,7 @@
 
 /* Genode includes */
 #include <base/allocator_avl.h>
+#include <base/attached_dataspace.h>
 #include <base/id_space.h>
 #include <file_system_session/connection.h>
 
@@ -54,6 +55,218 @@ class Vfs::Fs_file_system : public File_system
 		Handle_space _handle_space { };
 		Handle_space _watch_handle_space { };
 
+		/*
+		 * The content of a file requested via 'dataspace' is read into a RAM
+		 * dataspace. The dataspace is shared by all requests for the same
+		 * unchanged file and kept after its release, so that a later request
+		 * is served without reading the file again. A file is considered as
+		 * unchanged if its inode and size match and the file system has not
+		 * reported a change of the watched file. Dataspaces of files that are
+		 * written, truncated, synced, unlinked, or renamed via this file
+		 * system are not handed out anymore. A file that is opened for
+		 * writing or cannot be watched is not cached at all. Released
+		 * dataspaces are evicted in least-recently-used order once their
+		 * accumulated size exceeds the limit.
+		 */
+		struct Cached_dataspace : Genode::List<Cached_dataspace>::Element
+		{
+			Absolute_path                    const path;
+			unsigned long                    const inode;
+			file_size                        const size;
+			Genode::Ram_dataspace_capability const ds;
+			::File_system::Watch_handle      const watch;
+
+			unsigned      users    { 1 };
+			bool          stale    { false };
+			unsigned long last_use { 0 };
+
+			Cached_dataspace(Absolute_path const &path, unsigned long inode,
+			                 file_size size, Genode::Ram_dataspace_capability ds,
+			                 ::File_system::Watch_handle watch)
+			: path(path), inode(inode), size(size), ds(ds), watch(watch) { }
+		};
+
+		Genode::List<Cached_dataspace> _ds_cache { };
+
+		file_size     const _ds_cache_limit;
+		unsigned long       _ds_cache_time { 0 };
+
+		void _free_cached_dataspace(Cached_dataspace &entry)
+		{
+			_ds_cache.remove(&entry);
+			if (entry.watch.value != ~0UL)
+				_fs.close(entry.watch);
+			_env.env().ram().free(entry.ds);
+			destroy(_env.alloc(), &entry);
+		}
+
+		void _evict_cached_dataspaces()
+		{
+			for (Cached_dataspace *e = _ds_cache.first(), *next; e; e = next) {
+				next = e->next();
+				if (e->stale && !e->users)
+					_free_cached_dataspace(*e);
+			}
+
+			for (;;) {
+				file_size          unused = 0;
+				Cached_dataspace  *lru    = nullptr;
+
+				for (Cached_dataspace *e = _ds_cache.first(); e; e = e->next()) {
+					if (e->users)
+						continue;
+
+					unused += e->size;
+					if (!lru || e->last_use < lru->last_use)
+						lru = e;
+				}
+
+				if (!lru || unused <= _ds_cache_limit)
+					return;
+
+				_free_cached_dataspace(*lru);
+			}
+		}
+
+		/**
+		 * Mark dataspaces of the file at 'path' as outdated
+		 */
+		void _invalidate_cached_dataspaces(char const *path)
+		{
+			Absolute_path const abs_path(path);
+
+			for (Cached_dataspace *e = _ds_cache.first(); e; e = e->next())
+				if (e->path == abs_path)
+					e->stale = true;
+
+			_evict_cached_dataspaces();
+		}
+
+		/**
+		 * Read content of file into a new RAM dataspace
+		 *
+		 * \throw Out_of_ram
+		 * \throw Out_of_caps
+		 * \throw ::File_system::Lookup_failed
+		 */
+		Genode::Ram_dataspace_capability _read_dataspace(Absolute_path const &path,
+		                                                 file_size size)
+		{
+			Absolute_path dir_path(path);
+			dir_path.strip_last_element();
+
+			Absolute_path file_name(path);
+			file_name.keep_only_last_element();
+
+			Genode::Ram_dataspace_capability const ds = _env.env().ram().alloc(size);
+
+			file_size offset = 0;
+			try {
+				::File_system::Dir_handle dir = _fs.dir(dir_path.base(), false);
+				Fs_handle_guard dir_guard(*this, _fs, dir, _handle_space, _fs,
+				                          _env.io_handler());
+
+				::File_system::File_handle file =
+					_fs.file(dir, file_name.base() + 1, ::File_system::READ_ONLY, false);
+				Fs_handle_guard file_guard(*this, _fs, file, _handle_space, _fs,
+				                           _env.io_handler());
+
+				Genode::Attached_dataspace content(_env.env().rm(), ds);
+
+				while (offset < size) {
+					file_size const n = _read(file_guard, content.local_addr<char>() + offset,
+					                          size - offset, offset);
+					if (!n)
+						break;
+
+					offset += n;
+				}
+			}
+			catch (...) {
+				_env.env().ram().free(ds);
+				throw;
+			}
+
+			/* file was truncated while reading */
+			if (offset < size) {
+				_env.env().ram().free(ds);
+				throw ::File_system::Lookup_failed();
+			}
+
+			return ds;
+		}
+
+		/**
+		 * Determine the layout of a vectored packet
+		 *
+		 * \param max_size  maximum packet size
+		 * \param size      resulting packet size
+		 *
+		 * \return number of extents that fit into the packet
+		 *
+		 * The packet content starts with the extent table followed by the
+		 * payload of the extents. The last extent may be clipped.
+		 */
+		static unsigned _extent_layout(Io_extent const *extents, unsigned num,
+		                               file_size max_size, file_size &size)
+		{
+			enum { ENTRY_SIZE = sizeof(::File_system::Extent) };
+
+			unsigned  count = 0;
+			file_size data  = 0;
+
+			for (; count < num; count++) {
+
+				file_size const table = (count + 1)*ENTRY_SIZE;
+
+				/* no room for the payload of another extent */
+				if (table + data >= max_size)
+					break;
+
+				file_size const avail = max_size - table - data;
+
+				data += min(extents[count].count, avail);
+
+				if (extents[count].count >= avail) {
+					count++;
+					break;
+				}
+			}
+
+			size = count*ENTRY_SIZE + data;
+			return count;
+		}
+
+		/**
+		 * Write extent table to the content of a vectored packet
+		 *
+		 * The payload area of each extent is passed to 'fn'.
+		 *
+		 * \return total number of payload bytes
+		 */
+		template <typename FN>
+		static file_size _fill_extent_table(char *content, Io_extent const *extents,
+		                                    unsigned count, file_size size,
+		                                    FN const &fn)
+		{
+			::File_system::Extent * const table = (::File_system::Extent *)content;
+
+			file_size offset = count*sizeof(::File_system::Extent);
+
+			for (unsigned i = 0; i < count; i++) {
+
+				file_size const length = min(extents[i].count, size - offset);
+
+				table[i] = ::File_system::Extent { extents[i].seek,
+				                                   (Genode::size_t)offset,
+				                                   (Genode::size_t)length };
+
+				fn(i, content + offset, length);
+				offset += length;
+			}
+			return offset - count*sizeof(::File_system::Extent);
+		}
+
 		struct Handle_state
 		{
 			enum class Read_ready_state { IDLE, PENDING, READY };
@@ -65,6 +278,9 @@ class Vfs::Fs_file_system : public File_system
 
 			::File_system::Packet_descriptor queued_read_packet { };
 			::File_system::Packet_descriptor queued_sync_packet { };
+
+			/* number of extents of a queued 'READV' packet */
+			unsigned queued_readv_count = 0;
 		};
 
 		struct Fs_vfs_handle : Vfs_handle,
@@ -74,6 +290,7 @@ class Vfs::Fs_file_system : public File_system
 		{
 			using Handle_state::queued_read_state;
 			using Handle_state::queued_read_packet;
+			using Handle_state::queued_readv_count;
 			using Handle_state::queued_sync_packet;
 			using Handle_state::queued_sync_state;
 			using Handle_state::read_ready_state;
@@ -143,6 +360,101 @@ class Vfs::Fs_file_system : public File_system
 				return READ_OK;
 			}
 
+			bool _queue_readv(Io_extent const *extents, unsigned num)
+			{
+				if (queued_read_state != Handle_state::Queued_state::IDLE)
+					return false;
+
+				::File_system::Session::Tx::Source &source = *_fs.tx();
+
+				/* if not ready to submit suggest retry */
+				if (!source.ready_to_submit()) return false;
+
+				file_size size = 0;
+				unsigned const count =
+					_extent_layout(extents, num, source.bulk_buffer_size() / 2, size);
+
+				::File_system::Packet_descriptor p;
+				try {
+					p = source.alloc_packet(size,
+						::File_system::Packet_descriptor::EXTENT_ALIGNMENT);
+				} catch (::File_system::Session::Tx::Source::Packet_alloc_failed) {
+					return false;
+				}
+
+				_fill_extent_table(source.packet_content(p), extents, count, size,
+				                   [] (unsigned, char *, file_size) { });
+
+				::File_system::Packet_descriptor const
+					packet(p, file_handle(),
+					       ::File_system::Packet_descriptor::READV, count, 0);
+
+				read_ready_state   = Handle_state::Read_ready_state::IDLE;
+				queued_read_state  = Handle_state::Queued_state::QUEUED;
+				queued_readv_count = count;
+
+				/* pass packet to server side */
+				source.submit_packet(packet);
+
+				return true;
+			}
+
+			Read_result _complete_readv(Io_extent const *extents, unsigned num,
+			                            file_size &out_count)
+			{
+				if (queued_read_state != Handle_state::Queued_state::ACK)
+					return READ_QUEUED;
+
+				::File_system::Packet_descriptor const
+					packet = queued_read_packet;
+
+				::File_system::Session::Tx::Source &source = *_fs.tx();
+
+				char const * const content = source.packet_content(packet);
+
+				file_size const size       = packet.size();
+				file_size const table_size = queued_readv_count*sizeof(::File_system::Extent);
+
+				::File_system::Extent const * const table =
+					(::File_system::Extent const *)content;
+
+				/*
+				 * The server reported the bytes transferred per extent in the
+				 * extent table, which is located in shared memory. Hence, the
+				 * values are checked against the packet boundaries.
+				 */
+				file_size read_num_bytes = 0;
+				unsigned const count = packet.succeeded()
+				                     ? min(queued_readv_count, num) : 0;
+
+				for (unsigned i = 0; i < count; i++) {
+
+					::File_system::Extent const e = table[i];
+
+					if (e.offset < table_size || e.offset > size
+					 || e.length > size - e.offset)
+						break;
+
+					file_size const n = min((file_size)e.length, extents[i].count);
+
+					memcpy(extents[i].buf, content + e.offset, n);
+					read_num_bytes += n;
+
+					if (n < extents[i].count)
+						break;
+				}
+
+				queued_read_state  = Handle_state::Queued_state::IDLE;
+				queued_read_packet = ::File_system::Packet_descriptor();
+				queued_readv_count = 0;
+
+				out_count = read_num_bytes;
+
+				source.release_packet(packet);
+
+				return READ_OK;
+			}
+
 			Fs_vfs_handle(File_system &fs, Allocator &alloc,
 			              int status_flags, Handle_space &space,
 			              ::File_system::Node_handle node_handle,
@@ -157,6 +469,16 @@ class Vfs::Fs_file_system : public File_system
 			::File_system::File_handle file_handle() const
 			{ return ::File_system::File_handle { id().value }; }
 
+			/**
+			 * Return true if the node is accessible via vectored I/O
+			 */
+			virtual bool vectored() const { return false; }
+
+			/**
+			 * Return path of the file if it is opened for writing
+			 */
+			virtual Absolute_path const *written_path() const { return nullptr; }
+
 			virtual bool queue_read(file_size /* count */)
 			{
 				Genode::error("Fs_vfs_handle::queue_read() called");
@@ -227,6 +549,15 @@ class Vfs::Fs_file_system : public File_system
 		{
 			using Fs_vfs_handle::Fs_vfs_handle;
 
+			Genode::Constructible<Absolute_path> written { };
+
+			bool vectored() const override { return true; }
+
+			Absolute_path const *written_path() const override
+			{
+				return written.constructed() ? &*written : nullptr;
+			}
+
 			bool queue_read(file_size count) override
 			{
 				return _queue_read(count, seek());
@@ -549,12 +880,89 @@ class Vfs::Fs_file_system : public File_system
 			return count;
 		}
 
+		file_size _writev(Fs_vfs_handle &handle,
+		                  Io_extent const *extents, unsigned num)
+		{
+			::File_system::Session::Tx::Source &source = *_fs.tx();
+			using ::File_system::Packet_descriptor;
+
+			if (!source.ready_to_submit())
+				throw Insufficient_buffer();
+
+			file_size size = 0;
+			unsigned const count =
+				_extent_layout(extents, num, source.bulk_buffer_size() / 2, size);
+
+			file_size count_bytes = 0;
+
+			try {
+				Packet_descriptor packet_in(source.alloc_packet(size,
+				                                Packet_descriptor::EXTENT_ALIGNMENT),
+				                            handle.file_handle(),
+				                            Packet_descriptor::WRITEV,
+				                            count, 0);
+
+				count_bytes = _fill_extent_table(source.packet_content(packet_in),
+				                                 extents, count, size,
+					[&] (unsigned i, char *dst, file_size length) {
+						memcpy(dst, extents[i].buf, length); });
+
+				/* pass packet to server side */
+				source.submit_packet(packet_in);
+			} catch (::File_system::Session::Tx::Source::Packet_alloc_failed) {
+				throw Insufficient_buffer();
+			} catch (...) {
+				Genode::error("unhandled exception");
+				return 0;
+			}
+			return count_bytes;
+		}
+
 		void _ready_to_submit()
 		{
 			/* notify anyone who might have failed on write() ready_to_submit */
 			_post_signal_hook.arm_io_event(nullptr);
 		}
 
+		/**
+		 * Mark dataspaces of the file written via 'handle' as outdated
+		 */
+		void _invalidate_cached_dataspaces(Fs_vfs_handle const &handle)
+		{
+			if (Absolute_path const *path = handle.written_path())
+				_invalidate_cached_dataspaces(path->base());
+		}
+
+		/**
+		 * Return true if the file at 'path' is opened for writing
+		 */
+		bool _opened_for_writing(Absolute_path const &path) const
+		{
+			bool result = false;
+			_handle_space.for_each<Fs_vfs_handle const>([&] (Fs_vfs_handle const &handle) {
+				Absolute_path const *written = handle.written_path();
+				if (written && *written == path)
+					result = true; });
+
+			return result;
+		}
+
+		/**
+		 * Mark cached dataspace as outdated on a change of its file
+		 *
+		 * \return true if 'watch' refers to a cached dataspace
+		 */
+		bool _cached_dataspace_changed(unsigned long watch)
+		{
+			for (Cached_dataspace *e = _ds_cache.first(); e; e = e->next())
+				if (e->watch.value == watch) {
+					e->stale = true;
+					return true;
+				}
+
+			return false;
+		}
+
 		void _handle_ack()
 		{
 			::File_system::Session::Tx::Source &source = *_fs.tx();
@@ -578,12 +986,14 @@ class Vfs::Fs_file_system : public File_system
 						break;
 
 					case Packet_descriptor::READ:
+					case Packet_descriptor::READV:
 						handle.queued_read_packet = packet;
 						handle.queued_read_state  = Handle_state::Queued_state::ACK;
 						_post_signal_hook.arm_io_event(handle.context);
 						break;
 
 					case Packet_descriptor::WRITE:
+					case Packet_descriptor::WRITEV:
 						/*
 						 * Notify anyone who might have failed on
 						 * 'alloc_packet()'
@@ -603,6 +1013,10 @@ class Vfs::Fs_file_system : public File_system
 					}
 				};
 
+				if (packet.operation() == Packet_descriptor::CONTENT_CHANGED
+				 && _cached_dataspace_changed(packet.handle().value))
+					continue;
+
 				try {
 					if (packet.operation() == Packet_descriptor::CONTENT_CHANGED) {
 						_watch_handle_space.apply<Fs_vfs_watch_handle>(id, [&] (Fs_vfs_watch_handle &handle) {
@@ -615,7 +1029,8 @@ class Vfs::Fs_file_system : public File_system
 				catch (Handle_space::Unknown_id) {
 					Genode::warning("ack for unknown VFS handle"); }
 
-				if (packet.operation() == Packet_descriptor::WRITE) {
+				if (packet.operation() == Packet_descriptor::WRITE
+				 || packet.operation() == Packet_descriptor::WRITEV) {
 					Lock::Guard guard(_lock);
 					source.release_packet(packet);
 				}
@@ -638,23 +1053,111 @@ class Vfs::Fs_file_system : public File_system
 			_fs(_env.env(), _fs_packet_alloc,
 			    _label.string(), _root.string(),
 			    config.attribute_value("writeable", true),
-			    ::File_system::DEFAULT_TX_BUF_SIZE)
+			    ::File_system::DEFAULT_TX_BUF_SIZE),
+			_ds_cache_limit(config.attribute_value("dataspace_cache",
+			                                       Genode::Number_of_bytes(1024*1024)))
 		{
 			_fs.sigh_ack_avail(_ack_handler);
 			_fs.sigh_ready_to_submit(_ready_handler);
 		}
 
+		~Fs_file_system()
+		{
+			while (Cached_dataspace *e = _ds_cache.first())
+				_free_cached_dataspace(*e);
+		}
+
 		/*********************************
 		 ** Directory-service interface **
 		 *********************************/
 
-		Dataspace_capability dataspace(char const *) override
+		Dataspace_capability dataspace(char const *path) override
 		{
-			/* cannot be implemented without blocking */
+			Absolute_path const abs_path(path);
+
+			::File_system::Status status;
+
+			try {
+				::File_system::Node_handle node = _fs.node(abs_path.base());
+				Fs_handle_guard node_guard(*this, _fs, node, _handle_space,
+				                           _fs, _env.io_handler());
+				status = _fs.status(node);
+			}
+			catch (...) { return Dataspace_capability(); }
+
+			if (status.directory() || status.symlink() || status.size == 0)
+				return Dataspace_capability();
+
+			for (Cached_dataspace *e = _ds_cache.first(); e; e = e->next()) {
+
+				if (e->stale || !(e->path == abs_path))
+					continue;
+
+				if (e->inode == status.inode && e->size == status.size) {
+					e->users++;
+					e->last_use = ++_ds_cache_time;
+					return e->ds;
+				}
+
+				/* file was modified since the dataspace was obtained */
+				e->stale = true;
+			}
+
+			/*
+			 * Changes of the file by other clients of the file system are
+			 * detected via a watch. The watch is installed before reading
+			 * the content so that no change gets lost.
+			 */
+			::File_system::Watch_handle watch { ~0UL };
+			if (!_opened_for_writing(abs_path)) {
+				try { watch = _fs.watch(abs_path.base()); }
+				catch (...) { }
+			}
+
+			/*
+			 * The file content is read synchronously, which blocks the
+			 * caller until all packets are acknowledged.
+			 */
+			try {
+				Genode::Ram_dataspace_capability const ds =
+					_read_dataspace(abs_path, status.size);
+
+				Cached_dataspace &entry = *new (_env.alloc())
+					Cached_dataspace(abs_path, status.inode, status.size, ds,
+					                 watch);
+
+				/* without watch, the dataspace is freed on its release */
+				entry.stale    = (watch.value == ~0UL);
+				entry.last_use = ++_ds_cache_time;
+				_ds_cache.insert(&entry);
+				_evict_cached_dataspaces();
+
+				return ds;
+			}
+			catch (...) { }
+
+			if (watch.value != ~0UL)
+				_fs.close(watch);
+
+			_evict_cached_dataspaces();
 			return Dataspace_capability();
 		}
 
-		void release(char const *, Dataspace_capability) override { }
+		void release(char const *, Dataspace_capability ds) override
+		{
+			/*
+			 * The release may refer to a dataspace of another file system if
+			 * this file system is part of a directory.
+			 */
+			for (Cached_dataspace *e = _ds_cache.first(); e; e = e->next()) {
+				if (!(e->ds == ds) || !e->users)
+					continue;
+
+				e->users--;
+				_evict_cached_dataspaces();
+				return;
+			}
+		}
 
 		Stat_result stat(char const *path, Stat &out) override
 		{
@@ -696,6 +1199,8 @@ class Vfs::Fs_file_system : public File_system
 			Absolute_path file_name(path);
 			file_name.keep_only_last_element();
 
+			_invalidate_cached_dataspaces(path);
+
 			try {
 				::File_system::Dir_handle dir = _fs.dir(dir_path.base(), false);
 				Fs_handle_guard dir_guard(*this, _fs, dir, _handle_space, _fs,
@@ -730,6 +1235,9 @@ class Vfs::Fs_file_system : public File_system
 			Absolute_path to_file_name(to_path);
 			to_file_name.keep_only_last_element();
 
+			_invalidate_cached_dataspaces(from_path);
+			_invalidate_cached_dataspaces(to_path);
+
 			try {
 				::File_system::Dir_handle from_dir =
 					_fs.dir(from_dir_path.base(), false);
@@ -814,6 +1322,10 @@ class Vfs::Fs_file_system : public File_system
 
 			bool const create = vfs_mode & OPEN_MODE_CREATE;
 
+			if (create || mode == ::File_system::WRITE_ONLY
+			           || mode == ::File_system::READ_WRITE)
+				_invalidate_cached_dataspaces(path);
+
 			try {
 				::File_system::Dir_handle dir = _fs.dir(dir_path.base(), false);
 				Fs_handle_guard dir_guard(*this, _fs, dir, _handle_space, _fs,
@@ -823,9 +1335,15 @@ class Vfs::Fs_file_system : public File_system
 				                                           file_name.base() + 1,
 				                                           mode, create);
 
-				*out_handle = new (alloc)
+				Fs_vfs_file_handle &handle = *new (alloc)
 					Fs_vfs_file_handle(*this, alloc, vfs_mode, _handle_space,
 					                   file, _fs, _env.io_handler());
+
+				if (mode == ::File_system::WRITE_ONLY
+				 || mode == ::File_system::READ_WRITE)
+					handle.written.construct(path);
+
+				*out_handle = &handle;
 			}
 			catch (::File_system::Lookup_failed)       { return OPEN_ERR_UNACCESSIBLE;  }
 			catch (::File_system::Permission_denied)   { return OPEN_ERR_NO_PERM;       }
@@ -976,6 +1494,8 @@ class Vfs::Fs_file_system : public File_system
 
 			Fs_vfs_handle &handle = static_cast<Fs_vfs_handle &>(*vfs_handle);
 
+			_invalidate_cached_dataspaces(handle);
+
 			out_count = _write(handle, buf, buf_size, handle.seek());
 
 			return WRITE_OK;
@@ -1002,6 +1522,49 @@ class Vfs::Fs_file_system : public File_system
 			return handle->complete_read(dst, count, out_count);
 		}
 
+		bool vectored_io(Vfs_handle *vfs_handle) override
+		{
+			Fs_vfs_handle const *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+
+			return handle->vectored();
+		}
+
+		Write_result writev(Vfs_handle *vfs_handle, Io_extent const *extents,
+		                    unsigned num, file_size &out_count) override
+		{
+			Lock::Guard guard(_lock);
+
+			Fs_vfs_handle &handle = static_cast<Fs_vfs_handle &>(*vfs_handle);
+
+			_invalidate_cached_dataspaces(handle);
+
+			out_count = _writev(handle, extents, num);
+
+			return WRITE_OK;
+		}
+
+		bool queue_readv(Vfs_handle *vfs_handle, Io_extent const *extents,
+		                 unsigned num) override
+		{
+			Lock::Guard guard(_lock);
+
+			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+
+			return handle->_queue_readv(extents, num);
+		}
+
+		Read_result complete_readv(Vfs_handle *vfs_handle, Io_extent const *extents,
+		                           unsigned num, file_size &out_count) override
+		{
+			Lock::Guard guard(_lock);
+
+			out_count = 0;
+
+			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+
+			return handle->_complete_readv(extents, num, out_count);
+		}
+
 		bool read_ready(Vfs_handle *vfs_handle) override
 		{
 			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
@@ -1042,6 +1605,8 @@ class Vfs::Fs_file_system : public File_system
 		{
 			Fs_vfs_handle const *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
 
+			_invalidate_cached_dataspaces(*handle);
+
 			try {
 				_fs.truncate(handle->file_handle(), len);
 			}
@@ -1059,6 +1624,8 @@ class Vfs::Fs_file_system : public File_system
 
 			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
 
+			_invalidate_cached_dataspaces(*handle);
+
 			return handle->queue_sync();
 		}
 
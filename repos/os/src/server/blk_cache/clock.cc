@@ -0,0 +1,95 @@
+/*
+ * \brief  CLOCK cache replacement strategy
+ * \author Genode Labs
+ * \date   2018-12-07
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include "clock.h"
+#include "driver.h"
+
+typedef Driver<Clock_policy>::Chunk_level_4 Chunk;
+
+static const Clock_policy::Element *hand = nullptr;
+static Clock_policy::Stats          clock_stats;
+
+
+void Clock_policy::_access(const Clock_policy::Element *e)
+{
+	e->_referenced = true;
+
+	if (e->_next) return;
+
+	/* insert new element right before the hand, so it gets passed last */
+	if (!hand) {
+		e->_prev = e->_next = e;
+		hand = e;
+	} else {
+		e->_prev = hand->_prev;
+		e->_next = hand;
+		hand->_prev->_next = e;
+		hand->_prev        = e;
+	}
+	clock_stats.cached++;
+}
+
+
+void Clock_policy::_remove(const Clock_policy::Element *e)
+{
+	if (!e->_next) return;
+
+	if (e->_next == e) {
+		hand = nullptr;
+	} else {
+		e->_prev->_next = e->_next;
+		e->_next->_prev = e->_prev;
+		if (hand == e) hand = e->_next;
+	}
+	e->_prev = e->_next = nullptr;
+	clock_stats.cached--;
+}
+
+
+void Clock_policy::read(const Clock_policy::Element  *e) {
+	_access(e); }
+
+
+void Clock_policy::write(const Clock_policy::Element *e) {
+	_access(e); }
+
+
+Clock_policy::Stats const &Clock_policy::stats() { return clock_stats; }
+
+
+void Clock_policy::flush(Cache::size_t size)
+{
+	Cache::size_t s = 0;
+	while (hand && ((size == 0) || (s < size))) {
+
+		/* give referenced chunks a second chance unless flushing everything */
+		if (size && hand->_referenced) {
+			hand->_referenced = false;
+			hand = hand->_next;
+			continue;
+		}
+
+		Chunk *cb = static_cast<Chunk*>(const_cast<Clock_policy::Element*>(hand));
+		try {
+			/* freeing destructs the chunk, which removes it from the ring */
+			cb->free(Driver<Clock_policy>::CACHE_BLK_SIZE,
+			         cb->base_offset());
+			clock_stats.evictions++;
+			s += sizeof(Chunk);
+		} catch(Chunk::Dirty_chunk &e) {
+			cb->sync(e.size, e.off);
+		}
+	}
+
+	if (s < size) throw Block::Driver::Request_congestion();
+}
@@ -0,0 +1,70 @@
+/*
+ * \brief  CLOCK cache replacement strategy
+ * \author Genode Labs
+ * \date   2018-12-07
+ *
+ * All chunks that contain data are members of a ring. An access merely
+ * sets the reference flag of the chunk. When memory is needed, a clock
+ * hand sweeps over the ring, clears the reference flags it passes, and
+ * evicts the first chunk that was not referenced since the last sweep.
+ * Thereby, all bookkeeping on access and eviction is of constant cost.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+#include "chunk.h"
+
+struct Clock_policy
+{
+	class Element
+	{
+		private:
+
+			friend class Clock_policy;
+
+			/*
+			 * Noncopyable
+			 */
+			Element(Element const &);
+			Element &operator = (Element const &);
+
+			mutable Element const *_prev       = nullptr;
+			mutable Element const *_next       = nullptr;
+			mutable bool           _referenced = false;
+
+		protected:
+
+			~Element() { Clock_policy::_remove(this); }
+
+		public:
+
+			Element() { }
+	};
+
+	struct Stats
+	{
+		Cache::size_t cached    = 0; /* number of chunks in the ring */
+		Cache::size_t evictions = 0;
+	};
+
+	static void read(const Element  *e);
+	static void write(const Element *e);
+	static void flush(Cache::size_t size = 0);
+
+	static Stats const &stats();
+
+	private:
+
+		static void _access(const Element *e);
+		static void _remove(const Element *e);
+};
+
+#endif /* _CLOCK_H_ */
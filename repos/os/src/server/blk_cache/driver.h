@@ -15,6 +15,10 @@
 #include <block_session/connection.h>
 #include <block/component.h>
 #include <os/packet_allocator.h>
+#include <os/reporter.h>
+#include <timer_session/connection.h>
+#include <util/reconstructible.h>
+#include <util/xml_node.h>
 
 #include "chunk.h"
 
@@ -95,11 +99,26 @@ class Driver : public Block::Driver
 		struct Policy : POLICY {
 			static void sync(const typename POLICY::Element *e, char *src); };
 
+		/**
+		 * Counters exported via the statistics report
+		 */
+		struct Stats
+		{
+			Genode::size_t hits              = 0; /* reads served from cache    */
+			Genode::size_t misses            = 0; /* reads that needed backend  */
+			Genode::size_t read_ahead_blocks = 0; /* cache blocks read ahead    */
+			Genode::size_t write_backs       = 0; /* write requests to backend  */
+			Genode::size_t write_back_blocks = 0; /* cache blocks written back  */
+		};
+
 	public:
 
 		enum {
 			SLAB_SZ = Block::Session::TX_QUEUE_SIZE*sizeof(Request),
-			CACHE_BLK_SIZE = 4096
+			CACHE_BLK_SIZE = 4096,
+
+			/* maximum size of a multi-block request to the backend device */
+			MAX_REQUEST_SIZE = 32*CACHE_BLK_SIZE,
 		};
 
 		/**
@@ -126,6 +145,17 @@ class Driver : public Block::Driver
 		Genode::Io_signal_handler<Driver> _source_ack;
 		Genode::Io_signal_handler<Driver> _source_submit;
 		Genode::Io_signal_handler<Driver> _yield;
+		unsigned                   const  _read_ahead;        /* in cache blocks */
+		Block::sector_t                   _read_end = 0;      /* end of last read */
+		Block::Packet_descriptor          _write_back { };    /* pending write    */
+		Block::sector_t                   _write_back_nr  = 0;
+		Genode::size_t                    _write_back_cnt = 0;
+		char                              _write_back_buf[MAX_REQUEST_SIZE];
+		Stats                             _stats { };
+
+		Genode::Constructible<Timer::Connection>  _timer    { };
+		Genode::Constructible<Genode::Reporter>   _reporter { };
+		Genode::Signal_handler<Driver>            _report_handler;
 
 		Driver(Driver const&);            /* singleton pattern */
 		Driver& operator=(Driver const&); /* singleton pattern */
@@ -159,8 +189,8 @@ class Driver : public Block::Driver
 		{
 			try {
 			if (r->cli.operation() == Block::Packet_descriptor::READ)
-				read(r->cli.block_number(), r->cli.block_count(),
-				     r->buffer, r->cli);
+				_read(r->cli.block_number(), r->cli.block_count(),
+				      r->buffer, r->cli);
 			else
 				write(r->cli.block_number(), r->cli.block_count(),
 				      r->buffer, r->cli);
@@ -182,9 +212,7 @@ class Driver : public Block::Driver
 
 				/* when reading, write result into cache */
 				if (p.operation() == Block::Packet_descriptor::READ)
-					_cache.write(_blk.tx()->packet_content(p),
-					             p.block_count() * _blk_sz,
-					             p.block_number() * _blk_sz);
+					_fill_cache(p);
 
 				/* loop through the list of requests, and ack all related */
 				for (Request *r = _r_list.first(), *r_to_handle = r; r;
@@ -201,6 +229,30 @@ class Driver : public Block::Driver
 			}
 		}
 
+		/*
+		 * Write result of read request to the backend device into the cache
+		 *
+		 * All cache blocks of the request were uncached when the request
+		 * was submitted. A cache block that is cached by now got written
+		 * by the client meanwhile. Its content is newer than the data read
+		 * from the device and must not be overwritten.
+		 */
+		void _fill_cache(Block::Packet_descriptor const &p)
+		{
+			char const * const content = _blk.tx()->packet_content(p);
+			Genode::size_t const mod   = _cache_blk_mod();
+
+			for (Genode::size_t i = 0; i < p.block_count(); i += mod) {
+
+				Block::sector_t const nr = p.block_number() + i;
+				if (_cached(nr))
+					continue;
+
+				Genode::size_t const cnt = Genode::min(mod, p.block_count() - i);
+				_cache.write(content + i * _blk_sz, cnt * _blk_sz, nr * _blk_sz);
+			}
+		}
+
 		/*
 		 * Handle that the backend device is ready to receive again
 		 */
@@ -230,6 +282,12 @@ class Driver : public Block::Driver
 					}
 				}
 
+				/*
+				 * Evicted chunks may still wait for being written back, so
+				 * the backend must receive the write before the read
+				 */
+				_submit_write_back();
+
 				/* it doesn't pay, we've to send a request to the device */
 				if (!_blk.tx()->ready_to_submit()) {
 					Genode::warning("not ready_to_submit");
@@ -244,13 +302,41 @@ class Driver : public Block::Driver
 				/* ensure all memory is available before sending the request */
 				_cache.alloc(cnt * _blk_sz, nr * _blk_sz);
 
+				/*
+				 * On sequential reads, extend the request by the following
+				 * cache blocks as long as they are not cached already
+				 */
+				Genode::size_t ra_cnt = 0;
+				if (packet.operation() == Block::Packet_descriptor::READ &&
+				    packet.block_number() == _read_end)
+				{
+					Genode::size_t const max_cnt = _read_ahead * _cache_blk_mod();
+					while (ra_cnt < max_cnt &&
+					       (_blk_sz * (cnt + ra_cnt + _cache_blk_mod()) <= MAX_REQUEST_SIZE) &&
+					       nr + cnt + ra_cnt + _cache_blk_mod() <= _blk_cnt &&
+					       !_cached(nr + cnt + ra_cnt))
+						ra_cnt += _cache_blk_mod();
+				}
+				try {
+					if (ra_cnt) _cache.alloc(ra_cnt * _blk_sz, (nr + cnt) * _blk_sz);
+				} catch(Request_congestion) { ra_cnt = 0; }
+
 				/* construct and send the packet */
+				Block::Packet_descriptor content;
+				try {
+					content = _blk.dma_alloc_packet(_blk_sz*(cnt + ra_cnt));
+				} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+					if (!ra_cnt) throw;
+					ra_cnt  = 0;
+					content = _blk.dma_alloc_packet(_blk_sz*cnt);
+				}
 				p_to_dev =
-					Block::Packet_descriptor(_blk.dma_alloc_packet(_blk_sz*cnt),
+					Block::Packet_descriptor(content,
 					                         Block::Packet_descriptor::READ,
-					                         nr, cnt);
+					                         nr, cnt + ra_cnt);
 				_r_list.insert(new (&_r_slab) Request(p_to_dev, packet, buffer));
 				_blk.tx()->submit_packet(p_to_dev);
+				_stats.read_ahead_blocks += ra_cnt / _cache_blk_mod();
 			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
 				throw Request_congestion();
 			} catch(Genode::Allocator::Out_of_memory) {
@@ -260,6 +346,104 @@ class Driver : public Block::Driver
 			}
 		}
 
+		/*
+		 * Return true if the cache block at block number 'nr' is cached
+		 */
+		bool _cached(Block::sector_t nr) const
+		{
+			try {
+				_cache.stat(CACHE_BLK_SIZE, nr * _blk_sz);
+				return true;
+			} catch(Cache::Chunk_base::Range_incomplete) { }
+			return false;
+		}
+
+		/*
+		 * Append dirty chunk to the pending write to the backend device
+		 *
+		 * Adjacent dirty chunks are coalesced into one write request of at
+		 * most MAX_REQUEST_SIZE bytes. The data of the chunk is copied, so
+		 * the chunk can be freed right after.
+		 *
+		 * \param off   device offset of the chunk
+		 * \param data  content of the chunk
+		 */
+		void _write_back_chunk(Cache::offset_t off, char const *data)
+		{
+			Block::sector_t const nr = off / _blk_sz;
+
+			if (_write_back_cnt &&
+			    (nr != _write_back_nr + _write_back_cnt ||
+			     _blk_sz * (_write_back_cnt + _cache_blk_mod()) > MAX_REQUEST_SIZE))
+			{
+				if (!_blk.tx()->ready_to_submit() || !_alloc_write_back())
+					throw Write_failed(off);
+
+				_submit_write_back();
+			}
+
+			if (!_write_back_cnt)
+				_write_back_nr = nr;
+
+			Genode::memcpy(_write_back_buf + _write_back_cnt * _blk_sz,
+			               data, CACHE_BLK_SIZE);
+			_write_back_cnt += _cache_blk_mod();
+		}
+
+		/*
+		 * Allocate packet that fits the pending write
+		 *
+		 * The chunks of the pending write are collected in
+		 * '_write_back_buf' until the write is submitted. So the packet
+		 * is sized to the actual write instead of MAX_REQUEST_SIZE.
+		 *
+		 * \return false if the packet stream is out of space
+		 */
+		bool _alloc_write_back()
+		{
+			if (_write_back.size())
+				return true;
+
+			try {
+				_write_back = _blk.dma_alloc_packet(_write_back_cnt * _blk_sz);
+			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+				return false; }
+
+			Genode::memcpy(_blk.tx()->packet_content(_write_back),
+			               _write_back_buf, _write_back_cnt * _blk_sz);
+			return true;
+		}
+
+		/*
+		 * Submit the pending write to the backend device if any
+		 */
+		void _submit_write_back()
+		{
+			if (!_write_back_cnt)
+				return;
+
+			/*
+			 * Acknowledgements of the backend device free up space. Their
+			 * handling may submit the pending write already.
+			 */
+			while (_write_back_cnt &&
+			       (!_alloc_write_back() || !_blk.tx()->ready_to_submit()))
+				_env.ep().wait_and_dispatch_one_io_signal();
+
+			if (!_write_back_cnt)
+				return;
+
+			_blk.tx()->submit_packet(
+				Block::Packet_descriptor(_write_back,
+				                         Block::Packet_descriptor::WRITE,
+				                         _write_back_nr, _write_back_cnt));
+			_write_back = Block::Packet_descriptor();
+
+			_stats.write_backs++;
+			_stats.write_back_blocks += _write_back_cnt / _cache_blk_mod();
+			_write_back_cnt = 0;
+		}
+
 		/*
 		 * Synchronize dirty chunks with backend device
 		 */
@@ -282,6 +466,7 @@ class Driver : public Block::Driver
 					_env.ep().wait_and_dispatch_one_io_signal();
 				}
 			}
+			_submit_write_back();
 		}
 
 		/*
@@ -322,17 +507,62 @@ class Driver : public Block::Driver
 
 			/* flush the requested amount of RAM from cache */
 			POLICY::flush(requested_ram_quota);
+			_submit_write_back();
 			_env.parent().yield_response();
 		}
 
+		/*
+		 * Signal handler for updating the statistics report
+		 */
+		void _report()
+		{
+			typename POLICY::Stats const &policy_stats = POLICY::stats();
+
+			Genode::Reporter::Xml_generator xml(*_reporter, [&] () {
+				xml.attribute("cached_bytes", policy_stats.cached * CACHE_BLK_SIZE);
+				xml.attribute("hits",         _stats.hits);
+				xml.attribute("misses",       _stats.misses);
+				xml.attribute("evictions",    policy_stats.evictions);
+				xml.node("read-ahead", [&] () {
+					xml.attribute("blocks", _stats.read_ahead_blocks); });
+				xml.node("write-back", [&] () {
+					xml.attribute("requests", _stats.write_backs);
+					xml.attribute("blocks",   _stats.write_back_blocks);
+				});
+			});
+		}
+
+		/*
+		 * Read from cache and fetch missing data from the backend device
+		 *
+		 * \return true if the request was served from the cache
+		 */
+		bool _read(Block::sector_t           block_number,
+		           Genode::size_t            block_count,
+		           char*                     buffer,
+		           Block::Packet_descriptor &packet)
+		{
+			if (!_ops.supported(Block::Packet_descriptor::READ))
+				throw Io_error();
+
+			if (!_stat(block_number, block_count, buffer, packet))
+				return false;
+
+			_cache.read(buffer, block_count*_blk_sz, block_number*_blk_sz);
+			ack_packet(packet);
+			return true;
+		}
+
 	public:
 
 		/*
 		 * Constructor
 		 *
-		 * \param ep  server entrypoint
+		 * \param env     component environment
+		 * \param heap    allocator for the cache
+		 * \param config  configuration of the component
 		 */
-		Driver(Genode::Env &env, Genode::Heap &heap)
+		Driver(Genode::Env &env, Genode::Heap &heap, Genode::Xml_node config)
 		: Block::Driver(env.ram()),
 		  _env(env),
 		  _r_slab(&heap),
@@ -343,7 +573,9 @@ class Driver : public Block::Driver
 		  _cache(heap, 0),
 		  _source_ack(env.ep(), *this, &Driver::_ack_avail),
 		  _source_submit(env.ep(), *this, &Driver::_ready_to_submit),
-		  _yield(env.ep(), *this, &Driver::_parent_yield)
+		  _yield(env.ep(), *this, &Driver::_parent_yield),
+		  _read_ahead(config.attribute_value("read_ahead", 0U)),
+		  _report_handler(env.ep(), *this, &Driver::_report)
 		{
 			using namespace Genode;
 
@@ -360,6 +592,19 @@ class Driver : public Block::Driver
 
 			/* truncate chunk structure to real size of the device */
 			_cache.truncate(_blk_sz*_blk_cnt);
+
+			/* periodically report statistics if configured */
+			try {
+				Xml_node const report = config.sub_node("report");
+				unsigned long const interval_ms =
+					report.attribute_value("interval_ms", 1000UL);
+
+				_reporter.construct(_env, "stats");
+				_reporter->enabled(true);
+				_timer.construct(_env);
+				_timer->sigh(_report_handler);
+				_timer->trigger_periodic(interval_ms * 1000);
+			} catch (Xml_node::Nonexistent_sub_node) { }
 		}
 
 		~Driver()
@@ -367,6 +612,7 @@ class Driver : public Block::Driver
 			/* when session gets closed, synchronize and flush the cache */
 			_sync();
 			POLICY::flush();
+			_submit_write_back();
 		}
 
 		Block::Session_client* blk()    { return &_blk;   }
@@ -386,14 +632,12 @@ class Driver : public Block::Driver
 		          char*                     buffer,
 		          Block::Packet_descriptor &packet)
 		{
-			if (!_ops.supported(Block::Packet_descriptor::READ))
-				throw Io_error();
-
-			if (!_stat(block_number, block_count, buffer, packet))
-				return;
+			if (_read(block_number, block_count, buffer, packet))
+				_stats.hits++;
+			else
+				_stats.misses++;
 
-			_cache.read(buffer, block_count*_blk_sz, block_number*_blk_sz);
-			ack_packet(packet);
+			_read_end = block_number + block_count;
 		}
 
 		void write(Block::sector_t           block_number,
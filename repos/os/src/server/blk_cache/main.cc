@@ -11,12 +11,13 @@
  * under the terms of the GNU Affero General Public License version 3.
  */
 
+#include <base/attached_rom_dataspace.h>
 #include <base/component.h>
 
-#include "lru.h"
+#include "clock.h"
 #include "driver.h"
 
-using Policy = Lru_policy;
+using Policy = Clock_policy;
 static Driver<Policy> * driver = nullptr;
 
 
@@ -24,24 +25,14 @@ static Driver<Policy> * driver = nullptr;
  * Synchronize a chunk with the backend device
  */
 template <typename POLICY>
-void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *dst)
+void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *src)
 {
 	Cache::offset_t off =
 		static_cast<const Driver<POLICY>::Chunk_level_4*>(e)->base_offset();
 
 	if (!driver) throw Write_failed(off);
 
-	if (!driver->blk()->tx()->ready_to_submit())
-		throw Write_failed(off);
-	try {
-		Block::Packet_descriptor
-			p(driver->blk()->dma_alloc_packet(Driver::CACHE_BLK_SIZE),
-		      Block::Packet_descriptor::WRITE, off / driver->blk_sz(),
-		      Driver::CACHE_BLK_SIZE / driver->blk_sz());
-		driver->blk()->tx()->submit_packet(p);
-	} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
-		throw Write_failed(off);
-	}
+	driver->_write_back_chunk(off, src);
 }
 
 
@@ -53,11 +44,21 @@ struct Main
 		Genode::Env  &env;
 		Genode::Heap &heap;
 
-		Factory(Genode::Env &env, Genode::Heap &heap) : env(env), heap(heap) {}
+		Genode::Constructible<Genode::Attached_rom_dataspace> config { };
+
+		Factory(Genode::Env &env, Genode::Heap &heap) : env(env), heap(heap)
+		{
+			try { config.construct(env, "config"); }
+			catch (Genode::Service_denied) { }
+		}
 
 		Block::Driver *create()
 		{
-			driver = new (&heap) ::Driver<T>(env, heap);
+			Genode::Xml_node const node = config.constructed()
+			                            ? config->xml()
+			                            : Genode::Xml_node("<config/>");
+
+			driver = new (&heap) ::Driver<T>(env, heap, node);
 			return driver;
 		}
 
@@ -69,7 +70,7 @@ struct Main
 
 	Genode::Env                 &env;
 	Genode::Heap                 heap    { env.ram(), env.rm()     };
-	Factory<Lru_policy>          factory { env, heap               };
+	Factory<Clock_policy>        factory { env, heap               };
 	Block::Root                  root    { env.ep(), heap, env.rm(), factory, true };
 	Genode::Signal_handler<Main> resource_dispatcher {
 		env.ep(), *this, &Main::resource_handler };
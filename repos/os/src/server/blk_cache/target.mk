@@ -1,5 +1,5 @@
 TARGET = blk_cache
 LIBS   = base
-SRC_CC = main.cc lru.cc
+SRC_CC = main.cc clock.cc
 
 CC_CXX_WARN_STRICT =
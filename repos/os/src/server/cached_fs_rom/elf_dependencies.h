@@ -0,0 +1,220 @@
+/*
+ * \brief  Utility for obtaining the dependencies of a dynamic ELF object
+ * \author Genode Labs
+ * \date   2018-12-13
+ *
+ * The libraries needed by a dynamically linked program are listed in the
+ * DT_NEEDED entries of its dynamic section. The dynamic linker is named by
+ * the PT_INTERP segment. Both are obtained from the file content without
+ * relying on the alignment of the data, which is never trusted.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _ELF_DEPENDENCIES_H_
+#define _ELF_DEPENDENCIES_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+#include <util/string.h>
+
+namespace Cached_fs_rom {
+
+	template <typename FN>
+	static inline void for_each_elf_dependency(char const *, Genode::size_t, FN const &);
+}
+
+
+namespace Cached_fs_rom { namespace Elf {
+
+	using namespace Genode;
+
+	enum { PT_LOAD = 1, PT_DYNAMIC = 2, PT_INTERP = 3 };
+	enum { DT_NULL = 0, DT_NEEDED = 1, DT_STRTAB = 5, DT_STRSZ = 10 };
+	enum { EI_CLASS = 4, ELFCLASS32 = 1, ELFCLASS64 = 2 };
+
+	struct Layout_32
+	{
+		struct Ehdr
+		{
+			unsigned char ident[16];
+			uint16_t type, machine;
+			uint32_t version, entry, phoff, shoff, flags;
+			uint16_t ehsize, phentsize, phnum, shentsize, shnum, shstrndx;
+		};
+
+		struct Phdr { uint32_t type, offset, vaddr, paddr, filesz, memsz, flags, align; };
+
+		struct Dyn { int32_t tag; uint32_t val; };
+	};
+
+	struct Layout_64
+	{
+		struct Ehdr
+		{
+			unsigned char ident[16];
+			uint16_t type, machine;
+			uint32_t version;
+			uint64_t entry, phoff, shoff;
+			uint32_t flags;
+			uint16_t ehsize, phentsize, phnum, shentsize, shnum, shstrndx;
+		};
+
+		struct Phdr { uint32_t type, flags; uint64_t offset, vaddr, paddr, filesz, memsz, align; };
+
+		struct Dyn { int64_t tag; uint64_t val; };
+	};
+
+	/**
+	 * Copy object of type 'T' at 'offset' of the file to 'out'
+	 *
+	 * \return false if the object exceeds the file
+	 */
+	template <typename T>
+	static inline bool read(char const *base, size_t size, uint64_t offset, T &out)
+	{
+		if (offset > size || size - offset < sizeof(T))
+			return false;
+
+		memcpy(&out, base + offset, sizeof(T));
+		return true;
+	}
+
+	/**
+	 * Call 'fn' with the non-empty null-terminated string at 'offset'
+	 */
+	template <typename FN>
+	static inline void with_string(char const *base, size_t size,
+	                               uint64_t offset, uint64_t max_len, FN const &fn)
+	{
+		if (offset >= size)
+			return;
+
+		size_t const len = (size - offset < max_len) ? size - offset : (size_t)max_len;
+
+		for (size_t i = 0; i < len; i++)
+			if (base[offset + i] == 0) {
+				if (i) fn(base + offset);
+				return;
+			}
+	}
+
+	template <typename LAYOUT>
+	class Object
+	{
+		private:
+
+			typedef typename LAYOUT::Ehdr Ehdr;
+			typedef typename LAYOUT::Phdr Phdr;
+			typedef typename LAYOUT::Dyn  Dyn;
+
+			char const * const _base;
+			size_t       const _size;
+
+			Ehdr _ehdr { };
+
+			bool const _valid = read(_base, _size, 0, _ehdr)
+			                 && _ehdr.phentsize == sizeof(Phdr);
+
+			template <typename FN>
+			void _for_each_phdr(FN const &fn) const
+			{
+				for (unsigned i = 0; _valid && i < _ehdr.phnum; i++) {
+					Phdr phdr;
+					if (read(_base, _size, _ehdr.phoff + (uint64_t)i*sizeof(Phdr), phdr))
+						fn(phdr);
+				}
+			}
+
+			template <typename FN>
+			void _for_each_dyn(Phdr const &dynamic, FN const &fn) const
+			{
+				uint64_t const num = dynamic.filesz / sizeof(Dyn);
+
+				for (uint64_t i = 0; i < num; i++) {
+					Dyn dyn;
+					if (!read(_base, _size, dynamic.offset + i*sizeof(Dyn), dyn)
+					 || dyn.tag == DT_NULL)
+						return;
+					fn(dyn);
+				}
+			}
+
+			/**
+			 * Translate virtual address to file offset via the loadable segments
+			 */
+			bool _file_offset(uint64_t vaddr, uint64_t &offset) const
+			{
+				bool found = false;
+				_for_each_phdr([&] (Phdr const &phdr) {
+					if (!found && phdr.type == PT_LOAD && vaddr >= phdr.vaddr
+					 && vaddr - phdr.vaddr < phdr.filesz) {
+						offset = phdr.offset + (vaddr - phdr.vaddr);
+						found  = true;
+					}
+				});
+				return found;
+			}
+
+		public:
+
+			Object(char const *base, size_t size) : _base(base), _size(size) { }
+
+			template <typename FN>
+			void for_each_dependency(FN const &fn) const
+			{
+				_for_each_phdr([&] (Phdr const &phdr) {
+
+					if (phdr.type == PT_INTERP)
+						with_string(_base, _size, phdr.offset, phdr.filesz, fn);
+
+					if (phdr.type != PT_DYNAMIC)
+						return;
+
+					uint64_t strtab = 0, strsz = 0;
+					_for_each_dyn(phdr, [&] (Dyn const &dyn) {
+						if (dyn.tag == DT_STRTAB) strtab = dyn.val;
+						if (dyn.tag == DT_STRSZ)  strsz  = dyn.val;
+					});
+
+					uint64_t strtab_offset = 0;
+					if (!strtab || !_file_offset(strtab, strtab_offset))
+						return;
+
+					_for_each_dyn(phdr, [&] (Dyn const &dyn) {
+						if (dyn.tag == DT_NEEDED && dyn.val < strsz)
+							with_string(_base, _size, strtab_offset + dyn.val,
+							            strsz - dyn.val, fn);
+					});
+				});
+			}
+	};
+} }
+
+
+/**
+ * Call 'fn' with the name of each library the ELF object depends on
+ *
+ * The names include the dynamic linker. Files that are no ELF objects
+ * have no dependencies.
+ */
+template <typename FN>
+static inline void Cached_fs_rom::for_each_elf_dependency(char const *base,
+                                                          Genode::size_t size,
+                                                          FN const &fn)
+{
+	if (size < 16 || Genode::strcmp(base, "\177ELF", 4))
+		return;
+
+	switch (base[Elf::EI_CLASS]) {
+	case Elf::ELFCLASS32: Elf::Object<Elf::Layout_32>(base, size).for_each_dependency(fn); break;
+	case Elf::ELFCLASS64: Elf::Object<Elf::Layout_64>(base, size).for_each_dependency(fn); break;
+	}
+}
+
+#endif /* _ELF_DEPENDENCIES_H_ */
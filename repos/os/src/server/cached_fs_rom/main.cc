@@ -23,8 +23,9 @@
 #include <base/heap.h>
 #include <base/component.h>
 
-/* local session-requests utility */
+/* local includes */
 #include "session_requests.h"
+#include "elf_dependencies.h"
 
 /*****************
  ** ROM service **
@@ -49,6 +50,33 @@ namespace Cached_fs_rom {
 
 	typedef File_system::Session::Tx::Source::Packet_alloc_failed Packet_alloc_failed;
 	typedef File_system::File_handle File_handle;
+
+	typedef uint64_t Digest;
+
+	static inline Digest content_digest(char const *, size_t);
+}
+
+
+/**
+ * Compute FNV-1a hash over the content, processed in 64-bit words
+ *
+ * The digest serves as a quick test for identical content only. The
+ * content is compared in full before sharing a dataspace.
+ */
+Cached_fs_rom::Digest Cached_fs_rom::content_digest(char const *data, size_t len)
+{
+	Digest result = 14695981039346656037ULL;
+
+	for (; len >= sizeof(Digest); data += sizeof(Digest), len -= sizeof(Digest)) {
+		Digest word;
+		memcpy(&word, data, sizeof(word));
+		result = (result ^ word)*1099511628211ULL;
+	}
+
+	for (; len; data++, len--)
+		result = (result ^ (unsigned char)*data)*1099511628211ULL;
+
+	return result;
 }
 
 
@@ -57,6 +85,16 @@ struct Cached_fs_rom::Cached_rom final
 	Cached_rom(Cached_rom const &);
 	Cached_rom &operator = (Cached_rom const &);
 
+	struct Guard
+	{
+		Cached_rom &_rom;
+
+		Guard(Cached_rom &rom) : _rom(rom) {
+			++_rom._ref_count; }
+		~Guard() {
+			--_rom._ref_count; };
+	};
+
 	Genode::Env   &env;
 	Rm_connection &rm_connection;
 
@@ -65,24 +103,39 @@ struct Cached_fs_rom::Cached_rom final
 	/**
 	 * Backing RAM dataspace
 	 *
-	 * This shall be valid even if the file is empty.
+	 * This shall be valid even if the file is empty. It is released if
+	 * the content is identical to the content of another cached ROM.
 	 */
-	Attached_ram_dataspace ram_ds {
-		env.pd(), env.rm(), file_size ? file_size : 1 };
+	Constructible<Attached_ram_dataspace> ram_ds { };
 
 	/**
 	 * Read-only region map exposed as ROM module to the client
 	 */
-	Region_map_client      rm { rm_connection.create(ram_ds.size()) };
+	Constructible<Region_map_client> rm { };
 	Region_map::Local_addr rm_attachment { };
 	Dataspace_capability   rm_ds { };
 
+	/**
+	 * Cached ROM with identical content, whose dataspace is shared
+	 */
+	Constructible<Guard> origin { };
+
 	Path const path;
 
 	Cache_space::Element cache_elem;
 
 	Transfer *transfer = nullptr;
 
+	/**
+	 * Digest of the content, valid when completed
+	 */
+	Digest digest = 0;
+
+	/**
+	 * Point in time of the last request, used for evicting in LRU order
+	 */
+	unsigned long last_use = 0;
+
 	/**
 	 * Reference count of cache entry
 	 */
@@ -98,6 +151,8 @@ struct Cached_fs_rom::Cached_rom final
 		path(file_path),
 		cache_elem(*this, cache_space)
 	{
+		ram_ds.construct(env.pd(), env.rm(), file_size ? file_size : 1);
+
 		if (size == 0)
 			complete();
 	}
@@ -108,37 +163,56 @@ struct Cached_fs_rom::Cached_rom final
 	~Cached_rom()
 	{
 		if (rm_attachment)
-			rm.detach(rm_attachment);
+			rm->detach(rm_attachment);
+
+		if (rm.constructed())
+			rm_connection.destroy(*rm);
 	}
 
 	bool completed() const { return rm_ds.valid(); }
 	bool unused()    const { return (_ref_count < 1); }
 
+	char const *content() const { return ram_ds->local_addr<char const>(); }
+
 	void complete()
 	{
 		/* attach dataspace read-only into region map */
+		rm.construct(rm_connection.create(ram_ds->size()));
+
 		enum { OFFSET = 0, LOCAL_ADDR = false, EXEC = true, WRITE = false };
-		rm_attachment = rm.attach(
-			ram_ds.cap(), ram_ds.size(), OFFSET,
+		rm_attachment = rm->attach(
+			ram_ds->cap(), ram_ds->size(), OFFSET,
 			LOCAL_ADDR, (addr_t)~0, EXEC, WRITE);
-		rm_ds = rm.dataspace();
+		rm_ds = rm->dataspace();
 	}
 
 	/**
-	 * Return dataspace with content of file
+	 * Return true if the content is identical to the completed 'other' ROM
 	 */
-	Rom_dataspace_capability dataspace() const {
-		return static_cap_cast<Rom_dataspace>(rm_ds); }
+	bool identical(Cached_rom const &other) const
+	{
+		return other.completed() && other.ram_ds.constructed()
+		    && other.file_size == file_size
+		    && other.digest == digest
+		    && !memcmp(other.content(), content(), file_size);
+	}
 
-	struct Guard
+	/**
+	 * Complete ROM by sharing the dataspace of the identical 'other' ROM
+	 */
+	void complete(Cached_rom &other)
 	{
-		Cached_rom &_rom;
+		origin.construct(other);
+		digest = other.digest;
+		rm_ds  = other.rm_ds;
+		ram_ds.destruct();
+	}
 
-		Guard(Cached_rom &rom) : _rom(rom) {
-			++_rom._ref_count; }
-		~Guard() {
-			--_rom._ref_count; };
-	};
+	/**
+	 * Return dataspace with content of file
+	 */
+	Rom_dataspace_capability dataspace() const {
+		return static_cap_cast<Rom_dataspace>(rm_ds); }
 };
 
 
@@ -203,8 +277,12 @@ struct Cached_fs_rom::Transfer final
 			_submit_next_packet();
 		}
 
+		~Transfer() { _fs.close(_handle); }
+
 		Path const &path() const { return _cached_rom.path; }
 
+		Cached_rom &rom() { return _cached_rom; }
+
 		bool completed() const { return (_seek >= _size); }
 
 		/**
@@ -220,14 +298,12 @@ struct Cached_fs_rom::Transfer final
 				_seek = _size;
 			} else {
 				size_t const n = min(packet.length(), _size - pkt_seek);
-				memcpy(_cached_rom.ram_ds.local_addr<char>()+pkt_seek,
+				memcpy(_cached_rom.ram_ds->local_addr<char>()+pkt_seek,
 				       _fs.tx()->packet_content(packet), n);
 				_seek = pkt_seek+n;
 			}
 
-			if (completed())
-					_cached_rom.complete();
-			else
+			if (!completed())
 				_submit_next_packet();
 		}
 };
@@ -269,6 +345,8 @@ class Cached_fs_rom::Session_component final : public  Rpc_object<Rom_session>
 
 struct Cached_fs_rom::Main final : Genode::Session_request_handler
 {
+	enum { PREFETCH_RAM_RESERVE = 1024*1024, PREFETCH_CAPS_RESERVE = 32 };
+
 	Genode::Env &env;
 
 	Rm_connection rm { env };
@@ -287,15 +365,23 @@ struct Cached_fs_rom::Main final : Genode::Session_request_handler
 	Io_signal_handler<Main> packet_handler {
 		env.ep(), *this, &Main::handle_packets };
 
+	/**
+	 * Counter for tracking the order of ROM requests
+	 */
+	unsigned long use_count = 0;
+
 	/**
 	 * Return true when a cache element is freed
+	 *
+	 * The least-recently requested unused element is freed first.
 	 */
 	bool cache_evict()
 	{
 		Cached_rom *discard = nullptr;
 
 		cache.for_each<Cached_rom&>([&] (Cached_rom &rom) {
-			if (!discard && rom.unused()) discard = &rom; });
+			if (rom.unused() && (!discard || rom.last_use < discard->last_use))
+				discard = &rom; });
 
 		if (discard)
 			destroy(heap, discard);
@@ -337,6 +423,84 @@ struct Cached_fs_rom::Main final : Genode::Session_request_handler
 		throw Service_denied();
 	}
 
+	Cached_rom *lookup(Path const &path)
+	{
+		Cached_rom *rom = nullptr;
+		cache.for_each<Cached_rom&>([&] (Cached_rom &other) {
+			if (!rom && other.path == path)
+				rom = &other;
+		});
+		return rom;
+	}
+
+	/**
+	 * Start transfers of the libraries needed by a dynamically linked ROM
+	 *
+	 * As the completion of each transfer triggers the prefetching of the
+	 * dependencies of the transferred library, the whole closure of
+	 * dependencies is fetched before the dynamic linker requests it.
+	 * Prefetching is best effort. It does not evict cached ROMs, and
+	 * ROMs are left to be fetched on demand if no transfer can be started.
+	 */
+	void prefetch_dependencies(Cached_rom const &rom)
+	{
+		for_each_elf_dependency(rom.content(), rom.file_size, [&] (char const *name) {
+
+			Path const path(name);
+			if (lookup(path))
+				return;
+
+			try {
+				File_system::File_handle const handle = open(path);
+
+				try {
+					size_t const file_size = fs.status(handle).size;
+
+					if (env.pd().avail_ram().value < file_size + PREFETCH_RAM_RESERVE
+					 || env.pd().avail_caps().value < PREFETCH_CAPS_RESERVE)
+						throw Out_of_ram();
+
+					Cached_rom &prefetched =
+						*new (heap) Cached_rom(cache, env, rm, path, file_size);
+
+					prefetched.last_use = ++use_count;
+
+					/* the transfer closes the handle when completed */
+					if (!prefetched.completed()) {
+						new (heap) Transfer(transfers, prefetched, fs, handle, file_size);
+						return;
+					}
+				}
+				catch (...) { }
+
+				fs.close(handle);
+			}
+			catch (...) { }
+		});
+	}
+
+	/**
+	 * Finish a ROM whose content was transferred completely
+	 */
+	void complete(Cached_rom &rom)
+	{
+		rom.digest = content_digest(rom.content(), rom.file_size);
+
+		prefetch_dependencies(rom);
+
+		/* share the dataspace of an identical ROM, e.g., another depot version */
+		Cached_rom *origin = nullptr;
+		cache.for_each<Cached_rom&>([&] (Cached_rom &other) {
+			if (!origin && &other != &rom && rom.identical(other))
+				origin = &other;
+		});
+
+		if (origin)
+			rom.complete(*origin);
+		else
+			rom.complete();
+	}
+
 	/**
 	 * Create new sessions
 	 */
@@ -369,13 +533,8 @@ struct Cached_fs_rom::Main final : Genode::Session_request_handler
 		Session_label const label = label_from_args(args.string());
 		Path          const path(label.last_element().string());
 
-		Cached_rom *rom = nullptr;
-
 		/* lookup the ROM in the cache */
-		cache.for_each<Cached_rom&>([&] (Cached_rom &other) {
-			if (!rom && other.path == path)
-				rom = &other;
-		});
+		Cached_rom *rom = lookup(path);
 
 		if (!rom) {
 			File_system::File_handle handle = try_open(path);
@@ -390,6 +549,8 @@ struct Cached_fs_rom::Main final : Genode::Session_request_handler
 			rom = new (heap) Cached_rom(cache, env, rm, path, file_size);
 		}
 
+		rom->last_use = ++use_count;
+
 		if (rom->completed()) {
 			/* Create new RPC object */
 			Session_component *session = new (heap)
@@ -401,6 +562,7 @@ struct Cached_fs_rom::Main final : Genode::Session_request_handler
 
 			try { new (heap) Transfer(transfers, *rom, fs, handle, rom->file_size); }
 			catch (...) {
+				fs.close(handle);
 				Genode::warning("defer transfer of ", rom->path);
 				/* retry when next pending transfer completes */
 				return;
@@ -436,8 +598,10 @@ struct Cached_fs_rom::Main final : Genode::Session_request_handler
 			{
 				transfer.process_packet(pkt);
 				if (transfer.completed()) {
-					session_requests.schedule();
+					Cached_rom &rom = transfer.rom();
 					destroy(heap, &transfer);
+					complete(rom);
+					session_requests.schedule();
 				}
 				stray_pkt = false;
 			});
@@ -418,6 +418,12 @@ class Fs_rom::Rom_session_component : public  Rpc_object<Rom_session>
 			case File_system::Packet_descriptor::READ_READY:
 				warning("discarding strange READ_READY acknowledgement");
 				return;
+			case File_system::Packet_descriptor::READV:
+				warning("discarding strange READV acknowledgement");
+				return;
+			case File_system::Packet_descriptor::WRITEV:
+				warning("discarding strange WRITEV acknowledgement");
+				return;
 			}
 		}
 };
@@ -17,6 +17,7 @@
 #include <base/attached_rom_dataspace.h>
 #include <root/component.h>
 #include <file_system_session/rpc_object.h>
+#include <file_system/util.h>
 #include <os/session_policy.h>
 #include <util/xml_node.h>
 
@@ -97,6 +98,37 @@ class Lx_fs::Session_component : public Session_rpc_object
 				}
 				break;
 
+			case Packet_descriptor::READV:
+				if (tx_sink()->packet_valid(packet)) {
+					unsigned next = 0;
+					res_length = File_system::transfer_extents(packet,
+						tx_sink()->packet_content(packet), next,
+						[&] (seek_off_t pos, char *dst, size_t len) {
+							return open_node.node().read(dst, len, pos); });
+
+					/* extents beyond EOF are reported as short or empty */
+					succeeded = true;
+				}
+				break;
+
+			case Packet_descriptor::WRITEV:
+				if (tx_sink()->packet_valid(packet)) {
+					unsigned next = 0;
+					res_length = File_system::transfer_extents(packet,
+						tx_sink()->packet_content(packet), next,
+						[&] (seek_off_t pos, char *src, size_t len) {
+							return open_node.node().write(src, len, pos); });
+
+					/* File system session can't handle partial writes */
+					if (next != packet.length()) {
+						Genode::error("partial vectored write detected");
+						/* don't acknowledge */
+						return;
+					}
+					succeeded = true;
+				}
+				break;
+
 			case Packet_descriptor::CONTENT_CHANGED:
 				open_node.register_notify(*tx_sink());
 				/* notify_listeners may bounce the packet back*/
@@ -79,7 +79,7 @@ void Session_component::finalize_packet(Ethernet_frame *eth,
 	if (node)
 		node = node->find_by_address(eth->dst());
 	if (node)
-		node->component().send(eth, size);
+		node->component().forward(*this, eth, size);
 	else {
 		/* set our MAC as sender */
 		eth->src(_nic.mac());
@@ -97,6 +97,73 @@ void Session_component::_unset_ipv4_node()
 }
 
 
+bool Session_component::_hand_over(Session_component &from,
+                                   Ethernet_frame    &eth)
+{
+	Shared_buffer * const shared = Stream_dataspaces::shared;
+	if (!shared || from.Stream_dataspaces::shared != shared
+	 || _handoff_count == MAX_HANDOFFS)
+		return false;
+
+	/* the acknowledgement of the frame is deferred until we release it */
+	Packet_descriptor const tx_packet = from.hold_current_packet();
+	shared->acquire(from.slot);
+
+	while (_handoffs[_handoff_next].used)
+		_handoff_next = (_handoff_next + 1) % MAX_HANDOFFS;
+
+	if (!_handoff_count)
+		_handoff_oldest = _handoff_next;
+
+	_handoffs[_handoff_next].used   = true;
+	_handoffs[_handoff_next].slot   = from.slot;
+	_handoffs[_handoff_next].packet = tx_packet;
+	_handoff_count++;
+
+	/* the slots follow the session-local part of the RX buffer */
+	Genode::off_t const offset = _range_alloc.limit
+	                           + from.slot*shared->slot_size()
+	                           + tx_packet.offset();
+
+	_submit(eth, Packet_descriptor(offset, tx_packet.size()));
+	return true;
+}
+
+
+void Session_component::_release(Packet_descriptor packet)
+{
+	Shared_buffer * const shared = Stream_dataspaces::shared;
+	if (!shared || (Genode::addr_t)packet.offset() < _range_alloc.limit) {
+		source()->release_packet(packet);
+		return;
+	}
+
+	Genode::addr_t const offset = packet.offset() - _range_alloc.limit;
+	unsigned       const slot   = offset / shared->slot_size();
+	Genode::off_t  const tx_off = offset % shared->slot_size();
+
+	/* hand-offs are usually acknowledged in the order of their submission */
+	for (unsigned n = 0, i = _handoff_oldest; n < MAX_HANDOFFS;
+	     n++, i = (i + 1) % MAX_HANDOFFS) {
+
+		Handoff &h = _handoffs[i];
+		if (!h.used || h.slot != slot || h.packet.offset() != tx_off
+		 || h.packet.size() != packet.size())
+			continue;
+
+		h.used = false;
+		_handoff_count--;
+		if (i == _handoff_oldest)
+			while (_handoff_count && !_handoffs[_handoff_oldest].used)
+				_handoff_oldest = (_handoff_oldest + 1) % MAX_HANDOFFS;
+
+		shared->release(h.slot, h.packet);
+		return;
+	}
+	Genode::warning("invalid acknowledgement of forwarded packet");
+}
+
+
 bool Session_component::link_state() { return _nic.link_state(); }
 
 
@@ -114,22 +181,27 @@ Session_component::Session_component(Genode::Ram_session         &ram,
                                      Genode::size_t               amount,
                                      Genode::size_t               tx_buf_size,
                                      Genode::size_t               rx_buf_size,
+                                     Shared_buffer               *shared,
                                      Mac_address                  vmac,
                                      Net::Nic                    &nic,
                                      bool                  const &verbose,
                                      Genode::Session_label const &label,
                                      char                        *ip_addr)
-: Stream_allocator(ram, rm, amount),
-  Stream_dataspaces(ram, tx_buf_size, rx_buf_size),
+: Stream_allocator(ram, rm, amount,
+                   shared ? Shared_buffer::local_size(rx_buf_size) : ~0UL),
+  Stream_dataspaces(ram, shared, tx_buf_size, rx_buf_size),
   Session_rpc_object(rm,
-                     Stream_dataspaces::tx_ds,
-                     Stream_dataspaces::rx_ds,
+                     Stream_dataspaces::tx_cap(),
+                     Stream_dataspaces::rx_cap(),
                      Stream_allocator::range_allocator(), ep.rpc_ep()),
   Packet_handler(ep, nic.vlan(), label, verbose),
   _mac_node(*this, vmac),
   _ipv4_node(*this),
   _nic(nic)
 {
+	if (shared)
+		shared->own(slot, *this);
+
 	vlan().mac_tree.insert(&_mac_node);
 	vlan().mac_list.insert(&_mac_node);
 
@@ -156,6 +228,12 @@ Session_component::~Session_component() {
 	vlan().mac_tree.remove(&_mac_node);
 	vlan().mac_list.remove(&_mac_node);
 	_unset_ipv4_node();
+
+	/* return the frames handed over to us to their sessions */
+	for (unsigned i = 0; i < MAX_HANDOFFS; i++)
+		if (_handoffs[i].used)
+			Stream_dataspaces::shared->release(_handoffs[i].slot,
+			                                   _handoffs[i].packet);
 }
 
 
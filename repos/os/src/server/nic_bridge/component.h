@@ -24,6 +24,7 @@
 #include <os/session_policy.h>
 #include <root/component.h>
 #include <util/arg_string.h>
+#include <util/reconstructible.h>
 
 /* NIC router includes */
 #include <mac_allocator.h>
@@ -32,8 +33,10 @@
 #include <address_node.h>
 #include <nic.h>
 #include <packet_handler.h>
+#include <shared_buffer.h>
 
 namespace Net {
+	class Rx_packet_allocator;
 	class Stream_allocator;
 	class Stream_dataspace;
 	class Stream_dataspaces;
@@ -46,22 +49,41 @@ namespace Net {
  ** Helper classes **
  ********************/
 
+/**
+ * Packet allocator restricted to the first 'limit' bytes of a bulk buffer
+ */
+struct Net::Rx_packet_allocator : ::Nic::Packet_allocator
+{
+	Genode::addr_t const limit;
+
+	Rx_packet_allocator(Genode::Allocator *md_alloc, Genode::addr_t limit)
+	: ::Nic::Packet_allocator(md_alloc), limit(limit) { }
+
+	int add_range(Genode::addr_t base, Genode::size_t size) override {
+		return ::Nic::Packet_allocator::add_range(base, Genode::min(size, limit - base)); }
+
+	int remove_range(Genode::addr_t base, Genode::size_t size) override {
+		return ::Nic::Packet_allocator::remove_range(base, Genode::min(size, limit - base)); }
+};
+
+
 class Net::Stream_allocator
 {
 	protected:
 
 		Genode::Ram_session_guard _ram;
 		Genode::Heap              _heap;
-		::Nic::Packet_allocator   _range_alloc;
+		Rx_packet_allocator       _range_alloc;
 
 	public:
 
 		Stream_allocator(Genode::Ram_session &ram,
 		                 Genode::Region_map  &rm,
-		                 Genode::size_t     amount)
+		                 Genode::size_t     amount,
+		                 Genode::addr_t     rx_limit)
 		: _ram(ram, amount),
 		  _heap(ram, rm),
-		  _range_alloc(&_heap) {}
+		  _range_alloc(&_heap, rx_limit) {}
 
 		Genode::Range_allocator *range_allocator() {
 			return static_cast<Genode::Range_allocator *>(&_range_alloc); }
@@ -79,13 +101,58 @@ struct Net::Stream_dataspace : Genode::Ram_dataspace_capability
 };
 
 
+/**
+ * Bulk buffers of a session
+ *
+ * If 'shared' is defined, the TX buffer is a slot of the shared buffer and
+ * the RX buffer is 'rx_ds' followed by all slots of the shared buffer.
+ */
 struct Net::Stream_dataspaces
 {
-	Stream_dataspace tx_ds, rx_ds;
+	/*
+	 * Noncopyable
+	 */
+	Stream_dataspaces(Stream_dataspaces const &);
+	Stream_dataspaces &operator = (Stream_dataspaces const &);
+
+	Shared_buffer * const                   shared;
+	Stream_dataspace                        rx_ds;
+	Genode::Constructible<Stream_dataspace> tx_ds     { };
+	unsigned                                slot      { 0 };
+	Genode::Capability<Genode::Region_map>  rx_buffer { };
+
+	Stream_dataspaces(Genode::Ram_session &ram, Shared_buffer *shared,
+	                  Genode::size_t tx_size, Genode::size_t rx_size)
+	: shared(shared), rx_ds(ram, rx_size)
+	{
+		if (!shared) {
+			tx_ds.construct(ram, tx_size);
+			return;
+		}
+
+		slot = shared->alloc_slot(tx_size);
+		try { rx_buffer = shared->create_rx_buffer(rx_ds, rx_size); }
+		catch (...) {
+			shared->disown(slot);
+			throw;
+		}
+	}
+
+	~Stream_dataspaces()
+	{
+		if (!shared)
+			return;
+
+		shared->destroy_rx_buffer(rx_buffer);
+		shared->disown(slot);
+	}
+
+	Genode::Dataspace_capability tx_cap() {
+		return shared ? shared->ds(slot) : Genode::Dataspace_capability(*tx_ds); }
 
-	Stream_dataspaces(Genode::Ram_session &ram, Genode::size_t tx_size,
-	                  Genode::size_t rx_size)
-	: tx_ds(ram, tx_size), rx_ds(ram, rx_size) { }
+	Genode::Dataspace_capability rx_cap() {
+		return shared ? Genode::Region_map_client(rx_buffer).dataspace()
+		              : Genode::Dataspace_capability(rx_ds); }
 };
 
 
@@ -103,13 +170,45 @@ class Net::Session_component : private Net::Stream_allocator,
 {
 	private:
 
+		/*
+		 * Frame of the shared buffer submitted to the RX queue by
+		 * descriptor hand-off
+		 */
+		struct Handoff
+		{
+			bool              used   { false };
+			unsigned          slot   { 0 };
+			Packet_descriptor packet { };   /* packet of the slot's session */
+		};
+
+		enum { MAX_HANDOFFS = 256 };
+
 		Mac_address_node                  _mac_node;
 		Ipv4_address_node                 _ipv4_node;
 		Net::Nic                         &_nic;
 		Genode::Signal_context_capability _link_state_sigh { };
+		Handoff                           _handoffs[MAX_HANDOFFS] { };
+		unsigned                          _handoff_count  { 0 };
+		unsigned                          _handoff_oldest { 0 };
+		unsigned                          _handoff_next   { 0 };
 
 		void _unset_ipv4_node();
 
+		/**
+		 * Submit frame of the shared buffer without copying it
+		 *
+		 * 
+eturn  false if the frame cannot be handed over
+		 */
+		bool _hand_over(Session_component &from, Ethernet_frame &eth);
+
+
+		/******************************
+		 ** Packet_handler interface **
+		 ******************************/
+
+		void _release(Packet_descriptor) override;
+
 	public:
 
 		/**
@@ -121,6 +220,8 @@ class Net::Session_component : private Net::Stream_allocator,
 		 * \param amount       amount of memory managed by guarded allocator
 		 * \param tx_buf_size  buffer size for tx channel
 		 * \param rx_buf_size  buffer size for rx channel
+		 * \param shared       shared buffer used for the session's buffers,
+		 *                     or 0 if the session uses buffers of its own
 		 * \param vmac         virtual mac address
 		 */
 		Session_component(Genode::Ram_session         &ram,
@@ -129,6 +230,7 @@ class Net::Session_component : private Net::Stream_allocator,
 		                  Genode::size_t               amount,
 		                  Genode::size_t               tx_buf_size,
 		                  Genode::size_t               rx_buf_size,
+		                  Shared_buffer               *shared,
 		                  Mac_address                  vmac,
 		                  Net::Nic                    &nic,
 		                  bool                  const &verbose,
@@ -153,6 +255,19 @@ class Net::Session_component : private Net::Stream_allocator,
 
 		void set_ipv4_address(Ipv4_address ip_addr);
 
+		/**
+		 * Send ethernet frame received by session 'from'
+		 *
+		 * If both sessions use the shared buffer, the frame is handed
+		 * over instead of copied.
+		 */
+		void forward(Session_component &from, Ethernet_frame *eth,
+		             Genode::size_t size)
+		{
+			if (!_hand_over(from, *eth))
+				send(eth, size);
+		}
+
 
 		/****************************************
 		 ** Nic::Driver notification interface **
@@ -192,13 +307,33 @@ class Net::Root : public Genode::Root_component<Net::Session_component>
 {
 	private:
 
-		enum { DEFAULT_MAC = 0x02 };
+		enum { DEFAULT_MAC = 0x02, DEFAULT_SLOT_SIZE = 1024*1024 };
+
+		Mac_allocator                         _mac_alloc;
+		Genode::Env                          &_env;
+		Net::Nic                             &_nic;
+		Genode::Xml_node                      _config;
+		bool                           const &_verbose;
+		Genode::Constructible<Shared_buffer>  _shared_buffer { };
+
+		Shared_buffer *_shared_buffer_for(Genode::Session_label const &label,
+		                                  Genode::size_t tx_buf_size)
+		{
+			using namespace Genode;
 
-		Mac_allocator     _mac_alloc;
-		Genode::Env      &_env;
-		Net::Nic         &_nic;
-		Genode::Xml_node  _config;
-		bool       const &_verbose;
+			if (!_shared_buffer.constructed())
+				_shared_buffer.construct(_env,
+					_config.attribute_value("shared_buffer_slot_size",
+					                        Number_of_bytes(DEFAULT_SLOT_SIZE)));
+
+			if (tx_buf_size <= _shared_buffer->slot_size()
+			 && _shared_buffer->slot_avail())
+				return &*_shared_buffer;
+
+			warning("no shared buffer for session \"", label, "\", "
+			        "frames are copied");
+			return nullptr;
+		}
 
 	protected:
 
@@ -212,6 +347,7 @@ class Net::Root : public Genode::Root_component<Net::Session_component>
 
 			Session_label label;
 			Mac_address mac;
+			bool shared = false;
 			try {
 				label = label_from_args(args);
 				Session_policy policy(label, _config);
@@ -225,6 +361,8 @@ class Net::Root : public Genode::Root_component<Net::Session_component>
 					throw Service_denied();
 				}
 
+				shared = policy.attribute_value("shared_buffer", false);
+
 				policy.attribute("ip_addr").value(ip_addr, sizeof(ip_addr));
 			}
 			catch (Xml_node::Nonexistent_attribute) {
@@ -243,10 +381,14 @@ class Net::Root : public Genode::Root_component<Net::Session_component>
 				Arg_string::find_arg(args, "rx_buf_size").ulong_value(0);
 
 			try {
+				Shared_buffer * const shared_buffer =
+					shared ? _shared_buffer_for(label, tx_buf_size) : nullptr;
+
 				return new (md_alloc())
 					Session_component(_env.ram(), _env.rm(), _env.ep(),
 					                  ram_quota, tx_buf_size, rx_buf_size,
-					                  mac, _nic, _verbose, label, ip_addr);
+					                  shared_buffer, mac, _nic, _verbose,
+					                  label, ip_addr);
 			}
 			catch (Out_of_ram) {
 				Genode::warning("insufficient 'ram_quota'");
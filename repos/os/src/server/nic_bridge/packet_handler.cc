@@ -25,27 +25,64 @@ using namespace Net;
 
 void Packet_handler::_ready_to_submit()
 {
+	Packet_descriptor packets[BATCH];
+	Packet_descriptor acks[BATCH];
+
+	/* submit forwarded packets once per batch and destination */
+	_vlan.submit_deferred = true;
+	_throttled            = false;
+
 	/* as long as packets are available, and we can ack them */
-	while (sink()->packet_avail()) {
-		_packet = sink()->get_packet();
-		if (!_packet.size() || !sink()->packet_valid(_packet)) continue;
-		handle_ethernet(sink()->packet_content(_packet), _packet.size());
-
-		if (!sink()->ready_to_ack()) {
-			Genode::warning("ack state FULL");
-			return;
+	for (;;) {
+
+		/* keep acknowledgement slots for the held packets */
+		unsigned const slots = sink()->ack_slots_free();
+		unsigned const max   = slots > _held
+		                     ? Genode::min(slots - _held, (unsigned)BATCH) : 0;
+		if (!max) {
+			_throttled = true;
+			break;
 		}
 
-		sink()->acknowledge_packet(_packet);
+		unsigned const count = sink()->get_packets(packets, max);
+		unsigned       acked = 0;
+
+		for (unsigned i = 0; i < count; i++) {
+			Packet_descriptor const packet = packets[i];
+			if (!packet.size() || !sink()->packet_valid(packet)) continue;
+
+			_current      = packet;
+			_current_held = false;
+			handle_ethernet(sink()->packet_content(packet), packet.size());
+			if (!_current_held)
+				acks[acked++] = packet;
+		}
+		sink()->acknowledge_packets(acks, acked);
+
+		/* a short batch re-armed the signal for the next packet */
+		if (count < max)
+			break;
 	}
+
+	_vlan.submit_deferred = false;
+	while (Packet_handler *handler = _vlan.pending_submit.first())
+		handler->submit_pending();
 }
 
 
 void Packet_handler::_ready_to_ack()
 {
+	Packet_descriptor packets[BATCH];
+
 	/* check for acknowledgements */
-	while (source()->ack_avail())
-		source()->release_packet(source()->get_acked_packet());
+	for (;;) {
+		unsigned const count = source()->get_acked_packets(packets, BATCH);
+		for (unsigned i = 0; i < count; i++)
+			_release(packets[i]);
+
+		if (count < BATCH)
+			break;
+	}
 }
 
 
@@ -103,20 +140,67 @@ void Packet_handler::handle_ethernet(void* src, Genode::size_t size)
 
 void Packet_handler::send(Ethernet_frame *eth, Genode::size_t size)
 {
-	if (_verbose) {
-		Genode::log("[", _label, "] snd ", *eth); }
 	try {
 		/* copy and submit packet */
 		Packet_descriptor packet  = source()->alloc_packet(size);
 		char             *content = source()->packet_content(packet);
 		Genode::memcpy((void*)content, (void*)eth, size);
-		source()->submit_packet(packet);
+
+		_submit(*eth, packet);
 	} catch(Packet_stream_source< ::Nic::Session::Policy>::Packet_alloc_failed) {
 		Genode::warning("Packet dropped");
 	}
 }
 
 
+void Packet_handler::_submit(Ethernet_frame const &eth, Packet_descriptor packet)
+{
+	if (_verbose) {
+		Genode::log("[", _label, "] snd ", eth); }
+
+	if (!_vlan.submit_deferred) {
+		source()->submit_packet(packet);
+		return;
+	}
+	if (!_pending_count)
+		_vlan.pending_submit.insert(this);
+
+	_pending[_pending_count++] = packet;
+	if (_pending_count == BATCH)
+		submit_pending();
+}
+
+
+void Packet_handler::submit_pending()
+{
+	if (!_pending_count)
+		return;
+
+	source()->submit_packets(_pending, _pending_count);
+	_pending_count = 0;
+	_vlan.pending_submit.remove(this);
+}
+
+
+Packet_descriptor Packet_handler::hold_current_packet()
+{
+	_current_held = true;
+	_held++;
+	return _current;
+}
+
+
+void Packet_handler::release_held_packet(Packet_descriptor packet)
+{
+	sink()->acknowledge_packet(packet);
+	_held--;
+
+	/* resume the handling of packets stopped for lack of ack slots */
+	if (_throttled)
+		Genode::Signal_transmitter(_sink_submit).submit();
+}
+
+
 Packet_handler::Packet_handler(Genode::Entrypoint          &ep,
                                Vlan                        &vlan,
                                Genode::Session_label const &label,
@@ -133,3 +217,10 @@ Packet_handler::Packet_handler(Genode::Entrypoint          &ep,
 	if (_verbose) {
 		Genode::log("[", _label, "] interface initialized"); }
 }
+
+
+Packet_handler::~Packet_handler()
+{
+	if (_pending_count)
+		_vlan.pending_submit.remove(this);
+}
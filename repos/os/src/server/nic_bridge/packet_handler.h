@@ -35,15 +35,35 @@ namespace Net {
 /**
  * Generic packet handler used as base for NIC and client packet handlers.
  */
-class Net::Packet_handler
+class Net::Packet_handler : private Vlan::Handler_list::Element
 {
+	friend class Genode::List<Packet_handler>;
+
 	private:
 
-		Packet_descriptor      _packet { };
+		/*
+		 * Number of packet descriptors transferred per queue operation
+		 */
+		enum { BATCH = 64 };
+
 		Net::Vlan             &_vlan;
 		Genode::Session_label  _label;
 		bool            const &_verbose;
 
+		/* packets allocated and filled but not yet submitted */
+		Packet_descriptor      _pending[BATCH] { };
+		unsigned               _pending_count { 0 };
+
+		/* packet of the sink currently handled */
+		Packet_descriptor      _current { };
+		bool                   _current_held { false };
+
+		/* packets handed over to other sessions, acknowledged later on */
+		unsigned               _held { 0 };
+
+		/* handling stopped for lack of acknowledgement slots */
+		bool                   _throttled { false };
+
 		/**
 		 * submit queue not empty anymore
 		 */
@@ -52,10 +72,10 @@ class Net::Packet_handler
 		/**
 		 * acknoledgement queue not full anymore
 		 *
-		 * TODO: by now, we assume ACK and SUBMIT queue to be equally
-		 *       dimensioned. That's why we ignore this signal by now.
+		 * The handling of submitted packets is resumed if it was stopped
+		 * because the acknowledgement slots were reserved for held packets.
 		 */
-		void _ack_avail() { }
+		void _ack_avail() { if (_throttled) _ready_to_submit(); }
 
 		/**
 		 * acknoledgement queue not empty anymore
@@ -83,6 +103,20 @@ class Net::Packet_handler
 		Genode::Signal_handler<Packet_handler> _source_submit;
 		Genode::Signal_handler<Packet_handler> _client_link_state;
 
+		/**
+		 * Submit packet of the source
+		 *
+		 * During a batch, the submission is deferred to the end of the
+		 * batch.
+		 */
+		void _submit(Ethernet_frame const &eth, Packet_descriptor packet);
+
+		/**
+		 * Release packet acknowledged by the sink of the other side
+		 */
+		virtual void _release(Packet_descriptor packet) {
+			source()->release_packet(packet); }
+
 	public:
 
 		Packet_handler(Genode::Entrypoint&,
@@ -90,7 +124,7 @@ class Net::Packet_handler
 		               Genode::Session_label const &label,
 		               bool                  const &verbose);
 
-		virtual ~Packet_handler() { }
+		virtual ~Packet_handler();
 
 		virtual Packet_stream_sink< ::Nic::Session::Policy>   * sink()   = 0;
 		virtual Packet_stream_source< ::Nic::Session::Policy> * source() = 0;
@@ -115,6 +149,26 @@ class Net::Packet_handler
 		 */
 		void send(Ethernet_frame *eth, Genode::size_t size);
 
+		/**
+		 * Submit the packets deferred by 'send' during a batch
+		 */
+		void submit_pending();
+
+		/**
+		 * Hold back the acknowledgement of the packet currently handled
+		 *
+		 * The packet gets acknowledged by 'release_held_packet' once the
+		 * session it was handed over to does not refer to it anymore.
+		 *
+		 * eturn  packet currently handled
+		 */
+		Packet_descriptor hold_current_packet();
+
+		/**
+		 * Acknowledge packet held back by 'hold_current_packet'
+		 */
+		void release_held_packet(Packet_descriptor packet);
+
 		/**
 		 * Handle an ethernet packet
 		 *
@@ -0,0 +1,198 @@
+/*
+ * \brief  Bulk buffer shared by the sessions that forward by hand-off
+ * \author Genode Labs
+ * \date   2018-12-22
+ *
+ * The TX buffers of all sessions with a 'shared_buffer' policy are attached
+ * read-only to the slots of one managed dataspace. The RX buffer of such a
+ * session is a managed dataspace, which starts with the session-local buffer
+ * followed by all slots. Hence, a frame submitted by one of these sessions
+ * is visible in the RX buffer of every other one and can be forwarded by
+ * submitting a packet descriptor that refers to it instead of a copy.
+ *
+ * The TX buffer of a slot is freed not before the owning session is closed
+ * and no other session references a frame of it anymore.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _SRC__SERVER__NIC_BRIDGE__SHARED_BUFFER_H_
+#define _SRC__SERVER__NIC_BRIDGE__SHARED_BUFFER_H_
+
+/* Genode includes */
+#include <base/env.h>
+#include <region_map/client.h>
+#include <rm_session/connection.h>
+
+/* local includes */
+#include <packet_handler.h>
+
+namespace Net { class Shared_buffer; }
+
+
+class Net::Shared_buffer
+{
+	public:
+
+		enum { MAX_SLOTS = 16 };
+
+		class Out_of_slots : Genode::Exception { };
+
+	private:
+
+		struct Slot
+		{
+			Genode::Ram_dataspace_capability ds    { };
+			Packet_handler                  *owner { nullptr };
+			unsigned                         refs  { 0 };
+		};
+
+		Genode::Env               &_env;
+		Genode::size_t       const _slot_size;
+		Genode::Rm_connection      _rm { _env };
+		Genode::Region_map_client  _slots { _rm.create(MAX_SLOTS*_slot_size) };
+		Slot                       _slot[MAX_SLOTS] { };
+
+		void _free(unsigned i)
+		{
+			_slots.detach(i*_slot_size);
+			_env.ram().free(_slot[i].ds);
+			_slot[i] = Slot();
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param slot_size  maximum size of the TX buffer of a session
+		 */
+		Shared_buffer(Genode::Env &env, Genode::size_t slot_size)
+		: _env(env), _slot_size(Genode::align_addr(slot_size, 12)) { }
+
+		~Shared_buffer()
+		{
+			for (unsigned i = 0; i < MAX_SLOTS; i++)
+				if (_slot[i].ds.valid())
+					_free(i);
+		}
+
+		Genode::size_t slot_size() const { return _slot_size; }
+
+		Genode::size_t size() const { return MAX_SLOTS*_slot_size; }
+
+		/**
+		 * Size of the session-local part of an RX buffer
+		 */
+		static Genode::size_t local_size(Genode::size_t rx_size) {
+			return Genode::align_addr(rx_size, 12); }
+
+		bool slot_avail() const
+		{
+			for (unsigned i = 0; i < MAX_SLOTS; i++)
+				if (!_slot[i].ds.valid())
+					return true;
+			return false;
+		}
+
+		/**
+		 * Allocate slot with a TX buffer of 'size' bytes
+		 *
+		 * \throw Out_of_slots
+		 */
+		unsigned alloc_slot(Genode::size_t size)
+		{
+			for (unsigned i = 0; i < MAX_SLOTS; i++) {
+				if (_slot[i].ds.valid())
+					continue;
+
+				_slot[i].ds = _env.ram().alloc(size);
+				try {
+					_slots.attach(_slot[i].ds, 0, 0, true, i*_slot_size,
+					              false, false);
+				}
+				catch (...) {
+					_env.ram().free(_slot[i].ds);
+					_slot[i] = Slot();
+					throw;
+				}
+				return i;
+			}
+			throw Out_of_slots();
+		}
+
+		Genode::Dataspace_capability ds(unsigned slot) const {
+			return _slot[slot].ds; }
+
+		/**
+		 * Assign handler that acknowledges the released packets of a slot
+		 */
+		void own(unsigned slot, Packet_handler &owner) {
+			_slot[slot].owner = &owner; }
+
+		/**
+		 * Revoke owner of slot, free slot once it is not referenced
+		 */
+		void disown(unsigned slot)
+		{
+			_slot[slot].owner = nullptr;
+			if (!_slot[slot].refs)
+				_free(slot);
+		}
+
+		bool valid(unsigned slot) const {
+			return slot < MAX_SLOTS && _slot[slot].ds.valid(); }
+
+		/**
+		 * Reference frame of the TX buffer of 'slot'
+		 */
+		void acquire(unsigned slot) { _slot[slot].refs++; }
+
+		/**
+		 * Drop reference to 'packet' of the TX buffer of 'slot'
+		 */
+		void release(unsigned slot, Packet_descriptor packet)
+		{
+			Slot &s = _slot[slot];
+			s.refs--;
+
+			if (s.owner)
+				s.owner->release_held_packet(packet);
+			else if (!s.refs)
+				_free(slot);
+		}
+
+		/**
+		 * Create RX buffer that consists of 'local_ds' followed by all slots
+		 */
+		Genode::Capability<Genode::Region_map>
+		create_rx_buffer(Genode::Dataspace_capability local_ds,
+		                 Genode::size_t               rx_size)
+		{
+			Genode::size_t const local = local_size(rx_size);
+
+			Genode::Capability<Genode::Region_map> cap =
+				_rm.create(local + size());
+
+			try {
+				Genode::Region_map_client rx(cap);
+				rx.attach_at(local_ds, 0);
+				rx.attach(_slots.dataspace(), 0, 0, true, local, false, false);
+			}
+			catch (...) {
+				_rm.destroy(cap);
+				throw;
+			}
+			return cap;
+		}
+
+		void destroy_rx_buffer(Genode::Capability<Genode::Region_map> cap) {
+			_rm.destroy(cap); }
+};
+
+#endif /* _SRC__SERVER__NIC_BRIDGE__SHARED_BUFFER_H_ */
@@ -22,6 +22,8 @@
 
 namespace Net {
 
+	class Packet_handler;
+
 	/*
 	 * The Vlan is a database containing all clients
 	 * sorted by IP and MAC addresses.
@@ -31,10 +33,19 @@ namespace Net {
 		using Mac_address_tree  = Genode::Avl_tree<Mac_address_node>;
 		using Ipv4_address_tree = Genode::Avl_tree<Ipv4_address_node>;
 		using Mac_address_list  = Genode::List<Mac_address_node>;
+		using Handler_list      = Genode::List<Packet_handler>;
 
 		Mac_address_tree  mac_tree { };
 		Mac_address_list  mac_list { };
 		Ipv4_address_tree ip_tree  { };
+
+		/*
+		 * While a batch of received packets is handled, the packets
+		 * forwarded to other handlers are submitted at the end of the
+		 * batch. The list holds the handlers with pending submissions.
+		 */
+		Handler_list pending_submit   { };
+		bool         submit_deferred  { false };
 	};
 }
 
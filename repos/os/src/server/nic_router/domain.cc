@@ -89,6 +89,7 @@ void Domain::ip_config(Ipv4_config const &new_ip_config)
 	/* overwrite old with new IP config */
 	_ip_config.construct(new_ip_config);
 	_log_ip_config();
+	invalidate_flows();
 
 	/* attach all dependent interfaces to new IP config if it is valid */
 	if (ip_config().valid) {
@@ -116,6 +116,7 @@ class Net::Domain : public Domain_base,
 		Link_side_tree                        _icmp_links           { };
 		Genode::size_t                        _tx_bytes             { 0 };
 		Genode::size_t                        _rx_bytes             { 0 };
+		unsigned long                         _flow_epoch           { 0 };
 		bool                            const _verbose_packets;
 		bool                            const _verbose_packet_drop;
 		bool                            const _icmp_echo_server;
@@ -183,6 +184,11 @@ class Net::Domain : public Domain_base,
 
 		void raise_tx_bytes(Genode::size_t bytes) { _tx_bytes += bytes; }
 
+		/**
+		 * Invalidate all cached flows that depend on the domain
+		 */
+		void invalidate_flows() { _flow_epoch++; }
+
 		void report(Genode::Xml_generator &xml);
 
 
@@ -204,6 +210,7 @@ class Net::Domain : public Domain_base,
 		Ipv4_config           const &ip_config()           const { return *_ip_config; }
 		List<Domain>                &ip_config_dependents()      { return _ip_config_dependents; }
 		Domain_name           const &name()                const { return _name; }
+		unsigned long                flow_epoch()          const { return _flow_epoch; }
 		Ip_rule_list                &ip_rules()                  { return _ip_rules; }
 		Forward_rule_tree           &tcp_forward_rules()         { return _tcp_forward_rules; }
 		Forward_rule_tree           &udp_forward_rules()         { return _udp_forward_rules; }
@@ -0,0 +1,131 @@
+/*
+ * \brief  Cache for the routing decisions of established UDP/TCP links
+ * \author Genode Labs
+ * \date   2018-12-05
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <util/xml_generator.h>
+
+/* local includes */
+#include <flow_cache.h>
+#include <domain.h>
+#include <report.h>
+
+using namespace Net;
+using namespace Genode;
+
+
+/**********************
+ ** Flow_cache_stats **
+ **********************/
+
+void Flow_cache_stats::report(Xml_generator &xml)
+{
+	bool empty = true;
+
+	if (hits)      { xml.node("hits",      [&] () { xml.attribute("value", hits);      }); empty = false; }
+	if (hit_bytes) { xml.node("hit_bytes", [&] () { xml.attribute("value", hit_bytes); }); empty = false; }
+	if (misses)    { xml.node("misses",    [&] () { xml.attribute("value", misses);    }); empty = false; }
+	if (stale)     { xml.node("stale",     [&] () { xml.attribute("value", stale);     }); empty = false; }
+	if (flushes)   { xml.node("flushes",   [&] () { xml.attribute("value", flushes);   }); empty = false; }
+
+	if (empty) { throw Report::Empty(); }
+}
+
+
+/**********
+ ** Flow **
+ **********/
+
+Flow::Flow(L3_protocol            const  protocol,
+           Link_side_id           const &id,
+           Link_side                    &remote_side,
+           bool                   const  client,
+           Domain                       &local_domain,
+           Mac_address            const &dst_mac,
+           Internet_checksum_diff const &ip_icd,
+           Internet_checksum_diff const &prot_icd)
+:
+	_protocol(protocol), _id(id), _remote_side(remote_side), _client(client),
+	_local_domain(local_domain), _local_epoch(local_domain.flow_epoch()),
+	_remote_epoch(remote_side.domain().flow_epoch()), _dst_mac(dst_mac),
+	_ip_icd(ip_icd), _prot_icd(prot_icd)
+{ }
+
+
+bool Flow::valid() const
+{
+	/*
+	 * Dissolving the link raises the epoch of the local domain, so, as long
+	 * as the local epoch is unchanged, the remote link side can be accessed.
+	 */
+	return _local_epoch  == _local_domain.flow_epoch() &&
+	       _remote_epoch == _remote_side.domain().flow_epoch();
+}
+
+
+/****************
+ ** Flow_cache **
+ ****************/
+
+unsigned Flow_cache::_slot_idx(L3_protocol  const  protocol,
+                               Link_side_id const &id)
+{
+	uint32_t hash = (uint32_t)protocol;
+	uint8_t const *const data = (uint8_t const *)id.data_base();
+	for (size_t i = 0; i < sizeof(Link_side_id); i++) {
+		hash = (hash ^ data[i]) * 16777619; }
+
+	return (hash ^ (hash >> 16)) % NR_OF_SLOTS;
+}
+
+
+Flow const &Flow_cache::find(L3_protocol  const  protocol,
+                             Link_side_id const &id,
+                             size_t              bytes)
+{
+	Flow_slot &slot = _slots[_slot_idx(protocol, id)];
+	if (slot.constructed() && slot->matches(protocol, id)) {
+		if (slot->valid()) {
+			_stats.hits++;
+			_stats.hit_bytes += bytes;
+			return *slot;
+		}
+		slot.destruct();
+		_stats.stale++;
+	}
+	_stats.misses++;
+	throw No_match();
+}
+
+
+void Flow_cache::new_flow(L3_protocol            const  protocol,
+                          Link_side_id           const &id,
+                          Link_side                    &remote_side,
+                          bool                   const  client,
+                          Domain                       &local_domain,
+                          Mac_address            const &dst_mac,
+                          Internet_checksum_diff const &ip_icd,
+                          Internet_checksum_diff const &prot_icd)
+{
+	_slots[_slot_idx(protocol, id)].construct(protocol, id, remote_side,
+	                                          client, local_domain, dst_mac,
+	                                          ip_icd, prot_icd);
+}
+
+
+void Flow_cache::flush()
+{
+	for (Flow_slot &slot : _slots) {
+		slot.destruct(); }
+
+	_stats.flushes++;
+}
@@ -0,0 +1,145 @@
+/*
+ * \brief  Cache for the routing decisions of established UDP/TCP links
+ * \author Genode Labs
+ * \date   2018-12-05
+ *
+ * Each interface remembers for the most recent UDP/TCP connections it
+ * received packets of, which link and remote domain they belong to, which
+ * MAC address the packets are sent to, and which checksum differences the
+ * rewrite of their IP addresses and ports produces. Thereby, successive
+ * packets of an established connection can be forwarded without looking up
+ * the link, the ARP cache, or any routing rule.
+ *
+ * Cache entries are not removed actively when the state they were derived
+ * from changes. Instead, each domain maintains a flow epoch that is raised
+ * whenever a link of the domain gets dissolved, its ARP cache changes, or
+ * its IP config changes. An entry is valid only as long as the epochs of
+ * both its domains equal the values they had when the entry was created.
+ * On a configuration reload, the cache gets flushed completely.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _FLOW_CACHE_H_
+#define _FLOW_CACHE_H_
+
+/* Genode includes */
+#include <net/ethernet.h>
+#include <net/internet_checksum.h>
+#include <util/reconstructible.h>
+
+/* local includes */
+#include <link.h>
+#include <l3_protocol.h>
+
+namespace Genode { class Xml_generator; }
+
+namespace Net {
+
+	class Flow;
+	class Flow_cache;
+	struct Flow_cache_stats;
+	using Flow_slot = Genode::Constructible<Flow>;
+}
+
+
+struct Net::Flow_cache_stats
+{
+	Genode::size_t hits      { 0 };
+	Genode::size_t hit_bytes { 0 };
+	Genode::size_t misses    { 0 };
+	Genode::size_t stale     { 0 };
+	Genode::size_t flushes   { 0 };
+
+	void report(Genode::Xml_generator &xml);
+};
+
+
+class Net::Flow
+{
+	private:
+
+		L3_protocol            const  _protocol;
+		Link_side_id           const  _id;
+		Link_side                    &_remote_side;
+		bool                   const  _client;
+		Domain                       &_local_domain;
+		unsigned long          const  _local_epoch;
+		unsigned long          const  _remote_epoch;
+		Mac_address            const  _dst_mac;
+		Internet_checksum_diff const  _ip_icd;
+		Internet_checksum_diff const  _prot_icd;
+
+	public:
+
+		Flow(L3_protocol            const  protocol,
+		     Link_side_id           const &id,
+		     Link_side                    &remote_side,
+		     bool                   const  client,
+		     Domain                       &local_domain,
+		     Mac_address            const &dst_mac,
+		     Internet_checksum_diff const &ip_icd,
+		     Internet_checksum_diff const &prot_icd);
+
+		bool matches(L3_protocol const protocol, Link_side_id const &id) const {
+			return _protocol == protocol && _id == id; }
+
+		/**
+		 * Return whether the entry still reflects the state of both domains
+		 */
+		bool valid() const;
+
+
+		/***************
+		 ** Accessors **
+		 ***************/
+
+		Link                         &link()          const { return _remote_side.link(); }
+		Link_side                    &remote_side()   const { return _remote_side; }
+		bool                          client()        const { return _client; }
+		Mac_address            const &dst_mac()       const { return _dst_mac; }
+		Internet_checksum_diff const &ip_icd()        const { return _ip_icd; }
+		Internet_checksum_diff const &prot_icd()      const { return _prot_icd; }
+};
+
+
+class Net::Flow_cache
+{
+	private:
+
+		enum { NR_OF_SLOTS = 128 };
+
+		Flow_slot        _slots[NR_OF_SLOTS];
+		Flow_cache_stats _stats { };
+
+		static unsigned _slot_idx(L3_protocol         const  protocol,
+		                          Link_side_id        const &id);
+
+	public:
+
+		struct No_match : Genode::Exception { };
+
+		Flow const &find(L3_protocol  const  protocol,
+		                 Link_side_id const &id,
+		                 Genode::size_t      bytes);
+
+		void new_flow(L3_protocol            const  protocol,
+		              Link_side_id           const &id,
+		              Link_side                    &remote_side,
+		              bool                   const  client,
+		              Domain                       &local_domain,
+		              Mac_address            const &dst_mac,
+		              Internet_checksum_diff const &ip_icd,
+		              Internet_checksum_diff const &prot_icd);
+
+		void flush();
+
+		void report(Genode::Xml_generator &xml) { _stats.report(xml); }
+};
+
+#endif /* _FLOW_CACHE_H_ */
@@ -16,6 +16,7 @@
 #include <net/udp.h>
 #include <net/icmp.h>
 #include <net/arp.h>
+#include <net/internet_checksum.h>
 #include <base/quota_guard.h>
 
 /* local includes */
@@ -134,27 +135,34 @@ static void _link_packet(L3_protocol  const  prot,
 }
 
 
-static void _update_checksum(L3_protocol   const prot,
-                             void         *const prot_base,
-                             size_t        const prot_size,
-                             Ipv4_address  const src,
-                             Ipv4_address  const dst,
-                             size_t        const ip_size)
+/**
+ * Incrementally update the checksums of a packet with modified header fields
+ *
+ * \param ip_icd    modifications of the IP header
+ * \param prot_icd  modifications of the transport header
+ */
+static void _update_checksum(L3_protocol             const  prot,
+                             void                   *const  prot_base,
+                             Ipv4_packet                   &ip,
+                             Internet_checksum_diff  const &ip_icd,
+                             Internet_checksum_diff  const &prot_icd)
 {
+	ip.update_checksum(ip_icd);
+
+	/* the pseudo header of TCP and UDP covers the IP addresses */
+	Internet_checksum_diff pseudo_ip_icd = prot_icd;
+	pseudo_ip_icd.add_up_diff(ip_icd);
+
 	switch (prot) {
 	case L3_protocol::TCP:
-		((Tcp_packet *)prot_base)->update_checksum(src, dst, prot_size);
+		((Tcp_packet *)prot_base)->update_checksum(pseudo_ip_icd);
 		return;
 	case L3_protocol::UDP:
-		((Udp_packet *)prot_base)->update_checksum(src, dst);
+		((Udp_packet *)prot_base)->update_checksum(pseudo_ip_icd);
 		return;
 	case L3_protocol::ICMP:
-		{
-			Icmp_packet &icmp = *(Icmp_packet *)prot_base;
-			icmp.update_checksum(ip_size - sizeof(Ipv4_packet) -
-			                               sizeof(Icmp_packet));
-			return;
-		}
+		((Icmp_packet *)prot_base)->update_checksum(prot_icd);
+		return;
 	default: throw Interface::Bad_transport_protocol(); }
 }
 
@@ -169,9 +177,22 @@ static Port _dst_port(L3_protocol const prot, void *const prot_base)
 }
 
 
-static void _dst_port(L3_protocol  const prot,
-                      void        *const prot_base,
-                      Port         const port)
+static void _dst_port(L3_protocol             const  prot,
+                      void                   *const  prot_base,
+                      Port                    const  port,
+                      Internet_checksum_diff        &icd)
+{
+	switch (prot) {
+	case L3_protocol::TCP:  (*(Tcp_packet *)prot_base).dst_port(port, icd);  return;
+	case L3_protocol::UDP:  (*(Udp_packet *)prot_base).dst_port(port, icd);  return;
+	case L3_protocol::ICMP: (*(Icmp_packet *)prot_base).query_id(port.value, icd); return;
+	default: throw Interface::Bad_transport_protocol(); }
+}
+
+
+static void _dst_port(L3_protocol const prot,
+                      void       *const prot_base,
+                      Port        const port)
 {
 	switch (prot) {
 	case L3_protocol::TCP:  (*(Tcp_packet *)prot_base).dst_port(port);  return;
@@ -191,9 +212,22 @@ static Port _src_port(L3_protocol const prot, void *const prot_base)
 }
 
 
-static void _src_port(L3_protocol  const prot,
-                      void        *const prot_base,
-                      Port         const port)
+static void _src_port(L3_protocol             const  prot,
+                      void                   *const  prot_base,
+                      Port                    const  port,
+                      Internet_checksum_diff        &icd)
+{
+	switch (prot) {
+	case L3_protocol::TCP:  ((Tcp_packet *)prot_base)->src_port(port, icd);        return;
+	case L3_protocol::UDP:  ((Udp_packet *)prot_base)->src_port(port, icd);        return;
+	case L3_protocol::ICMP: ((Icmp_packet *)prot_base)->query_id(port.value, icd); return;
+	default: throw Interface::Bad_transport_protocol(); }
+}
+
+
+static void _src_port(L3_protocol const prot,
+                      void       *const prot_base,
+                      Port        const port)
 {
 	switch (prot) {
 	case L3_protocol::TCP:  ((Tcp_packet *)prot_base)->src_port(port);        return;
@@ -273,16 +307,11 @@ void Interface::_destroy_link(Link &link)
 }
 
 
-void Interface::_pass_prot(Ethernet_frame       &eth,
-                           Size_guard           &size_guard,
-                           Ipv4_packet          &ip,
-                           L3_protocol    const  prot,
-                           void          *const  prot_base,
-                           size_t         const  prot_size)
+void Interface::_pass_prot(Ethernet_frame &eth,
+                           Size_guard     &size_guard)
 {
 	eth.src(_router_mac);
-	_update_checksum(prot, prot_base, prot_size, ip.src(), ip.dst(), ip.total_length());
-	_pass_ip(eth, size_guard, ip);
+	send(eth, size_guard);
 }
 
 
@@ -317,6 +346,7 @@ Interface::_transport_rules(Domain &local_domain, L3_protocol const prot) const
 
 void Interface::_attach_to_domain_raw(Domain &domain)
 {
+	_flow_cache.flush();
 	_domain = domain;
 	Signal_transmitter(_session_link_state_sigh).submit();
 	_interfaces.remove(this);
@@ -329,6 +359,7 @@ void Interface::_detach_from_domain_raw()
 	Domain &domain = _domain();
 	domain.detach_interface(*this);
 	_interfaces.insert(this);
+	_flow_cache.flush();
 	_domain = Pointer<Domain>();
 	Signal_transmitter(_session_link_state_sigh).submit();
 
@@ -405,6 +436,7 @@ void Interface::detach_from_ip_config()
 	}
 	/* dissolve ARP cache entries with the MAC address of this interface */
 	domain.arp_cache().destroy_entries_with_mac(_mac);
+	domain.invalidate_flows();
 }
 
 
@@ -525,33 +557,35 @@ void Interface::_adapt_eth(Ethernet_frame          &eth,
 }
 
 
-void Interface::_nat_link_and_pass(Ethernet_frame        &eth,
-                                   Size_guard            &size_guard,
-                                   Ipv4_packet           &ip,
-                                   L3_protocol     const  prot,
-                                   void           *const  prot_base,
-                                   size_t          const  prot_size,
-                                   Link_side_id    const &local_id,
-                                   Domain                &local_domain,
-                                   Domain                &remote_domain)
+void Interface::_nat_link_and_pass(Ethernet_frame         &eth,
+                                   Size_guard             &size_guard,
+                                   Ipv4_packet            &ip,
+                                   Internet_checksum_diff &ip_icd,
+                                   L3_protocol      const  prot,
+                                   void            *const  prot_base,
+                                   Link_side_id     const &local_id,
+                                   Domain                 &local_domain,
+                                   Domain                 &remote_domain)
 {
 	try {
+		Internet_checksum_diff prot_icd { };
 		Pointer<Port_allocator_guard> remote_port_alloc;
 		try {
 			Nat_rule &nat = remote_domain.nat_rules().find_by_domain(local_domain);
 			if(_config().verbose()) {
 				log("[", local_domain, "] using NAT rule: ", nat); }
 
-			_src_port(prot, prot_base, nat.port_alloc(prot).alloc());
-			ip.src(remote_domain.ip_config().interface.address);
+			_src_port(prot, prot_base, nat.port_alloc(prot).alloc(), prot_icd);
+			ip.src(remote_domain.ip_config().interface.address, ip_icd);
 			remote_port_alloc = nat.port_alloc(prot);
 		}
 		catch (Nat_rule_tree::No_match) { }
 		Link_side_id const remote_id = { ip.dst(), _dst_port(prot, prot_base),
 		                                 ip.src(), _src_port(prot, prot_base) };
 		_new_link(prot, local_id, remote_port_alloc, remote_domain, remote_id);
+		_update_checksum(prot, prot_base, ip, ip_icd, prot_icd);
 		remote_domain.interfaces().for_each([&] (Interface &interface) {
-			interface._pass_prot(eth, size_guard, ip, prot, prot_base, prot_size);
+			interface._pass_prot(eth, size_guard);
 		});
 	} catch (Port_allocator_guard::Out_of_indices) {
 		switch (prot) {
@@ -906,7 +940,6 @@ void Interface::_handle_icmp_query(Ethernet_frame          &eth,
                                    Packet_descriptor const &pkt,
                                    L3_protocol              prot,
                                    void                    *prot_base,
-                                   size_t                   prot_size,
                                    Domain                  &local_domain)
 {
 	Link_side_id const local_id = { ip.src(), _src_port(prot, prot_base),
@@ -924,13 +957,16 @@ void Interface::_handle_icmp_query(Ethernet_frame          &eth,
 			    " link: ", link);
 		}
 		_adapt_eth(eth, remote_side.src_ip(), pkt, remote_domain);
-		ip.src(remote_side.dst_ip());
-		ip.dst(remote_side.src_ip());
-		_src_port(prot, prot_base, remote_side.dst_port());
-		_dst_port(prot, prot_base, remote_side.src_port());
+		Internet_checksum_diff ip_icd   { };
+		Internet_checksum_diff prot_icd { };
+		ip.src(remote_side.dst_ip(), ip_icd);
+		ip.dst(remote_side.src_ip(), ip_icd);
+		_src_port(prot, prot_base, remote_side.dst_port(), prot_icd);
+		_dst_port(prot, prot_base, remote_side.src_port(), prot_icd);
+		_update_checksum(prot, prot_base, ip, ip_icd, prot_icd);
 
 		remote_domain.interfaces().for_each([&] (Interface &interface) {
-			interface._pass_prot(eth, size_guard, ip, prot, prot_base, prot_size);
+			interface._pass_prot(eth, size_guard);
 		});
 		_link_packet(prot, prot_base, link, client);
 		return;
@@ -947,7 +983,8 @@ void Interface::_handle_icmp_query(Ethernet_frame          &eth,
 
 		Domain &remote_domain = rule.domain();
 		_adapt_eth(eth, local_id.dst_ip, pkt, remote_domain);
-		_nat_link_and_pass(eth, size_guard, ip, prot, prot_base, prot_size,
+		Internet_checksum_diff ip_icd { };
+		_nat_link_and_pass(eth, size_guard, ip, ip_icd, prot, prot_base,
 		                   local_id, local_domain, remote_domain);
 
 		return;
@@ -996,7 +1033,13 @@ void Interface::_handle_icmp_error(Ethernet_frame          &eth,
 		}
 		ip.dst(remote_side.src_ip());
 
-		/* adapt source and destination of embedded IP and transport packet */
+		/*
+		 * Adapt source and destination of embedded IP and transport packet
+		 *
+		 * The checksum of the embedded transport packet is left untouched
+		 * as the packet is usually truncated. The checksums of the
+		 * embedding packets are re-calculated as a whole below.
+		 */
 		embed_ip.src(remote_side.src_ip());
 		embed_ip.dst(remote_side.dst_ip());
 		_src_port(embed_prot, embed_prot_base, remote_side.src_port());
@@ -1050,7 +1093,7 @@ void Interface::_handle_icmp(Ethernet_frame            &eth,
 	/* try to act as ICMP router */
 	switch (icmp.type()) {
 	case Icmp_packet::Type::ECHO_REPLY:
-	case Icmp_packet::Type::ECHO_REQUEST:    _handle_icmp_query(eth, size_guard, ip, pkt, prot, prot_base, prot_size, local_domain); break;
+	case Icmp_packet::Type::ECHO_REQUEST:    _handle_icmp_query(eth, size_guard, ip, pkt, prot, prot_base, local_domain); break;
 	case Icmp_packet::Type::DST_UNREACHABLE: _handle_icmp_error(eth, size_guard, ip, pkt, local_domain, icmp, prot_size); break;
 	default: Drop_packet("unhandled type in ICMP"); }
 }
@@ -1112,6 +1155,29 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 		Link_side_id const local_id = { ip.src(), _src_port(prot, prot_base),
 		                                ip.dst(), _dst_port(prot, prot_base) };
 
+		/* try to route via the cached flows of established UDP/TCP links */
+		try {
+			Flow const &flow = _flow_cache.find(prot, local_id, pkt.size());
+			Link_side &remote_side = flow.remote_side();
+			if (_config().verbose()) {
+				log("[", local_domain, "] using cached ", l3_protocol_name(prot),
+				    " link: ", flow.link());
+			}
+			eth.dst(flow.dst_mac());
+			ip.src(remote_side.dst_ip());
+			ip.dst(remote_side.src_ip());
+			_src_port(prot, prot_base, remote_side.dst_port());
+			_dst_port(prot, prot_base, remote_side.src_port());
+			_update_checksum(prot, prot_base, ip, flow.ip_icd(), flow.prot_icd());
+
+			remote_side.domain().interfaces().for_each([&] (Interface &interface) {
+				interface._pass_prot(eth, size_guard);
+			});
+			_link_packet(prot, prot_base, flow.link(), flow.client());
+			return;
+		}
+		catch (Flow_cache::No_match) { }
+
 		/* try to route via existing UDP/TCP links */
 		try {
 			Link_side const &local_side = local_domain.links(prot).find_by_id(local_id);
@@ -1124,13 +1190,24 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 				    " link: ", link);
 			}
 			_adapt_eth(eth, remote_side.src_ip(), pkt, remote_domain);
-			ip.src(remote_side.dst_ip());
-			ip.dst(remote_side.src_ip());
-			_src_port(prot, prot_base, remote_side.dst_port());
-			_dst_port(prot, prot_base, remote_side.src_port());
+			Internet_checksum_diff ip_icd   { };
+			Internet_checksum_diff prot_icd { };
+			ip.src(remote_side.dst_ip(), ip_icd);
+			ip.dst(remote_side.src_ip(), ip_icd);
+			_src_port(prot, prot_base, remote_side.dst_port(), prot_icd);
+			_dst_port(prot, prot_base, remote_side.src_port(), prot_icd);
+			_update_checksum(prot, prot_base, ip, ip_icd, prot_icd);
+
+			/*
+			 * The routing decision as well as the checksum differences
+			 * depend only on the connection, so, remember them for the
+			 * successive packets of the connection.
+			 */
+			_flow_cache.new_flow(prot, local_id, remote_side, client,
+			                     local_domain, eth.dst(), ip_icd, prot_icd);
 
 			remote_domain.interfaces().for_each([&] (Interface &interface) {
-				interface._pass_prot(eth, size_guard, ip, prot, prot_base, prot_size);
+				interface._pass_prot(eth, size_guard);
 			});
 			_link_packet(prot, prot_base, link, client);
 			return;
@@ -1149,9 +1226,10 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 				}
 				Domain &remote_domain = rule.domain();
 				_adapt_eth(eth, rule.to(), pkt, remote_domain);
-				ip.dst(rule.to());
-				_nat_link_and_pass(eth, size_guard, ip, prot, prot_base,
-				                   prot_size, local_id, local_domain, remote_domain);
+				Internet_checksum_diff ip_icd { };
+				ip.dst(rule.to(), ip_icd);
+				_nat_link_and_pass(eth, size_guard, ip, ip_icd, prot, prot_base,
+				                   local_id, local_domain, remote_domain);
 				return;
 			}
 			catch (Forward_rule_tree::No_match) { }
@@ -1170,7 +1248,8 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 			}
 			Domain &remote_domain = permit_rule.domain();
 			_adapt_eth(eth, local_id.dst_ip, pkt, remote_domain);
-			_nat_link_and_pass(eth, size_guard, ip, prot, prot_base, prot_size,
+			Internet_checksum_diff ip_icd { };
+			_nat_link_and_pass(eth, size_guard, ip, ip_icd, prot, prot_base,
 			                   local_id, local_domain, remote_domain);
 			return;
 		}
@@ -1255,6 +1334,7 @@ void Interface::_handle_arp_reply(Ethernet_frame &eth,
 		/* by now, no matching ARP cache entry exists, so create one */
 		Ipv4_address const ip = arp.src_ip();
 		local_domain.arp_cache().new_entry(ip, arp.src_mac());
+		local_domain.invalidate_flows();
 
 		/* continue handling of packets that waited for the entry */
 		for (Arp_waiter_list_element *waiter_le = local_domain.foreign_arp_waiters().first();
@@ -1370,9 +1450,8 @@ void Interface::_handle_arp(Ethernet_frame &eth,
 }
 
 
-void Interface::_handle_pkt()
+void Interface::_handle_pkt(Packet_descriptor const &pkt)
 {
-	Packet_descriptor const pkt = _sink.get_packet();
 	Size_guard size_guard(pkt.size());
 	try {
 		_handle_eth(_sink.packet_content(pkt), size_guard, pkt);
@@ -1385,20 +1464,40 @@ void Interface::_handle_pkt()
 
 void Interface::_ready_to_submit()
 {
+	_interfaces.for_each([&] (Interface &interface) {
+		interface._submit_deferred = true; });
+
+	_acks_deferred = true;
+
 	unsigned long const max_pkts = _config().max_packets_per_signal();
-	if (max_pkts) {
-		for (unsigned long i = 0; _sink.packet_avail(); i++) {
+	Packet_descriptor   pkts[PKT_BATCH];
+	for (unsigned long handled = 0; ; ) {
 
-			if (i >= max_pkts) {
+		unsigned max = PKT_BATCH;
+		if (max_pkts) {
+			if (handled >= max_pkts) {
 				Signal_transmitter(_sink_submit).submit();
 				break;
 			}
-			_handle_pkt();
+			max = (unsigned)Genode::min((unsigned long)max, max_pkts - handled);
 		}
-	} else {
-		while (_sink.packet_avail()) {
-			_handle_pkt(); }
+		unsigned const nr_of_pkts = _sink.get_packets(pkts, max);
+		for (unsigned i = 0; i < nr_of_pkts; i++) {
+			_handle_pkt(pkts[i]); }
+
+		_flush_acks();
+		handled += nr_of_pkts;
+
+		/* a short batch re-armed the signal for the next packet */
+		if (nr_of_pkts < max) {
+			break; }
 	}
+	_acks_deferred = false;
+
+	_interfaces.for_each([&] (Interface &interface) {
+		interface._submit_deferred = false;
+		interface._flush_pkts();
+	});
 }
 
 
@@ -1422,8 +1521,15 @@ void Interface::_continue_handle_eth(Domain            const &domain,
 
 void Interface::_ready_to_ack()
 {
-	while (_source.ack_avail()) {
-		_source.release_packet(_source.get_acked_packet()); }
+	Packet_descriptor pkts[PKT_BATCH];
+	for (;;) {
+		unsigned const nr_of_pkts = _source.get_acked_packets(pkts, PKT_BATCH);
+		for (unsigned i = 0; i < nr_of_pkts; i++) {
+			_source.release_packet(pkts[i]); }
+
+		if (nr_of_pkts < PKT_BATCH) {
+			break; }
+	}
 }
 
 
@@ -1610,7 +1716,23 @@ void Interface::_send_submit_pkt(Packet_descriptor &pkt,
 		}
 		catch (Size_guard::Exceeded) { log("[", local_domain, "] snd ?"); }
 	}
-	_source.submit_packet(pkt);
+	if (!_submit_deferred) {
+		_source.submit_packet(pkt);
+		return;
+	}
+	_pending_pkts[_nr_of_pending_pkts++] = pkt;
+	if (_nr_of_pending_pkts == PKT_BATCH) {
+		_flush_pkts(); }
+}
+
+
+void Interface::_flush_pkts()
+{
+	if (!_nr_of_pending_pkts) {
+		return; }
+
+	_source.submit_packets(_pending_pkts, _nr_of_pending_pkts);
+	_nr_of_pending_pkts = 0;
 }
 
 
@@ -1840,6 +1962,9 @@ void Interface::_update_own_arp_waiters(Domain &domain)
 
 void Interface::handle_config_1(Configuration &config)
 {
+	/* cached flows may refer to state objects of the old configuration */
+	_flow_cache.flush();
+
 	/* update config and policy */
 	_config = config;
 	_policy.handle_config(config);
@@ -1955,6 +2080,12 @@ void Interface::handle_config_3()
 
 void Interface::_ack_packet(Packet_descriptor const &pkt)
 {
+	if (_acks_deferred) {
+		_pending_acks[_nr_of_pending_acks++] = pkt;
+		if (_nr_of_pending_acks == PKT_BATCH) {
+			_flush_acks(); }
+		return;
+	}
 	if (!_sink.ready_to_ack()) {
 		if (_config().verbose()) {
 			log("[", _domain(), "] leak packet (sink not ready to "
@@ -1966,6 +2097,23 @@ void Interface::_ack_packet(Packet_descriptor const &pkt)
 }
 
 
+void Interface::_flush_acks()
+{
+	unsigned nr_of_acks = _nr_of_pending_acks;
+	_nr_of_pending_acks = 0;
+
+	unsigned const nr_of_slots = _sink.ack_slots_free();
+	if (nr_of_acks > nr_of_slots) {
+		if (_config().verbose()) {
+			log("[", _domain(), "] leak ", nr_of_acks - nr_of_slots,
+			    " packets (sink not ready to acknowledge)");
+		}
+		nr_of_acks = nr_of_slots;
+	}
+	_sink.acknowledge_packets(_pending_acks, nr_of_acks);
+}
+
+
 void Interface::cancel_arp_waiting(Arp_waiter &waiter)
 {
 	try {
@@ -1991,18 +2139,24 @@ Interface::~Interface()
 
 void Interface::report(Genode::Xml_generator &xml)
 {
-	bool const stats = _config().report().stats();
-	if (stats) {
+	bool const stats      = _config().report().stats();
+	bool const flow_cache = _config().report().flow_cache();
+	if (stats || flow_cache) {
 		xml.node("interface",  [&] () {
 			bool empty = true;
 			xml.attribute("label", _policy.label());
-			try { _policy.report(xml); empty = false; } catch (Report::Empty) { }
-
-			try { xml.node("tcp-links",        [&] () { _tcp_stats.report(xml);  }); empty = false; } catch (Report::Empty) { }
-			try { xml.node("udp-links",        [&] () { _udp_stats.report(xml);  }); empty = false; } catch (Report::Empty) { }
-			try { xml.node("icmp-links",       [&] () { _icmp_stats.report(xml); }); empty = false; } catch (Report::Empty) { }
-			try { xml.node("arp-waiters",      [&] () { _arp_stats.report(xml);  }); empty = false; } catch (Report::Empty) { }
-			try { xml.node("dhcp-allocations", [&] () { _dhcp_stats.report(xml); }); empty = false; } catch (Report::Empty) { }
+			if (stats) {
+				try { _policy.report(xml); empty = false; } catch (Report::Empty) { }
+
+				try { xml.node("tcp-links",        [&] () { _tcp_stats.report(xml);  }); empty = false; } catch (Report::Empty) { }
+				try { xml.node("udp-links",        [&] () { _udp_stats.report(xml);  }); empty = false; } catch (Report::Empty) { }
+				try { xml.node("icmp-links",       [&] () { _icmp_stats.report(xml); }); empty = false; } catch (Report::Empty) { }
+				try { xml.node("arp-waiters",      [&] () { _arp_stats.report(xml);  }); empty = false; } catch (Report::Empty) { }
+				try { xml.node("dhcp-allocations", [&] () { _dhcp_stats.report(xml); }); empty = false; } catch (Report::Empty) { }
+			}
+			if (flow_cache) {
+				try { xml.node("flow-cache",       [&] () { _flow_cache.report(xml); }); empty = false; } catch (Report::Empty) { }
+			}
 			if (empty) { throw Report::Empty(); }
 		});
 	}
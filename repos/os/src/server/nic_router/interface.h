@@ -22,6 +22,7 @@
 #include <dhcp_server.h>
 #include <list.h>
 #include <report.h>
+#include <flow_cache.h>
 
 /* Genode includes */
 #include <nic_session/nic_session.h>
@@ -110,6 +111,7 @@ class Net::Interface : private Interface_list::Element
 
 		enum { IPV4_TIME_TO_LIVE          = 64 };
 		enum { MAX_FREE_OPS_PER_EMERGENCY = 1024 };
+		enum { PKT_BATCH                  = 64 };
 
 		struct Dismiss_link       : Genode::Exception { };
 		struct Dismiss_arp_waiter : Genode::Exception { };
@@ -159,6 +161,19 @@ class Net::Interface : private Interface_list::Element
 		Interface_link_stats                  _icmp_stats                { };
 		Interface_object_stats                _arp_stats                 { };
 		Interface_object_stats                _dhcp_stats                { };
+		Flow_cache                            _flow_cache                { };
+
+		/*
+		 * While an interface handles a batch of received packets, the
+		 * acknowledgements of the batch and the packets sent at any
+		 * interface are queued and passed on at the end of the batch.
+		 */
+		Packet_descriptor                     _pending_acks[PKT_BATCH]   { };
+		unsigned                              _nr_of_pending_acks        { 0 };
+		bool                                  _acks_deferred             { false };
+		Packet_descriptor                     _pending_pkts[PKT_BATCH]   { };
+		unsigned                              _nr_of_pending_pkts        { 0 };
+		bool                                  _submit_deferred           { false };
 
 		void _new_link(L3_protocol             const  protocol,
 		               Link_side_id            const &local_id,
@@ -232,7 +247,6 @@ class Net::Interface : private Interface_list::Element
 		                        Packet_descriptor const &pkt,
 		                        L3_protocol              prot,
 		                        void                    *prot_base,
-		                        Genode::size_t           prot_size,
 		                        Domain                  &local_domain);
 
 		void _handle_icmp_error(Ethernet_frame          &eth,
@@ -261,9 +275,9 @@ class Net::Interface : private Interface_list::Element
 		void _nat_link_and_pass(Ethernet_frame         &eth,
 		                        Size_guard             &size_guard,
 		                        Ipv4_packet            &ip,
+		                        Internet_checksum_diff &ip_icd,
 		                        L3_protocol      const  prot,
 		                        void            *const  prot_base,
-		                        Genode::size_t   const  prot_size,
 		                        Link_side_id     const &local_id,
 		                        Domain                 &local_domain,
 		                        Domain                 &remote_domain);
@@ -275,18 +289,18 @@ class Net::Interface : private Interface_list::Element
 		                       Size_guard     &size_guard,
 		                       Domain         &local_domain);
 
-		void _pass_prot(Ethernet_frame         &eth,
-		                Size_guard             &size_guard,
-		                Ipv4_packet            &ip,
-		                L3_protocol      const  prot,
-		                void            *const  prot_base,
-		                Genode::size_t   const  prot_size);
+		void _pass_prot(Ethernet_frame &eth,
+		                Size_guard     &size_guard);
 
 		void _pass_ip(Ethernet_frame       &eth,
 		              Size_guard           &size_guard,
 		              Ipv4_packet          &ip);
 
-		void _handle_pkt();
+		void _handle_pkt(Packet_descriptor const &pkt);
+
+		void _flush_acks();
+
+		void _flush_pkts();
 
 		void _continue_handle_eth(Domain            const &domain,
 		                          Packet_descriptor const &pkt);
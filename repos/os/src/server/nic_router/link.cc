@@ -170,6 +170,8 @@ void Link::dissolve(bool timeout)
 
 	_client.domain().links(_protocol).remove(&_client);
 	_server.domain().links(_protocol).remove(&_server);
+	_client.domain().invalidate_flows();
+	_server.domain().invalidate_flows();
 	if (_config().verbose()) {
 		log("Dissolve ", l3_protocol_name(_protocol), " link: ", *this); }
 
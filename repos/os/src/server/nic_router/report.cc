@@ -34,6 +34,7 @@ Net::Report::Report(bool        const &verbose,
 	_bytes           { node.attribute_value("bytes", true) },
 	_stats           { node.attribute_value("stats", true) },
 	_quota           { node.attribute_value("quota", true) },
+	_flow_cache      { node.attribute_value("flow_cache", false) },
 	_shared_quota    { shared_quota },
 	_pd              { pd },
 	_reporter        { reporter },
@@ -42,6 +43,7 @@ Net::Report::Report(bool        const &verbose,
 	                   read_sec_attr(node, "interval_sec", 5) }
 {
 	_reporter.enabled(true);
+	_reporter.incremental(node.attribute_value("delta", false));
 }
 
 
@@ -49,6 +49,7 @@ class Net::Report
 		bool                      const  _bytes;
 		bool                      const  _stats;
 		bool                      const  _quota;
+		bool                      const  _flow_cache;
 		Quota                     const &_shared_quota;
 		Genode::Pd_session              &_pd;
 		Genode::Reporter                &_reporter;
@@ -78,9 +79,10 @@ class Net::Report
 		 ** Accessors **
 		 ***************/
 
-		bool config() const { return _config; }
-		bool bytes()  const { return _bytes; }
-		bool stats()  const { return _stats; }
+		bool config()     const { return _config; }
+		bool bytes()      const { return _bytes; }
+		bool stats()      const { return _stats; }
+		bool flow_cache() const { return _flow_cache; }
 };
 
 #endif /* _REPORT_H_ */
@@ -293,6 +293,20 @@ struct Nitpicker::Main : Focus_updater
 	Reporter _keystate_reporter = { _env, "keystate" };
 	Reporter _clicked_reporter  = { _env, "clicked" };
 	Reporter _displays_reporter = { _env, "displays" };
+	Reporter _stats_reporter    = { _env, "stats" };
+
+	/*
+	 * Drawing statistics
+	 */
+	unsigned long long _frames         = 0;
+	unsigned long long _pixels_flushed = 0;
+
+	/**
+	 * Number of periods between two stats reports
+	 */
+	unsigned _stats_interval = 100;
+
+	void _report_stats();
 
 	Attached_rom_dataspace _config_rom { _env, "config" };
 
@@ -480,12 +494,21 @@ void Nitpicker::Main::_handle_input()
 		_view_stack.geometry(_pointer_origin, Rect(_user_state.pointer_pos(), Area()));
 
 	/* perform redraw and flush pixels to the framebuffer */
+	bool drawn = false;
 	_view_stack.draw(_fb_screen->screen, _font).flush([&] (Rect const &rect) {
 		_framebuffer.refresh(rect.x1(), rect.y1(),
-		                     rect.w(),  rect.h()); });
+		                     rect.w(),  rect.h());
+		_pixels_flushed += rect.area().count();
+		drawn = true; });
 
 	_view_stack.mark_all_views_as_clean();
 
+	if (drawn)
+		_frames++;
+
+	if (_period_cnt % _stats_interval == 0)
+		_report_stats();
+
 	/* deliver framebuffer synchronization events */
 	for (Session_component *s = _session_list.first(); s; s = s->next())
 		s->submit_sync();
@@ -552,6 +575,7 @@ void Nitpicker::Main::_handle_config()
 	configure_reporter(config, _keystate_reporter);
 	configure_reporter(config, _clicked_reporter);
 	configure_reporter(config, _displays_reporter);
+	configure_reporter(config, _stats_reporter);
 
 	/* update domain registry and session policies */
 	for (Session_component *s = _session_list.first(); s; s = s->next())
@@ -610,6 +634,20 @@ void Nitpicker::Main::_report_displays()
 }
 
 
+void Nitpicker::Main::_report_stats()
+{
+	if (!_stats_reporter.enabled())
+		return;
+
+	Reporter::Xml_generator xml(_stats_reporter, [&] () {
+		xml.attribute("periods",        _period_cnt);
+		xml.attribute("frames",         _frames);
+		xml.attribute("pixels_drawn",   _view_stack.pixels_drawn());
+		xml.attribute("pixels_flushed", _pixels_flushed);
+	});
+}
+
+
 void Nitpicker::Main::_handle_fb_mode()
 {
 	/* reconstruct framebuffer screen and menu bar */
@@ -32,6 +32,13 @@ namespace Nitpicker {
 
 	typedef Dirty_rect<Rect, 3> Dirty_rect;
 
+	/*
+	 * The dirty area of the whole screen collects the updates of all views
+	 * until the next frame is drawn. Using more rectangles than for a
+	 * single view avoids merging distant updates into one large area.
+	 */
+	typedef Genode::Dirty_rect<Rect, 8> Screen_dirty_rect;
+
 	/*
 	 * For each buffer, there is a list of views that belong to this buffer.
 	 */
@@ -192,11 +192,17 @@ void View_stack::draw_rec(Canvas_base &canvas, Font const &font,
 	/* draw current view */
 	view->dirty_rect().flush([&] (Rect const &dirty_rect) {
 
-		Clip_guard clip_guard(canvas, Rect::intersect(clipped, dirty_rect));
+		Rect const drawn = Rect::intersect(clipped, dirty_rect);
+		if (!drawn.valid())
+			return;
+
+		_pixels_drawn += drawn.area().count();
+
+		Clip_guard clip_guard(canvas, drawn);
 
 		/* draw background if view is transparent */
 		if (view->uses_alpha())
-			draw_rec(canvas, font, _next_view(*view), clipped);
+			draw_rec(canvas, font, _next_view(*view), drawn);
 
 		view->frame(canvas, _focus);
 		view->draw(canvas, font, _focus);
@@ -213,8 +219,21 @@ void View_stack::refresh_view(View_component &view, Rect const rect)
 	/* rectangle constrained to view geometry */
 	Rect const view_rect = Rect::intersect(rect, _outline(view));
 
-	for (View_component *v = _first_view(); v; v = v->view_stack_next())
-		_mark_view_as_dirty(*v, view_rect);
+	if (view_rect.valid()) {
+
+		_dirty_rect.mark_as_dirty(view_rect);
+
+		/*
+		 * Views that do not overlap with the refreshed area are not drawn
+		 * within it. Marking them as dirty would needlessly enlarge their
+		 * dirty rectangles.
+		 */
+		for (View_component *v = _first_view(); v; v = v->view_stack_next()) {
+			Rect const r = Rect::intersect(view_rect, _outline(*v));
+			if (r.valid())
+				v->mark_as_dirty(r);
+		}
+	}
 
 	view.for_each_child([&] (View_component &child) { refresh_view(child, rect); });
 }
@@ -29,7 +29,10 @@ class Nitpicker::View_stack
 		Focus                 &_focus;
 		List<View_stack_elem>  _views { };
 		View_component        *_default_background = nullptr;
-		Dirty_rect mutable     _dirty_rect { };
+		Screen_dirty_rect mutable _dirty_rect { };
+
+		/* number of view pixels drawn so far, for statistics */
+		unsigned long long mutable _pixels_drawn = 0;
 
 		/**
 		 * Return outline geometry of a view
@@ -120,9 +123,9 @@ class Nitpicker::View_stack
 		/**
 		 * Draw dirty areas
 		 */
-		Dirty_rect draw(Canvas_base &canvas, Font const &font) const
+		Screen_dirty_rect draw(Canvas_base &canvas, Font const &font) const
 		{
-			Dirty_rect result = _dirty_rect;
+			Screen_dirty_rect result = _dirty_rect;
 
 			_dirty_rect.flush([&] (Rect const &rect) {
 				draw_rec(canvas, font, _first_view(), rect); });
@@ -130,6 +133,11 @@ class Nitpicker::View_stack
 			return result;
 		}
 
+		/**
+		 * Return number of view pixels drawn so far
+		 */
+		unsigned long long pixels_drawn() const { return _pixels_drawn; }
+
 		/**
 		 * Trigger redraw of the whole view stack
 		 */
@@ -13,6 +13,7 @@
 
 /* Genode includes */
 #include <file_system/open_node.h>
+#include <file_system/util.h>
 #include <file_system_session/rpc_object.h>
 #include <base/component.h>
 #include <base/attached_rom_dataspace.h>
@@ -108,6 +109,44 @@ class Ram_fs::Session_component : public File_system::Session_rpc_object
 				open_node.mark_as_written();
 				break;
 
+			case Packet_descriptor::READV: {
+				Locked_ptr<Node> node { open_node.node() };
+				if (!node.valid())
+					break;
+
+				unsigned next = 0;
+				res_length = File_system::transfer_extents(packet,
+					tx_sink()->packet_content(packet), next,
+					[&] (seek_off_t pos, char *dst, size_t len) {
+						return node->read(dst, len, pos); });
+
+				/* extents beyond EOF are reported as short or empty */
+				succeeded = true;
+				break;
+			}
+
+			case Packet_descriptor::WRITEV: {
+				Locked_ptr<Node> node { open_node.node() };
+				if (!node.valid())
+					break;
+
+				unsigned next = 0;
+				res_length = File_system::transfer_extents(packet,
+					tx_sink()->packet_content(packet), next,
+					[&] (seek_off_t pos, char *src, size_t len) {
+						return node->write(src, len, pos); });
+
+				/* File system session can't handle partial writes */
+				if (next != packet.length()) {
+					Genode::error("partial vectored write detected");
+					/* don't acknowledge */
+					return;
+				}
+				succeeded = true;
+				open_node.mark_as_written();
+				break;
+			}
+
 			case Packet_descriptor::CONTENT_CHANGED:
 				Genode::error("CONTENT_CHANGED packets from clients have no effect");
 				return;
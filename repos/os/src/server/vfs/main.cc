@@ -15,9 +15,11 @@
 /* Genode includes */
 #include <base/component.h>
 #include <base/registry.h>
+#include <util/fifo.h>
 #include <base/heap.h>
 #include <base/attached_rom_dataspace.h>
 #include <file_system_session/rpc_object.h>
+#include <file_system/util.h>
 #include <root/component.h>
 #include <os/session_policy.h>
 #include <base/allocator_guard.h>
@@ -41,6 +43,8 @@ namespace Vfs_server {
 
 	typedef Genode::Registered<Session_component> Registered_session;
 	typedef Genode::Registry<Registered_session>  Session_registry;
+	typedef Genode::Fifo_element<Session_component> Session_queue_element;
+	typedef Genode::Fifo<Session_queue_element>     Session_queue;
 
 	/**
 	 * Convenience utities for parsing quotas
@@ -81,10 +85,30 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 		bool const _writable;
 
 		/*
-		 * XXX Currently, we have only one packet in backlog, which must finish
-		 *     processing before new packets can be processed.
+		 * Packets that could not be completed immediately
+		 *
+		 * Packets stay pending while the VFS plugin is not ready or an
+		 * earlier packet for the same handle is still pending. Pending
+		 * packets are retried on each I/O response, thereby packets are
+		 * completed out of order but in order per handle.
 		 */
-		Packet_descriptor _backlog_packet { };
+		enum { MAX_PENDING = TX_QUEUE_SIZE };
+
+		struct Pending
+		{
+			Packet_descriptor packet { };
+
+			/* progress of a vectored operation, see 'transfer_extents' */
+			unsigned extent { 0 };
+			size_t   length { 0 };
+		};
+
+		Pending  _pending[MAX_PENDING] { };
+		unsigned _num_pending { 0 };
+
+		/* sessions with pending packets, visited on general I/O progress */
+		Session_queue         &_pending_sessions;
+		Session_queue_element  _pending_element { this };
 
 		/****************************
 		 ** Handle to node mapping **
@@ -138,8 +162,10 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 		 * \throw Not_ready
 		 * \throw Dont_ack
 		 */
-		void _process_packet_op(Packet_descriptor &packet)
+		void _process_packet_op(Pending &pending)
 		{
+			Packet_descriptor &packet = pending.packet;
+
 			/* assume failure by default */
 			packet.succeeded(false);
 
@@ -234,85 +260,136 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 					throw Not_ready();
 				} catch (...) { Genode::error("SYNC: unhandled exception"); }
 				break;
+
+			case Packet_descriptor::READV:
+
+				try {
+					_apply(packet.handle(), [&] (Io_node &node) {
+						if (!(node.mode() & READ_ONLY))
+							return;
+
+						if (!node.read_ready()) {
+							node.notify_read_ready(true);
+							throw Not_ready();
+						}
+
+						/*
+						 * A short read of an extent ends the transfer and the
+						 * packet is acknowledged with the bytes read so far.
+						 * Only if the node throws 'Operation_incomplete', the
+						 * packet stays pending and the retry resumes at the
+						 * extent recorded in 'pending.extent'.
+						 */
+						File_system::transfer_extents(packet,
+							(char *)tx_sink()->packet_content(packet), pending.extent,
+							[&] (seek_off_t pos, char *dst, size_t len) {
+								size_t const n = node.read(dst, len, pos);
+								pending.length += n;
+								return n; });
+
+						res_length = pending.length;
+						succeeded  = true;
+					});
+				}
+				catch (Not_ready) { throw; }
+				catch (Operation_incomplete) { throw Not_ready(); }
+				catch (...) { }
+
+				break;
+
+			case Packet_descriptor::WRITEV:
+
+				try {
+					_apply(packet.handle(), [&] (Io_node &node) {
+						if (!(node.mode() & WRITE_ONLY))
+							return;
+
+						File_system::transfer_extents(packet,
+							(char *)tx_sink()->packet_content(packet), pending.extent,
+							[&] (seek_off_t pos, char *src, size_t len) {
+								size_t const n = node.write(src, len, pos);
+								pending.length += n;
+								return n; });
+
+						/* File system session can't handle partial writes */
+						if (pending.extent != packet.length()) {
+							Genode::error("partial vectored write detected");
+							throw Dont_ack();
+						}
+						res_length = pending.length;
+						succeeded  = true;
+					});
+				} catch (Dont_ack) {
+					throw;
+				} catch (Operation_incomplete) {
+					throw Not_ready();
+				} catch (...) { }
+				break;
 			}
 
 			packet.length(res_length);
 			packet.succeeded(succeeded);
 		}
 
-		bool _try_process_packet_op(Packet_descriptor &packet)
+		/**
+		 * Return true if packet must wait for one of the first 'num'
+		 * pending packets
+		 *
+		 * Only reads of distinct handles are reordered, any other pending
+		 * operation keeps succeeding packets from overtaking it.
+		 */
+		bool _blocked(Packet_descriptor const &packet, unsigned const num) const
 		{
-			try {
-				_process_packet_op(packet);
-				return true;
-			} catch (Not_ready) {
-				_backlog_packet = packet;
-			}
+			for (unsigned i = 0; i < num; i++) {
+				Packet_descriptor const &p = _pending[i].packet;
 
+				if (p.handle().value == packet.handle().value
+				 || p.operation()    != Packet_descriptor::READ)
+					return true;
+			}
 			return false;
 		}
 
-		bool _process_backlog()
+		/**
+		 * Try to complete packet
+		 *
+		 * \return false if the packet has to stay pending
+		 */
+		bool _try_process_packet(Pending &pending)
 		{
-			/* indicate success if there's no backlog */
-			if (!_backlog_packet.size() &&
-			    (_backlog_packet.operation() != Packet_descriptor::SYNC)) {
-				return true;
-			}
-
-			/* only start processing if acknowledgement is possible */
-			if (!tx_sink()->ready_to_ack())
-				return false;
-
-			if (!_try_process_packet_op(_backlog_packet))
-				return false;
+			try { _process_packet_op(pending); }
+			catch (Not_ready) { return false; }
+			catch (Dont_ack)  { return true; }
 
 			/*
 			 * The 'acknowledge_packet' function cannot block because we
-			 * checked for 'ready_to_ack' in '_process_packets'.
+			 * checked for 'ready_to_ack' beforehand.
 			 */
-			tx_sink()->acknowledge_packet(_backlog_packet);
-
-			/* invalidate backlog packet */
-			_backlog_packet = Packet_descriptor();
-
+			tx_sink()->acknowledge_packet(pending.packet);
 			return true;
 		}
 
-		bool _process_packet()
+		/**
+		 * Retry pending packets in the order they were received
+		 */
+		void _process_pending()
 		{
-			Packet_descriptor packet = tx_sink()->get_packet();
-
-			if (!_try_process_packet_op(packet))
-				return false;
+			unsigned num = 0;
 
-			/*
-			 * The 'acknowledge_packet' function cannot block because we
-			 * checked for 'ready_to_ack' in '_process_packets'.
-			 */
-			tx_sink()->acknowledge_packet(packet);
+			for (unsigned i = 0; i < _num_pending; i++) {
+				Pending pending = _pending[i];
 
-			return true;
+				bool const done = tx_sink()->ready_to_ack()
+				               && !_blocked(pending.packet, num)
+				               && _try_process_packet(pending);
+				if (!done)
+					_pending[num++] = pending;
+			}
+			_num_pending = num;
 		}
 
-		/**
-		 * Called by signal dispatcher, executed in the context of the main
-		 * thread (not serialized with the RPC functions)
-		 */
-		void _process_packets()
+		void _process_new_packets()
 		{
-			using namespace Genode;
-
-			/*
-			 * XXX Process client backlog before looking at new requests. This
-			 *     limits the number of simultaneously addressed handles (which
-			 *     was also the case before adding the backlog in case of
-			 *     blocking operations).
-			 */
-			if (!_process_backlog())
-				/* backlog not cleared - block for next condition change */
-				return;
-
 			/**
 			 * Process packets in batches, otherwise a client that
 			 * submits packets as fast as they are processed will
@@ -323,32 +400,58 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 			while (tx_sink()->packet_avail()) {
 				if (--quantum == 0) {
 					/* come back to this later */
-					Signal_transmitter(_process_packet_handler).submit();
+					Genode::Signal_transmitter(_process_packet_handler).submit();
 					break;
 				}
 
 				/*
-				 * Make sure that the '_process_packet' function does not
+				 * Make sure that the '_try_process_packet' function does not
 				 * block.
 				 *
 				 * If the acknowledgement queue is full, we defer packet
 				 * processing until the client processed pending
 				 * acknowledgements and thereby emitted a ready-to-ack
 				 * signal. Otherwise, the call of 'acknowledge_packet()'
-				 * in '_process_packet' would infinitely block the context
+				 * in '_try_process_packet' would infinitely block the context
 				 * of the main thread. The main thread is however needed
 				 * for receiving any subsequent 'ready-to-ack' signals.
 				 */
 				if (!tx_sink()->ready_to_ack())
 					return;
 
-				try {
-					if (!_process_packet())
-						return;
-				} catch (Dont_ack) { }
+				/*
+				 * Leave the packet in the submit queue if there is no room
+				 * to keep it pending, the next I/O response resumes the
+				 * processing.
+				 */
+				if (_num_pending == MAX_PENDING)
+					return;
+
+				Pending pending { };
+				pending.packet = tx_sink()->get_packet();
+
+				if (_blocked(pending.packet, _num_pending) || !_try_process_packet(pending))
+					_pending[_num_pending++] = pending;
 			}
 		}
 
+		/**
+		 * Called by signal dispatcher, executed in the context of the main
+		 * thread (not serialized with the RPC functions)
+		 */
+		void _process_packets()
+		{
+			_process_pending();
+			_process_new_packets();
+
+			/* only sessions with pending packets wait for I/O progress */
+			bool const enqueued = _pending_element.enqueued();
+			if (_num_pending && !enqueued)
+				_pending_sessions.enqueue(&_pending_element);
+			if (!_num_pending && enqueued)
+				_pending_sessions.remove(&_pending_element);
+		}
+
 		/**
 		 * Check if string represents a valid path (must start with '/')
 		 */
@@ -389,6 +492,7 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 		 * \param tx_buf_size  shared transmission buffer size
 		 * \param root_path    path root of the session
 		 * \param writable     whether the session can modify files
+		 * \param pending_sessions  queue of sessions waiting for I/O progress
 		 */
 
 		Session_component(Genode::Env          &env,
@@ -398,7 +502,8 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 		                  size_t                tx_buf_size,
 		                  Vfs::File_system     &vfs,
 		                  char           const *root_path,
-		                  bool                  writable)
+		                  bool                  writable,
+		                  Session_queue        &pending_sessions)
 		:
 			Session_rpc_object(env.ram().alloc(tx_buf_size), env.rm(), env.ep().rpc_ep()),
 			_ram_guard(ram_quota),
@@ -409,7 +514,8 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 			_vfs(vfs),
 			_root_path(root_path),
 			_label(label),
-			_writable(writable)
+			_writable(writable),
+			_pending_sessions(pending_sessions)
 		{
 			/*
 			 * Register '_process_packets' dispatch function as signal
@@ -424,6 +530,9 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 		 */
 		~Session_component()
 		{
+			if (_pending_element.enqueued())
+				_pending_sessions.remove(&_pending_element);
+
 			while (_node_space.apply_any<Node>([&] (Node &node) {
 				_close(node); })) { }
 		}
@@ -451,7 +560,7 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
 
 		void handle_node_io(Io_node &node) override
 		{
-			_process_backlog();
+			_process_packets();
 
 			if (!tx_sink()->ready_to_ack()) {
 				Genode::error(
@@ -695,13 +804,13 @@ class Vfs_server::Session_component : public File_system::Session_rpc_object,
  */
 struct Vfs_server::Io_response_handler : Vfs::Io_response_handler
 {
-	Session_registry &_session_registry;
+	Session_queue &_pending_sessions;
 
 	bool _in_progress  { false };
 	bool _handle_general_io { false };
 
-	Io_response_handler(Session_registry &session_registry)
-	: _session_registry(session_registry) { }
+	Io_response_handler(Session_queue &pending_sessions)
+	: _pending_sessions(pending_sessions) { }
 
 	void handle_io_response(Vfs::Vfs_handle::Context *context) override
 	{
@@ -720,9 +829,19 @@ struct Vfs_server::Io_response_handler : Vfs::Io_response_handler
 
 		while (_handle_general_io) {
 			_handle_general_io = false;
-			_session_registry.for_each([ ] (Registered_session &r) {
-				r.handle_general_io();
-			});
+
+			/*
+			 * Visit each waiting session once in the order the sessions
+			 * started waiting. Sessions that still have pending packets
+			 * enqueue themselves again and are thereby served last in
+			 * the next round.
+			 */
+			Session_queue waiting;
+			while (Session_queue_element *e = _pending_sessions.dequeue())
+				waiting.enqueue(e);
+
+			while (Session_queue_element *e = waiting.dequeue())
+				e->object()->handle_general_io();
 		}
 
 		_in_progress = false;
@@ -759,8 +878,8 @@ class Vfs_server::Vfs_env final : Vfs::Env
 	public:
 
 		Vfs_env(Genode::Env &env, Genode::Xml_node config,
-		        Session_registry &sessions)
-		: _env(env), _io_handler(sessions),
+		        Session_queue &pending_sessions)
+		: _env(env), _io_handler(pending_sessions),
 		  _root_dir(*this, config, _global_file_system_factory)
 		{ }
 
@@ -797,8 +916,9 @@ class Vfs_server::Root : public Genode::Root_component<Session_component>
 		}
 
 		Session_registry _session_registry { };
+		Session_queue    _pending_sessions { };
 
-		Vfs_env _vfs_env { _env, vfs_config(), _session_registry };
+		Vfs_env _vfs_env { _env, vfs_config(), _pending_sessions };
 
 		Genode::Signal_handler<Root> _config_handler {
 			_env.ep(), *this, &Root::_config_update };
@@ -895,7 +1015,8 @@ class Vfs_server::Root : public Genode::Root_component<Session_component>
 				                   Genode::Ram_quota{ram_quota},
 				                   Genode::Cap_quota{cap_quota},
 				                   tx_buf_size, _vfs_env.root_dir(),
-				                   session_root.base(), writeable);
+				                   session_root.base(), writeable,
+				                   _pending_sessions);
 
 			auto ram_used = _env.pd().used_ram().value - initial_ram_usage;
 			auto cap_used = _env.pd().used_caps().value - initial_cap_usage;
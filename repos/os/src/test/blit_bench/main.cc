@@ -0,0 +1,128 @@
+/*
+ * \brief  Pixel-throughput benchmark of the blit library
+ * \author Genode Labs
+ * \date   2018-12-11
+ *
+ * The benchmark applies the pixel operations of the blit library to
+ * full-HD buffers and compares them with the per-pixel loops of the
+ * 'Texture_painter' and 'Dither_painter'. For each variant, it reports
+ * the pixel throughput and the time needed per frame.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/attached_ram_dataspace.h>
+#include <blit/blit.h>
+#include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
+#include <os/dither_painter.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	enum { W = 1920, H = 1080, DURATION_MS = 2000 };
+
+	typedef Surface_base::Area  Area;
+	typedef Surface_base::Point Point;
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Attached_ram_dataspace src_ds    { env.ram(), env.rm(), W*H*sizeof(Pixel_rgb888) };
+	Attached_ram_dataspace dst_ds    { env.ram(), env.rm(), W*H*sizeof(Pixel_rgb888) };
+	Attached_ram_dataspace alpha_ds  { env.ram(), env.rm(), W*H };
+	Attached_ram_dataspace rgb565_ds { env.ram(), env.rm(), W*H*sizeof(Pixel_rgb565) };
+
+	Pixel_rgb888  * const src    = src_ds.local_addr<Pixel_rgb888>();
+	Pixel_rgb888  * const dst    = dst_ds.local_addr<Pixel_rgb888>();
+	unsigned char * const alpha  = alpha_ds.local_addr<unsigned char>();
+	Pixel_rgb565  * const rgb565 = rgb565_ds.local_addr<Pixel_rgb565>();
+
+	/**
+	 * Apply 'fn' to whole frames for 'DURATION_MS' and log the throughput
+	 */
+	template <typename FN>
+	void measure(char const *brief, FN const &fn)
+	{
+		unsigned long  frames   = 0;
+		unsigned const start_ms = timer.elapsed_ms();
+
+		for (; timer.elapsed_ms() - start_ms < DURATION_MS; frames++)
+			fn();
+
+		unsigned long const ms = timer.elapsed_ms() - start_ms;
+
+		log(brief, ": ", frames, " frames in ", ms, " ms (",
+		    ms ? (frames*W*H/1000)/ms : 0, " MPixel/sec, ",
+		    frames ? (ms*1000)/frames : 0, " us/frame)");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- blit benchmark ---");
+
+		/* pseudo-random pixels and alpha values, a quarter being transparent */
+		unsigned seed = 1;
+		for (unsigned i = 0; i < W*H; i++) {
+			seed = seed*1103515245 + 12345;
+			src[i].pixel = seed;
+			dst[i].pixel = seed >> 8;
+			alpha[i]     = (seed >> 24) & 3 ? seed >> 16 : 0;
+		}
+
+		measure("per-pixel alpha blending", [&] () {
+			for (unsigned i = 0; i < W*H; i++)
+				if (alpha[i])
+					dst[i] = Pixel_rgb888::mix(dst[i], src[i], alpha[i]); });
+
+		measure("blend_rgb888", [&] () {
+			blend_rgb888(src, W*sizeof(Pixel_rgb888), alpha, W,
+			             dst, W*sizeof(Pixel_rgb888), W, H); });
+
+		Texture<Pixel_rgb888> const texture(src, nullptr, Area(W, H));
+		Surface<Pixel_rgb565>       surface(rgb565, Area(W, H));
+
+		measure("Dither_painter", [&] () {
+			Dither_painter::paint(surface, texture, Point(0, 0)); });
+
+		measure("dither_rgb888_to_rgb565", [&] () {
+			dither_rgb888_to_rgb565(src, W*sizeof(Pixel_rgb888),
+			                        rgb565, W*sizeof(Pixel_rgb565), W, H, 0, 0); });
+
+		measure("convert_rgb888_to_rgb565", [&] () {
+			convert_rgb888_to_rgb565(src, W*sizeof(Pixel_rgb888),
+			                         rgb565, W*sizeof(Pixel_rgb565), W, H); });
+
+		measure("convert_rgb565_to_rgb888", [&] () {
+			convert_rgb565_to_rgb888(rgb565, W*sizeof(Pixel_rgb565),
+			                         dst, W*sizeof(Pixel_rgb888), W, H); });
+
+		measure("blit", [&] () {
+			blit(src, W*sizeof(Pixel_rgb888), dst, W*sizeof(Pixel_rgb888),
+			     W*sizeof(Pixel_rgb888), H); });
+
+		log("--- blit benchmark finished ---");
+	}
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Main(Main const &);
+		Main &operator = (Main const &);
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-blit_bench
+SRC_CC = main.cc
+LIBS   = base blit
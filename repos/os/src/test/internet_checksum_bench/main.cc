@@ -0,0 +1,183 @@
+/*
+ * \brief  Benchmark of the Internet Checksum implementation
+ * \author Genode Labs
+ * \date   2018-12-04
+ *
+ * The benchmark compares the checksum calculation of the net library with
+ * a reference implementation that adds up 16-bit words one at a time. It
+ * also compares the re-calculation of the TCP checksum of a whole packet
+ * with the incremental update after rewriting address and port as done by
+ * a NAT.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <net/internet_checksum.h>
+#include <net/tcp.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+using namespace Net;
+
+
+/**
+ * Former implementation of 'Net::internet_checksum'
+ */
+static uint16_t reference_checksum(uint16_t const *addr, size_t size)
+{
+	addr_t sum = 0;
+	for (; size > 1; size -= 2)
+		sum += *addr++;
+
+	if (size > 0)
+		sum += *(uint8_t *)addr;
+
+	while (addr_t const sum_rsh = sum >> 16)
+		sum = (sum & 0xffff) + sum_rsh;
+
+	return ~sum;
+}
+
+
+struct Main
+{
+	enum { DURATION_MS = 2000, BUF_SIZE = 2048, IP_SIZE = 1500 };
+
+	Env               &env;
+	Timer::Connection  timer { env };
+
+	uint8_t buf[BUF_SIZE] __attribute__((aligned(8)));
+
+	bool failed = false;
+
+	uint32_t _random = 1;
+
+	uint8_t _next_random()
+	{
+		_random = _random*1103515245 + 12345;
+		return _random >> 16;
+	}
+
+	void _fill_random()
+	{
+		uint8_t *data = buf;
+		for (unsigned i = 0; i < BUF_SIZE; i++)
+			data[i] = _next_random();
+	}
+
+	void _check_correctness()
+	{
+		uint8_t *data = buf;
+		for (unsigned size = 0; size < IP_SIZE; size++) {
+			for (unsigned offset = 0; offset < 8; offset += 2) {
+				uint16_t const *addr = (uint16_t const *)(data + offset);
+				if (reference_checksum(addr, size) == internet_checksum(addr, size))
+					continue;
+
+				error("checksum mismatch for size ", size, " offset ", offset);
+				failed = true;
+				return;
+			}
+		}
+	}
+
+	template <typename FN>
+	void _measure_throughput(char const *brief, size_t size, FN const &fn)
+	{
+		unsigned long  bytes    = 0;
+		unsigned const start_ms = timer.elapsed_ms();
+		uint16_t volatile result = 0;
+		while (timer.elapsed_ms() - start_ms < DURATION_MS) {
+			for (unsigned i = 0; i < 1000; i++) {
+				result = fn((uint16_t const *)buf, size);
+				bytes += size;
+			}
+		}
+		(void)result;
+		unsigned const ms = timer.elapsed_ms() - start_ms;
+		log(brief, " (", size, " bytes): ", bytes / 1024 / ms, " MiB/sec");
+	}
+
+	template <typename FN>
+	void _measure_rate(char const *brief, FN const &fn)
+	{
+		unsigned long  packets  = 0;
+		unsigned const start_ms = timer.elapsed_ms();
+		while (timer.elapsed_ms() - start_ms < DURATION_MS) {
+			for (unsigned i = 0; i < 1000; i++, packets++)
+				fn(i);
+		}
+		unsigned const ms = timer.elapsed_ms() - start_ms;
+		log(brief, ": ", packets * 1000 / ms, " packets/sec");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- Internet checksum benchmark ---");
+
+		_fill_random();
+		_check_correctness();
+
+		static size_t const sizes[] = { 20, 64, 576, IP_SIZE };
+		for (size_t size : sizes) {
+			_measure_throughput("reference", size, [&] (uint16_t const *addr, size_t size) {
+				return reference_checksum(addr, size); });
+			_measure_throughput("net library", size, [&] (uint16_t const *addr, size_t size) {
+				return internet_checksum(addr, size); });
+		}
+
+		/* prepare a TCP packet that gets rewritten by a NAT */
+		Ipv4_packet &ip  = *(Ipv4_packet *)buf;
+		Tcp_packet  &tcp = *(Tcp_packet *)((addr_t)buf + sizeof(Ipv4_packet));
+		size_t const tcp_size = IP_SIZE - sizeof(Ipv4_packet);
+		ip.header_length(sizeof(Ipv4_packet) / 4);
+		ip.total_length(IP_SIZE);
+		ip.update_checksum();
+		tcp.update_checksum(ip.src(), ip.dst(), tcp_size);
+
+		Ipv4_address const nat_ip[2] { Ipv4_address((uint8_t)10),
+		                               Ipv4_address((uint8_t)192) };
+
+		_measure_rate("NAT with full update", [&] (unsigned i) {
+			ip.src(nat_ip[i & 1]);
+			tcp.src_port(Port(i));
+			ip.update_checksum();
+			tcp.update_checksum(ip.src(), ip.dst(), tcp_size);
+		});
+		_measure_rate("NAT with incremental update", [&] (unsigned i) {
+			Internet_checksum_diff ip_icd   { };
+			Internet_checksum_diff prot_icd { };
+			ip.src(nat_ip[i & 1], ip_icd);
+			tcp.src_port(Port(i), prot_icd);
+			ip.update_checksum(ip_icd);
+			prot_icd.add_up_diff(ip_icd);
+			tcp.update_checksum(prot_icd);
+		});
+
+		/* the incremental update must yield a valid checksum */
+		uint16_t const tcp_checksum = tcp.checksum();
+		tcp.update_checksum(ip.src(), ip.dst(), tcp_size);
+		if (tcp_checksum != tcp.checksum()) {
+			error("incremental TCP checksum ", Hex(tcp_checksum),
+			      " differs from ", Hex(tcp.checksum()));
+			failed = true;
+		}
+		if (ip.checksum_error()) {
+			error("incremental IP checksum invalid");
+			failed = true;
+		}
+
+		log("--- Internet checksum benchmark ", failed ? "failed" : "finished", " ---");
+		env.parent().exit(failed ? -1 : 0);
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
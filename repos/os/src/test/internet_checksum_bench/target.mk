@@ -0,0 +1,3 @@
+TARGET = test-internet_checksum_bench
+SRC_CC = main.cc
+LIBS   = base net
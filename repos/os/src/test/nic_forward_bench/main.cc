@@ -0,0 +1,228 @@
+/*
+ * \brief  Frame-forwarding benchmark for NIC multiplexers
+ * \author Genode Labs
+ * \date   2018-12-19
+ *
+ * The component opens two NIC sessions at a NIC multiplexer like the NIC
+ * bridge. Frames sent via the "sender" session are addressed to the MAC
+ * address of the "receiver" session. Hence, the multiplexer forwards each
+ * frame from one session to the other. The benchmark keeps a window of
+ * frames in flight and reports the number of frames per second that arrive
+ * at the receiver for different frame sizes.
+ *
+ * The measurement is repeated with the "shared_sender" and
+ * "shared_receiver" sessions, which are expected to be configured for
+ * forwarding via the shared buffer of the NIC bridge.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/allocator_avl.h>
+#include <nic_session/connection.h>
+#include <nic/packet_allocator.h>
+#include <net/ethernet.h>
+#include <timer_session/connection.h>
+#include <util/reconstructible.h>
+
+namespace Test {
+
+	struct Main;
+
+	using namespace Genode;
+	using namespace Net;
+}
+
+
+struct Test::Main
+{
+	enum { DURATION_MS = 2000,
+	       BATCH       = 32,
+	       WINDOW      = 128,
+	       BUF_SIZE    = Nic::Packet_allocator::DEFAULT_PACKET_SIZE * 256 };
+
+	/* local experimental EtherType, not interpreted by the multiplexer */
+	enum { ETHER_TYPE = 0x88b5 };
+
+	Env &_env;
+
+	Heap          _heap           { _env.ram(), _env.rm() };
+	Allocator_avl _sender_alloc   { &_heap };
+	Allocator_avl _receiver_alloc { &_heap };
+
+	Constructible<Nic::Connection> _sender   { };
+	Constructible<Nic::Connection> _receiver { };
+
+	Mac_address _src { };
+	Mac_address _dst { };
+
+	Timer::Connection _timer { _env };
+
+	size_t   _frame_size = 0;
+	bool     _running    = false;
+	unsigned _in_flight  = 0;
+	uint64_t _start_ms   = 0;
+
+	unsigned long _sent = 0, _received = 0, _foreign = 0;
+
+	Nic::Packet_descriptor _packets[BATCH] { };
+
+	uint64_t _now_ms() { return _timer.curr_time().trunc_to_plain_ms().value; }
+
+	void _handle_sender();
+	void _handle_receiver();
+	void _handle_timeout(Duration);
+
+	Signal_handler<Main> _sender_handler   { _env.ep(), *this, &Main::_handle_sender };
+	Signal_handler<Main> _receiver_handler { _env.ep(), *this, &Main::_handle_receiver };
+
+	Timer::One_shot_timeout<Main> _timeout { _timer, *this, &Main::_handle_timeout };
+
+	enum { NUM_SIZES = 2, NUM_MODES = 2 };
+
+	size_t const _frame_sizes[NUM_SIZES] { 64, 1514 };
+	unsigned     _phase = 0;
+
+	bool _shared() const { return _phase / NUM_SIZES; }
+
+	char const *_mode() const { return _shared() ? "shared" : "copy"; }
+
+	void _open_sessions(char const *prefix);
+	void _start_phase();
+
+	Main(Env &env) : _env(env)
+	{
+		log("NIC forwarding benchmark started");
+		_start_phase();
+	}
+};
+
+
+void Test::Main::_open_sessions(char const *prefix)
+{
+	_receiver.destruct();
+	_sender.destruct();
+
+	_sender.construct(_env, &_sender_alloc, BUF_SIZE, BUF_SIZE,
+	                  String<32>(prefix, "sender").string());
+	_receiver.construct(_env, &_receiver_alloc, BUF_SIZE, BUF_SIZE,
+	                    String<32>(prefix, "receiver").string());
+
+	_in_flight = 0;
+
+	_src = _sender->mac_address();
+	_dst = _receiver->mac_address();
+
+	_sender->tx_channel()->sigh_ready_to_submit(_sender_handler);
+	_sender->tx_channel()->sigh_ack_avail      (_sender_handler);
+	_receiver->rx_channel()->sigh_ready_to_ack (_receiver_handler);
+	_receiver->rx_channel()->sigh_packet_avail (_receiver_handler);
+}
+
+
+void Test::Main::_start_phase()
+{
+	if (_phase % NUM_SIZES == 0)
+		_open_sessions(_shared() ? "shared_" : "");
+
+	_frame_size = _frame_sizes[_phase % NUM_SIZES];
+	_sent       = _received = _foreign = 0;
+	_running    = true;
+
+	log("start forward ", _mode(), " ", _frame_size);
+	_start_ms = _now_ms();
+	_timeout.schedule(Microseconds(DURATION_MS * 1000));
+	_handle_sender();
+}
+
+
+void Test::Main::_handle_sender()
+{
+	Nic::Session::Tx::Source &tx = *_sender->tx();
+
+	/* release the space of forwarded frames */
+	for (;;) {
+		unsigned const n = tx.get_acked_packets(_packets, BATCH);
+		for (unsigned i = 0; i < n; i++)
+			tx.release_packet(_packets[i]);
+
+		_in_flight -= n;
+		if (n < BATCH)
+			break;
+	}
+
+	while (_running && _in_flight + BATCH <= WINDOW) {
+
+		unsigned n = 0;
+		try {
+			for (; n < BATCH; n++)
+				_packets[n] = tx.alloc_packet(_frame_size);
+		}
+		catch (Nic::Session::Tx::Source::Packet_alloc_failed) { }
+
+		for (unsigned i = 0; i < n; i++) {
+			Size_guard size_guard(_frame_size);
+			Ethernet_frame &eth =
+				Ethernet_frame::construct_at(tx.packet_content(_packets[i]),
+				                             size_guard);
+			eth.dst(_dst);
+			eth.src(_src);
+			eth.type((Ethernet_frame::Type)ETHER_TYPE);
+		}
+		tx.submit_packets(_packets, n);
+
+		_in_flight += n;
+		_sent      += n;
+		if (n < BATCH)
+			break;
+	}
+}
+
+
+void Test::Main::_handle_receiver()
+{
+	Nic::Session::Rx::Sink &rx = *_receiver->rx();
+
+	Nic::Packet_descriptor packets[BATCH];
+	for (;;) {
+		unsigned const n = rx.get_packets(packets, BATCH);
+		for (unsigned i = 0; i < n; i++) {
+			if (packets[i].size() == _frame_size) _received++;
+			else                                  _foreign++;
+		}
+		rx.acknowledge_packets(packets, n);
+
+		if (n < BATCH)
+			break;
+	}
+}
+
+
+void Test::Main::_handle_timeout(Duration)
+{
+	_running = false;
+
+	uint64_t const ms = _now_ms() - _start_ms;
+	log("finished forward ", _mode(), " ", _frame_size);
+	log("frames: sent ", _sent, " received ", _received, " foreign ",
+	    _foreign, " in ", ms, " ms (", ms ? (_received*1000)/ms : 0,
+	    " frames/sec)");
+
+	if (++_phase < NUM_SIZES*NUM_MODES) {
+		_start_phase();
+		return;
+	}
+
+	log("--- NIC forwarding benchmark finished ---");
+	_env.parent().exit(_received ? 0 : -1);
+}
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-nic_forward_bench
+SRC_CC = main.cc
+LIBS   = base
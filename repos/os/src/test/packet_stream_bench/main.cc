@@ -0,0 +1,299 @@
+/*
+ * \brief  Packet-stream descriptor-throughput benchmark
+ * \author Genode Labs
+ * \date   2018-12-03
+ *
+ * Source and sink of one packet stream are instantiated within the same
+ * component and share a single communication buffer. The benchmark passes
+ * packet descriptors through the submit and acknowledgement queues, once
+ * packet by packet and once in batches, and reports the number of
+ * descriptors per second for each variant. As reference, the same traffic
+ * is passed through a replica of the lock-based descriptor queues that
+ * packet streams used before the lock-free rings. The speed-up of each
+ * variant is reported relative to this baseline.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/allocator_avl.h>
+#include <base/attached_ram_dataspace.h>
+#include <os/packet_stream.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+typedef Packet_stream_source<Default_packet_stream_policy> Source;
+typedef Packet_stream_sink<Default_packet_stream_policy>   Sink;
+
+
+struct Test
+{
+	enum { DURATION_MS = 2000, BATCH = 32, PACKET_SIZE = 64 };
+
+	Env                   &env;
+	Timer::Connection     &timer;
+	Heap                   heap    { env.ram(), env.rm() };
+	Allocator_avl          alloc   { &heap };
+	Attached_ram_dataspace ds      { env.ram(), env.rm(), 64*1024 };
+	Source                 source  { ds.cap(), env.rm(), alloc };
+	Sink                   sink    { ds.cap(), env.rm() };
+	Packet_descriptor      packets[BATCH];
+	Packet_descriptor      received[BATCH];
+
+	Test(Env &env, Timer::Connection &timer, char const *brief)
+	: env(env), timer(timer)
+	{
+		log("\nTEST: ", brief);
+
+		/* wire up signals the same way as a session does */
+		source.register_sigh_packet_avail(sink.sigh_packet_avail());
+		source.register_sigh_ready_to_ack(sink.sigh_ready_to_ack());
+		sink.register_sigh_ack_avail(source.sigh_ack_avail());
+		sink.register_sigh_ready_to_submit(source.sigh_ready_to_submit());
+
+		for (unsigned i = 0; i < BATCH; i++)
+			packets[i] = source.alloc_packet(PACKET_SIZE);
+	}
+
+	~Test()
+	{
+		for (unsigned i = 0; i < BATCH; i++)
+			source.release_packet(packets[i]);
+	}
+
+	/* descriptors per second */
+	unsigned long rate = 0;
+
+	void conclusion(unsigned long descriptors, unsigned start_ms, unsigned end_ms)
+	{
+		unsigned long const ms = end_ms - start_ms;
+		rate = ms ? (descriptors*1000)/ms : 0;
+		log("descriptors: ", descriptors, " in ", ms, " ms (",
+		    rate, " descriptors/sec)");
+	}
+
+	private:
+
+		/*
+		 * Noncopyable
+		 */
+		Test(Test const &);
+		Test &operator = (Test const &);
+};
+
+
+/**
+ * Descriptor queue of packet streams before the lock-free rings
+ *
+ * One slot stays unused to distinguish a full from an empty queue.
+ */
+template <unsigned QUEUE_SIZE>
+struct Baseline_queue
+{
+	unsigned          head = 0, tail = 0;
+	Packet_descriptor queue[QUEUE_SIZE];
+
+	bool empty()            const { return tail == head; }
+	bool full()             const { return (head + 1)%QUEUE_SIZE == tail; }
+	bool single_element()   const { return (tail + 1)%QUEUE_SIZE == head; }
+	bool single_slot_free() const { return (head + 2)%QUEUE_SIZE == tail; }
+
+	void add(Packet_descriptor packet)
+	{
+		queue[head] = packet;
+		head = (head + 1)%QUEUE_SIZE;
+	}
+
+	Packet_descriptor get()
+	{
+		Packet_descriptor const packet = queue[tail];
+		tail = (tail + 1)%QUEUE_SIZE;
+		return packet;
+	}
+};
+
+
+/**
+ * Data-flow control of packet streams before the lock-free rings
+ *
+ * Each operation takes the lock of its side of the queue. The receiver is
+ * signalled whenever the queue becomes non-empty and the transmitter
+ * whenever a slot becomes available in a full queue.
+ */
+struct Baseline_channel
+{
+	Baseline_queue<64> queue    { };
+	Lock               tx_lock  { };
+	Lock               rx_lock  { };
+	Signal_transmitter rx_ready;
+	Signal_transmitter tx_ready;
+
+	Baseline_channel(Signal_context_capability rx_ready,
+	                 Signal_context_capability tx_ready)
+	: rx_ready(rx_ready), tx_ready(tx_ready) { }
+
+	bool tx(Packet_descriptor packet)
+	{
+		Lock::Guard guard(tx_lock);
+
+		if (queue.full())
+			return false;
+
+		queue.add(packet);
+		if (queue.single_element())
+			rx_ready.submit();
+		return true;
+	}
+
+	bool ready_for_rx()
+	{
+		Lock::Guard guard(rx_lock);
+		return !queue.empty();
+	}
+
+	Packet_descriptor rx()
+	{
+		Lock::Guard guard(rx_lock);
+
+		Packet_descriptor const packet = queue.get();
+		if (queue.single_slot_free())
+			tx_ready.submit();
+		return packet;
+	}
+};
+
+
+struct Baseline_test : Test
+{
+	static constexpr char const *brief = "baseline, one descriptor per operation";
+
+	Signal_receiver signal_receiver { };
+	Signal_context  signal_context  { };
+
+	Signal_context_capability const signal_cap {
+		signal_receiver.manage(&signal_context) };
+
+	Baseline_channel submit { signal_cap, signal_cap };
+	Baseline_channel ack    { signal_cap, signal_cap };
+
+	Baseline_test(Env &env, Timer::Connection &timer) : Test(env, timer, brief)
+	{
+		unsigned long  descriptors = 0;
+		unsigned const start_ms    = timer.elapsed_ms();
+
+		while (timer.elapsed_ms() - start_ms < DURATION_MS) {
+
+			for (unsigned i = 0; i < BATCH; i++)
+				submit.tx(packets[i]);
+
+			while (submit.ready_for_rx())
+				ack.tx(submit.rx());
+
+			while (ack.ready_for_rx()) {
+				ack.rx();
+				descriptors++;
+			}
+		}
+		conclusion(descriptors, start_ms, timer.elapsed_ms());
+	}
+
+	~Baseline_test() { signal_receiver.dissolve(&signal_context); }
+};
+
+
+struct Single_test : Test
+{
+	static constexpr char const *brief = "one descriptor per operation";
+
+	Single_test(Env &env, Timer::Connection &timer) : Test(env, timer, brief)
+	{
+		unsigned long  descriptors = 0;
+		unsigned const start_ms    = timer.elapsed_ms();
+
+		while (timer.elapsed_ms() - start_ms < DURATION_MS) {
+
+			for (unsigned i = 0; i < BATCH; i++)
+				source.submit_packet(packets[i]);
+
+			while (sink.packet_avail())
+				sink.acknowledge_packet(sink.get_packet());
+
+			while (source.ack_avail()) {
+				source.get_acked_packet();
+				descriptors++;
+			}
+		}
+		conclusion(descriptors, start_ms, timer.elapsed_ms());
+	}
+};
+
+
+struct Batch_test : Test
+{
+	static constexpr char const *brief = "batches of descriptors";
+
+	Batch_test(Env &env, Timer::Connection &timer) : Test(env, timer, brief)
+	{
+		unsigned long  descriptors = 0;
+		unsigned const start_ms    = timer.elapsed_ms();
+
+		while (timer.elapsed_ms() - start_ms < DURATION_MS) {
+
+			source.submit_packets(packets, BATCH);
+
+			unsigned const n = sink.get_packets(received, BATCH);
+			sink.acknowledge_packets(received, n);
+
+			descriptors += source.get_acked_packets(received, BATCH);
+		}
+		conclusion(descriptors, start_ms, timer.elapsed_ms());
+	}
+};
+
+
+struct Main
+{
+	Timer::Connection timer;
+
+	Constructible<Baseline_test> baseline { };
+	Constructible<Single_test>   single   { };
+	Constructible<Batch_test>    batch    { };
+
+	unsigned long baseline_rate = 0;
+
+	void speedup(unsigned long rate)
+	{
+		log("rate relative to baseline: ",
+		    baseline_rate ? (rate*100)/baseline_rate : 0, "%");
+	}
+
+	Main(Env &env) : timer(env)
+	{
+		log("--- packet-stream benchmark ---");
+
+		baseline.construct(env, timer);
+		baseline_rate = baseline->rate;
+		baseline.destruct();
+
+		single.construct(env, timer);
+		speedup(single->rate);
+		single.destruct();
+
+		batch.construct(env, timer);
+		speedup(batch->rate);
+		batch.destruct();
+
+		log("--- packet-stream benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
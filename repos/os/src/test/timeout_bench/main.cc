@@ -0,0 +1,138 @@
+/*
+ * \brief  Benchmark of the timeout scheduler with many concurrent timeouts
+ * \author Genode Labs
+ * \date   2018-12-08
+ *
+ * The benchmark keeps 100,000 one-shot timeouts scheduled at the same time
+ * and measures the average cost of scheduling, re-scheduling (as done by
+ * the NIC router on each packet of a link), and discarding them. Finally,
+ * all timeouts are scheduled to expire within one second and the benchmark
+ * waits until each of them has triggered exactly once.
+ */
+
+/*
+ * Copyright (C) 2018 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+
+struct Main
+{
+	enum {
+		NUM_TIMEOUTS = 100*1000,
+		NUM_RESCHEDULES = 10,
+		EXPIRY_RANGE_US = 1000*1000,
+	};
+
+	struct Bench_timeout : Timeout::Handler
+	{
+		Main    &main;
+		Timeout  timeout;
+		unsigned triggered { 0 };
+
+		Bench_timeout(Main &main)
+		: main(main), timeout(main._timer) { }
+
+		void handle_timeout(Duration) override
+		{
+			triggered++;
+			main._triggered();
+		}
+	};
+
+	Env               &_env;
+	Heap               _heap { _env.ram(), _env.rm() };
+	Timer::Connection  _timer { _env };
+	Bench_timeout    **_timeouts { nullptr };
+	unsigned long      _seed { 1 };
+	unsigned           _num_triggered { 0 };
+	uint64_t           _expiry_start_us { 0 };
+
+	/*
+	 * Noncopyable
+	 */
+	Main(Main const &);
+	Main &operator = (Main const &);
+
+	unsigned long _random()
+	{
+		_seed = _seed*1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	uint64_t _now_us() { return _timer.curr_time().trunc_to_plain_us().value; }
+
+	/**
+	 * Apply 'fn' to each timeout and print the average cost per call
+	 */
+	template <typename FN>
+	void _measure(char const *what, unsigned rounds, FN const &fn)
+	{
+		uint64_t const start_us = _now_us();
+		for (unsigned r = 0; r < rounds; r++)
+			for (unsigned i = 0; i < NUM_TIMEOUTS; i++)
+				fn(*_timeouts[i]);
+
+		uint64_t const duration_us = _now_us() - start_us;
+		uint64_t const calls       = (uint64_t)rounds*NUM_TIMEOUTS;
+		log(what, ": ", calls, " calls in ", duration_us / 1000, " ms (",
+		    duration_us*1000 / calls, " ns/call)");
+	}
+
+	void _triggered()
+	{
+		if (++_num_triggered < NUM_TIMEOUTS)
+			return;
+
+		log("expiry: ", (unsigned)NUM_TIMEOUTS, " timeouts triggered within ",
+		    (_now_us() - _expiry_start_us) / 1000, " ms");
+
+		for (unsigned i = 0; i < NUM_TIMEOUTS; i++) {
+			if (_timeouts[i]->triggered != 1) {
+				error("timeout ", i, " triggered ", _timeouts[i]->triggered, " times");
+				_env.parent().exit(-1);
+				return;
+			}
+		}
+		log("--- timeout benchmark finished ---");
+		_env.parent().exit(0);
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		/* switch the timer connection to the multiplexing mode */
+		_timer.curr_time();
+
+		_timeouts = new (_heap) Bench_timeout*[NUM_TIMEOUTS];
+		for (unsigned i = 0; i < NUM_TIMEOUTS; i++)
+			_timeouts[i] = new (_heap) Bench_timeout(*this);
+
+		log("--- timeout benchmark started ---");
+
+		/* long-lasting timeouts that do not trigger during the benchmark */
+		auto schedule = [&] (Bench_timeout &t) {
+			t.timeout.schedule_one_shot(Microseconds(60*1000*1000 + _random() % (60*1000*1000)), t); };
+
+		_measure("schedule",   1,               schedule);
+		_measure("reschedule", NUM_RESCHEDULES, schedule);
+		_measure("discard",    1, [&] (Bench_timeout &t) { t.timeout.discard(); });
+
+		/* let all timeouts expire within a short period of time */
+		_expiry_start_us = _now_us();
+		for (unsigned i = 0; i < NUM_TIMEOUTS; i++)
+			_timeouts[i]->timeout.schedule_one_shot(
+				Microseconds(_random() % EXPIRY_RANGE_US), *_timeouts[i]);
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-timeout_bench
+SRC_CC = main.cc
+LIBS  += base